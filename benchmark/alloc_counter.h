@@ -0,0 +1,55 @@
+#ifndef LORAINE_BENCH_ALLOC_COUNTER_H
+#define LORAINE_BENCH_ALLOC_COUNTER_H
+
+#include <benchmark/benchmark.h>
+
+#include "utils/alloc_tracker.h"
+#include "utils/types.h"
+
+namespace bench {
+
+/**
+ * The number of heap allocations of the calling thread while its allocation tracking was enabled.
+ * The benchmarks link the `loraine_alloc_hook` target, which feeds the AllocationTracker.
+ */
+inline u64 allocations()
+{
+   return profiling::AllocationTracker::total().count;
+}
+
+/**
+ * Counts the allocations of the benchmarked thread between construction and `report`, which adds
+ * them as the average per iteration to the benchmark's counters. Allocations between `pause` and
+ * `resume` (i.e. untimed setup) are excluded.
+ */
+class AllocationCounter {
+  public:
+   AllocationCounter() : m_was_enabled(profiling::AllocationTracker::enabled())
+   {
+      profiling::AllocationTracker::enable();
+      m_start = allocations();
+   }
+   ~AllocationCounter() { profiling::AllocationTracker::enable(m_was_enabled); }
+   AllocationCounter(const AllocationCounter&) = delete;
+   AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+   void pause() { m_paused_at = allocations(); }
+   void resume() { m_excluded += allocations() - m_paused_at; }
+
+   void report(benchmark::State& state) const
+   {
+      state.counters["allocs"] = benchmark::Counter(
+         static_cast< double >(allocations() - m_start - m_excluded),
+         benchmark::Counter::kAvgIterations);
+   }
+
+  private:
+   bool m_was_enabled;
+   u64 m_start = 0;
+   u64 m_paused_at = 0;
+   u64 m_excluded = 0;
+};
+
+}  // namespace bench
+
+#endif  // LORAINE_BENCH_ALLOC_COUNTER_H
@@ -0,0 +1,37 @@
+
+#include <benchmark/benchmark.h>
+
+#include "alloc_counter.h"
+#include "bench_utils.h"
+
+namespace {
+
+struct CountingSubscriber: public IEventSubscriber< events::StrikeEvent > {
+   size_t calls = 0;
+
+   void on_event(GameState& /*state*/, events::StrikeEvent::EventData&& /*data*/) override
+   {
+      calls += 1;
+   }
+};
+
+}  // namespace
+
+static void BM_EventBusFire(benchmark::State& bm_state)
+{
+   auto state = bench::make_state(12);
+   auto unit1 = bench::make_unit(BLUE, 0);
+   auto unit2 = bench::make_unit(RED, 1);
+   std::vector< CountingSubscriber > subscribers(size_t(bm_state.range(0)));
+   events::StrikeEvent event;
+   for(auto& sub : subscribers) {
+      event.subscribe(&sub);
+   }
+   bench::AllocationCounter allocs;
+   for(auto _ : bm_state) {
+      event.fire(state, BLUE, unit1, unit2);
+   }
+   allocs.report(bm_state);
+   bm_state.SetItemsProcessed(bm_state.iterations() * bm_state.range(0));
+}
+BENCHMARK(BM_EventBusFire)->Arg(0)->Arg(1)->Arg(10)->Arg(50);
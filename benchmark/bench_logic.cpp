@@ -0,0 +1,110 @@
+
+#include <benchmark/benchmark.h>
+
+#include "alloc_counter.h"
+#include "bench_utils.h"
+
+static void BM_StrikeMutually(benchmark::State& bm_state)
+{
+   auto state = bench::make_state(12);
+   sptr< Unit > unit1 = std::make_shared< bench::BenchUnit >(BLUE, "B001", 3, 1000);
+   sptr< Unit > unit2 = std::make_shared< bench::BenchUnit >(RED, "B002", 2, 1000);
+   auto logic = state.logic();
+   bench::AllocationCounter allocs;
+   for(auto _ : bm_state) {
+      benchmark::DoNotOptimize(logic->strike_mutually(unit1, unit2));
+      unit1->heal(1000);
+      unit2->heal(1000);
+   }
+   allocs.report(bm_state);
+}
+BENCHMARK(BM_StrikeMutually);
+
+static void BM_Resolve6v6(benchmark::State& bm_state)
+{
+   auto state = bench::make_state(12);
+   auto logic = state.logic();
+   auto& board = state.board();
+   bench::AllocationCounter allocs;
+   for(auto _ : bm_state) {
+      bm_state.PauseTiming();
+      allocs.pause();
+      for(Team team : {BLUE, RED}) {
+         board.camp(team).clear();
+         board.battlefield(team).clear();
+         state.player(team).graveyard().clear();
+         for(size_t lane = 0; lane < board.max_size_bf(); ++lane) {
+            auto unit = bench::make_unit(team, lane + size_t(team));
+            unit->mutables().location = Location::BATTLEFIELD;
+            board.add_to_bf(unit);
+         }
+      }
+      state.attacker(BLUE);
+      logic->transition< CombatModeInvoker >();
+      allocs.resume();
+      bm_state.ResumeTiming();
+
+      logic->resolve();
+   }
+   allocs.report(bm_state);
+}
+BENCHMARK(BM_Resolve6v6);
+
+static void BM_DamageUnitsAoe(benchmark::State& bm_state)
+{
+   auto state = bench::make_state(12);
+   auto logic = state.logic();
+   auto& board = state.board();
+   sptr< Card > cause = bench::make_unit(BLUE, 0);
+   for(size_t lane = 0; lane < board.max_size_bf(); ++lane) {
+      board.add_to_bf(std::make_shared< bench::BenchUnit >(RED, "B003", 1, 1000));
+   }
+   const auto& targets = board.battlefield(RED);
+   bench::AllocationCounter allocs;
+   for(auto _ : bm_state) {
+      benchmark::DoNotOptimize(logic->damage_units(targets, cause, 1));
+      for(const auto& unit : targets) {
+         unit->heal(1000);
+      }
+   }
+   allocs.report(bm_state);
+}
+BENCHMARK(BM_DamageUnitsAoe);
+
+static void BM_CountUnits(benchmark::State& bm_state)
+{
+   auto state = bench::make_state(12);
+   auto& board = state.board();
+   for(size_t i = 0; i < board.max_size_camp(); ++i) {
+      board.add_to_camp(bench::make_unit(BLUE, i));
+   }
+   bench::AllocationCounter allocs;
+   for(auto _ : bm_state) {
+      benchmark::DoNotOptimize(board.count_units(BLUE, true, [](const sptr< FieldCard >& card) {
+         return to_unit(card)->power() > 2;
+      }));
+   }
+   allocs.report(bm_state);
+}
+BENCHMARK(BM_CountUnits);
+
+static void BM_GrantFactoryGrant(benchmark::State& bm_state)
+{
+   auto state = bench::make_state(12);
+   auto& factory = state.grantfactory(BLUE);
+   auto bestowing = bench::make_unit(BLUE, 0);
+   auto bestowed = bench::make_unit(BLUE, 1);
+   bench::AllocationCounter allocs;
+   for(auto _ : bm_state) {
+      auto grant = factory.grant< GrantType::STATS >(bestowing, bestowed, false, 1L, 1L);
+      benchmark::DoNotOptimize(grant);
+      bm_state.PauseTiming();
+      allocs.pause();
+      grant->undo();
+      bestowed->mutables().grants_temp.clear();
+      allocs.resume();
+      bm_state.ResumeTiming();
+   }
+   allocs.report(bm_state);
+}
+BENCHMARK(BM_GrantFactoryGrant);
@@ -0,0 +1,112 @@
+
+#include <benchmark/benchmark.h>
+
+#include "alloc_counter.h"
+#include "bench_utils.h"
+
+static void BM_GameStateCopy(benchmark::State& bm_state)
+{
+   auto state = bench::make_state();
+   for(int i = 0; i < 4; ++i) {
+      state.logic()->draw_card(BLUE);
+      state.logic()->draw_card(RED);
+   }
+   bench::AllocationCounter allocs;
+   for(auto _ : bm_state) {
+      GameState copy(state);
+      benchmark::DoNotOptimize(&copy);
+   }
+   allocs.report(bm_state);
+}
+BENCHMARK(BM_GameStateCopy);
+
+static void BM_GameStateConstruct(benchmark::State& bm_state)
+{
+   bench::AllocationCounter allocs;
+   for(auto _ : bm_state) {
+      auto state = bench::make_state();
+      benchmark::DoNotOptimize(&state);
+   }
+   allocs.report(bm_state);
+}
+BENCHMARK(BM_GameStateConstruct);
+
+static void BM_GameStateReset(benchmark::State& bm_state)
+{
+   auto state = bench::make_state();
+   bench::AllocationCounter allocs;
+   for(auto _ : bm_state) {
+      // the decks are built anew either way, as in BM_GameStateConstruct
+      state.reset({bench::make_deck(BLUE, 40), bench::make_deck(RED, 40)}, BLUE, 0);
+      benchmark::DoNotOptimize(&state);
+   }
+   allocs.report(bm_state);
+}
+BENCHMARK(BM_GameStateReset);
+
+static void BM_DeckCopy(benchmark::State& bm_state)
+{
+   auto deck = bench::make_deck(BLUE, size_t(bm_state.range(0)));
+   bench::AllocationCounter allocs;
+   for(auto _ : bm_state) {
+      Deck copy(deck);
+      benchmark::DoNotOptimize(&copy);
+   }
+   allocs.report(bm_state);
+}
+BENCHMARK(BM_DeckCopy)->Arg(12)->Arg(40);
+
+static void BM_DeckPopByIndex(benchmark::State& bm_state)
+{
+   auto deck = bench::make_deck(BLUE, 40);
+   auto rng = random::create_rng(0);
+   bench::AllocationCounter allocs;
+   for(auto _ : bm_state) {
+      // pop from the front (the worst case for the vector) and put the card back on top
+      auto card = deck.pop_by_index(0);
+      benchmark::DoNotOptimize(card);
+      bm_state.PauseTiming();
+      allocs.pause();
+      deck.shuffle_into(card, rng, 1);
+      allocs.resume();
+      bm_state.ResumeTiming();
+   }
+   allocs.report(bm_state);
+}
+BENCHMARK(BM_DeckPopByIndex);
+
+static void BM_DeckPopByCode(benchmark::State& bm_state)
+{
+   auto deck = bench::make_deck(BLUE, 40);
+   auto rng = random::create_rng(0);
+   bench::AllocationCounter allocs;
+   for(auto _ : bm_state) {
+      auto card = deck.pop_by_code("B005", rng);
+      benchmark::DoNotOptimize(card);
+      bm_state.PauseTiming();
+      allocs.pause();
+      deck.shuffle_into(card, rng, 0);
+      allocs.resume();
+      bm_state.ResumeTiming();
+   }
+   allocs.report(bm_state);
+}
+BENCHMARK(BM_DeckPopByCode);
+
+static void BM_DeckShuffleInto(benchmark::State& bm_state)
+{
+   auto deck = bench::make_deck(BLUE, 40);
+   auto rng = random::create_rng(0);
+   auto top_n = size_t(bm_state.range(0));
+   bench::AllocationCounter allocs;
+   for(auto _ : bm_state) {
+      bm_state.PauseTiming();
+      allocs.pause();
+      auto card = deck.pop();
+      allocs.resume();
+      bm_state.ResumeTiming();
+      deck.shuffle_into(card, rng, top_n);
+   }
+   allocs.report(bm_state);
+}
+BENCHMARK(BM_DeckShuffleInto)->Arg(0)->Arg(3);
@@ -0,0 +1,94 @@
+
+#ifndef LORAINE_BENCH_UTILS_H
+#define LORAINE_BENCH_UTILS_H
+
+#include <stdexcept>
+
+#include "all.h"
+
+namespace bench {
+
+/**
+ * A vanilla unit with the given stats, standing in for real cards.
+ */
+class BenchUnit: public CloneableCard< BenchUnit, Unit > {
+  public:
+   using CloneableCard::CloneableCard;
+
+   BenchUnit(
+      Team owner,
+      const char* code,
+      size_t power,
+      size_t health,
+      size_t cost = 2,
+      KeywordMap keywords = {})
+       : CloneableCard(
+          Card::ConstState{
+             code,
+             code,
+             "",
+             "",
+             Region::DEMACIA,
+             Group::NONE,
+             CardSuperType::NONE,
+             Rarity::COMMON,
+             CardType::UNIT,
+             cost,
+          },
+          Card::MutableState{owner, Location::DECK, 0, true, long(cost), 0, keywords},
+          Unit::ConstUnitState{power, health},
+          Unit::MutableUnitState{power, health})
+   {
+   }
+};
+
+/**
+ * A controller for states which are never asked for decisions.
+ */
+struct IdleController: public Controller {
+   using Controller::Controller;
+
+   actions::Action choose_action(const GameState& /*state*/) override
+   {
+      throw std::logic_error("The idle benchmark controller was asked for an action.");
+   }
+   actions::Action choose_targets(
+      const GameState& /*state*/,
+      const sptr< EffectBase >& /*effect*/) override
+   {
+      throw std::logic_error("The idle benchmark controller was asked for targets.");
+   }
+};
+
+inline sptr< Unit > make_unit(Team team, size_t idx)
+{
+   static const char* codes[] = {"B001", "B002", "B003", "B004", "B005", "B006", "B007", "B008"};
+   return std::make_shared< BenchUnit >(team, codes[idx % 8], 1 + idx % 5, 2 + idx % 4);
+}
+
+/**
+ * A deck of `size` units with 8 distinct codes.
+ */
+inline Deck make_deck(Team team, size_t size)
+{
+   Deck::ContainerType cards;
+   cards.reserve(size);
+   for(size_t i = 0; i < size; ++i) {
+      cards.emplace_back(make_unit(team, i));
+   }
+   return Deck(cards);
+}
+
+inline GameState make_state(size_t deck_size = 40, int seed = 0)
+{
+   return GameState(
+      Config(),
+      {make_deck(BLUE, deck_size), make_deck(RED, deck_size)},
+      {std::make_shared< IdleController >(BLUE), std::make_shared< IdleController >(RED)},
+      BLUE,
+      random::create_rng(seed));
+}
+
+}  // namespace bench
+
+#endif  // LORAINE_BENCH_UTILS_H
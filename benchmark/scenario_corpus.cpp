@@ -0,0 +1,157 @@
+
+#include "scenario_corpus.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "bench_utils.h"
+
+namespace bench::corpus {
+
+const std::vector< CardSpec >& cards()
+{
+   static const std::vector< CardSpec > pool{
+      {"BU001", "Scrapper", 1, 2, 1, {}},
+      {"BU002", "Sentry", 1, 1, 2, {Keyword::TOUGH}},
+      {"BU003", "Duelist", 2, 2, 2, {Keyword::QUICK_ATTACK}},
+      {"BU004", "Recruit", 2, 2, 3, {}},
+      {"BU005", "Raider", 2, 3, 1, {}},
+      {"BU006", "Vanguard", 3, 3, 3, {}},
+      {"BU007", "Bulwark", 3, 1, 5, {Keyword::TOUGH}},
+      {"BU008", "Skirmisher", 3, 3, 2, {Keyword::QUICK_ATTACK}},
+      {"BU009", "Brute", 4, 4, 4, {}},
+      {"BU010", "Trampler", 4, 4, 3, {Keyword::OVERWHELM}},
+      {"BU011", "Warden", 5, 3, 7, {Keyword::TOUGH}},
+      {"BU012", "Champion", 5, 5, 5, {}},
+      {"BU013", "Colossus", 6, 6, 6, {Keyword::OVERWHELM}},
+      {"BU014", "Titan", 8, 8, 8, {Keyword::OVERWHELM}},
+      {"BU015", "Blademaster", 4, 3, 3, {Keyword::DOUBLE_ATTACK}},
+   };
+   return pool;
+}
+
+const std::vector< DeckSpec >& decks()
+{
+   static const std::vector< DeckSpec > lists{
+      {"aggro",
+       {{"BU001", 3},
+        {"BU002", 3},
+        {"BU003", 3},
+        {"BU004", 3},
+        {"BU005", 3},
+        {"BU006", 3},
+        {"BU007", 2},
+        {"BU008", 3},
+        {"BU009", 3},
+        {"BU010", 3},
+        {"BU011", 2},
+        {"BU012", 3},
+        {"BU013", 3},
+        {"BU015", 3}}},
+      {"midrange",
+       {{"BU001", 1},
+        {"BU002", 2},
+        {"BU003", 3},
+        {"BU004", 3},
+        {"BU005", 2},
+        {"BU006", 3},
+        {"BU007", 3},
+        {"BU008", 3},
+        {"BU009", 3},
+        {"BU010", 3},
+        {"BU011", 3},
+        {"BU012", 3},
+        {"BU013", 3},
+        {"BU014", 2},
+        {"BU015", 3}}},
+      {"control",
+       {{"BU002", 3},
+        {"BU003", 3},
+        {"BU004", 3},
+        {"BU005", 2},
+        {"BU006", 3},
+        {"BU007", 3},
+        {"BU008", 2},
+        {"BU009", 3},
+        {"BU010", 3},
+        {"BU011", 3},
+        {"BU012", 3},
+        {"BU013", 3},
+        {"BU014", 3},
+        {"BU015", 3}}},
+      {"overwhelm",
+       {{"BU001", 2},
+        {"BU002", 2},
+        {"BU003", 3},
+        {"BU004", 3},
+        {"BU006", 3},
+        {"BU007", 3},
+        {"BU008", 3},
+        {"BU009", 3},
+        {"BU010", 3},
+        {"BU011", 3},
+        {"BU012", 3},
+        {"BU013", 3},
+        {"BU014", 3},
+        {"BU015", 3}}},
+   };
+   return lists;
+}
+
+const std::vector< u64 >& seeds()
+{
+   static const std::vector< u64 > game_seeds{
+      0x9e3779b97f4a7c15, 0x243f6a8885a308d3, 0x13198a2e03707344, 0xa4093822299f31d0};
+   return game_seeds;
+}
+
+const std::vector< Scenario >& scenarios()
+{
+   static const std::vector< Scenario > all = [] {
+      std::vector< Scenario > out;
+      const auto kinds = {ControllerKind::RANDOM, ControllerKind::SCRIPTED};
+      for(size_t blue = 0; blue < decks().size(); ++blue) {
+         for(size_t red = 0; red < decks().size(); ++red) {
+            for(auto kind_blue : kinds) {
+               for(auto kind_red : kinds) {
+                  for(auto seed : seeds()) {
+                     out.emplace_back(Scenario{blue, red, kind_blue, kind_red, seed});
+                  }
+               }
+            }
+         }
+      }
+      return out;
+   }();
+   return all;
+}
+
+Deck build_deck(const DeckSpec& spec, Team team)
+{
+   Deck::ContainerType deck_cards;
+   for(const auto& [code, copies] : spec.cards) {
+      auto card = std::find_if(cards().begin(), cards().end(), [code = code](const CardSpec& c) {
+         return std::string_view(c.code) == code;
+      });
+      if(card == cards().end()) {
+         throw std::invalid_argument(
+            std::string("Deck '") + spec.name + "' lists unknown card " + code + ".");
+      }
+      KeywordMap keywords{};
+      for(auto keyword : card->keywords) {
+         keywords[static_cast< size_t >(keyword)] = true;
+      }
+      for(size_t i = 0; i < copies; ++i) {
+         deck_cards.emplace_back(std::make_shared< BenchUnit >(
+            team, card->code, card->power, card->health, card->cost, keywords));
+      }
+   }
+   return Deck(deck_cards);
+}
+
+const char* controller_name(ControllerKind kind)
+{
+   return kind == ControllerKind::RANDOM ? "random" : "scripted";
+}
+
+}  // namespace bench::corpus
@@ -0,0 +1,63 @@
+
+#ifndef LORAINE_BENCH_SCENARIO_CORPUS_H
+#define LORAINE_BENCH_SCENARIO_CORPUS_H
+
+#include <vector>
+
+#include "all.h"
+
+namespace bench::corpus {
+
+/**
+ * The version of the corpus below. Any change to the cards, decklists, seeds or scenario order
+ * changes the games played and thus requires bumping the version, so that throughput numbers are
+ * only ever compared between runs of the same corpus.
+ */
+constexpr u32 version = 1;
+
+/**
+ * A vanilla unit of the corpus' card pool.
+ */
+struct CardSpec {
+   const char* code;
+   const char* name;
+   size_t cost;
+   size_t power;
+   size_t health;
+   std::vector< Keyword > keywords;
+};
+
+struct DeckSpec {
+   const char* name;
+   // pairs of card code and number of copies
+   std::vector< std::pair< const char*, size_t > > cards;
+};
+
+enum class ControllerKind { RANDOM, SCRIPTED };
+
+struct Scenario {
+   size_t deck_blue;
+   size_t deck_red;
+   ControllerKind controller_blue;
+   ControllerKind controller_red;
+   u64 seed;
+};
+
+const std::vector< CardSpec >& cards();
+const std::vector< DeckSpec >& decks();
+const std::vector< u64 >& seeds();
+/**
+ * Every ordered pair of decks, played by every pairing of controllers, with every seed.
+ */
+const std::vector< Scenario >& scenarios();
+
+/**
+ * Builds the (unshuffled) deck of the team from the spec.
+ */
+Deck build_deck(const DeckSpec& spec, Team team);
+
+const char* controller_name(ControllerKind kind);
+
+}  // namespace bench::corpus
+
+#endif  // LORAINE_BENCH_SCENARIO_CORPUS_H
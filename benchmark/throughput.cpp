@@ -0,0 +1,280 @@
+
+/**
+ * End-to-end throughput benchmark: plays the fixed-seed games of the scenario corpus at 1, 2, 4,
+ * ... N threads and reports games, decisions and events per second, heap allocations per game and
+ * the peak resident set size as JSON.
+ *
+ * Usage: loraine_throughput [--games N] [--max-threads N] [--output FILE]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+
+#include "alloc_counter.h"
+#include "scenario_corpus.h"
+#include "scripted_controllers.h"
+
+namespace {
+
+/**
+ * Counts every event fired in a state by subscribing one counter to each of its event buses.
+ */
+template < typename Event >
+struct EventCounter: public IEventSubscriber< Event > {
+   u64* count = nullptr;
+
+   void on_event(GameState& /*state*/, typename Event::EventData&& /*data*/) override
+   {
+      *count += 1;
+   }
+};
+
+template < typename EventVariant >
+struct EventCounters;
+
+template < typename... Events >
+struct EventCounters< std::variant< Events... > > {
+   std::tuple< EventCounter< Events >... > counters;
+   u64 count = 0;
+
+   EventCounters() = default;
+   EventCounters(const EventCounters&) = delete;
+   EventCounters& operator=(const EventCounters&) = delete;
+
+   void attach(GameState& state)
+   {
+      (_attach< Events >(state), ...);
+   }
+
+  private:
+   template < typename Event >
+   void _attach(GameState& state)
+   {
+      auto& counter = std::get< EventCounter< Event > >(counters);
+      counter.count = &count;
+      state.event(Event::label()).template detail< Event >().subscribe(&counter);
+   }
+};
+
+using StateEventCounters = EventCounters< events::LOREvent::EventVariant >;
+
+struct RunStats {
+   u64 games = 0;
+   u64 decisions = 0;
+   u64 events = 0;
+   u64 allocations = 0;
+   SymArr< u64 > wins{0, 0};
+   u64 ties = 0;
+
+   void merge(const RunStats& other)
+   {
+      games += other.games;
+      decisions += other.decisions;
+      events += other.events;
+      allocations += other.allocations;
+      wins[BLUE] += other.wins[BLUE];
+      wins[RED] += other.wins[RED];
+      ties += other.ties;
+   }
+};
+
+sptr< controllers::CountingController > make_controller(
+   bench::corpus::ControllerKind kind,
+   Team team,
+   u64 seed)
+{
+   if(kind == bench::corpus::ControllerKind::RANDOM) {
+      return std::make_shared< controllers::RandomController >(team, seed + team);
+   }
+   return std::make_shared< controllers::ScriptedController >(team);
+}
+
+void play_game(const bench::corpus::Scenario& scenario, RunStats& stats)
+{
+   u64 allocs_before = bench::allocations();
+   const auto& decks = bench::corpus::decks();
+   SymArr< sptr< controllers::CountingController > > controllers{
+      make_controller(scenario.controller_blue, BLUE, scenario.seed),
+      make_controller(scenario.controller_red, RED, scenario.seed)};
+   GameState state(
+      Config(),
+      {bench::corpus::build_deck(decks[scenario.deck_blue], BLUE),
+       bench::corpus::build_deck(decks[scenario.deck_red], RED)},
+      {controllers[BLUE], controllers[RED]},
+      random::create_rng(scenario.seed));
+   StateEventCounters event_counters;
+   event_counters.attach(state);
+
+   state.logic()->start_game();
+   auto status = state.logic()->check_status();
+   while(status == Status::ONGOING) {
+      status = state.logic()->step();
+   }
+
+   stats.games += 1;
+   stats.decisions += controllers[BLUE]->decisions() + controllers[RED]->decisions();
+   stats.events += event_counters.count;
+   if(status == Status::BLUE_WINS_NEXUS || status == Status::BLUE_WINS_DRAW) {
+      stats.wins[BLUE] += 1;
+   } else if(status == Status::RED_WINS_NEXUS || status == Status::RED_WINS_DRAW) {
+      stats.wins[RED] += 1;
+   } else {
+      stats.ties += 1;
+   }
+   stats.allocations += bench::allocations() - allocs_before;
+}
+
+/**
+ * The peak resident set size of the process in KiB (0 if unavailable).
+ */
+u64 peak_rss_kib()
+{
+   std::ifstream status("/proc/self/status");
+   std::string line;
+   while(std::getline(status, line)) {
+      if(line.rfind("VmHWM:", 0) == 0) {
+         return std::stoull(line.substr(6));
+      }
+   }
+   return 0;
+}
+
+/**
+ * Resets the peak resident set size to the current one, so that every run reports its own peak.
+ */
+void reset_peak_rss()
+{
+   std::ofstream clear_refs("/proc/self/clear_refs");
+   clear_refs << "5";
+}
+
+struct RunResult {
+   size_t threads;
+   double seconds;
+   RunStats stats;
+   u64 peak_rss_kib;
+};
+
+RunResult run(size_t n_threads, u64 n_games)
+{
+   const auto& scenarios = bench::corpus::scenarios();
+   std::atomic< u64 > next_game = 0;
+   std::vector< RunStats > thread_stats(n_threads);
+   std::vector< std::exception_ptr > errors(n_threads);
+   reset_peak_rss();
+
+   auto start = std::chrono::steady_clock::now();
+   std::vector< std::thread > workers;
+   workers.reserve(n_threads);
+   for(size_t t = 0; t < n_threads; ++t) {
+      workers.emplace_back([&, t] {
+         // the allocations are counted per thread, and only where tracking is enabled
+         profiling::AllocationTracker::enable();
+         try {
+            for(u64 game = next_game++; game < n_games; game = next_game++) {
+               play_game(scenarios[game % scenarios.size()], thread_stats[t]);
+            }
+         } catch(...) {
+            errors[t] = std::current_exception();
+         }
+      });
+   }
+   for(auto& worker : workers) {
+      worker.join();
+   }
+   auto seconds =
+      std::chrono::duration< double >(std::chrono::steady_clock::now() - start).count();
+   for(auto& error : errors) {
+      if(error) {
+         std::rethrow_exception(error);
+      }
+   }
+   RunResult result{n_threads, seconds, {}, peak_rss_kib()};
+   for(const auto& stats : thread_stats) {
+      result.stats.merge(stats);
+   }
+   return result;
+}
+
+void write_json(std::ostream& os, u64 n_games, const std::vector< RunResult >& results)
+{
+   os << std::fixed << std::setprecision(3);
+   os << "{\n  \"benchmark\": \"loraine_throughput\",\n";
+   os << "  \"corpus_version\": " << bench::corpus::version << ",\n";
+   os << "  \"decks\": [";
+   const auto& decks = bench::corpus::decks();
+   for(size_t i = 0; i < decks.size(); ++i) {
+      os << (i > 0 ? ", " : "") << "\"" << decks[i].name << "\"";
+   }
+   os << "],\n  \"seeds\": [";
+   const auto& seeds = bench::corpus::seeds();
+   for(size_t i = 0; i < seeds.size(); ++i) {
+      os << (i > 0 ? ", " : "") << seeds[i];
+   }
+   os << "],\n  \"scenarios\": " << bench::corpus::scenarios().size() << ",\n";
+   os << "  \"games_per_run\": " << n_games << ",\n";
+   os << "  \"runs\": [";
+   for(size_t i = 0; i < results.size(); ++i) {
+      const auto& [threads, seconds, stats, peak_rss] = results[i];
+      os << (i > 0 ? "," : "") << "\n    {\"threads\": " << threads
+         << ", \"seconds\": " << seconds << ", \"games\": " << stats.games
+         << ", \"games_per_sec\": " << double(stats.games) / seconds
+         << ", \"decisions_per_sec\": " << double(stats.decisions) / seconds
+         << ", \"events_per_sec\": " << double(stats.events) / seconds
+         << ", \"allocs_per_game\": " << double(stats.allocations) / double(stats.games)
+         << ", \"peak_rss_kib\": " << peak_rss << ", \"outcomes\": {\"blue\": " << stats.wins[BLUE]
+         << ", \"red\": " << stats.wins[RED] << ", \"tie\": " << stats.ties << "}}";
+   }
+   os << "\n  ]\n}\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+   u64 n_games = 2 * bench::corpus::scenarios().size();
+   size_t max_threads = std::max(1U, std::thread::hardware_concurrency());
+   std::string output;
+   for(int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      if(i + 1 < argc && arg == "--games") {
+         n_games = std::stoull(argv[++i]);
+      } else if(i + 1 < argc && arg == "--max-threads") {
+         max_threads = std::stoul(argv[++i]);
+      } else if(i + 1 < argc && arg == "--output") {
+         output = argv[++i];
+      } else {
+         std::cerr << "Usage: " << argv[0]
+                   << " [--games N] [--max-threads N] [--output FILE]\n";
+         return 1;
+      }
+   }
+
+   std::vector< size_t > thread_counts;
+   for(size_t n = 1; n < max_threads; n *= 2) {
+      thread_counts.emplace_back(n);
+   }
+   thread_counts.emplace_back(max_threads);
+
+   std::vector< RunResult > results;
+   for(auto n_threads : thread_counts) {
+      results.emplace_back(run(n_threads, n_games));
+      std::cerr << n_threads << " thread(s): " << results.back().stats.games << " games in "
+                << results.back().seconds << "s\n";
+   }
+   if(output.empty()) {
+      write_json(std::cout, n_games, results);
+   } else {
+      std::ofstream file(output);
+      write_json(file, n_games, results);
+   }
+   return 0;
+}
@@ -0,0 +1,92 @@
+
+#include "scripted_controllers.h"
+
+#include <stdexcept>
+
+namespace controllers {
+
+actions::Action CountingController::choose_action(const GameState& state)
+{
+   m_decisions += 1;
+   auto valid = state.logic()->action_invoker().valid_actions(state);
+   if(valid.empty()) {
+      throw std::logic_error("No valid action offered to the scripted controller.");
+   }
+   return choose(state, valid);
+}
+
+actions::Action CountingController::choose_targets(
+   const GameState& /*state*/,
+   const sptr< EffectBase >& /*effect*/)
+{
+   throw std::logic_error("The scripted controllers play no cards requiring targets.");
+}
+
+actions::Action RandomController::choose(
+   const GameState& /*state*/,
+   std::vector< actions::Action >& valid)
+{
+   std::uniform_int_distribution< size_t > dist(0, valid.size() - 1);
+   return std::move(valid[dist(m_rng)]);
+}
+
+actions::Action ScriptedController::choose(
+   const GameState& state,
+   std::vector< actions::Action >& valid)
+{
+   Team team = state.active_team();
+   std::optional< size_t > accept;
+   std::optional< size_t > best_play;
+   std::optional< size_t > widest_placement;
+   const auto& hand = state.player(team).hand();
+   for(size_t i = 0; i < valid.size(); ++i) {
+      const auto& action = valid[i];
+      if(action.is_accept()) {
+         accept = i;
+      } else if(action.is_play_request()) {
+         auto cost = hand[action.detail< actions::PlayRequestAction >().index()]->mana_cost();
+         if(not best_play.has_value()
+            || cost > hand[valid[*best_play].detail< actions::PlayRequestAction >().index()]
+                         ->mana_cost()) {
+            best_play = i;
+         }
+      } else if(action.is_placing_unit()) {
+         auto n_units = action.detail< actions::PlaceUnitAction >().indices_vec().size();
+         if(not widest_placement.has_value()
+            || n_units > valid[*widest_placement]
+                            .detail< actions::PlaceUnitAction >()
+                            .indices_vec()
+                            .size()) {
+            widest_placement = i;
+         }
+      }
+   }
+
+   if(state.logic()->in_combat()) {
+      // defending: block once the attack threatens a third of the nexus' health
+      long incoming = 0;
+      for(const auto& unit : state.board().battlefield(opponent(team))) {
+         if(utils::has_value(unit)) {
+            incoming += unit->power();
+         }
+      }
+      if(widest_placement.has_value()
+         && 3 * incoming >= state.player(team).nexus().health()) {
+         return std::move(valid[*widest_placement]);
+      }
+   } else {
+      if(best_play.has_value()) {
+         return std::move(valid[*best_play]);
+      }
+      if(widest_placement.has_value()) {
+         auto n_attackers =
+            valid[*widest_placement].detail< actions::PlaceUnitAction >().indices_vec().size();
+         if(n_attackers >= state.board().camp(opponent(team)).size()) {
+            return std::move(valid[*widest_placement]);
+         }
+      }
+   }
+   return std::move(valid[accept.value_or(0)]);
+}
+
+}  // namespace controllers
@@ -0,0 +1,59 @@
+
+#ifndef LORAINE_SCRIPTED_CONTROLLERS_H
+#define LORAINE_SCRIPTED_CONTROLLERS_H
+
+#include "all.h"
+
+namespace controllers {
+
+/**
+ * Base for the scripted controllers playing the benchmark and tool games (e.g. of deckopt), which
+ * choose among the current invoker's valid actions and count their decisions.
+ */
+class CountingController: public Controller {
+  public:
+   using Controller::Controller;
+
+   actions::Action choose_action(const GameState& state) override;
+   actions::Action choose_targets(const GameState& state, const sptr< EffectBase >& effect) override;
+
+   [[nodiscard]] auto decisions() const { return m_decisions; }
+
+  protected:
+   virtual actions::Action choose(const GameState& state, std::vector< actions::Action >& valid) = 0;
+
+  private:
+   u64 m_decisions = 0;
+};
+
+/**
+ * Picks uniformly at random among the valid actions.
+ */
+class RandomController: public CountingController {
+  public:
+   RandomController(Team team, u64 seed) : CountingController(team), m_rng(random::create_rng(seed))
+   {
+   }
+
+  protected:
+   actions::Action choose(const GameState& state, std::vector< actions::Action >& valid) override;
+
+  private:
+   random::rng_type m_rng;
+};
+
+/**
+ * A deterministic greedy player: plays the most expensive affordable card, attacks with all units
+ * unless outnumbered and blocks with all units when the attack threatens a third of its nexus.
+ */
+class ScriptedController: public CountingController {
+  public:
+   using CountingController::CountingController;
+
+  protected:
+   actions::Action choose(const GameState& state, std::vector< actions::Action >& valid) override;
+};
+
+}  // namespace controllers
+
+#endif  // LORAINE_SCRIPTED_CONTROLLERS_H
@@ -43,8 +43,7 @@ bool actions::PlaceSpellAction::execute_impl(GameState& state)
          hand.erase(std::find(hand.begin(), hand.end(), spell));
          // a burst or focus spell is played immediately if no targeting is required
          if(spell->has_any_keyword({Keyword::BURST, Keyword::FOCUS})) {
-            state.buffer().action.emplace_back(
-               std::make_shared< Action >(PlaySpellFinishAction(team(), true)));
+            state.buffer().action.emplace_back(PlaySpellFinishAction(team(), true));
          }
       }
    } else {
@@ -138,15 +137,15 @@ bool actions::CancelAction::execute_impl(GameState& state)
    // implementation error
    auto& p_buffer = state.buffer().play;
    auto& s_buffer = state.buffer().spell;
-   if(not s_buffer.empty() && utils::has_value(*p_buffer)) {
+   if(not s_buffer.empty() && p_buffer.has_value()) {
       throw std::logic_error(
          "Both buffers for spells and fieldcards hold values. This should not occur.");
    }
 
-   if(utils::has_value(*p_buffer)) {
+   if(p_buffer.has_value()) {
       // the player cancelled playing this field spell so undo all targeting for its effects
       reset_targets(p_buffer.value()->effects(events::EventLabel::PLAY));
-      p_buffer->reset();
+      p_buffer.reset();
    } else if(not s_buffer.empty()) {
       // a spell to play with targeting was cancelled so cancel its targets
       reset_targets(s_buffer.back()->effects(events::EventLabel::CAST));
@@ -168,13 +167,11 @@ bool actions::TargetingAction::execute_impl(GameState& state)
          // if the effect to target is the last one in the t_buffer, and the effects belong
          // to a BURST or FOCUS spell, then a placing with subsequent targeting also triggers
          // playing it
-         state.buffer().action.emplace_back(
-            std::make_shared< Action >(PlaySpellFinishAction(team(), true)));
+         state.buffer().action.emplace_back(PlaySpellFinishAction(team(), true));
       } else if(assoc_card->is_fieldcard()) {
-         if(not state.buffer().action.back()->is_play_finish()) {
+         if(not state.buffer().action.back().is_play_finish()) {
             // if no replace action has occured before, then we have to place a PlayFinishAction
-            state.buffer().action.emplace_back(std::make_shared< Action >(
-               PlayFieldCardFinishAction(team(), state.board().camp(team()).size())));
+            state.buffer().action.emplace_back(PlayFieldCardFinishAction(team()));
          }
       }
    }
@@ -238,8 +235,8 @@ bool actions::PlayRequestAction::execute_impl(GameState& state)
       state.logic()->transition< ReplacingModeInvoker >();
       return false;
    }
-   state.buffer().action.emplace_back(
-      std::make_shared< Action >(PlayFieldCardFinishAction(team(), camp.size())));
+   // the camp has space, so the card is simply appended (no camp index to replace)
+   state.buffer().action.emplace_back(PlayFieldCardFinishAction(team()));
 
    if(field_card->has_effect(events::EventLabel::PLAY)) {
       for(const auto& effect : field_card->effects(events::EventLabel::PLAY)) {
@@ -283,8 +280,10 @@ bool actions::PlaySpellFinishAction::execute_impl(GameState& state)
 bool actions::PlayFieldCardFinishAction::execute_impl(GameState& state)
 {
    auto field_card = state.buffer().play.value();
-   state.buffer().play->reset();
+   state.buffer().play.reset();
    state.player(team()).flags().has_played = true;
+   auto& hand = state.player(team()).hand();
+   hand.erase(std::find(hand.begin(), hand.end(), field_card));
 
    field_card->uncover();
    state.logic()->spend_mana(field_card);
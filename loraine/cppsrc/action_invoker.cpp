@@ -1,8 +1,10 @@
 
 #include "core/action_invoker.h"
 
+#include "cards/card.h"
 #include "core/logic.h"
 #include "effects/effect.h"
+#include "utils/alloc_tracker.h"
 
 // namespace actions {
 //
@@ -143,7 +145,10 @@ actions::Action ActionInvokerBase::request_action(const GameState& state) const
 {
    int n_invalid_choices = 0;
    while(true) {
-      auto action = state.player(state.active_team()).controller()->choose_action(state);
+      auto action = [&] {
+         LORAINE_ALLOC_PHASE("Controller::choose_action");
+         return state.player(state.active_team()).controller()->choose_action(state);
+      }();
 
       if(is_valid(action)) {
          return action;
@@ -189,21 +194,175 @@ std::vector< actions::Action > TargetModeInvoker::valid_actions(const GameState&
 {
    return std::vector< actions::Action >();
 }
+namespace {
+
+/**
+ * The camp indices of all units (i.e. no landmarks) of the team.
+ */
+std::vector< size_t > camp_unit_indices(const GameState& state, Team team)
+{
+   const auto& camp = state.board().camp(team);
+   std::vector< size_t > indices;
+   indices.reserve(camp.size());
+   for(size_t i = 0; i < camp.size(); ++i) {
+      if(camp[i]->is_unit()) {
+         indices.emplace_back(i);
+      }
+   }
+   return indices;
+}
+
+/**
+ * Checks that the camp indices are distinct, refer to units and are at most `max_count` many.
+ */
+bool are_valid_unit_indices(
+   const GameState& state,
+   Team team,
+   const std::vector< size_t >& indices,
+   size_t max_count)
+{
+   const auto& camp = state.board().camp(team);
+   if(indices.empty() || indices.size() > max_count) {
+      return false;
+   }
+   for(size_t i = 0; i < indices.size(); ++i) {
+      if(indices[i] >= camp.size() || not camp[indices[i]]->is_unit()) {
+         return false;
+      }
+      if(std::find(std::next(indices.begin(), i + 1), indices.end(), indices[i]) != indices.end()) {
+         return false;
+      }
+   }
+   return true;
+}
+
+/**
+ * Appends the unit placements offered to the controllers: every single unit and every prefix of
+ * the camp's units, up to `max_count` units. This is a representative rather than complete
+ * selection, since the number of unit subsets grows exponentially with the camp size.
+ */
+void append_unit_placements(
+   std::vector< actions::Action >& actions,
+   Team team,
+   const std::vector< size_t >& unit_indices,
+   size_t max_count)
+{
+   if(max_count == 0) {
+      return;
+   }
+   for(auto idx : unit_indices) {
+      actions.emplace_back(actions::PlaceUnitAction(team, true, {idx}));
+   }
+   for(size_t n = 2; n <= std::min(unit_indices.size(), max_count); ++n) {
+      actions.emplace_back(actions::PlaceUnitAction(
+         team, true, std::vector< size_t >(unit_indices.begin(), unit_indices.begin() + n)));
+   }
+}
+
+/**
+ * Whether the hand card can be played right away. Spells (which require targeting) and playing
+ * into a full camp (which requires replacing) are not supported yet.
+ */
+bool is_playable(const GameState& state, Team team, size_t hand_index)
+{
+   const auto& hand = state.player(team).hand();
+   if(hand_index >= hand.size()) {
+      return false;
+   }
+   const auto& card = hand[hand_index];
+   return card->is_fieldcard()
+          && state.board().camp(team).size() < state.board().max_size_camp()
+          && static_cast< size_t >(card->mana_cost()) <= state.player(team).mana().common;
+}
+
+}  // namespace
+
 bool DefaultModeInvoker::is_valid(const actions::Action& action) const
 {
-   return false;
+   if(not accepts(action.label())) {
+      return false;
+   }
+   const auto& state = *logic()->state();
+   Team team = action.team();
+   bool units_placed = not state.buffer().bf.empty();
+   switch(action.label()) {
+      case actions::ActionLabel::ACCEPT: {
+         return true;
+      }
+      case actions::ActionLabel::PLAY_REQUEST: {
+         return not units_placed
+                && is_playable(state, team, action.detail< actions::PlayRequestAction >().index());
+      }
+      case actions::ActionLabel::PLACE_UNIT: {
+         const auto& placement = action.detail< actions::PlaceUnitAction >();
+         return not units_placed && placement.to_bf() && state.player(team).flags().attack_token
+                && are_valid_unit_indices(
+                   state, team, placement.indices_vec(), state.board().max_size_bf());
+      }
+      default: {
+         return false;
+      }
+   }
 }
-std::vector< actions::Action > DefaultModeInvoker::valid_actions(const GameState& action) const
+std::vector< actions::Action > DefaultModeInvoker::valid_actions(const GameState& state) const
 {
-   return std::vector< actions::Action >();
+   Team team = state.active_team();
+   std::vector< actions::Action > actions{actions::Action(actions::AcceptAction(team))};
+   if(not state.buffer().bf.empty()) {
+      // units have been moved to the battlefield, so the attack can only be declared now
+      return actions;
+   }
+   for(size_t i = 0; i < state.player(team).hand().size(); ++i) {
+      if(is_playable(state, team, i)) {
+         actions.emplace_back(actions::PlayRequestAction(team, i));
+      }
+   }
+   if(state.player(team).flags().attack_token) {
+      append_unit_placements(
+         actions, team, camp_unit_indices(state, team), state.board().max_size_bf());
+   }
+   return actions;
 }
 bool CombatModeInvoker::is_valid(const actions::Action& action) const
 {
-   return false;
+   if(not accepts(action.label())) {
+      return false;
+   }
+   const auto& state = *logic()->state();
+   Team team = action.team();
+   switch(action.label()) {
+      case actions::ActionLabel::ACCEPT: {
+         return true;
+      }
+      case actions::ActionLabel::PLACE_UNIT: {
+         // only the defender may move units, once, to block the attackers
+         const auto& placement = action.detail< actions::PlaceUnitAction >();
+         return state.attacker() != team && placement.to_bf()
+                && state.board().battlefield(team).empty() && state.buffer().bf.empty()
+                && are_valid_unit_indices(
+                   state,
+                   team,
+                   placement.indices_vec(),
+                   state.board().battlefield(opponent(team)).size());
+      }
+      default: {
+         return false;
+      }
+   }
 }
-std::vector< actions::Action > CombatModeInvoker::valid_actions(const GameState& action) const
+std::vector< actions::Action > CombatModeInvoker::valid_actions(const GameState& state) const
 {
-   return std::vector< actions::Action >();
+   Team team = state.active_team();
+   std::vector< actions::Action > actions{actions::Action(actions::AcceptAction(team))};
+   if(state.attacker() != team && state.board().battlefield(team).empty()
+      && state.buffer().bf.empty()) {
+      append_unit_placements(
+         actions,
+         team,
+         camp_unit_indices(state, team),
+         state.board().battlefield(opponent(team)).size());
+   }
+   return actions;
 }
 actions::Action ReplacingModeInvoker::request_action(const GameState& state) const
 {
@@ -0,0 +1,155 @@
+/**
+ * Replacement of the global allocation functions, reporting every allocation to the
+ * AllocationTracker. This file is not part of the loraine library, but of the opt-in
+ * `loraine_alloc_hook` object library, since an executable can only replace them once.
+ */
+
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+   #include <malloc.h>
+#endif
+
+#include "utils/alloc_tracker.h"
+
+namespace {
+
+void* tracked_malloc(std::size_t size) noexcept
+{
+   profiling::AllocationTracker::record(size);
+   return std::malloc(size == 0 ? 1 : size);
+}
+
+void* tracked_aligned_malloc(std::size_t size, std::align_val_t alignment) noexcept
+{
+   profiling::AllocationTracker::record(size);
+   auto align = static_cast< std::size_t >(alignment);
+#ifdef _WIN32
+   return _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+   // aligned_alloc requires the size to be a multiple of the alignment
+   return std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+}
+
+void aligned_free(void* ptr) noexcept
+{
+#ifdef _WIN32
+   _aligned_free(ptr);
+#else
+   std::free(ptr);
+#endif
+}
+
+const bool hook_announced = [] {
+   profiling::AllocationTracker::mark_hooked();
+   return true;
+}();
+
+}  // namespace
+
+void* operator new(std::size_t size)
+{
+   if(void* ptr = tracked_malloc(size)) {
+      return ptr;
+   }
+   throw std::bad_alloc();
+}
+void* operator new[](std::size_t size)
+{
+   if(void* ptr = tracked_malloc(size)) {
+      return ptr;
+   }
+   throw std::bad_alloc();
+}
+void* operator new(std::size_t size, const std::nothrow_t& /*tag*/) noexcept
+{
+   return tracked_malloc(size);
+}
+void* operator new[](std::size_t size, const std::nothrow_t& /*tag*/) noexcept
+{
+   return tracked_malloc(size);
+}
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+   if(void* ptr = tracked_aligned_malloc(size, alignment)) {
+      return ptr;
+   }
+   throw std::bad_alloc();
+}
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+   if(void* ptr = tracked_aligned_malloc(size, alignment)) {
+      return ptr;
+   }
+   throw std::bad_alloc();
+}
+void* operator new(
+   std::size_t size,
+   std::align_val_t alignment,
+   const std::nothrow_t& /*tag*/) noexcept
+{
+   return tracked_aligned_malloc(size, alignment);
+}
+void* operator new[](
+   std::size_t size,
+   std::align_val_t alignment,
+   const std::nothrow_t& /*tag*/) noexcept
+{
+   return tracked_aligned_malloc(size, alignment);
+}
+void operator delete(void* ptr) noexcept
+{
+   std::free(ptr);
+}
+void operator delete[](void* ptr) noexcept
+{
+   std::free(ptr);
+}
+void operator delete(void* ptr, std::size_t /*size*/) noexcept
+{
+   std::free(ptr);
+}
+void operator delete[](void* ptr, std::size_t /*size*/) noexcept
+{
+   std::free(ptr);
+}
+void operator delete(void* ptr, const std::nothrow_t& /*tag*/) noexcept
+{
+   std::free(ptr);
+}
+void operator delete[](void* ptr, const std::nothrow_t& /*tag*/) noexcept
+{
+   std::free(ptr);
+}
+void operator delete(void* ptr, std::align_val_t /*alignment*/) noexcept
+{
+   aligned_free(ptr);
+}
+void operator delete[](void* ptr, std::align_val_t /*alignment*/) noexcept
+{
+   aligned_free(ptr);
+}
+void operator delete(void* ptr, std::size_t /*size*/, std::align_val_t /*alignment*/) noexcept
+{
+   aligned_free(ptr);
+}
+void operator delete[](void* ptr, std::size_t /*size*/, std::align_val_t /*alignment*/) noexcept
+{
+   aligned_free(ptr);
+}
+void operator delete(
+   void* ptr,
+   std::align_val_t /*alignment*/,
+   const std::nothrow_t& /*tag*/) noexcept
+{
+   aligned_free(ptr);
+}
+void operator delete[](
+   void* ptr,
+   std::align_val_t /*alignment*/,
+   const std::nothrow_t& /*tag*/) noexcept
+{
+   aligned_free(ptr);
+}
@@ -0,0 +1,46 @@
+#include "utils/alloc_tracker.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+namespace profiling {
+
+std::vector< PhaseAllocations > AllocationTracker::phases()
+{
+   auto& data = local();
+   // building the report must not show up in it
+   bool was_enabled = std::exchange(data.enabled, false);
+   std::vector< PhaseAllocations > rows(data.phases.begin(), data.phases.begin() + data.n_phases);
+   std::sort(rows.begin(), rows.end(), [](const PhaseAllocations& r1, const PhaseAllocations& r2) {
+      return r1.stats.count > r2.stats.count;
+   });
+   data.enabled = was_enabled;
+   return rows;
+}
+
+void AllocationTracker::write_report(std::ostream& os)
+{
+   auto rows = phases();
+   bool was_enabled = std::exchange(local().enabled, false);
+   os << std::left << std::setw(48) << "phase" << std::right << std::setw(12) << "allocs"
+      << std::setw(14) << "bytes"
+      << "\n";
+   for(const auto& [phase, stats] : rows) {
+      os << std::left << std::setw(48) << (phase == nullptr ? "<none>" : phase) << std::right
+         << std::setw(12) << stats.count << std::setw(14) << stats.bytes << "\n";
+   }
+   os << std::left << std::setw(48) << "total" << std::right << std::setw(12)
+      << local().total.count << std::setw(14) << local().total.bytes << "\n";
+   local().enabled = was_enabled;
+}
+
+void AllocationTracker::reset()
+{
+   auto& data = local();
+   data.total = {};
+   data.phases.fill({});
+   data.n_phases = 0;
+}
+
+}  // namespace profiling
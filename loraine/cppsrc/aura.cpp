@@ -0,0 +1,134 @@
+
+
+#include "effects/aura.h"
+
+#include <algorithm>
+
+#include "core/board.h"
+
+void AuraTracker::add_source(const sptr< Card >& source, AuraSpec spec, const Board& board)
+{
+   const auto& added = m_sources.emplace_back(Source{source, spec});
+   for(Team team : {Team::BLUE, Team::RED}) {
+      for(const auto& card : board.camp(team)) {
+         if(card->is_unit()) {
+            _contribute(added, to_unit(card));
+         }
+      }
+      for(const auto& unit : board.battlefield(team)) {
+         if(utils::has_value(unit)) {
+            _contribute(added, unit);
+         }
+      }
+   }
+}
+
+std::vector< sptr< Unit > > AuraTracker::remove_source(const sptr< Card >& source)
+{
+   std::vector< sptr< Unit > > weakened;
+   auto is_source = [&](const auto& elem) { return elem.card == source; };
+   auto sources_end = std::remove_if(m_sources.begin(), m_sources.end(), is_source);
+   if(sources_end == m_sources.end()) {
+      return weakened;
+   }
+   m_sources.erase(sources_end, m_sources.end());
+   _remove_contributions(
+      [&](const Contribution& contribution) { return contribution.source == source; }, weakened);
+   return weakened;
+}
+
+void AuraTracker::enter(const sptr< Unit >& unit)
+{
+   for(const auto& source : m_sources) {
+      _contribute(source, unit);
+   }
+}
+
+std::vector< sptr< Unit > > AuraTracker::leave(const sptr< Card >& card)
+{
+   if(m_sources.empty()) {
+      return {};
+   }
+   auto weakened = remove_source(card);
+   // a unit off the board (e.g. recalled to the hand) keeps none of the auras' deltas, but whether
+   // it has health left no longer matters
+   std::vector< sptr< Unit > > left;
+   _remove_contributions(
+      [&](const Contribution& contribution) { return contribution.target == card; }, left);
+   weakened.erase(std::remove(weakened.begin(), weakened.end(), card), weakened.end());
+   return weakened;
+}
+
+void AuraTracker::clear()
+{
+   m_sources.clear();
+   m_contributions.clear();
+}
+
+bool AuraTracker::_covers(const Source& source, const Unit& unit)
+{
+   const auto& spec = source.spec;
+   if(&unit == source.card.get() && not spec.includes_source) {
+      return false;
+   }
+   bool allied = unit.mutables().owner == source.card->mutables().owner;
+   switch(spec.scope) {
+      case AuraSpec::Scope::ALLIES:
+         if(not allied) {
+            return false;
+         }
+         break;
+      case AuraSpec::Scope::ENEMIES:
+         if(allied) {
+            return false;
+         }
+         break;
+      case AuraSpec::Scope::ALL:
+         break;
+   }
+   return not spec.filter || spec.filter(*source.card, unit);
+}
+
+void AuraTracker::_contribute(const Source& source, const sptr< Unit >& unit)
+{
+   if(not _covers(source, *unit)) {
+      return;
+   }
+   const auto& spec = source.spec;
+   bool owns_keyword = spec.keyword.has_value() && not unit->has_keyword(*spec.keyword);
+   if(owns_keyword) {
+      unit->add_keyword(*spec.keyword);
+   }
+   if(spec.power != 0) {
+      unit->add_power(spec.power, false);
+   }
+   if(spec.health != 0) {
+      unit->add_health(spec.health, false);
+   }
+   m_contributions.emplace_back(
+      Contribution{source.card, unit, spec.power, spec.health, spec.keyword, owns_keyword});
+}
+
+void AuraTracker::_undo(
+   const Contribution& contribution,
+   std::vector< Contribution >::iterator kept_end)
+{
+   const auto& unit = contribution.target;
+   if(contribution.power != 0) {
+      unit->add_power(-contribution.power, false);
+   }
+   if(contribution.health != 0) {
+      unit->add_health(-contribution.health, false);
+   }
+   if(contribution.owns_keyword) {
+      // another aura granting the same keyword to the unit takes over the keyword
+      auto other = std::find_if(m_contributions.begin(), kept_end, [&](const Contribution& other) {
+         return other.target == unit && other.keyword == contribution.keyword;
+      });
+      if(other != kept_end) {
+         other->owns_keyword = true;
+      } else {
+         unit->remove_keyword(*contribution.keyword);
+      }
+   }
+}
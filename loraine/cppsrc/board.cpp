@@ -8,7 +8,7 @@
 size_t Board::count_units(
    Team team,
    bool in_camp,
-   const std::function< bool(const sptr< FieldCard >&) >& filter) const
+   const UnitFilter& filter) const
 {
    size_t sum = 0;
    if(in_camp) {
@@ -46,6 +46,21 @@ std::vector< sptr< Unit > > Board::camp_units(Team team) const
    }
    return units;
 }
+Board::UnitsType Board::units(Team team) const
+{
+   UnitsType units;
+   for(const auto& card : m_camp[team]) {
+      if(card->is_unit()) {
+         units.emplace_back(to_unit(card));
+      }
+   }
+   for(const auto& unit : m_bf[team]) {
+      if(utils::has_value(unit)) {
+         units.emplace_back(unit);
+      }
+   }
+   return units;
+}
 void Board::add_to_camp_queue(const sptr< FieldCard >& card)
 {
    m_camp_queue[card->mutables().owner].emplace(card);
@@ -79,4 +94,12 @@ void Board::add_to_camp(const sptr< Unit >& card)
 {
    m_camp[card->mutables().owner].emplace_back(card);
 }
-
+void Board::clear()
+{
+   for(Team team : {Team::BLUE, Team::RED}) {
+      m_bf[team].clear();
+      m_camp[team].clear();
+      m_camp_queue[team].clear();
+      m_bf_queue[team].clear();
+   }
+}
@@ -0,0 +1,81 @@
+#include "cards/card_pool.h"
+
+#include <algorithm>
+
+CardPool::CardPool(const CardCatalog& catalog)
+    : m_catalog(&catalog),
+      m_all(catalog.size(), true),
+      m_none(catalog.size()),
+      m_collectible(catalog.size())
+{
+   auto n_cards = catalog.size();
+   std::fill(m_regions.begin(), m_regions.end(), m_none);
+   std::fill(m_card_types.begin(), m_card_types.end(), m_none);
+   std::fill(m_super_types.begin(), m_super_types.end(), m_none);
+   std::fill(m_groups.begin(), m_groups.end(), m_none);
+   std::fill(m_rarities.begin(), m_rarities.end(), m_none);
+   std::fill(m_keywords.begin(), m_keywords.end(), m_none);
+
+   u32 max_cost = 0;
+   for(const auto& entry : catalog) {
+      max_cost = std::max(max_cost, entry.mana_cost);
+   }
+   m_costs.assign(max_cost + 1, m_none);
+
+   for(size_t idx = 0; idx < n_cards; ++idx) {
+      const auto& entry = catalog[idx];
+      if(entry.collectible != 0) {
+         m_collectible.set(idx);
+      }
+      m_regions.at(entry.region).set(idx);
+      m_card_types.at(entry.card_type).set(idx);
+      m_super_types.at(entry.super_type).set(idx);
+      m_groups.at(entry.group).set(idx);
+      m_rarities.at(entry.rarity).set(idx);
+      for(size_t kw = 0; kw < n_keywords; ++kw) {
+         if(entry.has_keyword(Keyword(kw))) {
+            m_keywords[kw].set(idx);
+         }
+      }
+      m_costs[entry.mana_cost].set(idx);
+   }
+
+   m_costs_at_most.reserve(m_costs.size());
+   for(const auto& cost_cards : m_costs) {
+      m_costs_at_most.emplace_back(
+         m_costs_at_most.empty() ? cost_cards : m_costs_at_most.back() | cost_cards);
+   }
+}
+
+CardQuery& CardQuery::regions(RegionSet regions)
+{
+   Bitmap cards(m_pool->size());
+   for(size_t r = 0; r < n_regions; ++r) {
+      if(regions.contains(Region(r))) {
+         cards |= m_pool->region(Region(r));
+      }
+   }
+   return _and(cards);
+}
+
+CardQuery& CardQuery::collectible(bool collectible)
+{
+   if(collectible) {
+      return _and(m_pool->collectible());
+   }
+   m_cards.subtract(m_pool->collectible());
+   return *this;
+}
+
+CardQuery& CardQuery::cost_between(size_t min_cost, size_t max_cost)
+{
+   if(min_cost > max_cost) {
+      m_cards = Bitmap(m_pool->size());
+      return *this;
+   }
+   _and(m_pool->cost_at_most(max_cost));
+   if(min_cost > 0) {
+      m_cards.subtract(m_pool->cost_at_most(min_cost - 1));
+   }
+   return *this;
+}
@@ -1,6 +1,7 @@
 
 #include <cards/types/cardbase.h>
 
+#include <algorithm>
 #include <utility>
 
 #include "cards/card.h"
@@ -11,6 +12,7 @@
 Card::Card(ConstState const_attrs, MutableState var_attrs)
     : m_immutables(std::move(const_attrs)), m_mutables(std::move(var_attrs))
 {
+   _update_mana_cost();
 }
 
 void Card::remove_effect(events::EventLabel e_type, const EffectBase& effect)
@@ -74,8 +76,23 @@ bool Card::has_effect(events::EventLabel e_type, const EffectBase& effect) const
    }
    return false;
 }
-Card::Card(const Card& card)
-    : m_immutables(card.m_immutables),
+Card::Card(const Card& card) : Card(card, card.m_immutables.uuid) {}
+
+Card::Card(const Card& card, UUID uuid)
+    : m_immutables(ConstState{
+       card.m_immutables.code,
+       card.m_immutables.name,
+       card.m_immutables.effect_desc,
+       card.m_immutables.lore,
+       card.m_immutables.region,
+       card.m_immutables.group,
+       card.m_immutables.super_type,
+       card.m_immutables.rarity,
+       card.m_immutables.card_type,
+       card.m_immutables.mana_cost_ref,
+       card.m_immutables.is_collectible,
+       card.m_immutables.creator,
+       uuid}),
       m_mutables(MutableState{
          card.m_mutables.owner,
          card.m_mutables.location,
@@ -87,8 +104,48 @@ Card::Card(const Card& card)
          _clone_effect_map(card.m_mutables.effects),
          card.m_mutables.play_toll->clone(),
          card.m_mutables.grants,
-         card.m_mutables.grants_temp})
+         card.m_mutables.grants_temp}),
+      m_mana_cost(card.m_mana_cost)
+{
+   for(auto* grants : {&m_mutables.grants, &m_mutables.grants_temp}) {
+      for(auto& grant : *grants) {
+         grant = _clone_grant(card, *grant);
+      }
+   }
+}
+sptr< Grant > Card::_clone_grant(const Card& original, const Grant& grant) const
+{
+   auto clone = grant.clone();
+   if(grant.get_grant_type() == GrantType::EFFECT) {
+      // the granted effect is the clone of it in this card's effects, so that undoing the grant
+      // removes that one
+      auto& effect_grant = static_cast< EffectGrant& >(*clone);
+      auto label = effect_grant.get_event_type();
+      if(auto found = original.m_mutables.effects.find(label);
+         found != original.m_mutables.effects.end()) {
+         const auto& effects = found->second;
+         auto pos = std::find(effects.begin(), effects.end(), effect_grant.get_effect());
+         if(pos != effects.end()) {
+            effect_grant.set_effect(m_mutables.effects.at(label)[pos - effects.begin()]);
+            return clone;
+         }
+      }
+      effect_grant.set_effect(effect_grant.get_effect()->clone());
+   }
+   return clone;
+}
+void Card::rebind(const sptr< Card >& self, const CardMap& card_of)
 {
+   for(const auto* grants : {&m_mutables.grants, &m_mutables.grants_temp}) {
+      for(const auto& grant : *grants) {
+         grant->rebind(card_of(grant->get_bestowing_card()), self);
+      }
+   }
+   for(auto& [label, effects] : m_mutables.effects) {
+      for(auto& effect : effects) {
+         effect->associated_card(card_of(effect->associated_card()));
+      }
+   }
 }
 Card::EffectMap Card::_clone_effect_map(const Card::EffectMap& emap)
 {
@@ -1,2 +1,116 @@
-
 #include "cards/cardfactory.h"
+
+#include <stdexcept>
+#include <string>
+
+#include "cards/card.h"
+
+CardFactory::CardFactory(CardCatalog catalog)
+    : m_catalog(std::move(catalog)),
+      m_catalog_prototypes(m_catalog->size()),
+      m_built(m_catalog->size())
+{
+}
+
+CardFactory::CardFactory(const std::filesystem::path& catalog_path)
+    : CardFactory(CardCatalog(catalog_path))
+{
+}
+
+void CardFactory::add_prototype(sptr< Card > prototype)
+{
+   // the key views the code of the prototype it maps to, so it is replaced along with it
+   m_prototypes.erase(prototype->immutables().code);
+   std::string_view code = prototype->immutables().code;
+   m_prototypes.emplace(code, std::move(prototype));
+}
+
+const Card* CardFactory::prototype(std::string_view code) const
+{
+   if(auto found = m_prototypes.find(code); found != m_prototypes.end()) {
+      return found->second.get();
+   }
+   if(m_catalog.has_value()) {
+      if(const auto* entry = m_catalog->find(code); entry != nullptr) {
+         return _catalog_prototype(*entry);
+      }
+   }
+   return nullptr;
+}
+
+const Card* CardFactory::_catalog_prototype(const CatalogEntry& entry) const
+{
+   size_t idx = m_catalog->index_of(entry);
+   // a build that throws leaves the flag unset, so that every attempt reports the error
+   std::call_once(
+      m_built[idx], [&] { m_catalog_prototypes[idx] = _build(*m_catalog, entry); });
+   return m_catalog_prototypes[idx].get();
+}
+
+sptr< Card > CardFactory::create(std::string_view code, Team owner, const sptr< Arena >& arena)
+   const
+{
+   const auto* proto = prototype(code);
+   if(proto == nullptr) {
+      throw std::out_of_range("There is no card of code " + std::string(code) + ".");
+   }
+   auto card = clone(*proto, arena);
+   card->mutables().owner = owner;
+   return card;
+}
+
+sptr< Card > CardFactory::clone(const Card& card, const sptr< Arena >& arena)
+{
+   auto copy = card.clone_into(utils::new_uuid(), arena);
+   // the copy's grants and effects refer to the copy instead of the card it was cloned from
+   copy->rebind(copy, [&card, &copy](const sptr< Card >& other) {
+      return other.get() == &card ? copy : other;
+   });
+   return copy;
+}
+
+sptr< Card > CardFactory::_build(const CardCatalog& catalog, const CatalogEntry& entry)
+{
+   Card::ConstState const_state{
+      std::string(catalog.string(entry.code)),
+      std::string(catalog.string(entry.name)),
+      std::string(catalog.string(entry.description)),
+      std::string(catalog.string(entry.lore)),
+      Region(entry.region),
+      Group(entry.group),
+      CardSuperType(entry.super_type),
+      Rarity(entry.rarity),
+      CardType(entry.card_type),
+      entry.mana_cost,
+      entry.collectible != 0};
+   KeywordMap keywords{};
+   for(size_t kw = 0; kw < n_keywords; ++kw) {
+      keywords[kw] = entry.has_keyword(Keyword(kw));
+   }
+   Card::MutableState mutable_state{
+      Team::BLUE, Location::DECK, 0, true, long(entry.mana_cost), 0, keywords};
+
+   switch(CardType(entry.card_type)) {
+      case CardType::UNIT:
+         return std::make_shared< Unit >(
+            std::move(const_state),
+            std::move(mutable_state),
+            Unit::ConstUnitState{entry.power, entry.health},
+            Unit::MutableUnitState{entry.power, entry.health});
+      case CardType::SPELL:
+         if(CardSuperType(entry.super_type) == CardSuperType::SKILL) {
+            return std::make_shared< Skill >(std::move(const_state), std::move(mutable_state));
+         }
+         return std::make_shared< Spell >(std::move(const_state), std::move(mutable_state));
+      case CardType::LANDMARK:
+         return std::make_shared< Landmark >(std::move(const_state), std::move(mutable_state));
+      case CardType::TRAP:
+         throw std::invalid_argument(
+            "The card " + std::string(catalog.string(entry.code))
+            + " is a trap card, which cannot be built from the catalog.");
+      default:
+         throw std::invalid_argument(
+            "The card " + std::string(catalog.string(entry.code)) + " has the card type "
+            + std::to_string(entry.card_type) + ", which cannot be built from the catalog.");
+   }
+}
@@ -0,0 +1,219 @@
+
+#include "cards/catalog.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+size_t aligned(size_t offset)
+{
+   return (offset + 7) / 8 * 8;
+}
+
+/**
+ * The number of index slots for the given number of cards: a power of 2 keeping the load factor
+ * at or below 1/2.
+ */
+size_t index_size(size_t n_cards)
+{
+   size_t size = 2;
+   while(size < 2 * n_cards) {
+      size *= 2;
+   }
+   return size;
+}
+
+}  // namespace
+
+u64 CardCatalog::hash_code(std::string_view code)
+{
+   u64 hash = 14695981039346656037ull;
+   for(char c : code) {
+      hash = (hash ^ u8(c)) * 1099511628211ull;
+   }
+   return hash;
+}
+
+CardCatalog::CardCatalog(const std::filesystem::path& path) : m_file(path)
+{
+   const u8* data = m_file.data();
+   size_t size = m_file.size();
+   if(size < sizeof(CatalogHeader)) {
+      throw std::runtime_error("Card catalog " + path.string() + " is truncated.");
+   }
+   m_header = reinterpret_cast< const CatalogHeader* >(data);
+   if(m_header->magic != CatalogHeader::file_magic) {
+      throw std::runtime_error(path.string() + " is not a card catalog.");
+   }
+   if(m_header->format_version != CatalogHeader::current_format) {
+      throw std::runtime_error(
+         "Card catalog " + path.string() + " has the unsupported format version "
+         + std::to_string(m_header->format_version) + ".");
+   }
+   auto fits = [&](u64 offset, u64 n_bytes) {
+      return offset % 8 == 0 && offset <= size && n_bytes <= size - offset;
+   };
+   bool ok = fits(m_header->cards_offset, u64(m_header->n_cards) * sizeof(CatalogEntry))
+             && fits(m_header->associated_offset, u64(m_header->n_associated) * sizeof(u32))
+             && fits(m_header->index_offset, u64(m_header->index_size) * sizeof(u32))
+             && fits(m_header->strings_offset, m_header->strings_size)
+             && m_header->index_size > m_header->n_cards
+             && (m_header->index_size & (m_header->index_size - 1)) == 0;
+   if(not ok) {
+      throw std::runtime_error("Card catalog " + path.string() + " is corrupt.");
+   }
+   m_cards = reinterpret_cast< const CatalogEntry* >(data + m_header->cards_offset);
+   m_associated = reinterpret_cast< const u32* >(data + m_header->associated_offset);
+   m_index = reinterpret_cast< const u32* >(data + m_header->index_offset);
+   m_strings = reinterpret_cast< const char* >(data + m_header->strings_offset);
+   if(not _is_consistent()) {
+      throw std::runtime_error("Card catalog " + path.string() + " is corrupt.");
+   }
+}
+
+bool CardCatalog::_is_consistent() const
+{
+   auto in_strings = [&](const CatalogString& str) {
+      return str.size <= m_header->strings_size && str.offset <= m_header->strings_size - str.size;
+   };
+   if(not in_strings(m_header->data_version)) {
+      return false;
+   }
+   for(const auto& entry : *this) {
+      if(not (in_strings(entry.code) && in_strings(entry.name) && in_strings(entry.description)
+              && in_strings(entry.lore))) {
+         return false;
+      }
+      if(entry.n_associated > m_header->n_associated
+         || entry.first_associated > m_header->n_associated - entry.n_associated) {
+         return false;
+      }
+      for(u32 card : associated(entry)) {
+         if(card >= m_header->n_cards) {
+            return false;
+         }
+      }
+   }
+   // an index with more occupied slots than cards might have no empty slot left, on which a
+   // lookup of a missing code would never end
+   size_t n_occupied = 0;
+   for(size_t slot = 0; slot < m_header->index_size; ++slot) {
+      if(m_index[slot] > m_header->n_cards) {
+         return false;
+      }
+      n_occupied += m_index[slot] != 0;
+   }
+   return n_occupied <= m_header->n_cards;
+}
+
+const CatalogEntry* CardCatalog::find(std::string_view code) const
+{
+   size_t mask = m_header->index_size - 1;
+   for(size_t slot = hash_code(code) & mask;; slot = (slot + 1) & mask) {
+      u32 card = m_index[slot];
+      if(card == 0) {
+         return nullptr;
+      }
+      if(string(m_cards[card - 1].code) == code) {
+         return &m_cards[card - 1];
+      }
+   }
+}
+
+const CatalogEntry& CardCatalog::at(std::string_view code) const
+{
+   if(const auto* entry = find(code); entry != nullptr) {
+      return *entry;
+   }
+   throw std::out_of_range("The card catalog has no card of code " + std::string(code) + ".");
+}
+
+void CatalogBuilder::write(const std::filesystem::path& path) const
+{
+   std::unordered_map< std::string_view, u32 > card_index;
+   for(size_t i = 0; i < m_cards.size(); ++i) {
+      if(not card_index.emplace(m_cards[i].code, u32(i)).second) {
+         throw std::invalid_argument("The card code " + m_cards[i].code + " was added twice.");
+      }
+   }
+
+   std::string strings;
+   auto add_string = [&](std::string_view str) {
+      CatalogString entry{u32(strings.size()), u32(str.size())};
+      strings.append(str);
+      return entry;
+   };
+
+   CatalogHeader header;
+   header.n_cards = u32(m_cards.size());
+   header.data_version = add_string(m_data_version);
+   header.index_size = u32(index_size(m_cards.size()));
+
+   std::vector< CatalogEntry > entries;
+   std::vector< u32 > associated;
+   entries.reserve(m_cards.size());
+   for(const auto& card : m_cards) {
+      CatalogEntry entry{};
+      entry.code = add_string(card.code);
+      entry.name = add_string(card.name);
+      entry.description = add_string(card.description);
+      entry.lore = add_string(card.lore);
+      for(auto keyword : card.keywords) {
+         entry.keywords |= u64(1) << static_cast< size_t >(keyword);
+      }
+      entry.region = u8(card.region);
+      entry.group = u8(card.group);
+      entry.super_type = u8(card.super_type);
+      entry.rarity = u8(card.rarity);
+      entry.card_type = u8(card.card_type);
+      entry.collectible = card.collectible;
+      entry.mana_cost = u32(card.mana_cost);
+      entry.power = u32(card.power);
+      entry.health = u32(card.health);
+      entry.first_associated = u32(associated.size());
+      entry.n_associated = u32(card.associated_codes.size());
+      for(const auto& code : card.associated_codes) {
+         auto found = card_index.find(code);
+         if(found == card_index.end()) {
+            throw std::invalid_argument(
+               "The card " + card.code + " is associated with the unknown card " + code + ".");
+         }
+         associated.emplace_back(found->second);
+      }
+      entries.emplace_back(entry);
+   }
+   header.n_associated = u32(associated.size());
+
+   std::vector< u32 > index(header.index_size, 0);
+   for(size_t i = 0; i < m_cards.size(); ++i) {
+      size_t slot = CardCatalog::hash_code(m_cards[i].code) & (index.size() - 1);
+      while(index[slot] != 0) {
+         slot = (slot + 1) & (index.size() - 1);
+      }
+      index[slot] = u32(i + 1);
+   }
+
+   header.cards_offset = aligned(sizeof(CatalogHeader));
+   header.associated_offset = aligned(header.cards_offset + entries.size() * sizeof(CatalogEntry));
+   header.index_offset = aligned(header.associated_offset + associated.size() * sizeof(u32));
+   header.strings_offset = aligned(header.index_offset + index.size() * sizeof(u32));
+   header.strings_size = strings.size();
+
+   std::vector< char > bytes(header.strings_offset + strings.size(), 0);
+   std::memcpy(bytes.data(), &header, sizeof(CatalogHeader));
+   std::memcpy(
+      bytes.data() + header.cards_offset, entries.data(), entries.size() * sizeof(CatalogEntry));
+   std::memcpy(
+      bytes.data() + header.associated_offset, associated.data(), associated.size() * sizeof(u32));
+   std::memcpy(bytes.data() + header.index_offset, index.data(), index.size() * sizeof(u32));
+   std::memcpy(bytes.data() + header.strings_offset, strings.data(), strings.size());
+
+   std::ofstream file(path, std::ios::binary | std::ios::trunc);
+   file.write(bytes.data(), std::streamsize(bytes.size()));
+   if(not file) {
+      throw std::runtime_error("Writing the card catalog " + path.string() + " failed.");
+   }
+}
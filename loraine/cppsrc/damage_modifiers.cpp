@@ -0,0 +1,37 @@
+
+#include "effects/damage_modifiers.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace modifiers {
+
+namespace {
+
+std::vector< DamageModifier >& registered()
+{
+   static std::vector< DamageModifier > modifiers;
+   return modifiers;
+}
+
+}  // namespace
+
+ModifierId DamageModifiers::add(DamageModifier modifier)
+{
+   auto& modifiers = registered();
+   modifiers.emplace_back(modifier);
+   return static_cast< ModifierId >(n_builtin_damage_modifiers + modifiers.size() - 1);
+}
+
+long DamageModifiers::_apply_registered(ModifierId id, const Card& source, long amount)
+{
+   const auto& modifiers = registered();
+   size_t idx = id - n_builtin_damage_modifiers;
+   if(idx >= modifiers.size()) {
+      throw std::out_of_range("Unknown damage modifier id " + std::to_string(id) + ".");
+   }
+   return modifiers[idx](source, amount);
+}
+
+}  // namespace modifiers
@@ -68,22 +68,27 @@ sptr< Card > Deck::pop_by_index(size_t index)
    auto rbegin = m_cards.rbegin();
    auto pos = std::next(rbegin, index);
    sptr< Card > popped_card = *pos;
-   m_cards.erase(pos.base());
+   // the base of a reverse iterator points one past its element
+   m_cards.erase(std::next(pos).base());
    return popped_card;
 }
 
-std::set< Region > Deck::identify_regions(const Deck::ContainerType& container)
+RegionSet Deck::identify_regions(const Deck::ContainerType& container)
 {
-   std::set< Region > rs;
+   RegionSet rs;
    for(const auto& cptr : container) {
-      rs.emplace(cptr->immutables().region);
+      rs.add(cptr->immutables().region);
    }
    return rs;
 }
 
-std::set< Region > Deck::identify_regions(std::initializer_list< value_type > cards)
+RegionSet Deck::identify_regions(std::initializer_list< value_type > cards)
 {
-   return identify_regions(ContainerType(cards));
+   RegionSet rs;
+   for(const auto& cptr : cards) {
+      rs.add(cptr->immutables().region);
+   }
+   return rs;
 }
 
 Deck::Deck(const Deck& other) : m_cards(), m_regions(other.m_regions)
@@ -0,0 +1,485 @@
+#include "core/deckcode.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+
+#include "cards/card.h"
+#include "cards/cardfactory.h"
+#include "cards/catalog.h"
+#include "core/deck.h"
+#include "utils/varint.h"
+
+namespace {
+
+constexpr u32 format = 1;
+constexpr size_t card_code_size = 7;
+constexpr std::string_view base32_alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+
+// the faction codes by their deck code ids, empty for unused ids
+constexpr std::array< std::string_view, 13 > factions = {
+   "DE", "FR", "IO", "NX", "PZ", "SI", "BW", "SH", "", "MT", "BC", "", "RU"};
+// the deck code version introducing each faction id, as in Riot's LoRDeckCodes library: Bilgewater
+// and Mount Targon came with version 2, Shurima 3, Bandle City 4 and Runeterra 5
+constexpr std::array< u32, 13 > faction_versions = {1, 1, 1, 1, 1, 1, 2, 3, 0, 2, 4, 0, 5};
+
+constexpr std::array< u8, 256 > base32_values()
+{
+   std::array< u8, 256 > values{};
+   for(auto& value : values) {
+      value = 0xFF;
+   }
+   for(size_t i = 0; i < base32_alphabet.size(); ++i) {
+      values[u8(base32_alphabet[i])] = u8(i);
+      // lower case letters are accepted as well
+      if(base32_alphabet[i] >= 'A' && base32_alphabet[i] <= 'Z') {
+         values[u8(base32_alphabet[i] - 'A' + 'a')] = u8(i);
+      }
+   }
+   return values;
+}
+
+constexpr auto base32_table = base32_values();
+
+/**
+ * The code's bytes, decoded into `out` (which needs room for 5/8 of the code's length).
+ */
+size_t base32_decode(std::string_view code, u8* out)
+{
+   while(not code.empty() && code.back() == '=') {
+      code.remove_suffix(1);
+   }
+   size_t n = 0;
+   u32 buffer = 0;
+   u32 n_bits = 0;
+   for(char c : code) {
+      u8 value = base32_table[u8(c)];
+      if(value == 0xFF) {
+         throw std::invalid_argument(
+            "Invalid character '" + std::string(1, c) + "' in deck code " + std::string(code)
+            + ".");
+      }
+      buffer = (buffer << 5) | value;
+      n_bits += 5;
+      if(n_bits >= 8) {
+         n_bits -= 8;
+         out[n++] = u8(buffer >> n_bits);
+      }
+   }
+   return n;
+}
+
+std::string base32_encode(const std::vector< u8 >& bytes)
+{
+   std::string code;
+   code.reserve((bytes.size() * 8 + 4) / 5);
+   u32 buffer = 0;
+   u32 n_bits = 0;
+   for(u8 byte : bytes) {
+      buffer = (buffer << 8) | byte;
+      n_bits += 8;
+      while(n_bits >= 5) {
+         n_bits -= 5;
+         code.push_back(base32_alphabet[(buffer >> n_bits) & 0x1F]);
+      }
+   }
+   if(n_bits > 0) {
+      code.push_back(base32_alphabet[(buffer << (5 - n_bits)) & 0x1F]);
+   }
+   return code;
+}
+
+class ByteReader {
+  public:
+   ByteReader(const u8* begin, const u8* end) : m_pos(begin), m_end(end) {}
+
+   [[nodiscard]] bool done() const { return m_pos == m_end; }
+   [[nodiscard]] size_t remaining() const { return size_t(m_end - m_pos); }
+
+   u32 read(u32 max)
+   {
+      u64 value = 0;
+      try {
+         value = varint::decode(m_pos, m_end);
+      } catch(std::out_of_range&) {
+         throw std::invalid_argument("Truncated deck code.");
+      }
+      if(value > max) {
+         throw std::invalid_argument(
+            "Deck code value " + std::to_string(value) + " exceeds its maximum of "
+            + std::to_string(max) + ".");
+      }
+      return u32(value);
+   }
+
+   DeckCodeCard read_card(u32 set, u32 faction, u32 count)
+   {
+      if(faction >= factions.size() || factions[faction].empty()) {
+         throw std::invalid_argument("Unknown deck code faction " + std::to_string(faction) + ".");
+      }
+      return {set, faction, read(999), count};
+   }
+
+  private:
+   const u8* m_pos;
+   const u8* m_end;
+};
+
+/**
+ * Calls `visit` with each card of the deck code, in the order of the code.
+ */
+template < typename Visitor >
+void parse(std::string_view code, Visitor&& visit)
+{
+   // deck codes of regular decks are about 40-100 bytes, longer ones fall back to the heap
+   std::array< u8, 512 > stack_bytes;
+   std::vector< u8 > heap_bytes;
+   u8* bytes = stack_bytes.data();
+   if(code.size() * 5 / 8 > stack_bytes.size()) {
+      heap_bytes.resize(code.size() * 5 / 8);
+      bytes = heap_bytes.data();
+   }
+   size_t n_bytes = base32_decode(code, bytes);
+   if(n_bytes == 0) {
+      throw std::invalid_argument("Empty deck code.");
+   }
+   u32 code_format = bytes[0] >> 4;
+   u32 version = bytes[0] & 0xF;
+   if(code_format != format || version > DeckCodec::max_version) {
+      throw std::invalid_argument(
+         "Unsupported deck code format " + std::to_string(code_format) + " version "
+         + std::to_string(version) + ".");
+   }
+   ByteReader reader(bytes + 1, bytes + n_bytes);
+   for(u32 count = 3; count > 0; --count) {
+      u32 n_groups = reader.read(u32(reader.remaining()));
+      for(u32 group = 0; group < n_groups; ++group) {
+         u32 n_cards = reader.read(u32(reader.remaining()));
+         u32 set = reader.read(99);
+         u32 faction = reader.read(u32(factions.size()));
+         for(u32 card = 0; card < n_cards; ++card) {
+            visit(reader.read_card(set, faction, count));
+         }
+      }
+   }
+   while(not reader.done()) {
+      u32 count = reader.read(std::numeric_limits< u32 >::max());
+      u32 set = reader.read(99);
+      u32 faction = reader.read(u32(factions.size()));
+      visit(reader.read_card(set, faction, count));
+   }
+}
+
+void write_varint(std::vector< u8 >& bytes, u64 value)
+{
+   std::array< u8, varint::max_bytes > buffer{};
+   auto n = varint::encode(value, buffer.data());
+   bytes.insert(bytes.end(), buffer.begin(), buffer.begin() + long(n));
+}
+
+}  // namespace
+
+DeckCodeCard DeckCodeCard::parse(std::string_view card_code, u32 count)
+{
+   auto is_digit = [](char c) { return c >= '0' && c <= '9'; };
+   auto digits = [](std::string_view part) {
+      u32 value = 0;
+      for(char c : part) {
+         value = value * 10 + u32(c - '0');
+      }
+      return value;
+   };
+   if(card_code.size() != card_code_size
+      || not std::all_of(card_code.begin(), card_code.begin() + 2, is_digit)
+      || not std::all_of(card_code.begin() + 4, card_code.end(), is_digit)) {
+      throw std::invalid_argument(
+         "The card code " + std::string(card_code) + " is not of the form SSFFNNN.");
+   }
+   auto faction = std::find(factions.begin(), factions.end(), card_code.substr(2, 2));
+   if(faction == factions.end()) {
+      throw std::invalid_argument(
+         "Unknown faction " + std::string(card_code.substr(2, 2)) + " of card code "
+         + std::string(card_code) + ".");
+   }
+   return {
+      digits(card_code.substr(0, 2)),
+      u32(std::distance(factions.begin(), faction)),
+      digits(card_code.substr(4, 3)),
+      count};
+}
+
+size_t DeckCodeCard::write_code(char* out) const
+{
+   out[0] = char('0' + set / 10 % 10);
+   out[1] = char('0' + set % 10);
+   std::memcpy(out + 2, factions[faction].data(), 2);
+   out[4] = char('0' + number / 100 % 10);
+   out[5] = char('0' + number / 10 % 10);
+   out[6] = char('0' + number % 10);
+   return card_code_size;
+}
+
+std::string DeckCodeCard::code() const
+{
+   std::string out(card_code_size, '0');
+   write_code(out.data());
+   return out;
+}
+
+DeckCodec::DeckCodec(const CardCatalog& catalog, const Config& config)
+    : m_catalog(&catalog),
+      m_max_copies(config.MAX_CARD_COPIES_IN_DECK),
+      m_deck_size(config.DECK_CARDS_LIMIT),
+      m_max_champions(config.CHAMPIONS_LIMIT),
+      m_max_regions(config.REGIONS_LIMIT)
+{
+}
+
+DeckList DeckCodec::decode(std::string_view code) const
+{
+   DeckList deck_list;
+   deck_list.cards.reserve(m_deck_size);
+   parse(code, [&](const DeckCodeCard& card) {
+      std::array< char, card_code_size > card_code{};
+      auto size = card.write_code(card_code.data());
+      const auto* entry = m_catalog->find({card_code.data(), size});
+      if(entry == nullptr) {
+         throw std::out_of_range(
+            "The card " + std::string(card_code.data(), size) + " of deck code "
+            + std::string(code) + " is not in the catalog.");
+      }
+      _add(deck_list, u32(m_catalog->index_of(*entry)), card.count);
+   });
+   _check(deck_list);
+   return deck_list;
+}
+
+std::vector< DeckList > DeckCodec::decode(
+   const std::vector< std::string_view >& codes,
+   size_t n_threads) const
+{
+   if(n_threads == 0) {
+      n_threads = std::max(1U, std::thread::hardware_concurrency());
+   }
+   n_threads = std::max(size_t(1), std::min(n_threads, codes.size()));
+   std::vector< DeckList > deck_lists(codes.size());
+   std::vector< std::exception_ptr > errors(n_threads);
+   auto decode_range = [&](size_t thread, size_t first, size_t last) {
+      try {
+         for(size_t i = first; i < last; ++i) {
+            try {
+               deck_lists[i] = decode(codes[i]);
+            } catch(std::invalid_argument&) {
+               deck_lists[i].violations = DeckList::MALFORMED;
+            } catch(std::out_of_range&) {
+               deck_lists[i].violations = DeckList::UNKNOWN_CARD;
+            }
+         }
+      } catch(...) {
+         errors[thread] = std::current_exception();
+      }
+   };
+   size_t chunk = (codes.size() + n_threads - 1) / n_threads;
+   std::vector< std::thread > workers;
+   workers.reserve(n_threads - 1);
+   // the calling thread decodes the first chunk itself
+   for(size_t t = 1; t < n_threads; ++t) {
+      workers.emplace_back(
+         decode_range,
+         t,
+         std::min(t * chunk, codes.size()),
+         std::min((t + 1) * chunk, codes.size()));
+   }
+   decode_range(0, 0, std::min(chunk, codes.size()));
+   for(auto& worker : workers) {
+      worker.join();
+   }
+   for(auto& error : errors) {
+      if(error) {
+         std::rethrow_exception(error);
+      }
+   }
+   return deck_lists;
+}
+
+std::vector< DeckList > DeckCodec::decode_file(
+   const std::filesystem::path& path,
+   size_t n_threads) const
+{
+   std::ifstream file(path, std::ios::binary);
+   if(not file) {
+      throw std::runtime_error("Cannot open deck code file " + path.string() + ".");
+   }
+   std::string text(std::istreambuf_iterator< char >(file), {});
+   std::vector< std::string_view > codes;
+   std::string_view rest = text;
+   constexpr std::string_view whitespace = " \t\r";
+   while(not rest.empty()) {
+      auto end = std::min(rest.find('\n'), rest.size());
+      auto line = rest.substr(0, end);
+      rest.remove_prefix(std::min(end + 1, rest.size()));
+      auto first = line.find_first_not_of(whitespace);
+      if(first == std::string_view::npos) {
+         continue;
+      }
+      line = line.substr(first, line.find_last_not_of(whitespace) + 1 - first);
+      codes.emplace_back(line);
+   }
+   return decode(codes, n_threads);
+}
+
+std::string DeckCodec::encode(const DeckList& deck_list) const
+{
+   std::vector< DeckCodeCard > cards;
+   cards.reserve(deck_list.cards.size());
+   for(const auto& [card, count] : deck_list.cards) {
+      cards.emplace_back(DeckCodeCard::parse(m_catalog->string((*m_catalog)[card].code), count));
+   }
+   return encode_cards(cards);
+}
+
+DeckList DeckCodec::list(const Deck& deck) const
+{
+   // the copies of each card, in the order of their first appearance in the deck
+   std::vector< DeckList::Entry > counts;
+   std::unordered_map< u32, size_t > positions;
+   for(const auto& card : deck) {
+      auto index = u32(m_catalog->index_of(m_catalog->at(card->immutables().code)));
+      auto [pos, inserted] = positions.emplace(index, counts.size());
+      if(inserted) {
+         counts.push_back({index, 0});
+      }
+      counts[pos->second].count++;
+   }
+   DeckList deck_list;
+   deck_list.cards.reserve(counts.size());
+   for(const auto& [card, count] : counts) {
+      _add(deck_list, card, count);
+   }
+   _check(deck_list);
+   return deck_list;
+}
+
+Deck DeckCodec::build(
+   const DeckList& deck_list,
+   const CardFactory& factory,
+   Team owner,
+   const sptr< Arena >& arena)
+{
+   const auto& catalog = factory.catalog();
+   Deck::ContainerType cards;
+   cards.reserve(deck_list.n_cards);
+   for(const auto& [card, count] : deck_list.cards) {
+      auto code = catalog.string(catalog[card].code);
+      for(u32 copy = 0; copy < count; ++copy) {
+         cards.emplace_back(factory.create(code, owner, arena));
+      }
+   }
+   return Deck(std::move(cards));
+}
+
+std::vector< DeckCodeCard > DeckCodec::decode_cards(std::string_view code)
+{
+   std::vector< DeckCodeCard > cards;
+   parse(code, [&](const DeckCodeCard& card) { cards.emplace_back(card); });
+   return cards;
+}
+
+std::string DeckCodec::encode_cards(const std::vector< DeckCodeCard >& cards)
+{
+   using CodedCard = std::pair< std::array< char, card_code_size >, const DeckCodeCard* >;
+   std::vector< CodedCard > coded;
+   coded.reserve(cards.size());
+   u32 version = 1;
+   for(const auto& card : cards) {
+      if(card.faction >= factions.size() || factions[card.faction].empty() || card.set > 99
+         || card.number > 999) {
+         throw std::invalid_argument("The card " + std::to_string(card.set) + "/"
+                                     + std::to_string(card.faction) + "/"
+                                     + std::to_string(card.number)
+                                     + " has no deck code.");
+      }
+      if(card.count == 0) {
+         continue;
+      }
+      version = std::max(version, faction_versions[card.faction]);
+      auto& [card_code, ptr] = coded.emplace_back();
+      card.write_code(card_code.data());
+      ptr = &card;
+   }
+   // the cards are ordered by their code, as are the groups by their size and first card
+   std::sort(coded.begin(), coded.end(), [](const CodedCard& a, const CodedCard& b) {
+      return a.first < b.first;
+   });
+
+   std::vector< u8 > bytes{u8(format << 4 | version)};
+   for(u32 count = 3; count > 0; --count) {
+      std::vector< std::vector< const DeckCodeCard* > > groups;
+      for(const auto& [card_code, card] : coded) {
+         if(card->count != count) {
+            continue;
+         }
+         auto group = std::find_if(groups.begin(), groups.end(), [&](const auto& members) {
+            return members.front()->set == card->set && members.front()->faction == card->faction;
+         });
+         if(group == groups.end()) {
+            groups.emplace_back(1, card);
+         } else {
+            group->emplace_back(card);
+         }
+      }
+      std::stable_sort(groups.begin(), groups.end(), [](const auto& a, const auto& b) {
+         return a.size() < b.size();
+      });
+      write_varint(bytes, groups.size());
+      for(const auto& group : groups) {
+         write_varint(bytes, group.size());
+         write_varint(bytes, group.front()->set);
+         write_varint(bytes, group.front()->faction);
+         for(const auto* card : group) {
+            write_varint(bytes, card->number);
+         }
+      }
+   }
+   for(const auto& [card_code, card] : coded) {
+      if(card->count > 3) {
+         write_varint(bytes, card->count);
+         write_varint(bytes, card->set);
+         write_varint(bytes, card->faction);
+         write_varint(bytes, card->number);
+      }
+   }
+   return base32_encode(bytes);
+}
+
+void DeckCodec::_add(DeckList& deck_list, u32 card, u32 count) const
+{
+   const auto& entry = (*m_catalog)[card];
+   deck_list.cards.push_back({card, count});
+   deck_list.n_cards += count;
+   deck_list.regions.add(Region(entry.region));
+   if(CardSuperType(entry.super_type) == CardSuperType::CHAMPION) {
+      deck_list.n_champions += count;
+   }
+   if(count > m_max_copies) {
+      deck_list.violations |= DeckList::TOO_MANY_COPIES;
+   }
+}
+
+void DeckCodec::_check(DeckList& deck_list) const
+{
+   if(deck_list.n_cards != m_deck_size) {
+      deck_list.violations |= DeckList::WRONG_SIZE;
+   }
+   if(deck_list.n_champions > m_max_champions) {
+      deck_list.violations |= DeckList::TOO_MANY_CHAMPIONS;
+   }
+   if(deck_list.regions.size() > m_max_regions) {
+      deck_list.violations |= DeckList::TOO_MANY_REGIONS;
+   }
+}
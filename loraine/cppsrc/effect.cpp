@@ -1,6 +1,8 @@
 
 #include "effects/effect.h"
 
+#include "cards/card.h"
+
 bool EffectBase::operator==(const EffectBase& effect) const
 {
    return m_uuid == effect.uuid();
@@ -10,9 +12,18 @@ bool EffectBase::operator!=(const EffectBase& effect) const
 {
    return not (*this == effect);
 }
+std::string_view EffectBase::trace_name() const
+{
+   if(m_assoc_card == nullptr) {
+      return "<no card>";
+   }
+   return m_assoc_card->immutables().code;
+}
 EffectBase::EffectBase(const EffectBase& effect)
-    : Targeting(effect),
+    : EventListener(effect),
+      Targeting(effect),
       m_effect_label(effect.m_effect_label),
+      m_reg_time(effect.m_reg_time),
       m_consumed(effect.m_consumed),
       m_assoc_card(effect.m_assoc_card),
       m_uuid(utils::new_uuid())
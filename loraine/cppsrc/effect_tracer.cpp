@@ -0,0 +1,70 @@
+
+#include "utils/effect_tracer.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+namespace profiling {
+
+std::vector< EffectCost > EffectTracer::report(SortKey sort_by)
+{
+   std::map< EffectKey, EffectCost, EffectKeyLess > merged;
+   EffectTraceRegistry::instance().for_each([&](const ThreadEffectTrace& trace, u32 /*thread*/) {
+      for(const auto& [key, cost] : trace.costs) {
+         auto& entry = merged.try_emplace(key, EffectCost{key.card_code, key.label}).first->second;
+         entry.calls += cost.calls;
+         entry.inclusive_ns += cost.inclusive_ns;
+         entry.self_ns += cost.self_ns;
+         entry.events_fired += cost.events_fired;
+      }
+   });
+   std::vector< EffectCost > rows;
+   rows.reserve(merged.size());
+   for(auto& [key, cost] : merged) {
+      rows.emplace_back(std::move(cost));
+   }
+   auto column = [sort_by](const EffectCost& cost) {
+      switch(sort_by) {
+         case SortKey::CALLS: return cost.calls;
+         case SortKey::INCLUSIVE_TIME: return cost.inclusive_ns;
+         case SortKey::SELF_TIME: return cost.self_ns;
+         case SortKey::EVENTS_FIRED: return cost.events_fired;
+      }
+      return cost.self_ns;
+   };
+   // stable, so that ties keep the (card code, label) order of the merged map
+   std::stable_sort(rows.begin(), rows.end(), [&](const EffectCost& c1, const EffectCost& c2) {
+      return column(c1) > column(c2);
+   });
+   return rows;
+}
+
+void EffectTracer::write_report(std::ostream& os, SortKey sort_by, size_t top_n)
+{
+   auto rows = report(sort_by);
+   if(top_n > 0 && rows.size() > top_n) {
+      rows.resize(top_n);
+   }
+   os << std::left << std::setw(16) << "card" << std::setw(16) << "event" << std::right
+      << std::setw(12) << "calls" << std::setw(14) << "incl [ms]" << std::setw(14) << "self [ms]"
+      << std::setw(12) << "mean [us]" << std::setw(12) << "events"
+      << "\n";
+   os << std::fixed << std::setprecision(3);
+   for(const auto& cost : rows) {
+      os << std::left << std::setw(16) << cost.card_code << std::setw(16)
+         << events::label_name(cost.label) << std::right << std::setw(12) << cost.calls
+         << std::setw(14) << double(cost.inclusive_ns) * 1e-6 << std::setw(14)
+         << double(cost.self_ns) * 1e-6 << std::setw(12)
+         << double(cost.self_ns) * 1e-3 / double(std::max(cost.calls, u64(1))) << std::setw(12)
+         << cost.events_fired << "\n";
+   }
+}
+
+void EffectTracer::reset()
+{
+   EffectTraceRegistry::instance().for_each_mut(
+      [](ThreadEffectTrace& trace) { trace.costs.clear(); });
+}
+
+}  // namespace profiling
@@ -0,0 +1,507 @@
+
+#include "core/gamelog.h"
+
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <stdexcept>
+#include <utility>
+
+#include "core/gamestate.h"
+#include "io/output_sink.h"
+
+namespace {
+
+using namespace actions;
+using ActionVariant = actions::Action::ActionVariant;
+
+/**
+ * The zones a target is looked up in. A target is recorded as its zone, the team of the zone and
+ * its index in there, which identifies it again in the re-simulated game (unlike its id).
+ */
+enum class TargetZone : u8 { NEXUS = 0, HAND, CAMP, BATTLEFIELD, SPELL_STACK };
+
+/**
+ * Collects an action's payload along with the state its targets are located in.
+ */
+template < typename Payload >
+struct ActionWriter {
+   Payload& payload;
+   const GameState* state;
+
+   void put(u64 value) { payload.put(value); }
+};
+
+template < typename Container >
+std::optional< size_t > index_of(const Container& cards, const Targetable* target)
+{
+   for(size_t i = 0; i < cards.size(); ++i) {
+      if(static_cast< const Targetable* >(cards[i].get()) == target) {
+         return i;
+      }
+   }
+   return std::nullopt;
+}
+
+template < typename Writer >
+void put_target(Writer& out, const Targetable* target)
+{
+   const auto& state = *out.state;
+   auto put = [&](TargetZone zone, Team team, size_t index) {
+      out.put(static_cast< u64 >(zone));
+      out.put(static_cast< u64 >(team));
+      out.put(index);
+   };
+   for(Team team : {Team::BLUE, Team::RED}) {
+      const auto& player = state.player(team);
+      if(static_cast< const Targetable* >(&player.nexus()) == target) {
+         return put(TargetZone::NEXUS, team, 0);
+      }
+      if(auto idx = index_of(player.hand(), target)) {
+         return put(TargetZone::HAND, team, *idx);
+      }
+      if(auto idx = index_of(state.board().camp(team), target)) {
+         return put(TargetZone::CAMP, team, *idx);
+      }
+      if(auto idx = index_of(state.board().battlefield(team), target)) {
+         return put(TargetZone::BATTLEFIELD, team, *idx);
+      }
+   }
+   if(auto idx = index_of(state.spell_stack(), target)) {
+      return put(TargetZone::SPELL_STACK, Team::BLUE, *idx);
+   }
+   throw std::invalid_argument("A target of the action is in none of the zones targets are in.");
+}
+
+template < typename Writer >
+void put_targets(Writer& out, const std::vector< sptr< Targetable > >& targets)
+{
+   if(targets.empty()) {
+      return;
+   }
+   if(out.state == nullptr) {
+      throw std::invalid_argument("The targets of an action are only logged along with its state.");
+   }
+   for(const auto& target : targets) {
+      put_target(out, target.get());
+   }
+}
+
+template < typename Writer >
+void encode_detail(Writer&, const AcceptAction&)
+{
+}
+template < typename Writer >
+void encode_detail(Writer&, const CancelAction&)
+{
+}
+template < typename Writer >
+void encode_detail(Writer& out, const ChoiceAction& action)
+{
+   out.put(action.n_choices());
+   out.put(action.choice());
+}
+template < typename Writer >
+void encode_detail(Writer& out, const DragEnemyAction& action)
+{
+   out.put(action.to_bf());
+   out.put(action.from());
+   out.put(action.to());
+}
+template < typename Writer >
+void encode_detail(Writer& out, const MulliganAction& action)
+{
+   // the decisions as a bitmask
+   u64 mask = 0;
+   auto decisions = action.replace_decisions();
+   if(decisions.size() > 64) {
+      throw std::invalid_argument("A mulligan of more than 64 cards cannot be logged.");
+   }
+   for(size_t i = 0; i < decisions.size(); ++i) {
+      mask |= u64(decisions[i]) << i;
+   }
+   out.put(decisions.size());
+   out.put(mask);
+}
+template < typename Writer >
+void encode_detail(Writer& out, const PlaceSpellAction& action)
+{
+   out.put(action.index());
+   out.put(action.to_stack());
+}
+template < typename Writer >
+void encode_detail(Writer& out, const PlaceUnitAction& action)
+{
+   out.put(action.to_bf());
+   out.put(action.indices_vec().size());
+   for(auto idx : action.indices_vec()) {
+      out.put(idx);
+   }
+}
+template < typename Writer >
+void encode_detail(Writer& out, const PlayAction& action)
+{
+   out.put(action.index());
+   // an optional index is stored shifted by one, 0 meaning none
+   out.put(action.target_index().has_value() ? *action.target_index() + 1 : 0);
+   out.put(action.targets().has_value() ? action.targets()->size() + 1 : 0);
+   if(action.targets().has_value()) {
+      put_targets(out, *action.targets());
+   }
+}
+template < typename Writer >
+void encode_detail(Writer& out, const PlayRequestAction& action)
+{
+   out.put(action.index());
+}
+template < typename Writer >
+void encode_detail(Writer& out, const PlayFieldCardFinishAction& action)
+{
+   out.put(action.index().has_value() ? *action.index() + 1 : 0);
+}
+template < typename Writer >
+void encode_detail(Writer& out, const PlaySpellFinishAction& action)
+{
+   out.put(action.burst());
+}
+template < typename Writer >
+void encode_detail(Writer& out, const TargetingAction& action)
+{
+   out.put(action.targets().size());
+   put_targets(out, action.targets());
+}
+
+template < typename Container >
+sptr< Targetable > target_at(const Container& cards, size_t index)
+{
+   if(index >= cards.size() || cards[index] == nullptr) {
+      throw std::runtime_error("A logged target is not where it was in the game.");
+   }
+   return cards[index];
+}
+
+std::vector< sptr< Targetable > > decode_targets(
+   size_t n_targets,
+   GameLog::PayloadReader& in,
+   const GameState* state)
+{
+   std::vector< sptr< Targetable > > targets;
+   if(n_targets == 0) {
+      return targets;
+   }
+   // each target is its zone, team and index
+   if(n_targets > in.remaining() / 3) {
+      throw std::runtime_error("The game log is corrupt.");
+   }
+   if(state == nullptr) {
+      throw std::invalid_argument("The targets of a logged action are only found in its state.");
+   }
+   targets.reserve(n_targets);
+   for(size_t i = 0; i < n_targets; ++i) {
+      auto zone = TargetZone(in.next());
+      auto team_index = in.next();
+      auto index = in.next();
+      if(team_index > 1) {
+         throw std::runtime_error("The game log is corrupt.");
+      }
+      auto team = Team(team_index);
+      switch(zone) {
+         case TargetZone::NEXUS: {
+            // the nexus is owned by its player, so the pointer to it does not own anything
+            auto& nexus = const_cast< Nexus& >(state->player(team).nexus());
+            targets.emplace_back(sptr< Targetable >(sptr< Targetable >(), &nexus));
+            break;
+         }
+         case TargetZone::HAND:
+            targets.emplace_back(target_at(state->player(team).hand(), index));
+            break;
+         case TargetZone::CAMP:
+            targets.emplace_back(target_at(state->board().camp(team), index));
+            break;
+         case TargetZone::BATTLEFIELD:
+            targets.emplace_back(target_at(state->board().battlefield(team), index));
+            break;
+         case TargetZone::SPELL_STACK:
+            targets.emplace_back(target_at(state->spell_stack(), index));
+            break;
+         default:
+            throw std::runtime_error("The game log is corrupt.");
+      }
+   }
+   return targets;
+}
+
+template < typename DetailType >
+DetailType decode_detail(Team team, GameLog::PayloadReader& in, const GameState* state)
+{
+   if constexpr(std::is_same_v< DetailType, AcceptAction >
+                or std::is_same_v< DetailType, CancelAction >) {
+      return DetailType(team);
+   } else if constexpr(std::is_same_v< DetailType, ChoiceAction >) {
+      auto n_choices = in.next();
+      return ChoiceAction(team, n_choices, in.next());
+   } else if constexpr(std::is_same_v< DetailType, DragEnemyAction >) {
+      bool to_bf = in.next();
+      auto from = in.next();
+      return DragEnemyAction(team, to_bf, from, in.next());
+   } else if constexpr(std::is_same_v< DetailType, MulliganAction >) {
+      auto n_decisions = in.next();
+      auto mask = in.next();
+      // the decisions are the bits of the mask, no others are set
+      if(n_decisions > 64 || (n_decisions < 64 && (mask >> n_decisions) != 0)) {
+         throw std::runtime_error("The game log is corrupt.");
+      }
+      std::vector< bool > decisions(n_decisions);
+      for(size_t i = 0; i < n_decisions; ++i) {
+         decisions[i] = (mask >> i) & 1;
+      }
+      return MulliganAction(team, std::move(decisions));
+   } else if constexpr(std::is_same_v< DetailType, PlaceSpellAction >) {
+      auto index = in.next();
+      return PlaceSpellAction(team, index, in.next());
+   } else if constexpr(std::is_same_v< DetailType, PlaceUnitAction >) {
+      bool to_bf = in.next();
+      std::vector< size_t > indices(in.next_count());
+      for(auto& idx : indices) {
+         idx = in.next();
+      }
+      return PlaceUnitAction(team, to_bf, std::move(indices));
+   } else if constexpr(std::is_same_v< DetailType, PlayAction >) {
+      auto index = in.next();
+      auto target_index = in.next();
+      auto n_targets = in.next();
+      if(n_targets > 0) {
+         return PlayAction(team, index, decode_targets(n_targets - 1, in, state));
+      }
+      if(target_index > 0) {
+         return PlayAction(team, index, target_index - 1);
+      }
+      return PlayAction(team, index);
+   } else if constexpr(std::is_same_v< DetailType, PlayRequestAction >) {
+      return PlayRequestAction(team, in.next());
+   } else if constexpr(std::is_same_v< DetailType, PlayFieldCardFinishAction >) {
+      auto index = in.next();
+      return index > 0 ? PlayFieldCardFinishAction(team, index - 1)
+                       : PlayFieldCardFinishAction(team);
+   } else if constexpr(std::is_same_v< DetailType, PlaySpellFinishAction >) {
+      return PlaySpellFinishAction(team, in.next());
+   } else {
+      static_assert(std::is_same_v< DetailType, TargetingAction >, "Unhandled action type.");
+      auto n_targets = in.next();
+      return TargetingAction(team, decode_targets(n_targets, in, state));
+   }
+}
+
+template < size_t I = 0 >
+actions::Action decode_alternative(
+   size_t index,
+   Team team,
+   GameLog::PayloadReader& in,
+   const GameState* state)
+{
+   if constexpr(I < std::variant_size_v< ActionVariant >) {
+      if(index == I) {
+         return actions::Action(
+            decode_detail< std::variant_alternative_t< I, ActionVariant > >(team, in, state));
+      }
+      return decode_alternative< I + 1 >(index, team, in, state);
+   } else {
+      throw std::invalid_argument("Unknown action index " + std::to_string(index) + ".");
+   }
+}
+
+u64 read_u64(std::istream& in)
+{
+   u64 value = 0;
+   in.read(reinterpret_cast< char* >(&value), sizeof(u64));
+   if(not in) {
+      throw std::runtime_error("The game log is truncated.");
+   }
+   return value;
+}
+
+}  // namespace
+
+void GameLog::PayloadWriter::put(u64 value)
+{
+   if(size > max_payload_size) {
+      throw std::length_error("Record payload exceeds the maximum payload size.");
+   }
+   size += varint::encode(value, bytes + size);
+}
+
+void GameLog::append_action(size_t round, const actions::Action& action)
+{
+   _append_action(round, action, nullptr);
+}
+
+void GameLog::append_action(size_t round, const actions::Action& action, const GameState& state)
+{
+   _append_action(round, action, &state);
+}
+
+void GameLog::_append_action(size_t round, const actions::Action& action, const GameState* state)
+{
+   PayloadWriter payload;
+   ActionWriter< PayloadWriter > out{payload, state};
+   std::visit([&](const auto& detail) { encode_detail(out, detail); }, action.detail());
+   _append(
+      round, Kind::ACTION, static_cast< u8 >(action.detail().index()), action.team(), payload);
+}
+
+actions::Action GameLog::decode_action(const RecordView& record)
+{
+   return _decode_action(record, nullptr);
+}
+
+actions::Action GameLog::decode_action(const RecordView& record, const GameState& state)
+{
+   return _decode_action(record, &state);
+}
+
+actions::Action GameLog::_decode_action(const RecordView& record, const GameState* state)
+{
+   if(not record.is_action()) {
+      throw std::invalid_argument("The record is not an action record.");
+   }
+   auto reader = record.reader();
+   try {
+      auto action = decode_alternative(record.action_index(), record.team(), reader, state);
+      if(not reader.empty()) {
+         throw std::runtime_error("The action record has more payload than its action.");
+      }
+      return action;
+   } catch(const std::out_of_range&) {
+      // a varint ran past the payload
+      throw std::runtime_error("The action record's payload is truncated.");
+   }
+}
+
+GameLog::Range GameLog::records(size_t round) const
+{
+   if(round >= m_round_offsets.size()) {
+      return {end(), end()};
+   }
+   size_t last = round + 1 < m_round_offsets.size() ? m_round_offsets[round + 1] : m_bytes.size();
+   return {{this, m_round_offsets[round], round}, {this, last, round}};
+}
+
+void GameLog::clear()
+{
+   m_bytes.clear();
+   m_round_offsets.clear();
+   m_n_records = 0;
+}
+
+void GameLog::append(const RecordView& record)
+{
+   _append(record.round, *record.header, record.payload(), record.payload_size());
+}
+
+void GameLog::_append(size_t round, Header header, const u8* payload, size_t payload_size)
+{
+   if(payload_size > max_payload_size) {
+      throw std::length_error("Record payload exceeds the maximum payload size.");
+   }
+   // rounds without records begin where the next recorded round does
+   if(m_round_offsets.size() <= round) {
+      m_round_offsets.resize(round + 1, m_bytes.size());
+   }
+   header.size = static_cast< u8 >(payload_size);
+   auto offset = m_bytes.size();
+   m_bytes.resize(offset + sizeof(Header) + payload_size);
+   std::copy_n(reinterpret_cast< const u8* >(&header), sizeof(Header), m_bytes.data() + offset);
+   std::copy_n(payload, payload_size, m_bytes.data() + offset + sizeof(Header));
+   m_n_records += 1;
+}
+
+void GameLog::write(OutputSink& sink, size_t file) const
+{
+   SinkWriter out(sink, file);
+   out.put(static_cast< u64 >(m_level));
+   out.put(u64(m_n_records));
+   out.put(u64(m_round_offsets.size()));
+   out.put(u64(m_bytes.size()));
+   for(auto offset : m_round_offsets) {
+      out.put(u64(offset));
+   }
+   out.put(m_bytes.data(), m_bytes.size());
+   out.finish();
+}
+
+bool GameLog::_is_consistent() const
+{
+   if(not m_bytes.empty() && (m_round_offsets.empty() || m_round_offsets.front() != 0)) {
+      return false;
+   }
+   auto round = m_round_offsets.begin();
+   size_t n_records = 0;
+   size_t offset = 0;
+   while(offset < m_bytes.size()) {
+      // the offsets up to here have to be at this record boundary
+      while(round != m_round_offsets.end() && *round == offset) {
+         ++round;
+      }
+      if(round != m_round_offsets.end() && *round < offset) {
+         return false;
+      }
+      if(m_bytes.size() - offset < sizeof(Header)) {
+         return false;
+      }
+      Header header{};
+      std::memcpy(&header, m_bytes.data() + offset, sizeof(Header));
+      bool valid_label = header.kind == Kind::ACTION
+                            ? header.label < std::variant_size_v< ActionVariant >
+                            : header.kind == Kind::EVENT && header.label < events::n_events;
+      if(not valid_label || header.team > 1
+         || m_bytes.size() - offset - sizeof(Header) < header.size) {
+         return false;
+      }
+      offset += sizeof(Header) + header.size;
+      n_records += 1;
+   }
+   // the remaining rounds are empty ones at the end
+   return n_records == m_n_records
+          && std::all_of(round, m_round_offsets.end(), [&](size_t rest) {
+                return rest == m_bytes.size();
+             });
+}
+
+GameLog GameLog::read(std::istream& in)
+{
+   auto level = read_u64(in);
+   if(level > static_cast< u64 >(LogLevel::ACTIONS_AND_EVENTS)) {
+      throw std::runtime_error("The game log is corrupt.");
+   }
+   GameLog log(static_cast< LogLevel >(level));
+   auto n_records = read_u64(in);
+   auto n_rounds = read_u64(in);
+   auto n_bytes = read_u64(in);
+   // every record takes at least its header
+   if(n_records > n_bytes / sizeof(Header)) {
+      throw std::runtime_error("The game log is corrupt.");
+   }
+   // the sizes are not trusted with allocations, the containers grow by what is actually read
+   for(u64 round = 0; round < n_rounds; ++round) {
+      auto offset = read_u64(in);
+      if(offset > n_bytes || (round > 0 && offset < log.m_round_offsets.back())) {
+         throw std::runtime_error("The game log is corrupt.");
+      }
+      log.m_round_offsets.emplace_back(offset);
+   }
+   constexpr u64 chunk_size = u64(1) << 16;
+   while(log.m_bytes.size() < n_bytes) {
+      auto offset = log.m_bytes.size();
+      auto n_read = std::min(chunk_size, n_bytes - offset);
+      log.m_bytes.resize(offset + n_read);
+      in.read(reinterpret_cast< char* >(log.m_bytes.data() + offset), std::streamsize(n_read));
+      if(not in) {
+         throw std::runtime_error("The game log is truncated.");
+      }
+   }
+   log.m_n_records = n_records;
+   if(not log._is_consistent()) {
+      throw std::runtime_error("The game log is corrupt.");
+   }
+   return log;
+}
@@ -4,22 +4,89 @@
 
 #include <utils/algorithms.h>
 
+#include <unordered_map>
+
 #include "core/action.h"
 #include "core/logic.h"
 #include "events/lor_events/construction.h"
+#include "utils/profiler.h"
 
-void GameState::commit_to_history(uptr< Record >&& record)
-{
-   (*m_history)[m_round].emplace_back(std::move(record));
-}
+namespace {
+
+/**
+ * Clones each card once, however often it is referred to, so that the references among the
+ * clones mirror those among the originals.
+ */
+class CardCloner {
+  public:
+   template < typename CardType >
+   sptr< CardType > operator()(const sptr< CardType >& card)
+   {
+      if(card == nullptr) {
+         return nullptr;
+      }
+      auto& clone = m_clones[card.get()];
+      if(clone == nullptr) {
+         clone = sptr< Card >(card->clone());
+         m_pairs.emplace_back(card.get(), clone);
+      }
+      return std::static_pointer_cast< CardType >(clone);
+   }
+   /**
+    * Registers `clone` as the clone of `card`, e.g. one a player cloned along with its zones.
+    */
+   void insert(const sptr< Card >& card, const sptr< Card >& clone)
+   {
+      if(m_clones.emplace(card.get(), clone).second) {
+         m_pairs.emplace_back(card.get(), clone);
+      }
+   }
+   /**
+    * Points the grants and effects of every clone at the clones of the cards they refer to. A card
+    * that is referred to but was not cloned yet (e.g. the bestower of a grant that left the game)
+    * is cloned on the way and rebound as well.
+    */
+   void rebind()
+   {
+      for(size_t i = 0; i < m_pairs.size(); ++i) {
+         auto clone = m_pairs[i].second;
+         clone->rebind(clone, [this](const sptr< Card >& card) { return (*this)(card); });
+      }
+   }
+   /**
+    * Connects the effects of every clone to the events of `state` whose original effects were
+    * connected to the events of the copied state.
+    */
+   void reconnect(GameState& state) const
+   {
+      for(const auto& [original, clone] : m_pairs) {
+         auto& clone_effects = clone->effects();
+         for(const auto& [label, effects] : original->effects()) {
+            const auto& clones = clone_effects.at(label);
+            for(size_t i = 0; i < effects.size(); ++i) {
+               if(not effects[i]->subscribed_events().empty()) {
+                  clones[i]->connect(state.event(label));
+               }
+            }
+         }
+      }
+   }
+
+  private:
+   std::unordered_map< const Card*, sptr< Card > > m_clones;
+   // the originals and their clones in the order they were cloned
+   std::vector< std::pair< const Card*, sptr< Card > > > m_pairs;
+};
+
+}  // namespace
 
 void GameState::send_to_graveyard(const sptr< FieldCard >& unit)
 {
-   player(unit->mutables().owner).graveyard().at(m_round).emplace_back(unit);
+   player(unit->mutables().owner).graveyard().emplace_back(m_round, unit);
 }
 void GameState::send_to_spellyard(const sptr< Spell >& unit)
 {
-   player(unit->mutables().owner).spellyard().at(m_round).emplace_back(unit);
+   player(unit->mutables().owner).spellyard().emplace_back(m_round, unit);
 }
 void GameState::send_to_tossed(const sptr< Card >& card)
 {
@@ -49,12 +116,12 @@ GameState::GameState(
                 cfg.START_NEXUS_HEALTH,
                 cfg.PASSIVE_POWERS_BLUE,
                 cfg.NEXUS_KEYWORDS_BLUE),
-             decks[0],
+             std::move(decks[0]),
              std::move(controllers[0])),
           Player(
              Team(1),
              Nexus(Team(1), cfg.START_NEXUS_HEALTH, cfg.PASSIVE_POWERS_RED, cfg.NEXUS_KEYWORDS_RED),
-             decks[1],
+             std::move(decks[1]),
              std::move(controllers[1]))}),
       m_starting_team(starting_team),
       m_board(cfg.CAMP_SIZE, cfg.BATTLEFIELD_SIZE),
@@ -66,6 +133,11 @@ GameState::GameState(
       m_rng(rng)
 {
    m_logic->state(*this);
+   if(cfg.HAND_CARDS_LIMIT > hand_capacity || cfg.SPELL_STACK_LIMIT > spell_stack_capacity) {
+      throw std::invalid_argument(
+         "Configured limits exceed the zone capacities (hand: " + std::to_string(hand_capacity)
+         + ", spell stack: " + std::to_string(spell_stack_capacity) + ").");
+   }
 }
 
 GameState::GameState(
@@ -81,15 +153,100 @@ GameState::GameState(
        rng)
 {
 }
+void GameState::reset(SymArr< Deck > decks, Team starting_team, random::seed_type seed)
+{
+   LORAINE_PROFILE_SCOPE("GameState::reset");
+   m_logic->reset();
+   for(Team team : {Team::BLUE, Team::RED}) {
+      player(team).reset(std::move(decks[team]), m_config.START_NEXUS_HEALTH);
+      m_grant_factory[team].clear_modifiers();
+   }
+   m_board.clear();
+   m_auras.clear();
+   m_timers.clear();
+   m_buffer.play.reset();
+   m_buffer.bf.clear();
+   m_buffer.spell.clear();
+   m_buffer.targeting.clear();
+   m_buffer.choice.clear();
+   m_buffer.action.clear();
+   m_spell_stack.clear();
+   m_log.clear();
+   m_card_arena.reset();
+   m_ids.reset();
+   m_starting_team = starting_team;
+   m_attacker = starting_team;
+   m_turn = starting_team;
+   m_round = 0;
+   m_status = Status::ONGOING;
+   m_rng.seed(seed);
+}
+const sptr< Arena >& GameState::card_arena()
+{
+   if(m_card_arena == nullptr) {
+      m_card_arena = make_arena();
+   }
+   return m_card_arena;
+}
 GameState::GameState(const GameState& other)
     : m_config(other.m_config),
-      m_players(other.m_players),
+      m_ids(other.m_ids),
+      m_players(uuids::Pool::with(m_ids, [&other] { return other.m_players; })),
       m_events(events::build_event_array()),
       m_starting_team(other.m_starting_team),
       m_board(other.m_board),
       m_logic(other.m_logic->clone()),
-      m_round(other.m_round)
+      m_attacker(other.m_attacker),
+      m_turn(other.m_turn),
+      m_round(other.m_round),
+      m_status(other.m_status),
+      m_spell_stack(other.m_spell_stack),
+      m_grant_factory(other.m_grant_factory),
+      m_auras(other.m_auras),
+      m_timers(other.m_timers),
+      m_log(other.m_log.level()),
+      m_rng(other.m_rng),
+      m_card_factory(other.m_card_factory)
 {
-   // TODO: this needs to fully reconnect all cloned event listeners with the correct events
+   // times cloning the cards, the member copies above are profiled where copies are taken (e.g.
+   // by the ReplayPlayer)
+   LORAINE_PROFILE_SCOPE("GameState::copy");
+   m_logic->state(*this);
+   uuids::Pool::Scope ids(m_ids);
+   // the cards on the board and the stack are shared with the timers and auras, so they are
+   // cloned together. The players clone the cards in their hands, decks and yards themselves,
+   // those clones are registered, so that grants and timers referring to them map to them too.
+   CardCloner clone;
+   for(Team team : {Team::BLUE, Team::RED}) {
+      const auto& original = other.player(team);
+      auto& copy = player(team);
+      auto register_zone = [&clone](const auto& originals, const auto& clones, auto card_of) {
+         for(size_t i = 0; i < originals.size(); ++i) {
+            clone.insert(card_of(originals[i]), card_of(clones[i]));
+         }
+      };
+      auto as_is = [](const auto& card) -> sptr< Card > { return card; };
+      auto yard_card = [](const auto& entry) -> sptr< Card > { return entry.second; };
+      register_zone(original.hand(), copy.hand(), as_is);
+      register_zone(original.deck(), copy.deck(), as_is);
+      register_zone(original.tossed_cards(), copy.tossed_cards(), as_is);
+      register_zone(original.graveyard(), copy.graveyard(), yard_card);
+      register_zone(original.spellyard(), copy.spellyard(), yard_card);
+   }
+   for(Team team : {Team::BLUE, Team::RED}) {
+      for(auto& card : m_board.camp(team)) {
+         card = clone(card);
+      }
+      for(auto& unit : m_board.battlefield(team)) {
+         unit = clone(unit);
+      }
+   }
+   for(auto& spell : m_spell_stack) {
+      spell = clone(spell);
+   }
+   m_auras.rebind(clone);
+   m_timers.rebind(clone);
+   clone.rebind();
+   clone.reconnect(*this);
 }
 
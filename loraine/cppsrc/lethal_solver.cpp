@@ -0,0 +1,420 @@
+
+#include "search/lethal_solver.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "cards/card.h"
+#include "core/gamestate.h"
+
+namespace {
+
+enum CombatFlag : u16 {
+   ELUSIVE = 1 << 0,
+   FEARSOME = 1 << 1,
+   CANT_BLOCK = 1 << 2,
+   OVERWHELM = 1 << 3,
+   CHALLENGER = 1 << 4,
+   TOUGH = 1 << 5,
+};
+
+constexpr long infinity = std::numeric_limits< long >::max() / 4;
+// the minimum power a unit needs to block a FEARSOME attacker
+constexpr long fearsome_block_power = 3;
+// deadline checks are amortized over this many nodes
+constexpr size_t time_check_interval = 64;
+
+u16 combat_flags(const Unit& unit)
+{
+   u16 flags = 0;
+   flags |= unit.has_keyword(Keyword::ELUSIVE) ? ELUSIVE : 0;
+   flags |= unit.has_keyword(Keyword::FEARSOME) ? FEARSOME : 0;
+   flags |= unit.has_keyword(Keyword::CANT_BLOCK) ? CANT_BLOCK : 0;
+   flags |= unit.has_keyword(Keyword::OVERWHELM) ? OVERWHELM : 0;
+   flags |= unit.has_keyword(Keyword::CHALLENGER) ? CHALLENGER : 0;
+   flags |= unit.has_keyword(Keyword::TOUGH) ? TOUGH : 0;
+   return flags;
+}
+
+}  // namespace
+
+using utils::hash_combine;
+
+LethalSolver::LethalSolver(
+   std::chrono::microseconds budget,
+   size_t tt_size_log2,
+   size_t cache_capacity)
+    : m_budget(budget), m_tt(size_t(1) << tt_size_log2), m_cache_capacity(cache_capacity)
+{
+}
+
+LethalSolver::Result LethalSolver::solve(const GameState& state)
+{
+   return solve(state, state.active_team());
+}
+
+LethalSolver::Result LethalSolver::solve(const GameState& state, Team attacker)
+{
+   Result result{};
+   Team defender = opponent(attacker);
+   if(not state.player(attacker).flags().attack_token) {
+      // without the attack token there is no combat and thus no lethal this round
+      return result;
+   }
+   const auto& board = state.board();
+   const long nexus_health = state.player(defender).nexus().health();
+   const size_t lanes = std::min(board.max_size_bf(), max_lanes);
+
+   m_attackers.clear();
+   m_blockers.clear();
+   const auto& camp_att = board.camp(attacker);
+   for(size_t i = 0; i < camp_att.size() && m_attackers.size() < lanes; ++i) {
+      const auto& card = camp_att[i];
+      if(not card->is_unit()) {
+         continue;
+      }
+      auto unit = to_unit(card);
+      if(not unit->unit_mutables().alive or unit->has_keyword(Keyword::STUN)) {
+         continue;
+      }
+      m_attackers.emplace_back(Fighter{
+         long(unit->power()), long(unit->health()), combat_flags(*unit), i});
+   }
+   const auto& camp_def = board.camp(defender);
+   for(size_t i = 0; i < camp_def.size() && m_blockers.size() < max_lanes; ++i) {
+      const auto& card = camp_def[i];
+      if(not card->is_unit()) {
+         continue;
+      }
+      auto unit = to_unit(card);
+      if(not unit->unit_mutables().alive) {
+         continue;
+      }
+      auto flags = combat_flags(*unit);
+      if(unit->has_keyword(Keyword::STUN)) {
+         // stunned units can still be dragged into combat, but not declared as blockers
+         flags |= CANT_BLOCK;
+      }
+      m_blockers.emplace_back(Fighter{long(unit->power()), long(unit->health()), flags, i});
+   }
+   // move ordering: the strongest attackers are placed in the first lanes, so that the defender's
+   // most damaging refutations are found early
+   std::stable_sort(
+      m_attackers.begin(), m_attackers.end(), [](const Fighter& f1, const Fighter& f2) {
+         return f1.power > f2.power;
+      });
+
+   // combat predictor: not even an unblocked attack of everything can reach the nexus
+   long max_damage = 0;
+   for(const auto& fighter : m_attackers) {
+      max_damage += fighter.power;
+   }
+   auto fill_attackers = [&](Line& line) {
+      line.attackers.clear();
+      for(const auto& fighter : m_attackers) {
+         line.attackers.emplace_back(fighter.camp_index);
+      }
+      line.challenged.assign(m_attackers.size(), std::nullopt);
+   };
+   if(max_damage < nexus_health || m_attackers.empty()) {
+      fill_attackers(result.line);
+      result.line.guaranteed_damage = m_blockers.empty() ? max_damage : 0;
+      return result;
+   }
+
+   const u64 board_hash = _board_hash(nexus_health);
+   if(auto cached = m_cache.find(board_hash); cached != m_cache.end()) {
+      result = cached->second;
+      result.nodes = 0;
+      return result;
+   }
+
+   m_forced.fill(no_blocker);
+   m_nodes = 0;
+   m_aborted = false;
+   m_deadline = std::chrono::steady_clock::now() + m_budget;
+   // the transposition keys only encode the position within this solve, so every solve
+   // invalidates the table by moving on to the next generation
+   if(++m_generation == 0) {
+      std::fill(m_tt.begin(), m_tt.end(), TTEntry{});
+      m_generation = 1;
+   }
+
+   // null window search: is the attacker's value at least the nexus health?
+   long value = _max_node(0, 0, nexus_health - 1, nexus_health);
+   result.lethal = not m_aborted && value >= nexus_health;
+
+   // extract the line by fixing the CHALLENGER drags lane by lane. A drag that keeps the verdict
+   // is always found, since the verdict was reached by one of them.
+   fill_attackers(result.line);
+   u32 used = 0;
+   for(size_t lane = 0; lane < m_attackers.size() && not m_aborted; ++lane) {
+      if(not (m_attackers[lane].flags & CHALLENGER)) {
+         continue;
+      }
+      i8 chosen = no_blocker;
+      long best = -infinity;
+      for(i8 b = 0; b < i8(m_blockers.size()); ++b) {
+         if(used & (1U << u32(b))) {
+            continue;
+         }
+         m_forced[lane] = b;
+         long v = result.lethal ? _max_node(lane + 1, used | (1U << u32(b)), nexus_health - 1,
+                                            nexus_health)
+                                : _max_node(lane + 1, used | (1U << u32(b)), -infinity, infinity);
+         if(v > best) {
+            best = v;
+            chosen = b;
+         }
+         if(result.lethal && v >= nexus_health) {
+            break;
+         }
+      }
+      m_forced[lane] = no_blocker;
+      long v_free = _max_node(lane + 1, used, -infinity, infinity);
+      if(not result.lethal || best < nexus_health) {
+         if(v_free >= best) {
+            chosen = no_blocker;
+         }
+      }
+      m_forced[lane] = chosen;
+      if(chosen != no_blocker) {
+         used |= 1U << u32(chosen);
+         result.line.challenged[lane] = m_blockers[size_t(chosen)].camp_index;
+      }
+   }
+   result.line.guaranteed_damage = m_aborted ? 0 : _search_min_exact();
+   result.complete = not m_aborted;
+   result.nodes = m_nodes;
+
+   if(result.complete) {
+      if(m_cache.size() >= m_cache_capacity) {
+         m_cache.clear();
+      }
+      m_cache.emplace(board_hash, result);
+   }
+   return result;
+}
+
+long LethalSolver::_max_node(size_t lane, u32 used, long alpha, long beta)
+{
+   // skip ahead to the next attacker whose drag is still undecided
+   while(lane < m_attackers.size()
+         && (not (m_attackers[lane].flags & CHALLENGER) || m_forced[lane] != no_blocker)) {
+      ++lane;
+   }
+   if(lane >= m_attackers.size()) {
+      return _min_node(0, used, alpha, beta);
+   }
+   if(_out_of_time()) {
+      return -infinity;
+   }
+   const u64 key = _tt_key(true, lane, used);
+   long value;
+   const long alpha_orig = alpha;
+   const long beta_orig = beta;
+   if(_tt_probe(key, alpha, beta, value)) {
+      return value;
+   }
+
+   // move ordering: dragging the weakest blockers leaves the strongest ones unused, while dragging
+   // the units able to stop ELUSIVE attackers removes the most important blockers
+   std::array< i8, max_lanes + 1 > moves{};
+   size_t n_moves = 0;
+   for(i8 b = 0; b < i8(m_blockers.size()); ++b) {
+      if(not (used & (1U << u32(b)))) {
+         moves[n_moves++] = b;
+      }
+   }
+   std::sort(moves.begin(), moves.begin() + long(n_moves), [&](i8 b1, i8 b2) {
+      const auto& f1 = m_blockers[size_t(b1)];
+      const auto& f2 = m_blockers[size_t(b2)];
+      bool e1 = f1.flags & ELUSIVE;
+      bool e2 = f2.flags & ELUSIVE;
+      if(e1 != e2) {
+         return e1;
+      }
+      return f1.health < f2.health;
+   });
+   moves[n_moves++] = no_blocker;
+
+   long best = -infinity;
+   for(size_t m = 0; m < n_moves; ++m) {
+      i8 b = moves[m];
+      m_forced[lane] = b;
+      u32 next_used = b == no_blocker ? used : used | (1U << u32(b));
+      long v = _max_node(lane + 1, next_used, alpha, beta);
+      m_forced[lane] = no_blocker;
+      best = std::max(best, v);
+      alpha = std::max(alpha, best);
+      if(alpha >= beta) {
+         break;
+      }
+   }
+   if(not m_aborted) {
+      _tt_store(key, best, alpha_orig, beta_orig);
+   }
+   return best;
+}
+
+long LethalSolver::_min_node(size_t lane, u32 used, long alpha, long beta)
+{
+   if(lane >= m_attackers.size()) {
+      return 0;
+   }
+   const auto& attacker = m_attackers[lane];
+   if(auto forced = m_forced[lane]; forced != no_blocker) {
+      long dmg = _lane_damage(attacker, &m_blockers[size_t(forced)]);
+      return dmg + _min_node(lane + 1, used, alpha - dmg, beta - dmg);
+   }
+   if(_out_of_time()) {
+      return infinity;
+   }
+   const u64 key = _tt_key(false, lane, used);
+   long value;
+   const long alpha_orig = alpha;
+   const long beta_orig = beta;
+   if(_tt_probe(key, alpha, beta, value)) {
+      return value;
+   }
+
+   // move ordering: the blocks preventing the most damage come first, not blocking comes last
+   std::array< std::pair< long, i8 >, max_lanes + 1 > moves{};
+   size_t n_moves = 0;
+   for(i8 b = 0; b < i8(m_blockers.size()); ++b) {
+      const auto& blocker = m_blockers[size_t(b)];
+      if(not (used & (1U << u32(b))) && _can_block(attacker, blocker)) {
+         moves[n_moves++] = {_lane_damage(attacker, &blocker), b};
+      }
+   }
+   std::stable_sort(moves.begin(), moves.begin() + long(n_moves));
+   moves[n_moves++] = {_lane_damage(attacker, nullptr), no_blocker};
+
+   long best = infinity;
+   for(size_t m = 0; m < n_moves; ++m) {
+      auto [dmg, b] = moves[m];
+      u32 next_used = b == no_blocker ? used : used | (1U << u32(b));
+      long v = dmg + _min_node(lane + 1, next_used, alpha - dmg, beta - dmg);
+      best = std::min(best, v);
+      beta = std::min(beta, best);
+      if(alpha >= beta) {
+         break;
+      }
+   }
+   if(not m_aborted) {
+      _tt_store(key, best, alpha_orig, beta_orig);
+   }
+   return best;
+}
+
+long LethalSolver::_search_min_exact()
+{
+   return _min_node(0, [&] {
+      u32 used = 0;
+      for(auto forced : m_forced) {
+         if(forced != no_blocker) {
+            used |= 1U << u32(forced);
+         }
+      }
+      return used;
+   }(), -infinity, infinity);
+}
+
+bool LethalSolver::_can_block(const Fighter& attacker, const Fighter& blocker) const
+{
+   if(blocker.flags & CANT_BLOCK) {
+      return false;
+   }
+   if((attacker.flags & ELUSIVE) && not (blocker.flags & ELUSIVE)) {
+      return false;
+   }
+   if((attacker.flags & FEARSOME) && blocker.power < fearsome_block_power) {
+      return false;
+   }
+   return true;
+}
+
+long LethalSolver::_lane_damage(const Fighter& attacker, const Fighter* blocker) const
+{
+   if(blocker == nullptr) {
+      return attacker.power;
+   }
+   if(not (attacker.flags & OVERWHELM) || attacker.power <= 0) {
+      return 0;
+   }
+   // mirrors Unit::take_damage: TOUGH reduces the damage before it is taken, the surplus of the
+   // strike over the damage taken goes through to the nexus.
+   long dmg = attacker.power - ((blocker->flags & TOUGH) ? 1 : 0);
+   long taken = std::clamp(dmg, 0L, blocker->health);
+   return attacker.power - taken;
+}
+
+u64 LethalSolver::_tt_key(bool max_phase, size_t lane, u32 used) const
+{
+   // the key is an exact encoding of the node: phase (1 bit), lane (3 bits), used blockers
+   // (6 bits) and the forced blocker of every lane (3 bits each)
+   u64 key = u64(max_phase) | (u64(lane) << 1) | (u64(used) << 4);
+   for(size_t l = 0; l < max_lanes; ++l) {
+      key |= u64(u8(m_forced[l] + 1) & 0x7) << (10 + 3 * l);
+   }
+   return key;
+}
+
+bool LethalSolver::_tt_probe(u64 key, long& alpha, long& beta, long& value) const
+{
+   const auto& entry = m_tt[key * 0x9e3779b97f4a7c15ULL >> 17 & (m_tt.size() - 1)];
+   if(entry.generation != m_generation || entry.key != key) {
+      return false;
+   }
+   switch(entry.bound) {
+      case Bound::EXACT: value = entry.value; return true;
+      case Bound::LOWER: alpha = std::max(alpha, entry.value); break;
+      case Bound::UPPER: beta = std::min(beta, entry.value); break;
+   }
+   if(alpha >= beta) {
+      value = entry.value;
+      return true;
+   }
+   return false;
+}
+
+void LethalSolver::_tt_store(u64 key, long value, long alpha, long beta)
+{
+   auto& entry = m_tt[key * 0x9e3779b97f4a7c15ULL >> 17 & (m_tt.size() - 1)];
+   entry.key = key;
+   entry.generation = m_generation;
+   entry.value = value;
+   if(value <= alpha) {
+      entry.bound = Bound::UPPER;
+   } else if(value >= beta) {
+      entry.bound = Bound::LOWER;
+   } else {
+      entry.bound = Bound::EXACT;
+   }
+}
+
+bool LethalSolver::_out_of_time()
+{
+   if(m_aborted) {
+      return true;
+   }
+   if(++m_nodes % time_check_interval == 0 && std::chrono::steady_clock::now() > m_deadline) {
+      m_aborted = true;
+   }
+   return m_aborted;
+}
+
+u64 LethalSolver::_board_hash(long nexus_health) const
+{
+   u64 seed = hash_combine(u64(nexus_health), m_attackers.size());
+   for(const auto& fighters : {&m_attackers, &m_blockers}) {
+      for(const auto& fighter : *fighters) {
+         seed = hash_combine(seed, u64(fighter.power));
+         seed = hash_combine(seed, u64(fighter.health));
+         seed = hash_combine(seed, fighter.flags);
+         seed = hash_combine(seed, fighter.camp_index);
+      }
+      seed = hash_combine(seed, 0xff);
+   }
+   return seed;
+}
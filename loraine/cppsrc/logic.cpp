@@ -1,23 +1,38 @@
 #include "core/logic.h"
 
+#include "cards/card_pool.h"
+#include "cards/cardfactory.h"
 #include "core/action.h"
 #include "core/gamestate.h"
 
 Logic::Logic(const Logic& other)
     : m_state(other.m_state),
       m_action_invoker(other.m_action_invoker->clone()),
-      m_prev_action_invoker(other.m_prev_action_invoker->clone())
+      m_prev_action_invoker(
+         other.m_prev_action_invoker == nullptr ? nullptr : other.m_prev_action_invoker->clone())
 {
+   // the cloned invokers still point to the logic they were cloned from
+   m_action_invoker->logic(this);
+   if(m_prev_action_invoker != nullptr) {
+      m_prev_action_invoker->logic(this);
+   }
 }
 
 void Logic::request_action() const
 {
-   m_state->buffer().action.emplace_back(
-      std::make_shared< actions::Action >(std::move(m_action_invoker->request_action(*state()))));
+   LORAINE_PROFILE_SCOPE("Logic::request_action");
+   LORAINE_ALLOC_PHASE("Logic::request_action");
+   auto& action = m_state->buffer().action.emplace_back(m_action_invoker->request_action(*state()));
+   // the decisions are logged, the actions they queue in turn follow from them
+   if(auto& log = m_state->history(); log.logs_actions()) {
+      log.append_action(m_state->round(), action, *m_state);
+   }
 }
 
 void Logic::cast(bool burst)
 {
+   LORAINE_PROFILE_SCOPE("Logic::cast");
+   LORAINE_ALLOC_PHASE("Logic::cast");
    auto& spell_stack = m_state->spell_stack();
    while(not spell_stack.empty()) {
       auto spell = spell_stack.back();
@@ -30,15 +45,29 @@ void Logic::cast(bool burst)
 }
 Status Logic::step()
 {
-   _start_round();
+   LORAINE_PROFILE_SCOPE("Logic::step");
+   LORAINE_ALLOC_PHASE("Logic::step");
+   uuids::Pool::Scope ids(m_state->ids());
+   Team active_team = m_state->active_team();
+   auto& flags = m_state->player(active_team).flags();
+   flags.has_played = false;
+   // a player who has passed before needs to pass anew to end the round
+   reset_pass(active_team);
    bool flip_initiative = false;
-   m_state->player(m_state->active_team()).flags().has_played = false;
    while(not flip_initiative) {
       request_action();
       flip_initiative = invoke_actions();
    }
-   if(m_state->player(Team::BLUE).flags().pass && m_state->player(Team::RED).flags().pass) {
+   if(not flags.pass) {
+      // anything but passing revokes the opponent's pass
+      reset_pass(opponent(active_team));
+   } else if(m_state->player(opponent(active_team)).flags().pass) {
       _end_round();
+      if(check_status() == Status::ONGOING) {
+         // the new round hands the initiative to the new attacker
+         _start_round();
+      }
+      return check_status();
    }
    m_state->turn() += 1;
    return check_status();
@@ -54,10 +83,18 @@ void Logic::place_in_camp(const sptr< FieldCard >& card, const std::optional< si
    auto& camp = m_state->board().camp(card->mutables().owner);
    if(utils::has_value(replaces)) {
       size_t replace_idx = replaces.value();
-      obliterate(camp[replace_idx]);
-      camp[replace_idx] = card;
+      // obliterating removes the replaced card from the camp
+      auto replaced = camp.at(replace_idx);
+      obliterate(replaced);
+      camp.insert(std::next(camp.begin(), replace_idx), card);
+      card->move(Location::CAMP, replace_idx);
    } else {
       camp.emplace_back(card);
+      card->move(Location::CAMP, camp.size() - 1);
+   }
+   if(card->is_unit()) {
+      m_state->auras().enter(to_unit(card));
+      _schedule_keyword_timers(to_unit(card));
    }
 }
 void Logic::_trigger_daybreak_if(const sptr< Card >& card)
@@ -79,27 +116,84 @@ void Logic::_trigger_nightfall_if(const sptr< Card >& card)
    }
 }
 
+void Logic::start_game()
+{
+   LORAINE_PROFILE_SCOPE("Logic::start_game");
+   LORAINE_ALLOC_PHASE("Logic::start_game");
+   uuids::Pool::Scope ids(m_state->ids());
+   for(Team team : {Team::BLUE, Team::RED}) {
+      random::shuffle_inplace(m_state->player(team).deck(), m_state->rng());
+      for(size_t i = 0; i < m_state->config().INITIAL_HAND_SIZE; ++i) {
+         draw_card(team);
+      }
+   }
+   // no mulligan is offered yet, the starting hands are kept as drawn
+   transition< DefaultModeInvoker >();
+   _start_round();
+}
+
+void Logic::reset()
+{
+   for(Team team : {Team::BLUE, Team::RED}) {
+      auto& player = m_state->player(team);
+      for(const auto& card : player.hand()) {
+         unsubscribe_effects(card);
+      }
+      for(const auto& card : player.deck()) {
+         unsubscribe_effects(card);
+      }
+      for(const auto& card : m_state->board().camp(team)) {
+         unsubscribe_effects(card);
+      }
+      for(const auto& unit : m_state->board().battlefield(team)) {
+         if(unit != nullptr) {
+            unsubscribe_effects(unit);
+         }
+      }
+   }
+   for(const auto& spell : m_state->spell_stack()) {
+      unsubscribe_effects(spell);
+   }
+   _retire(std::move(m_prev_action_invoker));
+   if(m_action_invoker->label() != MulliganModeInvoker::invoker_label) {
+      _retire(std::move(m_action_invoker));
+      if(auto& spare = m_spare_invokers[MulliganModeInvoker::invoker_label]; spare != nullptr) {
+         m_action_invoker = std::move(spare);
+      } else {
+         m_action_invoker = std::make_unique< MulliganModeInvoker >(this);
+      }
+   }
+}
+
 void Logic::_start_round()
 {
+   LORAINE_PROFILE_SCOPE("Logic::_start_round");
+   LORAINE_ALLOC_PHASE("Logic::_start_round");
    auto& round = m_state->round();
    round += 1;
+   // the attack token alternates between the teams, beginning with the starting team
+   Team attacker = Team((m_state->starting_team() + round - 1) % n_teams);
    for(Team team : {Team::RED, Team::BLUE}) {
       auto& flags = m_state->player(team).flags();
       flags.plunder_token = false;
       flags.is_daybreak = true;
       flags.is_nightfall = false;
-      flags.attack_token = false;
+      flags.attack_token = team == attacker;
       flags.scout_token = false;
       reset_pass(team);
-      auto& mana = m_state->player(team).mana();
-      give_managems(Team(team));
-      refill_mana(BLUE, false);
+      if(m_state->player(team).mana().gems < m_state->config().MAX_MANA) {
+         give_managems(team);
+      }
+      refill_mana(team, true);
+   }
+   m_state->attacker(attacker);
+   if(m_state->active_team() != attacker) {
+      // the attacker holds the initiative at the start of the round
+      m_state->turn() += 1;
    }
 
-   Team active_team = Team(m_state->starting_team() + round % 2);
-   m_state->attacker(active_team);
-
-   trigger_event< events::EventLabel::ROUND_START >(m_state->active_team(), round);
+   _fire_timers(RoundPhase::START);
+   trigger_event< events::EventLabel::ROUND_START >(attacker, round);
 
    draw_card(BLUE);
    draw_card(RED);
@@ -116,6 +210,8 @@ void Logic::refill_mana(Team team, bool normal_mana)
 
 void Logic::draw_card(Team team)
 {
+   LORAINE_PROFILE_SCOPE("Logic::draw_card");
+   LORAINE_ALLOC_PHASE("Logic::draw_card");
    auto& deck = m_state->player(team).deck();
    if(deck.empty()) {
       _set_status(Status::win(opponent(team), false));
@@ -127,11 +223,53 @@ void Logic::draw_card(Team team)
    if(auto& hand = m_state->player(team).hand();
       hand.size() < m_state->config().HAND_CARDS_LIMIT) {
       hand.emplace_back(card_drawn);
+      card_drawn->move(Location::HAND, hand.size() - 1);
    } else {
       obliterate(card_drawn);
    }
 }
 
+sptr< Card > Logic::create(Team team, const char* card_code)
+{
+   uuids::Pool::Scope ids(m_state->ids());
+   return _card_factory().create(card_code, team, m_state->card_arena());
+}
+
+sptr< Card > Logic::create_random(Team team, const CardQuery& query)
+{
+   const auto* entry = query.sample(m_state->rng());
+   if(entry == nullptr) {
+      return nullptr;
+   }
+   uuids::Pool::Scope ids(m_state->ids());
+   return _card_factory().create(
+      query.pool().catalog().string(entry->code), team, m_state->card_arena());
+}
+
+sptr< Card > Logic::copy(const sptr< Card >& card, bool exact_copy)
+{
+   uuids::Pool::Scope ids(m_state->ids());
+   if(exact_copy) {
+      auto copy = CardFactory::clone(*card, m_state->card_arena());
+      // the copied temporary grants expire at the end of the round as the original's do
+      for(const auto& grant : copy->mutables().grants_temp) {
+         m_state->timers().schedule(
+            {m_state->round(), RoundPhase::END, TimerWheel::Kind::EXPIRE_GRANT, copy, grant});
+      }
+      return copy;
+   }
+   return _card_factory().create(
+      card->immutables().code, card->mutables().owner, m_state->card_arena());
+}
+
+const CardFactory& Logic::_card_factory() const
+{
+   if(m_state->card_factory() == nullptr) {
+      throw std::logic_error("The game state has no card factory to create cards with.");
+   }
+   return *m_state->card_factory();
+}
+
 void Logic::give_managems(Team team, long amount)
 {
    m_state->player(team).mana().gems += amount;
@@ -213,21 +351,17 @@ void Logic::process_camp_queue(Team team)
 
 Status Logic::check_status()
 {
-   const auto& cfg = m_state->config();
-   if(m_state->round() > cfg.MAX_ROUNDS) {
-      m_state->m_status = Status::TIE;
-   }
-   auto& player_blue = m_state->player(Team::BLUE);
-   auto& player_red = m_state->player(Team::RED);
-   if(player_blue.nexus().health() < 1) {
-      if(player_red.nexus().health() < 1) {
-         _set_status(Status::TIE);
-      }
+   bool blue_dead = m_state->player(Team::BLUE).nexus().health() < 1;
+   bool red_dead = m_state->player(Team::RED).nexus().health() < 1;
+   if(blue_dead && red_dead) {
+      _set_status(Status::TIE);
+   } else if(blue_dead) {
       _set_status(Status::RED_WINS_NEXUS);
-   } else if(player_red.nexus().health() < 1) {
+   } else if(red_dead) {
       _set_status(Status::BLUE_WINS_NEXUS);
+   } else if(m_state->round() > m_state->config().MAX_ROUNDS) {
+      _set_status(Status::TIE);
    }
-   _set_status(Status::ONGOING);
    return m_state->m_status;
 }
 
@@ -247,26 +381,29 @@ void Logic::reset_pass()
 void Logic::_set_status(Status status)
 {
    if(m_state->m_status == Status::ONGOING) {
-      // once the status is set to anything but ongoing, it is frozen
+      // once the status is set to anything but ongoing, it is frozen (and thus marked checked)
       m_state->m_status = status;
    }
-   m_state->status().mark_checked();
 }
 bool Logic::invoke_actions()
 {
+   LORAINE_PROFILE_SCOPE("Logic::invoke_actions");
+   LORAINE_ALLOC_PHASE("Logic::invoke_actions");
    auto& action_buffer = m_state->buffer().action;
    bool flip_initiative = true;
    while(not action_buffer.empty()) {
-      auto& action = action_buffer.back();
-      m_state->commit_to_history(std::make_unique< ActionRecord >(action));
-      flip_initiative = m_action_invoker->invoke(*action);
+      // take the action off the buffer first, since executing it may queue follow-up actions
+      auto action = std::move(action_buffer.back());
       action_buffer.pop_back();
+      flip_initiative = m_action_invoker->invoke(action);
    }
    return flip_initiative;
 }
 
 void Logic::resolve()
 {
+   LORAINE_PROFILE_SCOPE("Logic::resolve");
+   LORAINE_ALLOC_PHASE("Logic::resolve");
    // cast all the spells on the spell stack first
    cast(false);
    // then process the combat if necessary
@@ -289,7 +426,11 @@ void Logic::resolve()
             break;
          }
          auto unit_att = bf_att.at(pos);
-         auto unit_def = bf_def.at(pos);
+         if(not utils::has_value(unit_att)) {
+            continue;
+         }
+         // the defender's battlefield is only as long as its rightmost blocker
+         auto unit_def = pos < bf_def.size() ? bf_def[pos] : nullptr;
 
          if(utils::has_value(unit_def)) {
             if(unit_def->unit_mutables().alive) {
@@ -299,10 +440,7 @@ void Logic::resolve()
                if(quick_attacks || double_attacks) {
                   // first the attacker hits the defender, any surplus is potential overwhelm_if dmg
                   overwhelm_if(unit_att, strike(unit_att, unit_def));
-                  // check whether to kill defending unit
-                  if(unit_def->health() == 0) {
-                     kill_unit(unit_def, unit_att);
-                  }
+                  // the strike killed the defender if it had no health left
                   if(unit_def->unit_mutables().alive) {
                      if(double_attacks) {
                         // a double attacking unit attacks again after a quick attack
@@ -316,14 +454,9 @@ void Logic::resolve()
                   overwhelm_if(unit_att, strike_mutually(unit_att, unit_def)[0]);
                }
 
-               // check whether to kill the attacking unit
-               if(unit_att->health() == 0) {
-                  kill_unit(unit_att, unit_att);
-               }
-               // check whether to kill defending unit
-               if(unit_def->health() == 0) {
-                  kill_unit(unit_def, unit_att);
-               }
+               // check whether to kill the units (a single strike has already killed)
+               _kill_if_dead(unit_att, unit_att);
+               _kill_if_dead(unit_def, unit_att);
             } else {
                // if the blocking unit is already dead, the attacker could still overwhelm
                overwhelm_if(unit_att, unit_att->power());
@@ -333,10 +466,9 @@ void Logic::resolve()
             // strikes the nexus
             strike_nexus(unit_att, unit_att->power());
          }
-
-         retreat_to_camp(attacker);
-         retreat_to_camp(defender);
       }
+      retreat_to_camp(attacker);
+      retreat_to_camp(defender);
    }
    transition< DefaultModeInvoker >();
 }
@@ -354,26 +486,25 @@ SymArr< long > Logic::strike_mutually(const sptr< Unit >& unit1, sptr< Unit >& u
 {
    SymArr< long > dmg_taken{0, 0};
    SymArr< long > surplus_dmg{0, 0};
-   std::function< void() > trigger_strike_1 = [&]() {
-      trigger_event< events::EventLabel::STRIKE >(unit1->mutables().owner, unit1, unit2);
-   };
-   std::function< void() > trigger_strike_2 = [&]() {
-      trigger_event< events::EventLabel::STRIKE >(unit2->mutables().owner, unit2, unit1);
-   };
+   // the strike events are only triggered once both units have struck
+   bool strikes_1 = false;
+   bool strikes_2 = false;
    if(auto dmg = unit1->power(); dmg > 0) {
       dmg_taken[0] = unit2->take_damage(unit1, dmg);
       surplus_dmg[0] = dmg - dmg_taken[0];
-   } else {
-      trigger_strike_1 = []() {};
+      strikes_1 = true;
    }
    if(auto dmg = unit2->power(); dmg > 0) {
       dmg_taken[1] = unit1->take_damage(unit2, dmg);
       surplus_dmg[1] = dmg - dmg_taken[1];
-   } else {
-      trigger_strike_2 = []() {};
+      strikes_2 = true;
+   }
+   if(strikes_1) {
+      trigger_event< events::EventLabel::STRIKE >(unit1->mutables().owner, unit1, unit2);
+   }
+   if(strikes_2) {
+      trigger_event< events::EventLabel::STRIKE >(unit2->mutables().owner, unit2, unit1);
    }
-   trigger_strike_1();
-   trigger_strike_2();
 
    if(auto dmg = dmg_taken[0]; dmg > 0) {
       trigger_event< events::EventLabel::UNIT_DAMAGE >(unit1->mutables().owner, unit1, unit2, dmg);
@@ -413,8 +544,45 @@ long Logic::damage_unit(const sptr< Unit >& unit, const sptr< Card >& cause, lon
    long dmg_taken = unit->take_damage(cause, dmg);
    trigger_event< events::EventLabel::UNIT_DAMAGE >(
       cause->mutables().owner, cause, unit, dmg_taken);
+   _kill_if_dead(unit, cause);
    return dmg_taken;
 }
+long Logic::damage_units(Span< const sptr< Unit > > units, const sptr< Card >& cause, long dmg)
+{
+   LORAINE_PROFILE_SCOPE("Logic::damage_units");
+   // the damage taken per unit, one slot for each unit of both boards
+   StaticVector< long, 2 * Board::UnitsType::capacity() > dmg_taken;
+   // throws before any unit is damaged if there are more units than that
+   dmg_taken.reserve(units.size());
+   long total_dmg = 0;
+   for(const auto& unit : units) {
+      long taken = utils::has_value(unit) ? unit->take_damage(cause, dmg) : 0;
+      dmg_taken.emplace_back(taken);
+      total_dmg += taken;
+   }
+   for(size_t i = 0; i < units.size(); ++i) {
+      if(dmg_taken[i] > 0) {
+         trigger_event< events::EventLabel::UNIT_DAMAGE >(
+            cause->mutables().owner, cause, units[i], dmg_taken[i]);
+      }
+   }
+   _kill_if_dead(units, cause);
+   return total_dmg;
+}
+void Logic::apply_stats_grant(
+   Span< const sptr< Unit > > units,
+   const sptr< Card >& bestowing_card,
+   long power,
+   long health,
+   bool permanent)
+{
+   Team team = bestowing_card->mutables().owner;
+   for(const auto& unit : units) {
+      if(utils::has_value(unit)) {
+         grant< GrantType::STATS >(team, bestowing_card, unit, permanent, power, health);
+      }
+   }
+}
 void Logic::kill_unit(const sptr< Unit >& killed_unit, const sptr< Card >& cause)
 {
    killed_unit->kill(cause);
@@ -427,18 +595,37 @@ void Logic::kill_unit(const sptr< Unit >& killed_unit, const sptr< Card >& cause
       _remove(killed_unit);
    }
 }
+void Logic::_kill_if_dead(const sptr< Unit >& unit, const sptr< Card >& cause)
+{
+   if(utils::has_value(unit) && unit->unit_mutables().alive && unit->health() == 0) {
+      kill_unit(unit, cause);
+   }
+}
+void Logic::_kill_if_dead(Span< const sptr< Unit > > units, const sptr< Card >& cause)
+{
+   for(const auto& unit : units) {
+      _kill_if_dead(unit, cause);
+   }
+}
 void Logic::_remove(const sptr< Card >& card)
 {
    Team team = card->mutables().owner;
    unsubscribe_effects(card);
    // remove the unit from camp
    if(card->is_fieldcard()) {
+      // the units that lost a health aura of the card may die of it, once the card is gone
+      auto weakened = m_state->auras().leave(card);
+      m_state->timers().cancel(card);
       auto loc = card->mutables().location;
       if(loc == Location::CAMP) {
-         auto camp = m_state->board().camp(team);
-         camp.erase(std::next(camp.begin(), card->mutables().position));
+         // the stored position goes stale whenever a card left of it leaves the camp
+         auto& camp = m_state->board().camp(team);
+         if(auto pos = std::find(camp.begin(), camp.end(), card); pos != camp.end()) {
+            camp.erase(pos);
+         }
       }
       // if it is on the battlefield, then we let the retreat to camp method clean up dead units
+      _kill_if_dead(weakened, card);
    }
 }
 void Logic::unsubscribe_effects(const sptr< Card >& card)
@@ -469,7 +656,9 @@ void Logic::subscribe_effects(
 void Logic::strike_nexus(const sptr< Unit >& striking_unit, long dmg)
 {
    if(dmg > 0) {
-      m_state->player(striking_unit->mutables().owner).nexus().add_health(striking_unit, dmg);
+      m_state->player(opponent(striking_unit->mutables().owner))
+         .nexus()
+         .add_health(striking_unit, -dmg);
    }
 }
 
@@ -522,50 +711,116 @@ void Logic::strike_nexus(const sptr< Unit >& striking_unit, long dmg)
 //}
 void Logic::_end_round()
 {
+   LORAINE_PROFILE_SCOPE("Logic::_end_round");
+   LORAINE_ALLOC_PHASE("Logic::_end_round");
    // first let all m_effects fire that state an effect with the "Round End" keyword
    auto active_team = m_state->active_team();
    auto passive_team = opponent(active_team);
    trigger_event< events::EventLabel::ROUND_END >(active_team, m_state->round());
 
-   SymArr< std::vector< sptr< Unit > > > regenerating_units;
-   auto end_round_proc = [&](Team team) {
-      // kill ephemeral units
-      for(auto& unit : m_state->board().camp(team)) {
-         if(unit->has_keyword(Keyword::EPHEMERAL)) {
-            kill_unit(to_unit(unit), unit);
-            continue;
+   // ephemerals die and temporary grants expire, only then the regenerating units heal
+   _fire_timers(RoundPhase::END);
+
+   for(Team team : {active_team, passive_team}) {
+      // store floating mana if available
+      auto& mana = m_state->player(team).mana();
+      mana.floating = std::min(mana.floating + mana.common, m_state->config().MAX_FLOATING_MANA);
+   }
+}
+void Logic::schedule(
+   size_t rounds_ahead,
+   RoundPhase phase,
+   const sptr< Card >& card,
+   TimerWheel::Callback callback)
+{
+   m_state->timers().schedule(
+      {m_state->round() + rounds_ahead, phase, TimerWheel::Kind::DELAYED, card, nullptr, callback});
+}
+void Logic::_schedule_expiry(const sptr< Grant >& grant)
+{
+   if(not grant->is_permanent()) {
+      m_state->timers().schedule(
+         {m_state->round(),
+          RoundPhase::END,
+          TimerWheel::Kind::EXPIRE_GRANT,
+          grant->get_bestowed_card(),
+          grant});
+   }
+   if(auto bestowed = grant->get_bestowed_card(); bestowed->is_unit()) {
+      auto loc = bestowed->mutables().location;
+      if(loc == Location::CAMP || loc == Location::BATTLEFIELD) {
+         // a keyword grant might have made the unit ephemeral or regenerating
+         _schedule_keyword_timers(to_unit(bestowed));
+      }
+   }
+}
+void Logic::_schedule_keyword_timers(const sptr< Unit >& unit)
+{
+   auto& timers = m_state->timers();
+   for(auto [keyword, kind] :
+       {std::pair(Keyword::EPHEMERAL, TimerWheel::Kind::EPHEMERAL),
+        std::pair(Keyword::REGENERATION, TimerWheel::Kind::REGENERATION)}) {
+      if(unit->has_keyword(keyword) && not timers.is_scheduled(kind, unit)) {
+         timers.schedule({m_state->round(), RoundPhase::END, kind, unit});
+      }
+   }
+}
+void Logic::_fire_timers(RoundPhase phase)
+{
+   auto& timers = m_state->timers();
+   if(timers.empty()) {
+      return;
+   }
+   // firing a timer may schedule further timers for the same phase (e.g. a delayed trigger making a
+   // unit ephemeral), which are fired right after. It may also remove a card whose timers are in
+   // the same batch, which the wheel then marks as cancelled.
+   for(auto* due = &timers.pop_due(m_state->round(), phase); not due->empty();
+       due = &timers.pop_due(m_state->round(), phase)) {
+      for(const auto& timer : *due) {
+         if(timer.kind != TimerWheel::Kind::REGENERATION && not timer.cancelled) {
+            _fire(timer);
          }
-         // remove temporary grants
-         // undo temporary buffs/nerfs and possibly heal the units if applicable
-         auto temp_grants = unit->mutables().grants_temp;
-         for(auto&& grant : temp_grants) {
-            grant->undo();
+      }
+      for(const auto& timer : *due) {
+         if(timer.kind == TimerWheel::Kind::REGENERATION && not timer.cancelled) {
+            _fire(timer);
          }
-         temp_grants.clear();
-
-         // REGENERATION units will regenerate after removing grants etc.
-         if(unit->has_keyword(Keyword::REGENERATION)) {
-            regenerating_units[team].emplace_back(to_unit(unit));
+      }
+   }
+}
+void Logic::_fire(const TimerWheel::Timer& timer)
+{
+   const auto& card = timer.card;
+   switch(timer.kind) {
+      case TimerWheel::Kind::EXPIRE_GRANT: {
+         // undo temporary buffs/nerfs and possibly heal the unit if applicable
+         timer.grant->undo();
+         auto& temp_grants = card->mutables().grants_temp;
+         if(auto pos = std::find(temp_grants.begin(), temp_grants.end(), timer.grant);
+            pos != temp_grants.end()) {
+            temp_grants.erase(pos);
          }
+         break;
       }
-      // store floating mana if available
-      auto& mana = m_state->player(team).mana();
-      mana.floating += mana.common;
-   };
-
-   auto regen_proc = [&](Team team) {
-      // regenerate the units with regeneration
-      for(auto& unit : regenerating_units[team]) {
-         if(unit->unit_mutables().alive) {
-            heal(to_unit(unit), unit, unit->unit_mutables().damage);
+      case TimerWheel::Kind::EPHEMERAL: {
+         if(card->has_keyword(Keyword::EPHEMERAL)) {
+            kill_unit(to_unit(card), card);
          }
+         break;
+      }
+      case TimerWheel::Kind::REGENERATION: {
+         auto unit = to_unit(card);
+         if(unit->has_keyword(Keyword::REGENERATION) && unit->unit_mutables().alive) {
+            heal(unit, unit, unit->unit_mutables().damage);
+            m_state->timers().schedule(
+               {m_state->round() + 1, RoundPhase::END, TimerWheel::Kind::REGENERATION, card});
+         }
+         break;
+      }
+      case TimerWheel::Kind::DELAYED: {
+         timer.callback(*this, card);
+         break;
       }
-   };
-
-   for(const auto& procedure :
-       std::initializer_list< std::function< void(Team) > >{end_round_proc, regen_proc}) {
-      procedure(active_team);
-      procedure(passive_team);
    }
 }
 void Logic::heal(const sptr< Unit >& unit, const sptr< Card >& cause, size_t amount)
@@ -578,40 +833,49 @@ void Logic::retreat_to_camp(Team team)
 {
    auto& bf = m_state->board().battlefield(team);
    auto& camp = m_state->board().camp(team);
-   std::decay_t< decltype(bf) > bf_stack_buffer;
-   bf_stack_buffer.reserve(bf.size());
-   // we reverse the bf container, because popping from the end of a vector is performant, while
-   // popping from the beginning is not, and we need to loop over the bf from the beginning, since
-   // the units return to camp from left to right
-   for(const auto& unit : utils::reverse(bf)) {
-      if(unit->unit_mutables().alive) {
-         bf.emplace_back(unit);
+   // the units return to camp from left to right. Neither moving nor obliterating a unit touches
+   // the battlefield, so it can be iterated directly and cleared afterwards.
+   for(const auto& unit : bf) {
+      if(not utils::has_value(unit) || not unit->unit_mutables().alive) {
+         // if it isn't alive, then the kill_unit method should have already sent it to the
+         // graveyard and unsubscribed its effects. The pointer on the battlefield was only kept for
+         // deciding striking mechanisms during combat resolution
+         continue;
       }
-      // if it isn't alive, then the kill_unit method should have already sent it to the graveyard
-      // and unsubscribed its effects. The pointer on the battlefield was only kept for
-      // deciding striking mechanisms during combat resolution
-   }
-   bf.clear();
-
-   while(not bf_stack_buffer.empty()) {
-      auto unit = bf_stack_buffer.back();
-      bf_stack_buffer.pop_back();
       if(camp.size() >= m_state->config().CAMP_SIZE) {
          // no space left in camp (due to meddling during combat resolution, e.g. removal of an
          // ephemeral keyword), so the unit is obliterated
          obliterate(unit);
       } else {
          camp.emplace_back(unit);
+         unit->move(Location::CAMP, camp.size() - 1);
       }
    }
+   bf.clear();
+}
+void Logic::add_aura(const sptr< Card >& source, AuraSpec spec)
+{
+   m_state->auras().add_source(source, spec, m_state->board());
+}
+void Logic::remove_aura(const sptr< Card >& source)
+{
+   _kill_if_dead(m_state->auras().remove_source(source), source);
 }
 void Logic::restore_previous_invoker()
 {
    utils::throw_if_no_value(
       m_prev_action_invoker, "Previous action invoker pointer holds no value.");
+   _retire(std::move(m_action_invoker));
    m_action_invoker = std::move(m_prev_action_invoker);
    m_prev_action_invoker = nullptr;
 }
+void Logic::_retire(std::unique_ptr< ActionInvokerBase >&& invoker)
+{
+   if(invoker != nullptr) {
+      auto label = invoker->label();
+      m_spare_invokers[label] = std::move(invoker);
+   }
+}
 void Logic::summon(const sptr< Unit >& unit, bool to_bf, bool is_play) {
 
 }
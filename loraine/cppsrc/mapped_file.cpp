@@ -0,0 +1,78 @@
+
+#include "io/mapped_file.h"
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+   #include <fcntl.h>
+   #include <sys/mman.h>
+   #include <sys/stat.h>
+   #include <unistd.h>
+   #define LORAINE_HAS_MMAP
+#endif
+
+namespace {
+
+void check_io(bool ok, const std::filesystem::path& path, const char* what)
+{
+   if(not ok) {
+      throw std::runtime_error(std::string("File ") + path.string() + ": " + what + " failed.");
+   }
+}
+
+}  // namespace
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+#ifdef LORAINE_HAS_MMAP
+   int fd = ::open(path.c_str(), O_RDONLY);
+   check_io(fd >= 0, path, "opening");
+   struct stat stats {};
+   bool ok = ::fstat(fd, &stats) == 0;
+   m_size = size_t(stats.st_size);
+   if(ok && m_size > 0) {
+      void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+      ok = data != MAP_FAILED;
+      m_data = ok ? static_cast< const u8* >(data) : nullptr;
+   }
+   ::close(fd);
+   check_io(ok, path, "mapping");
+#else
+   std::ifstream file(path, std::ios::binary | std::ios::ate);
+   check_io(file.good(), path, "opening");
+   m_size = size_t(file.tellg());
+   m_fallback.resize((m_size + sizeof(u64) - 1) / sizeof(u64));
+   file.seekg(0);
+   file.read(reinterpret_cast< char* >(m_fallback.data()), std::streamsize(m_size));
+   check_io(file.good(), path, "reading");
+   m_data = reinterpret_cast< const u8* >(m_fallback.data());
+#endif
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr)),
+      m_size(std::exchange(other.m_size, 0)),
+      m_fallback(std::move(other.m_fallback))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+   // the other mapping is released along with other
+   std::swap(m_data, other.m_data);
+   std::swap(m_size, other.m_size);
+   std::swap(m_fallback, other.m_fallback);
+   return *this;
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef LORAINE_HAS_MMAP
+   if(m_data != nullptr) {
+      ::munmap(const_cast< u8* >(m_data), m_size);
+   }
+#endif
+}
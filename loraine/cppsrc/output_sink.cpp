@@ -0,0 +1,537 @@
+
+#include "io/output_sink.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+   #include <fcntl.h>
+   #include <unistd.h>
+   #define LORAINE_HAS_PWRITE
+#else
+   #include <fstream>
+#endif
+
+#if defined(LORAINE_ENABLE_IO_URING) && defined(__linux__)
+   #include <liburing.h>
+   #define LORAINE_HAS_IO_URING
+#endif
+
+namespace {
+
+void check_io(bool ok, const std::filesystem::path& path, const char* what)
+{
+   if(not ok) {
+      throw std::runtime_error(
+         std::string("Output file ") + path.string() + ": " + what + " failed.");
+   }
+}
+
+}  // namespace
+
+struct OutputSink::File {
+   FileId id = 0;
+   std::filesystem::path path;
+#ifdef LORAINE_HAS_PWRITE
+   int fd = -1;
+#else
+   // without positional writes, the workers take turns seeking and writing
+   std::mutex mutex;
+   std::ofstream stream;
+#endif
+   // the offset the next submission is appended at
+   u64 end = 0;
+   size_t n_pending = 0;
+   bool closing = false;
+   bool open = false;
+};
+
+#ifdef LORAINE_HAS_IO_URING
+/**
+ * Submits the writes to an io_uring and completes them on a reaper thread as the kernel reports
+ * them done.
+ */
+class OutputSink::Uring {
+  public:
+   /**
+    * The ring, or nullptr if the kernel does not provide io_uring (or does not allow it).
+    */
+   static uptr< Uring > create(OutputSink& sink)
+   {
+      auto uring = uptr< Uring >(new Uring(sink));
+      // at most every buffer is in flight, plus the entry waking the reaper to stop
+      if(io_uring_queue_init(unsigned(sink.m_options.n_buffers + 1), &uring->m_ring, 0) < 0) {
+         return nullptr;
+      }
+      uring->m_initialized = true;
+      uring->m_reaper = std::thread([ptr = uring.get()] { ptr->_reap(); });
+      return uring;
+   }
+   Uring(const Uring&) = delete;
+   Uring& operator=(const Uring&) = delete;
+   ~Uring()
+   {
+      if(m_reaper.joinable()) {
+         _push_stop();
+         m_reaper.join();
+      }
+      if(m_initialized) {
+         io_uring_queue_exit(&m_ring);
+      }
+   }
+
+   void submit(Write write) { _push(new Write(std::move(write))); }
+
+  private:
+   OutputSink* m_sink;
+   io_uring m_ring{};
+   bool m_initialized = false;
+   // guards the submission queue, which producers and the reaper (resubmitting) share
+   std::mutex m_mutex;
+   std::thread m_reaper;
+
+   explicit Uring(OutputSink& sink) : m_sink(&sink) {}
+
+   void _push(Write* write)
+   {
+      int result = 0;
+      {
+         std::lock_guard lock(m_mutex);
+         io_uring_sqe* sqe = io_uring_get_sqe(&m_ring);
+         if(sqe == nullptr) {
+            result = -EBUSY;
+         } else {
+            if(write == nullptr) {
+               io_uring_prep_nop(sqe);
+            } else {
+               io_uring_prep_write(
+                  sqe,
+                  write->file->fd,
+                  write->buffer.data() + write->written,
+                  unsigned(write->buffer.size() - write->written),
+                  write->offset + write->written);
+            }
+            io_uring_sqe_set_data(sqe, write);
+            result = io_uring_submit(&m_ring);
+         }
+      }
+      if(result < 0 && write != nullptr) {
+         _fail(uptr< Write >(write), -result);
+      }
+   }
+
+   /**
+    * Queues the entry waking the reaper to stop. Unlike a write, it cannot fail over to an error,
+    * since the reaper would then never return, so it is retried until the ring takes it.
+    */
+   void _push_stop()
+   {
+      std::unique_lock lock(m_mutex);
+      io_uring_sqe* sqe = io_uring_get_sqe(&m_ring);
+      while(sqe == nullptr) {
+         // the submission queue is full, flush it and give the kernel time to make room
+         io_uring_submit(&m_ring);
+         lock.unlock();
+         std::this_thread::yield();
+         lock.lock();
+         sqe = io_uring_get_sqe(&m_ring);
+      }
+      io_uring_prep_nop(sqe);
+      io_uring_sqe_set_data(sqe, nullptr);
+      for(int result = io_uring_submit(&m_ring);
+          result == -EBUSY || result == -EAGAIN || result == -EINTR;
+          result = io_uring_submit(&m_ring)) {
+         // the completion queue is full, the reaper has to take some completions off first
+         lock.unlock();
+         std::this_thread::yield();
+         lock.lock();
+      }
+   }
+
+   void _reap()
+   {
+      while(true) {
+         io_uring_cqe* cqe = nullptr;
+         int result = io_uring_wait_cqe(&m_ring, &cqe);
+         if(result == -EINTR) {
+            continue;
+         }
+         if(result < 0) {
+            return;
+         }
+         auto write = uptr< Write >(static_cast< Write* >(io_uring_cqe_get_data(cqe)));
+         result = cqe->res;
+         io_uring_cqe_seen(&m_ring, cqe);
+         if(write == nullptr) {
+            return;
+         }
+         if(result < 0) {
+            _fail(std::move(write), -result);
+            continue;
+         }
+         write->written += size_t(result);
+         if(result > 0 && write->written < write->buffer.size()) {
+            // a short write, the rest is submitted anew
+            _push(write.release());
+            continue;
+         }
+         std::exception_ptr error = nullptr;
+         if(write->written < write->buffer.size()) {
+            error = std::make_exception_ptr(std::runtime_error(
+               "Output file " + write->file->path.string() + ": writing failed."));
+         }
+         m_sink->_finish(*write, error);
+      }
+   }
+
+   void _fail(uptr< Write > write, int error_code)
+   {
+      m_sink->_finish(
+         *write,
+         std::make_exception_ptr(std::runtime_error(
+            "Output file " + write->file->path.string()
+            + ": writing failed (errno " + std::to_string(error_code) + ").")));
+   }
+};
+#else
+class OutputSink::Uring {
+  public:
+   static uptr< Uring > create(OutputSink&) { return nullptr; }
+   void submit(Write) {}
+};
+#endif
+
+OutputSink::OutputSink() : OutputSink(Options{}) {}
+
+OutputSink::OutputSink(Options options) : m_options(options)
+{
+   m_options.n_buffers = std::max(m_options.n_buffers, size_t(1));
+   m_options.n_threads = std::max(m_options.n_threads, size_t(1));
+   m_free.reserve(m_options.n_buffers);
+   if(m_options.io_uring) {
+      m_uring = Uring::create(*this);
+   }
+   if(m_uring == nullptr) {
+      for(size_t i = 0; i < m_options.n_threads; ++i) {
+         m_workers.emplace_back([this] { _work(); });
+      }
+   }
+}
+
+OutputSink::~OutputSink()
+{
+   {
+      std::unique_lock lock(m_mutex);
+      m_cv.wait(lock, [&] { return m_n_pending == 0; });
+      m_stopping = true;
+   }
+   m_cv.notify_all();
+   for(auto& worker : m_workers) {
+      worker.join();
+   }
+   m_uring.reset();
+   for(auto& [id, file] : m_files) {
+      try {
+         _close_file(*file);
+      } catch(...) {
+         // errors are only reported by an explicit close
+      }
+   }
+}
+
+OutputSink::FileId OutputSink::open(const std::filesystem::path& path)
+{
+   auto file = std::make_unique< File >();
+   file->path = path;
+#ifdef LORAINE_HAS_PWRITE
+   file->fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+   check_io(file->fd >= 0, path, "opening");
+#else
+   file->stream.open(path, std::ios::binary | std::ios::trunc);
+   check_io(file->stream.good(), path, "opening");
+#endif
+   file->open = true;
+   std::lock_guard lock(m_mutex);
+   file->id = m_next_file++;
+   return m_files.emplace(file->id, std::move(file)).first->first;
+}
+
+void OutputSink::close(FileId file_id)
+{
+   std::lock_guard lock(m_mutex);
+   auto& file = _file(file_id);
+   if(file.n_pending > 0) {
+      // closed by the last write to complete
+      file.closing = true;
+   } else {
+      _erase_file(file);
+   }
+}
+
+OutputSink::Buffer OutputSink::acquire()
+{
+   std::unique_lock lock(m_mutex);
+   // backpressure: a buffer only becomes available once another has been written
+   m_cv.wait(lock, [&] { return m_n_in_use < m_options.n_buffers; });
+   m_n_in_use += 1;
+   if(not m_free.empty()) {
+      auto buffer = std::move(m_free.back());
+      m_free.pop_back();
+      return buffer;
+   }
+   lock.unlock();
+   Buffer buffer;
+   buffer.reserve(m_options.buffer_capacity);
+   return buffer;
+}
+
+void OutputSink::release(Buffer buffer)
+{
+   {
+      std::lock_guard lock(m_mutex);
+      _recycle(std::move(buffer));
+   }
+   m_cv.notify_all();
+}
+
+void OutputSink::submit(FileId file_id, Buffer buffer)
+{
+   std::unique_lock lock(m_mutex);
+   auto& file = _target(lock, file_id, buffer);
+   u64 offset = file.end;
+   file.end += buffer.size();
+   _enqueue(lock, Write{&file, offset, std::move(buffer)});
+}
+
+void OutputSink::submit_at(FileId file_id, u64 offset, Buffer buffer)
+{
+   std::unique_lock lock(m_mutex);
+   auto& file = _target(lock, file_id, buffer);
+   file.end = std::max(file.end, offset + buffer.size());
+   _enqueue(lock, Write{&file, offset, std::move(buffer)});
+}
+
+void OutputSink::skip(FileId file_id, u64 n_bytes)
+{
+   std::lock_guard lock(m_mutex);
+   _file(file_id).end += n_bytes;
+}
+
+void OutputSink::drain()
+{
+   std::unique_lock lock(m_mutex);
+   m_cv.wait(lock, [&] { return m_n_pending == 0; });
+   if(m_error) {
+      std::rethrow_exception(m_error);
+   }
+}
+
+u64 OutputSink::size(FileId file) const
+{
+   std::lock_guard lock(m_mutex);
+   auto it = m_files.find(file);
+   if(it == m_files.end()) {
+      throw std::invalid_argument("Output file " + std::to_string(file) + " is not open.");
+   }
+   return it->second->end;
+}
+
+void OutputSink::_enqueue(std::unique_lock< std::mutex >& lock, Write write)
+{
+   if(m_error || write.buffer.empty()) {
+      auto error = m_error;
+      _recycle(std::move(write.buffer));
+      lock.unlock();
+      m_cv.notify_all();
+      if(error) {
+         std::rethrow_exception(error);
+      }
+      return;
+   }
+   m_n_pending += 1;
+   write.file->n_pending += 1;
+   if(m_uring != nullptr) {
+      lock.unlock();
+      m_uring->submit(std::move(write));
+      return;
+   }
+   m_queue.emplace_back(std::move(write));
+   lock.unlock();
+   m_cv.notify_all();
+}
+
+void OutputSink::_work()
+{
+   std::unique_lock lock(m_mutex);
+   while(true) {
+      m_cv.wait(lock, [&] { return not m_queue.empty() || m_stopping; });
+      if(m_queue.empty()) {
+         return;
+      }
+      auto write = std::move(m_queue.front());
+      m_queue.pop_front();
+      lock.unlock();
+      std::exception_ptr error = nullptr;
+      try {
+         _write(write);
+      } catch(...) {
+         error = std::current_exception();
+      }
+      _finish(write, error);
+      lock.lock();
+   }
+}
+
+void OutputSink::_write(Write& write)
+{
+   auto& file = *write.file;
+#ifdef LORAINE_HAS_PWRITE
+   while(write.written < write.buffer.size()) {
+      auto n = ::pwrite(
+         file.fd,
+         write.buffer.data() + write.written,
+         write.buffer.size() - write.written,
+         off_t(write.offset + write.written));
+      if(n < 0 && errno == EINTR) {
+         continue;
+      }
+      check_io(n > 0, file.path, "writing");
+      write.written += size_t(n);
+   }
+#else
+   std::lock_guard lock(file.mutex);
+   file.stream.seekp(std::streamoff(write.offset));
+   file.stream.write(
+      reinterpret_cast< const char* >(write.buffer.data()), std::streamsize(write.buffer.size()));
+   check_io(file.stream.good(), file.path, "writing");
+   write.written = write.buffer.size();
+#endif
+}
+
+void OutputSink::_finish(Write& write, std::exception_ptr error)
+{
+   {
+      std::lock_guard lock(m_mutex);
+      if(error && not m_error) {
+         m_error = error;
+      }
+      _recycle(std::move(write.buffer));
+      auto& file = *write.file;
+      file.n_pending -= 1;
+      if(file.closing && file.n_pending == 0) {
+         try {
+            _erase_file(file);
+         } catch(...) {
+            if(not m_error) {
+               m_error = std::current_exception();
+            }
+         }
+      }
+      m_n_pending -= 1;
+   }
+   m_cv.notify_all();
+}
+
+void OutputSink::_recycle(Buffer buffer)
+{
+   if(m_n_in_use > 0) {
+      m_n_in_use -= 1;
+   }
+   if(m_free.size() < m_options.n_buffers) {
+      buffer.clear();
+      m_free.emplace_back(std::move(buffer));
+   }
+}
+
+void OutputSink::_close_file(File& file)
+{
+   if(not file.open) {
+      return;
+   }
+   file.open = false;
+   file.closing = false;
+#ifdef LORAINE_HAS_PWRITE
+   bool ok = ::close(file.fd) == 0;
+   file.fd = -1;
+#else
+   file.stream.close();
+   bool ok = not file.stream.fail();
+#endif
+   check_io(ok, file.path, "closing");
+}
+
+void OutputSink::_erase_file(File& file)
+{
+   // the file is erased even if closing it fails, the error is reported instead
+   auto closed = std::move(m_files.at(file.id));
+   m_files.erase(file.id);
+   _close_file(*closed);
+}
+
+OutputSink::File& OutputSink::_target(
+   std::unique_lock< std::mutex >& lock,
+   FileId file,
+   Buffer& buffer)
+{
+   try {
+      return _file(file);
+   } catch(...) {
+      // the buffer is taken back all the same, so that it does not go missing from circulation
+      _recycle(std::move(buffer));
+      lock.unlock();
+      m_cv.notify_all();
+      throw;
+   }
+}
+
+OutputSink::File& OutputSink::_file(FileId file)
+{
+   auto it = m_files.find(file);
+   if(it == m_files.end() || not it->second->open || it->second->closing) {
+      throw std::invalid_argument("Output file " + std::to_string(file) + " is not open.");
+   }
+   return *it->second;
+}
+
+SinkWriter::SinkWriter(OutputSink& sink, OutputSink::FileId file)
+    : m_sink(sink),
+      m_file(file),
+      m_capacity(std::max(sink.options().buffer_capacity, size_t(1))),
+      m_buffer(sink.acquire()),
+      m_holds_buffer(true)
+{
+}
+
+SinkWriter::~SinkWriter()
+{
+   if(m_holds_buffer) {
+      m_sink.release(std::move(m_buffer));
+   }
+}
+
+void SinkWriter::put(const void* data, size_t size)
+{
+   const auto* bytes = static_cast< const u8* >(data);
+   while(size > 0) {
+      if(m_buffer.size() == m_capacity) {
+         // the sink owns the buffer from here on, whether submitting succeeds or not
+         m_holds_buffer = false;
+         m_sink.submit(m_file, std::exchange(m_buffer, OutputSink::Buffer{}));
+         m_buffer = m_sink.acquire();
+         m_holds_buffer = true;
+      }
+      size_t n = std::min(size, m_capacity - m_buffer.size());
+      m_buffer.insert(m_buffer.end(), bytes, bytes + n);
+      bytes += n;
+      size -= n;
+   }
+}
+
+void SinkWriter::finish()
+{
+   m_holds_buffer = false;
+   m_sink.submit(m_file, std::move(m_buffer));
+}
@@ -19,13 +19,32 @@ Player::Player(
       m_mana(mana),
       m_flags(flags)
 {
+   // every card of the deck may end up in one of the yards, which thus never need to grow in
+   // games without created cards
+   m_graveyard.reserve(m_deck.size());
+   m_spellyard.reserve(m_deck.size());
+   m_tossed_cards.reserve(m_deck.size());
+}
+void Player::reset(Deck deck, long nexus_health)
+{
+   m_nexus.reset(nexus_health);
+   m_hand.clear();
+   m_deck = std::move(deck);
+   m_mana = {};
+   m_flags = {};
+   m_graveyard.clear();
+   m_spellyard.clear();
+   m_tossed_cards.clear();
+   m_graveyard.reserve(m_deck.size());
+   m_spellyard.reserve(m_deck.size());
+   m_tossed_cards.reserve(m_deck.size());
 }
 Player::Player(const Player& other)
     : m_team(other.m_team),
       m_nexus(other.m_nexus),
       m_controller(other.m_controller),  // the controller is not copied, since we assume the same
                                          // BOT or human should control this copy
-      m_hand(),  // hand is only a vector and thus needs to be coopied manually
+      m_hand(),  // the hand's cards need to be cloned manually
       m_deck(other.m_deck),  // deck has copy constructor which clones the spell pointers
       m_mana(other.m_mana),
       m_flags(other.m_flags)
@@ -34,4 +53,17 @@ Player::Player(const Player& other)
    for(const auto& card : other.m_hand) {
       m_hand.emplace_back(card->clone());
    }
+   // as are the yards'
+   m_graveyard.reserve(other.m_graveyard.size());
+   for(const auto& [round, card] : other.m_graveyard) {
+      m_graveyard.emplace_back(round, card->clone());
+   }
+   m_spellyard.reserve(other.m_spellyard.size());
+   for(const auto& [round, spell] : other.m_spellyard) {
+      m_spellyard.emplace_back(round, spell->clone());
+   }
+   m_tossed_cards.reserve(other.m_tossed_cards.size());
+   for(const auto& card : other.m_tossed_cards) {
+      m_tossed_cards.emplace_back(card->clone());
+   }
 }
@@ -0,0 +1,136 @@
+
+#include "utils/profiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+namespace profiling {
+
+namespace {
+
+std::string zone_name(const ZoneKey& zone)
+{
+   std::string name = zone.name;
+   if(zone.detail != nullptr) {
+      name.append("<").append(zone.detail).append(">");
+   }
+   return name;
+}
+
+void write_json_string(std::ostream& os, const std::string& str)
+{
+   os << '"';
+   for(char c : str) {
+      if(c == '"' || c == '\\') {
+         os << '\\';
+      }
+      os << c;
+   }
+   os << '"';
+}
+
+}  // namespace
+
+void Profiler::enable_tracing(bool enable, size_t capacity_per_thread)
+{
+   s_trace_capacity = capacity_per_thread;
+   s_tracing = enable;
+   if(enable) {
+      ProfileRegistry::instance().for_each_mut(
+         [&](ThreadProfile& profile) { profile.trace.reserve(capacity_per_thread); });
+   }
+}
+
+std::vector< ZoneReport > Profiler::report()
+{
+   // merge by name rather than by key, since equal literals may have distinct addresses across
+   // translation units
+   std::unordered_map< std::string, ZoneStats > merged;
+   ProfileRegistry::instance().for_each([&](const ThreadProfile& profile, u32 /*thread*/) {
+      for(const auto& [zone, stats] : profile.zones) {
+         merged[zone_name(zone)].merge(stats);
+      }
+   });
+   std::vector< ZoneReport > rows;
+   rows.reserve(merged.size());
+   for(auto& [name, stats] : merged) {
+      rows.emplace_back(ZoneReport{name, stats});
+   }
+   std::sort(rows.begin(), rows.end(), [](const ZoneReport& r1, const ZoneReport& r2) {
+      return r1.stats.total_ns > r2.stats.total_ns;
+   });
+   return rows;
+}
+
+std::vector< std::pair< std::string, u64 > > Profiler::counters()
+{
+   std::unordered_map< std::string, u64 > merged;
+   ProfileRegistry::instance().for_each([&](const ThreadProfile& profile, u32 /*thread*/) {
+      for(const auto& [name, value] : profile.counters) {
+         merged[name] += value;
+      }
+   });
+   std::vector< std::pair< std::string, u64 > > rows(merged.begin(), merged.end());
+   std::sort(rows.begin(), rows.end());
+   return rows;
+}
+
+void Profiler::write_report(std::ostream& os)
+{
+   auto rows = report();
+   os << std::left << std::setw(48) << "zone" << std::right << std::setw(12) << "calls"
+      << std::setw(14) << "total [ms]" << std::setw(12) << "mean [us]" << std::setw(12)
+      << "min [us]" << std::setw(12) << "max [us]"
+      << "\n";
+   os << std::fixed << std::setprecision(3);
+   for(const auto& [name, stats] : rows) {
+      os << std::left << std::setw(48) << name << std::right << std::setw(12) << stats.calls
+         << std::setw(14) << double(stats.total_ns) * 1e-6 << std::setw(12)
+         << double(stats.total_ns) * 1e-3 / double(std::max(stats.calls, u64(1)))
+         << std::setw(12) << double(stats.min_ns) * 1e-3 << std::setw(12)
+         << double(stats.max_ns) * 1e-3 << "\n";
+   }
+   auto counter_rows = counters();
+   if(not counter_rows.empty()) {
+      os << "\n" << std::left << std::setw(48) << "counter" << std::right << std::setw(12)
+         << "value"
+         << "\n";
+      for(const auto& [name, value] : counter_rows) {
+         os << std::left << std::setw(48) << name << std::right << std::setw(12) << value << "\n";
+      }
+   }
+}
+
+void Profiler::write_chrome_trace(std::ostream& os)
+{
+   os << "{\"traceEvents\":[";
+   bool first = true;
+   os << std::fixed << std::setprecision(3);
+   ProfileRegistry::instance().for_each([&](const ThreadProfile& profile, u32 thread) {
+      for(const auto& event : profile.trace) {
+         if(not first) {
+            os << ",";
+         }
+         first = false;
+         // complete events ("X") with timestamps and durations in microseconds
+         os << "\n{\"name\":";
+         write_json_string(os, zone_name(event.zone));
+         os << ",\"cat\":\"loraine\",\"ph\":\"X\",\"ts\":" << double(event.start_ns) * 1e-3
+            << ",\"dur\":" << double(event.duration_ns) * 1e-3 << ",\"pid\":0,\"tid\":" << thread
+            << "}";
+      }
+   });
+   os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+void Profiler::reset()
+{
+   ProfileRegistry::instance().for_each_mut([](ThreadProfile& profile) {
+      profile.zones.clear();
+      profile.counters.clear();
+      profile.trace.clear();
+   });
+}
+
+}  // namespace profiling
@@ -1,2 +0,0 @@
-
-#include "core/record.h"
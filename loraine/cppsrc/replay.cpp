@@ -0,0 +1,468 @@
+
+#include "core/replay.h"
+
+#include <algorithm>
+#include <istream>
+
+#include "cards/card.h"
+#include "core/gamestate.h"
+#include "core/logic.h"
+#include "io/output_sink.h"
+#include "utils/profiler.h"
+#include "utils/utils.h"
+
+namespace {
+
+using utils::hash_combine;
+
+/**
+ * FNV-1a, so that the hashes of card codes (and with them the recorded step hashes) stay the same
+ * across builds and standard libraries.
+ */
+u64 hash_code(const std::string& code)
+{
+   u64 hash = 0xcbf29ce484222325ULL;
+   for(char c : code) {
+      hash = (hash ^ u64(static_cast< unsigned char >(c))) * 0x100000001b3ULL;
+   }
+   return hash;
+}
+
+u64 hash_card(u64 seed, const sptr< Card >& card)
+{
+   if(card == nullptr) {
+      return hash_combine(seed, 0);
+   }
+   seed = hash_combine(seed, hash_code(card->immutables().code));
+   if(card->is_unit()) {
+      auto unit = to_unit(card);
+      seed = hash_combine(seed, unit->power());
+      seed = hash_combine(seed, unit->health());
+      seed = hash_combine(seed, unit->unit_mutables().alive);
+   }
+   return seed;
+}
+
+template < typename Container >
+u64 hash_cards(u64 seed, const Container& cards)
+{
+   seed = hash_combine(seed, cards.size());
+   for(const auto& card : cards) {
+      seed = hash_card(seed, card);
+   }
+   return seed;
+}
+
+constexpr size_t n_rules = 17;
+
+std::array< u64, n_rules > rules_of(const Config& config)
+{
+   return {
+      config.MAX_CARD_COPIES_IN_DECK,
+      config.DECK_CARDS_LIMIT,
+      config.CHAMPIONS_LIMIT,
+      config.REGIONS_LIMIT,
+      config.BATTLEFIELD_SIZE,
+      config.CAMP_SIZE,
+      config.HAND_CARDS_LIMIT,
+      config.START_NEXUS_HEALTH,
+      config.SPELL_STACK_LIMIT,
+      config.MAX_MANA,
+      config.MAX_FLOATING_MANA,
+      config.MANA_START,
+      config.FLOATING_MANA_START,
+      config.INITIAL_HAND_SIZE,
+      config.MAX_ROUNDS,
+      config.INVALID_ACTIONS_LIMIT,
+      config.ENLIGHTENMENT_THRESHOLD};
+}
+
+Config config_of(
+   const std::array< u64, n_rules >& rules,
+   const KeywordMap& keywords_blue,
+   const KeywordMap& keywords_red)
+{
+#ifdef LORAINE_STATIC_RULES
+   if(rules != rules_of(Config{})) {
+      throw std::runtime_error("The replay was recorded with other rules than this build's.");
+   }
+   return Config{{}, {}, keywords_blue, keywords_red};
+#else
+   return Config{
+      size_t(rules[0]),
+      size_t(rules[1]),
+      size_t(rules[2]),
+      size_t(rules[3]),
+      size_t(rules[4]),
+      size_t(rules[5]),
+      size_t(rules[6]),
+      size_t(rules[7]),
+      size_t(rules[8]),
+      size_t(rules[9]),
+      size_t(rules[10]),
+      size_t(rules[11]),
+      size_t(rules[12]),
+      size_t(rules[13]),
+      size_t(rules[14]),
+      size_t(rules[15]),
+      size_t(rules[16]),
+      {},
+      {},
+      keywords_blue,
+      keywords_red};
+#endif
+}
+
+void write_keywords(SinkWriter& out, const KeywordMap& keywords)
+{
+   out.put(u64(keywords.size()));
+   for(bool has_keyword : keywords) {
+      u8 byte = has_keyword;
+      out.put(&byte, 1);
+   }
+}
+
+void write_string(SinkWriter& out, const std::string& str)
+{
+   out.put(u64(str.size()));
+   out.put(str.data(), str.size());
+}
+
+void read_bytes(std::istream& in, void* data, size_t size)
+{
+   in.read(static_cast< char* >(data), std::streamsize(size));
+   if(not in) {
+      throw std::runtime_error("The replay is truncated.");
+   }
+}
+
+u64 read_u64(std::istream& in)
+{
+   u64 value = 0;
+   read_bytes(in, &value, sizeof(u64));
+   return value;
+}
+
+/**
+ * A count read from the stream, checked against a bound for what a valid replay could hold.
+ */
+size_t read_count(std::istream& in, u64 max)
+{
+   auto count = read_u64(in);
+   if(count > max) {
+      throw std::runtime_error("The replay is corrupt.");
+   }
+   return size_t(count);
+}
+
+KeywordMap read_keywords(std::istream& in)
+{
+   if(read_u64(in) != n_keywords) {
+      throw std::runtime_error("The replay was recorded with another set of keywords.");
+   }
+   KeywordMap keywords{};
+   for(auto& has_keyword : keywords) {
+      u8 byte = 0;
+      read_bytes(in, &byte, 1);
+      has_keyword = byte != 0;
+   }
+   return keywords;
+}
+
+std::string read_string(std::istream& in)
+{
+   std::string str(read_count(in, u64(1) << 16), '\0');
+   read_bytes(in, str.data(), str.size());
+   return str;
+}
+
+}  // namespace
+
+u64 Replay::hash(const GameState& state)
+{
+   u64 seed = hash_combine(state.round(), state.turn());
+   for(Team team : {Team::BLUE, Team::RED}) {
+      auto& player = state.player(team);
+      auto& mana = player.mana();
+      auto& flags = player.flags();
+      seed = hash_combine(seed, u64(player.nexus().health()));
+      seed = hash_combine(seed, mana.gems);
+      seed = hash_combine(seed, mana.common);
+      seed = hash_combine(seed, mana.floating);
+      seed = hash_combine(
+         seed,
+         u64(flags.attack_token) | u64(flags.scout_token) << 1 | u64(flags.plunder_token) << 2
+            | u64(flags.is_daybreak) << 3 | u64(flags.is_nightfall) << 4
+            | u64(flags.enlightened) << 5 | u64(flags.pass) << 6);
+      seed = hash_cards(seed, player.hand());
+      seed = hash_cards(seed, player.deck());
+      seed = hash_combine(seed, player.graveyard().size());
+      seed = hash_combine(seed, player.spellyard().size());
+      seed = hash_cards(seed, state.board().camp(team));
+      seed = hash_cards(seed, state.board().battlefield(team));
+   }
+   return hash_cards(seed, state.spell_stack());
+}
+
+void Replay::write(OutputSink& sink, size_t file) const
+{
+   if(not config.PASSIVE_POWERS_BLUE.empty() || not config.PASSIVE_POWERS_RED.empty()) {
+      throw std::invalid_argument(
+         "The nexus passive powers of a replay's config cannot be stored.");
+   }
+   SinkWriter out(sink, file);
+   out.put(file_magic.data(), file_magic.size());
+   out.put(current_format);
+   for(auto rule : rules_of(config)) {
+      out.put(rule);
+   }
+   write_keywords(out, config.NEXUS_KEYWORDS_BLUE);
+   write_keywords(out, config.NEXUS_KEYWORDS_RED);
+   for(const auto& decklist : decklists) {
+      out.put(u64(decklist.size()));
+      for(const auto& code : decklist) {
+         write_string(out, code);
+      }
+   }
+   out.put(u64(starting_team));
+   out.put(u64(seed));
+   out.finish();
+
+   actions.write(sink, file);
+
+   SinkWriter hashes(sink, file);
+   hashes.put(u64(step_hashes.size()));
+   hashes.put(step_hashes.data(), step_hashes.size() * sizeof(u64));
+   hashes.finish();
+}
+
+Replay Replay::read(std::istream& in)
+{
+   std::array< char, 8 > magic{};
+   read_bytes(in, magic.data(), magic.size());
+   if(magic != file_magic) {
+      throw std::runtime_error("The stream holds no replay.");
+   }
+   if(auto format = read_u64(in); format != current_format) {
+      throw std::runtime_error(
+         "The replay has the unsupported format version " + std::to_string(format) + ".");
+   }
+   std::array< u64, n_rules > rules{};
+   for(auto& rule : rules) {
+      rule = read_u64(in);
+   }
+   auto keywords_blue = read_keywords(in);
+   auto keywords_red = read_keywords(in);
+   SymArr< std::vector< std::string > > decklists;
+   for(auto& decklist : decklists) {
+      decklist.resize(read_count(in, u64(1) << 16));
+      for(auto& code : decklist) {
+         code = read_string(in);
+      }
+   }
+   auto starting_team = read_u64(in);
+   if(starting_team > 1) {
+      throw std::runtime_error("The replay is corrupt.");
+   }
+   auto seed = read_u64(in);
+   Replay replay{
+      config_of(rules, keywords_blue, keywords_red),
+      std::move(decklists),
+      Team(starting_team),
+      random::seed_type(seed),
+      GameLog::read(in)};
+   replay.step_hashes.resize(read_count(in, u64(1) << 40));
+   read_bytes(in, replay.step_hashes.data(), replay.step_hashes.size() * sizeof(u64));
+   return replay;
+}
+
+ReplayRecorder::ReplayRecorder(GameState& state, random::seed_type seed)
+    : m_state(&state), m_replay{state.config(), {}, state.starting_team(), seed}
+{
+   if(state.round() != 0) {
+      throw std::invalid_argument("A replay has to be recorded from the start of the game.");
+   }
+   if(state.rng() != random::create_rng(seed)) {
+      throw std::invalid_argument("The state's rng is not freshly seeded with the given seed.");
+   }
+   for(Team team : {Team::BLUE, Team::RED}) {
+      auto& decklist = m_replay.decklists[team];
+      decklist.reserve(state.player(team).deck().size());
+      for(const auto& card : state.player(team).deck()) {
+         decklist.emplace_back(card->immutables().code);
+      }
+   }
+   if(not state.history().logs_actions()) {
+      state.log_level(LogLevel::ACTIONS);
+   }
+}
+
+void ReplayRecorder::record_step()
+{
+   m_replay.step_hashes.emplace_back(Replay::hash(*m_state));
+}
+
+Replay ReplayRecorder::replay() const
+{
+   Replay replay{
+      m_replay.config,
+      m_replay.decklists,
+      m_replay.starting_team,
+      m_replay.seed,
+      GameLog(LogLevel::ACTIONS),
+      m_replay.step_hashes};
+   // only the actions are needed to re-simulate, the events follow from them
+   for(auto record : m_state->history()) {
+      if(record.is_action()) {
+         replay.actions.append(record);
+      }
+   }
+   return replay;
+}
+
+/**
+ * Answers with the next recorded action.
+ */
+class ReplayPlayer::ScriptedController: public Controller {
+  public:
+   ScriptedController(Team team, ReplayPlayer* player) : Controller(team), m_player(player) {}
+
+   actions::Action choose_action(const GameState& state) override
+   {
+      return m_player->_next_action(state.active_team());
+   }
+   actions::Action choose_targets(const GameState& /*state*/, const sptr< EffectBase >& effect)
+      override
+   {
+      return m_player->_next_action(effect->associated_card()->mutables().owner);
+   }
+
+  private:
+   ReplayPlayer* m_player;
+};
+
+ReplayPlayer::ReplayPlayer(Replay replay, CardBuilder build_card, size_t keyframe_interval)
+    : m_replay(std::move(replay)),
+      m_build_card(build_card),
+      m_next_action(m_replay.actions.begin()),
+      m_keyframe_interval(std::max(keyframe_interval, size_t(1)))
+{
+   SymArr< Deck > decks;
+   for(Team team : {Team::BLUE, Team::RED}) {
+      Deck::ContainerType cards;
+      cards.reserve(m_replay.decklists[team].size());
+      for(const auto& code : m_replay.decklists[team]) {
+         cards.emplace_back(m_build_card(code, team));
+      }
+      decks[team] = Deck(cards);
+   }
+   m_state = std::make_unique< GameState >(
+      m_replay.config,
+      std::move(decks),
+      SymArr< sptr< Controller > >{
+         std::make_shared< ScriptedController >(Team::BLUE, this),
+         std::make_shared< ScriptedController >(Team::RED, this)},
+      m_replay.starting_team,
+      random::create_rng(m_replay.seed));
+   m_state->log_level(LogLevel::OFF);
+   m_state->logic()->start_game();
+   _take_keyframe();
+}
+
+ReplayPlayer::~ReplayPlayer() = default;
+
+Status ReplayPlayer::step()
+{
+   if(done()) {
+      throw std::out_of_range("The replay has no steps left.");
+   }
+   auto status = m_state->logic()->step();
+   if(Replay::hash(*m_state) != m_replay.step_hashes[m_step]) {
+      throw std::runtime_error(
+         "Replay desynchronized at step " + std::to_string(m_step) + " (round "
+         + std::to_string(m_state->round()) + ").");
+   }
+   m_step += 1;
+   auto& last = m_keyframes.back();
+   if(m_step > last.step && m_state->round() >= last.round + m_keyframe_interval) {
+      _take_keyframe();
+   }
+   return status;
+}
+
+Status ReplayPlayer::fast_forward(size_t n_steps)
+{
+   auto status = m_state->logic()->check_status();
+   while(m_step < n_steps && not done()) {
+      status = step();
+   }
+   return status;
+}
+
+Status ReplayPlayer::seek(size_t n_steps)
+{
+   if(n_steps > m_replay.n_steps()) {
+      throw std::out_of_range(
+         "Cannot seek to step " + std::to_string(n_steps) + " of a replay of "
+         + std::to_string(m_replay.n_steps()) + " steps.");
+   }
+   // the last keyframe taken at or before the target
+   auto keyframe = std::prev(std::upper_bound(
+      m_keyframes.begin(), m_keyframes.end(), n_steps, [](size_t step, const Keyframe& frame) {
+         return step < frame.step;
+      }));
+   if(m_step > n_steps || m_step < keyframe->step) {
+      _restore(*keyframe);
+   }
+   return fast_forward(n_steps);
+}
+
+Status ReplayPlayer::seek_round(size_t round)
+{
+   // the last keyframe of a round before the target round (or of the target round itself)
+   auto keyframe = std::upper_bound(
+      m_keyframes.begin(), m_keyframes.end(), round, [](size_t target, const Keyframe& frame) {
+         return target < frame.round;
+      });
+   if(keyframe != m_keyframes.begin()) {
+      --keyframe;
+   }
+   auto status = seek(keyframe->step);
+   while(m_state->round() < round && not done()) {
+      status = step();
+   }
+   return status;
+}
+
+void ReplayPlayer::_take_keyframe()
+{
+   LORAINE_PROFILE_SCOPE("ReplayPlayer::take_keyframe");
+   m_keyframes.push_back(
+      Keyframe{m_step, m_state->round(), m_next_action, std::make_unique< GameState >(*m_state)});
+}
+
+void ReplayPlayer::_restore(const Keyframe& keyframe)
+{
+   LORAINE_PROFILE_SCOPE("ReplayPlayer::restore");
+   // the keyframe's state is copied, so that it can be restored again later on
+   m_state = std::make_unique< GameState >(*keyframe.state);
+   m_step = keyframe.step;
+   m_next_action = keyframe.next_action;
+}
+
+actions::Action ReplayPlayer::_next_action(Team team)
+{
+   if(m_next_action == m_replay.actions.end()) {
+      throw std::runtime_error(
+         "Replay desynchronized at step " + std::to_string(m_step)
+         + ": the game asks for more actions than were recorded.");
+   }
+   auto action = GameLog::decode_action(*m_next_action, *m_state);
+   ++m_next_action;
+   if(action.team() != team) {
+      throw std::runtime_error(
+         "Replay desynchronized at step " + std::to_string(m_step)
+         + ": the recorded action belongs to the other team.");
+   }
+   return action;
+}
@@ -0,0 +1,87 @@
+
+#include "core/timer_wheel.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "cards/card.h"
+#include "grants/grant.h"
+
+void TimerWheel::schedule(Timer timer)
+{
+   m_slots[_slot(timer.round, timer.phase)].emplace_back(std::move(timer));
+   m_size += 1;
+}
+
+std::vector< TimerWheel::Timer >& TimerWheel::pop_due(size_t round, RoundPhase phase)
+{
+   m_due.clear();
+   auto& slot = m_slots[_slot(round, phase)];
+   // the timers not yet due (a multiple of the horizon ahead) keep their order in the slot
+   auto kept_end = slot.begin();
+   for(auto& timer : slot) {
+      if(timer.round <= round) {
+         m_due.emplace_back(std::move(timer));
+      } else {
+         if(&*kept_end != &timer) {
+            *kept_end = std::move(timer);
+         }
+         ++kept_end;
+      }
+   }
+   slot.erase(kept_end, slot.end());
+   m_size -= m_due.size();
+   return m_due;
+}
+
+void TimerWheel::cancel(const sptr< Card >& card)
+{
+   if(m_size == 0 && m_due.empty()) {
+      return;
+   }
+   for(auto& slot : m_slots) {
+      auto size_before = slot.size();
+      slot.erase(
+         std::remove_if(
+            slot.begin(), slot.end(), [&](const Timer& timer) { return timer.card == card; }),
+         slot.end());
+      m_size -= size_before - slot.size();
+   }
+   for(auto& timer : m_due) {
+      if(timer.card == card) {
+         timer.cancelled = true;
+      }
+   }
+}
+
+bool TimerWheel::is_scheduled(Kind kind, const sptr< Card >& card) const
+{
+   return std::any_of(m_slots.begin(), m_slots.end(), [&](const auto& slot) {
+      return std::any_of(slot.begin(), slot.end(), [&](const Timer& timer) {
+         return timer.kind == kind && timer.card == card;
+      });
+   });
+}
+
+void TimerWheel::clear()
+{
+   for(auto& slot : m_slots) {
+      slot.clear();
+   }
+   m_due.clear();
+   m_size = 0;
+}
+
+sptr< Grant > TimerWheel::_grant_of(const Card& card, const Grant& grant)
+{
+   for(const auto* grants : {&card.mutables().grants_temp, &card.mutables().grants}) {
+      auto pos = std::find_if(grants->begin(), grants->end(), [&](const sptr< Grant >& held) {
+         return held->get_uuid() == grant.get_uuid();
+      });
+      if(pos != grants->end()) {
+         return *pos;
+      }
+   }
+   throw std::logic_error(
+      "The card " + card.immutables().code + " does not hold the grant of its expiry timer.");
+}
@@ -0,0 +1,215 @@
+
+#include "io/trajectory.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <utility>
+
+namespace {
+
+TrajectoryHeader read_header(const u8* data, size_t size, const std::filesystem::path& path)
+{
+   TrajectoryHeader header;
+   if(size < TrajectoryHeader::data_offset) {
+      throw std::runtime_error("Trajectory file " + path.string() + " is truncated.");
+   }
+   std::memcpy(&header, data, sizeof(TrajectoryHeader));
+   if(header.magic != TrajectoryHeader::file_magic) {
+      throw std::runtime_error(path.string() + " is not a trajectory file.");
+   }
+   if(header.format_version != TrajectoryHeader::current_format) {
+      throw std::runtime_error(
+         "Trajectory file " + path.string() + " has the unsupported format version "
+         + std::to_string(header.format_version) + ".");
+   }
+   if(header.stride != header.layout().stride()
+      || size < TrajectoryHeader::data_offset + header.n_records * header.stride) {
+      throw std::runtime_error("Trajectory file " + path.string() + " is corrupt.");
+   }
+   return header;
+}
+
+}  // namespace
+
+TrajectoryWriter::TrajectoryWriter(
+   std::filesystem::path base_path,
+   TrajectoryLayout layout,
+   u32 encoder_version,
+   size_t records_per_buffer,
+   size_t records_per_shard)
+    : m_owned_sink(std::make_unique< OutputSink >(OutputSink::Options{
+       2, std::max(records_per_buffer, size_t(1)) * layout.stride(), 1})),
+      m_sink(m_owned_sink.get()),
+      m_base_path(std::move(base_path)),
+      m_layout(layout),
+      m_encoder_version(encoder_version),
+      m_stride(layout.stride()),
+      m_records_per_buffer(std::max(records_per_buffer, size_t(1))),
+      m_records_per_shard(std::max(records_per_shard, size_t(1)))
+{
+   _open_shard();
+}
+
+TrajectoryWriter::TrajectoryWriter(
+   OutputSink& sink,
+   std::filesystem::path base_path,
+   TrajectoryLayout layout,
+   u32 encoder_version,
+   size_t records_per_shard)
+    : m_sink(&sink),
+      m_base_path(std::move(base_path)),
+      m_layout(layout),
+      m_encoder_version(encoder_version),
+      m_stride(layout.stride()),
+      m_records_per_buffer(std::max(sink.options().buffer_capacity / m_stride, size_t(1))),
+      m_records_per_shard(std::max(records_per_shard, size_t(1)))
+{
+   _open_shard();
+}
+
+TrajectoryWriter::~TrajectoryWriter()
+{
+   try {
+      close();
+   } catch(...) {
+      // errors are only reported by an explicit close
+   }
+}
+
+std::filesystem::path TrajectoryWriter::shard_path(
+   const std::filesystem::path& base_path,
+   size_t shard)
+{
+   auto path = base_path;
+   path += "." + std::to_string(shard) + ".traj";
+   return path;
+}
+
+TrajectoryRecord TrajectoryWriter::append()
+{
+   if(m_closed) {
+      throw std::logic_error("Records cannot be appended to a closed trajectory writer.");
+   }
+   if(m_shard_records == m_records_per_shard) {
+      _close_shard();
+      m_shard += 1;
+      _open_shard();
+   }
+   if(m_buffer_records == m_records_per_buffer) {
+      _hand_over();
+   }
+   if(m_buffer.empty()) {
+      // the sink's buffers are allocated by operator new and thus aligned for the record fields
+      m_buffer = m_sink->acquire();
+      m_buffer.resize(m_records_per_buffer * m_stride);
+   }
+   // a recycled buffer is cleared, so resizing it zeroed the records
+   u8* data = m_buffer.data() + m_buffer_records * m_stride;
+   m_buffer_records += 1;
+   m_shard_records += 1;
+   m_n_records += 1;
+   return {data, m_layout};
+}
+
+void TrajectoryWriter::flush()
+{
+   _hand_over();
+   m_sink->drain();
+}
+
+void TrajectoryWriter::close()
+{
+   if(m_closed) {
+      return;
+   }
+   m_closed = true;
+   _close_shard();
+   m_sink->drain();
+}
+
+void TrajectoryWriter::_hand_over()
+{
+   if(m_buffer_records == 0) {
+      return;
+   }
+   m_buffer.resize(m_buffer_records * m_stride);
+   m_buffer_records = 0;
+   m_sink->submit(m_file, std::exchange(m_buffer, OutputSink::Buffer{}));
+}
+
+void TrajectoryWriter::_open_shard()
+{
+   m_file = m_sink->open(shard_path(m_base_path, m_shard));
+   m_shard_records = 0;
+   // the header is written when the shard is closed, the records follow it page aligned
+   m_sink->skip(m_file, TrajectoryHeader::data_offset);
+}
+
+void TrajectoryWriter::_close_shard()
+{
+   _hand_over();
+   TrajectoryHeader header;
+   header.encoder_version = m_encoder_version;
+   header.observation_size = m_layout.observation_size;
+   header.n_actions = m_layout.n_actions;
+   header.stride = m_stride;
+   header.n_records = m_shard_records;
+   auto header_page = m_sink->acquire();
+   header_page.resize(TrajectoryHeader::data_offset);
+   std::memcpy(header_page.data(), &header, sizeof(TrajectoryHeader));
+   m_sink->submit_at(m_file, 0, std::move(header_page));
+   m_sink->close(m_file);
+}
+
+TrajectoryReader::TrajectoryReader(const std::vector< std::filesystem::path >& shard_paths)
+{
+   m_shards.reserve(shard_paths.size());
+   m_first_record.reserve(shard_paths.size());
+   for(const auto& path : shard_paths) {
+      MappedFile mapping(path);
+      auto header = read_header(mapping.data(), mapping.size(), path);
+      if(m_shards.empty()) {
+         m_layout = header.layout();
+         m_encoder_version = header.encoder_version;
+         m_stride = header.stride;
+      } else if(header.layout() != m_layout || header.encoder_version != m_encoder_version) {
+         throw std::runtime_error(
+            "Trajectory file " + path.string() + " does not match the layout of the others.");
+      }
+      m_first_record.emplace_back(m_n_records);
+      m_n_records += header.n_records;
+      m_shards.push_back(Shard{std::move(mapping), header.n_records});
+   }
+}
+
+TrajectoryReader TrajectoryReader::open(const std::filesystem::path& base_path)
+{
+   std::vector< std::filesystem::path > paths;
+   for(size_t shard = 0; std::filesystem::exists(TrajectoryWriter::shard_path(base_path, shard));
+       ++shard) {
+      paths.emplace_back(TrajectoryWriter::shard_path(base_path, shard));
+   }
+   if(paths.empty()) {
+      throw std::runtime_error("No trajectory shards found for " + base_path.string() + ".");
+   }
+   return TrajectoryReader(paths);
+}
+
+ConstTrajectoryRecord TrajectoryReader::operator[](size_t idx) const
+{
+   // the last shard beginning at or before the index
+   size_t shard = size_t(
+      std::upper_bound(m_first_record.begin(), m_first_record.end(), idx) - m_first_record.begin()
+      - 1);
+   return {m_shards[shard].records() + (idx - m_first_record[shard]) * m_stride, m_layout};
+}
+
+ConstTrajectoryRecord TrajectoryReader::at(size_t idx) const
+{
+   if(idx >= m_n_records) {
+      throw std::out_of_range(
+         "Record " + std::to_string(idx) + " requested of " + std::to_string(m_n_records) + ".");
+   }
+   return (*this)[idx];
+}
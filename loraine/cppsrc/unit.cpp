@@ -3,6 +3,16 @@
 
 #include "core/gamemode.h"
 
+Unit::Unit(const Unit& unit) : Unit(unit, unit.immutables().uuid) {}
+
+Unit::Unit(const Unit& unit, UUID uuid)
+    : CloneableCard(unit, uuid),
+      m_unit_immutables(unit.m_unit_immutables),
+      m_unit_mutables(unit.m_unit_mutables),
+      m_hooks(unit.m_hooks ? std::make_unique< UnitHooks >(*unit.m_hooks) : nullptr)
+{
+}
+
 void Unit::add_power(long amount, bool permanent)
 {
    if(permanent) {
@@ -10,6 +20,7 @@ void Unit::add_power(long amount, bool permanent)
    } else {
       m_unit_mutables.power_delta += amount;
    }
+   _update_stats();
 }
 void Unit::add_health(long amount, bool permanent)
 {
@@ -19,39 +30,45 @@ void Unit::add_health(long amount, bool permanent)
    } else {
       m_unit_mutables.health_delta += amount;
    }
+   _update_stats();
 }
 void Unit::health(size_t health)
 {
-   m_unit_mutables.health_delta = static_cast< decltype(m_unit_mutables.health_delta) >(
-      health - m_unit_mutables.health_base);
+   m_unit_mutables.health_delta = static_cast< StatType >(
+      long(health) - m_unit_mutables.health_base);
+   _update_stats();
 }
 void Unit::power(size_t power, bool as_delta)
 {
    if(as_delta) {
-      m_unit_mutables.power_delta = static_cast< decltype(m_unit_mutables.power_delta) >(
-         power - m_unit_mutables.power_base);
+      m_unit_mutables.power_delta = static_cast< StatType >(
+         long(power) - m_unit_mutables.power_base);
    } else {
-      m_unit_mutables.power_base = power;
+      m_unit_mutables.power_base = static_cast< StatType >(power);
       m_unit_mutables.power_delta = 0;
    }
+   _update_stats();
 }
 long Unit::take_damage(const sptr< Card >& damaging_card, long amount)
 {
    if(has_keyword(Keyword::TOUGH)) {
       --amount;
    }
-   for(auto& dmg_modifier : m_unit_mutables.dmg_modifiers) {
-      dmg_modifier(*damaging_card, amount);
+   if(m_hooks) {
+      for(auto modifier : m_hooks->dmg_modifiers) {
+         amount = modifiers::DamageModifiers::apply(modifier, *damaging_card, amount);
+      }
    }
    auto health_before = health();
    m_unit_mutables.damage += amount;
+   _update_stats();
    // the damage taken by the unit is returned: health_before - health_after
    return health_before - health();
 }
 void Unit::kill(const sptr< Card >& cause)
 {
-   if(m_unit_mutables.kill_func) {
-      m_unit_mutables.kill_func(cause);
+   if(m_hooks && m_hooks->kill_func) {
+      m_hooks->kill_func(cause);
    } else {
       m_unit_mutables.alive = false;
    }
@@ -59,17 +76,37 @@ void Unit::kill(const sptr< Card >& cause)
 size_t Unit::heal(size_t amount)
 {
    auto before = m_unit_mutables.damage;
-   m_unit_mutables.damage -= std::min(m_unit_mutables.damage, amount);
-   return before - m_unit_mutables.damage;
+   m_unit_mutables.damage -= std::min(long(m_unit_mutables.damage), long(amount));
+   _update_stats();
+   return size_t(before - m_unit_mutables.damage);
+}
+void Unit::add_damage_modifier(modifiers::ModifierId modifier)
+{
+   _hooks().dmg_modifiers.emplace_back(modifier);
+}
+void Unit::kill_func(KillFunc func)
+{
+   _hooks().kill_func = func;
 }
 long Unit::health_raw() const
 {
-   long health_base = static_cast< long int >(m_unit_mutables.health_base);
-   long damage = static_cast< long >(m_unit_mutables.damage);
-   return health_base + m_unit_mutables.health_delta - damage;
+   return long(m_unit_mutables.health_base) + m_unit_mutables.health_delta
+          - m_unit_mutables.damage;
 }
 
 long Unit::power_raw() const
 {
-   return m_unit_mutables.power_base + static_cast< size_t >(m_unit_mutables.power_delta);
+   return long(m_unit_mutables.power_base) + m_unit_mutables.power_delta;
+}
+Unit::UnitHooks& Unit::_hooks()
+{
+   if(not m_hooks) {
+      m_hooks = std::make_unique< UnitHooks >();
+   }
+   return *m_hooks;
+}
+void Unit::_update_stats()
+{
+   m_unit_mutables.power = static_cast< StatType >(std::max(0L, power_raw()));
+   m_unit_mutables.health = static_cast< StatType >(std::max(0L, health_raw()));
 }
@@ -45,6 +45,49 @@ enum struct Region {
 
 constexpr const size_t n_regions = static_cast< size_t >(Region::TARGON) + 1;
 
+/**
+ * A set of regions as a bitmask, bit i standing for the region of value i.
+ */
+class RegionSet {
+  public:
+   constexpr RegionSet() noexcept = default;
+   constexpr explicit RegionSet(u8 bits) noexcept : m_bits(bits) {}
+
+   constexpr void add(Region region) noexcept { m_bits |= _bit(region); }
+   constexpr void remove(Region region) noexcept { m_bits &= u8(~_bit(region)); }
+   [[nodiscard]] constexpr bool contains(Region region) const noexcept
+   {
+      return (m_bits & _bit(region)) != 0;
+   }
+   [[nodiscard]] constexpr size_t size() const noexcept
+   {
+      size_t count = 0;
+      for(u8 bits = m_bits; bits != 0; bits &= u8(bits - 1)) {
+         ++count;
+      }
+      return count;
+   }
+   [[nodiscard]] constexpr bool empty() const noexcept { return m_bits == 0; }
+   [[nodiscard]] constexpr u8 bits() const noexcept { return m_bits; }
+
+   constexpr RegionSet& operator|=(RegionSet other) noexcept
+   {
+      m_bits |= other.m_bits;
+      return *this;
+   }
+   constexpr bool operator==(RegionSet other) const noexcept { return m_bits == other.m_bits; }
+   constexpr bool operator!=(RegionSet other) const noexcept { return m_bits != other.m_bits; }
+
+  private:
+   u8 m_bits = 0;
+
+   constexpr static u8 _bit(Region region) noexcept
+   {
+      return u8(1U << static_cast< size_t >(region));
+   }
+};
+static_assert(n_regions <= 8, "RegionSet holds the regions in 8 bits.");
+
 enum class Keyword {
    ALLEGIANCE = 0,  // define the starting value, necessary for indexing.
    ATTACK,
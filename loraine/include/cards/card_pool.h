@@ -0,0 +1,217 @@
+
+#ifndef LORAINE_CARD_POOL_H
+#define LORAINE_CARD_POOL_H
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+#include "cards/card_defs.h"
+#include "cards/catalog.h"
+#include "utils/bitmap.h"
+#include "utils/span.h"
+#include "utils/types.h"
+
+class CardQuery;
+
+/**
+ * Bitmap indices over the cards of a catalog, one bitmap per value of each card attribute (region,
+ * mana cost, card type, super type, group, rarity, keyword and collectibility), bit i standing for
+ * the catalog's card i.
+ *
+ * Finding the cards that match several attributes, e.g. for deck generation or for the effects
+ * that create or draw "a random X", is then an intersection of a few bitmaps rather than a pass
+ * over every card with a filter function. The pool only reads its catalog and indices after
+ * construction, so one pool serves the games of all threads.
+ */
+class CardPool {
+  public:
+   explicit CardPool(const CardCatalog& catalog);
+
+   [[nodiscard]] auto& catalog() const { return *m_catalog; }
+   [[nodiscard]] size_t size() const { return m_all.size(); }
+   /**
+    * A query over all cards of the pool, to be narrowed down.
+    */
+   [[nodiscard]] CardQuery query() const;
+
+   [[nodiscard]] const Bitmap& all() const { return m_all; }
+   [[nodiscard]] const Bitmap& collectible() const { return m_collectible; }
+   [[nodiscard]] const Bitmap& region(Region region) const
+   {
+      return m_regions[static_cast< size_t >(region)];
+   }
+   [[nodiscard]] const Bitmap& card_type(CardType type) const
+   {
+      return m_card_types[static_cast< size_t >(type)];
+   }
+   [[nodiscard]] const Bitmap& super_type(CardSuperType super_type) const
+   {
+      return m_super_types[static_cast< size_t >(super_type)];
+   }
+   [[nodiscard]] const Bitmap& group(Group group) const
+   {
+      return m_groups[static_cast< size_t >(group)];
+   }
+   [[nodiscard]] const Bitmap& rarity(Rarity rarity) const
+   {
+      return m_rarities[static_cast< size_t >(rarity)];
+   }
+   [[nodiscard]] const Bitmap& keyword(Keyword keyword) const
+   {
+      return m_keywords[static_cast< size_t >(keyword)];
+   }
+   /**
+    * The cards of exactly the given mana cost.
+    */
+   [[nodiscard]] const Bitmap& cost(size_t mana_cost) const
+   {
+      return mana_cost < m_costs.size() ? m_costs[mana_cost] : m_none;
+   }
+   /**
+    * The cards of at most the given mana cost.
+    */
+   [[nodiscard]] const Bitmap& cost_at_most(size_t mana_cost) const
+   {
+      return mana_cost < m_costs_at_most.size() ? m_costs_at_most[mana_cost] : m_all;
+   }
+
+   /**
+    * A card of the given ones chosen uniformly at random, or nullptr if there is none.
+    */
+   template < class RNG >
+   [[nodiscard]] const CatalogEntry* sample(const Bitmap& cards, RNG&& rng) const;
+   /**
+    * A card of the given ones chosen at random by their weights, given per catalog card, or nullptr
+    * if none of them has a positive weight.
+    */
+   template < class RNG >
+   [[nodiscard]] const CatalogEntry* sample(
+      const Bitmap& cards,
+      Span< const double > weights,
+      RNG&& rng) const;
+
+  private:
+   const CardCatalog* m_catalog;
+   Bitmap m_all;
+   Bitmap m_none;
+   Bitmap m_collectible;
+   std::array< Bitmap, n_regions > m_regions;
+   std::array< Bitmap, static_cast< size_t >(CardType::TRAP) + 1 > m_card_types;
+   std::array< Bitmap, n_cardsupertypes > m_super_types;
+   std::array< Bitmap, n_groups > m_groups;
+   std::array< Bitmap, n_rarities > m_rarities;
+   std::array< Bitmap, n_keywords > m_keywords;
+   // indexed by the mana cost, up to the highest one in the catalog
+   std::vector< Bitmap > m_costs;
+   std::vector< Bitmap > m_costs_at_most;
+};
+
+/**
+ * The cards of a pool matching all the attributes asked for so far, narrowed down in place:
+ *
+ *    auto query = pool.query().region(Region::DEMACIA).card_type(CardType::UNIT).cost_at_most(3);
+ *    const auto* card = query.sample(state.rng());
+ */
+class CardQuery {
+  public:
+   explicit CardQuery(const CardPool& pool) : m_pool(&pool), m_cards(pool.all()) {}
+
+   CardQuery& region(Region region) { return _and(m_pool->region(region)); }
+   /**
+    * Keeps the cards of any of the regions.
+    */
+   CardQuery& regions(RegionSet regions);
+   CardQuery& card_type(CardType type) { return _and(m_pool->card_type(type)); }
+   CardQuery& super_type(CardSuperType super_type) { return _and(m_pool->super_type(super_type)); }
+   CardQuery& group(Group group) { return _and(m_pool->group(group)); }
+   CardQuery& rarity(Rarity rarity) { return _and(m_pool->rarity(rarity)); }
+   CardQuery& keyword(Keyword keyword) { return _and(m_pool->keyword(keyword)); }
+   CardQuery& without_keyword(Keyword keyword)
+   {
+      m_cards.subtract(m_pool->keyword(keyword));
+      return *this;
+   }
+   CardQuery& collectible(bool collectible = true);
+   CardQuery& cost(size_t mana_cost) { return _and(m_pool->cost(mana_cost)); }
+   /**
+    * Keeps the cards whose mana cost is within [min_cost, max_cost].
+    */
+   CardQuery& cost_between(size_t min_cost, size_t max_cost);
+   /**
+    * Keeps the given cards, e.g. those of another query.
+    */
+   CardQuery& only(const Bitmap& cards) { return _and(cards); }
+   CardQuery& exclude(const Bitmap& cards)
+   {
+      m_cards.subtract(cards);
+      return *this;
+   }
+
+   [[nodiscard]] auto& pool() const { return *m_pool; }
+   [[nodiscard]] const Bitmap& cards() const { return m_cards; }
+   [[nodiscard]] size_t count() const { return m_cards.count(); }
+   [[nodiscard]] bool empty() const { return m_cards.none(); }
+
+   template < class RNG >
+   [[nodiscard]] const CatalogEntry* sample(RNG&& rng) const
+   {
+      return m_pool->sample(m_cards, std::forward< RNG >(rng));
+   }
+   template < class RNG >
+   [[nodiscard]] const CatalogEntry* sample(Span< const double > weights, RNG&& rng) const
+   {
+      return m_pool->sample(m_cards, weights, std::forward< RNG >(rng));
+   }
+
+  private:
+   const CardPool* m_pool;
+   Bitmap m_cards;
+
+   CardQuery& _and(const Bitmap& cards)
+   {
+      m_cards &= cards;
+      return *this;
+   }
+};
+
+inline CardQuery CardPool::query() const
+{
+   return CardQuery(*this);
+}
+
+template < class RNG >
+const CatalogEntry* CardPool::sample(const Bitmap& cards, RNG&& rng) const
+{
+   auto n_cards = cards.count();
+   if(n_cards == 0) {
+      return nullptr;
+   }
+   std::uniform_int_distribution< size_t > dist(0, n_cards - 1);
+   return &(*m_catalog)[cards.select(dist(rng))];
+}
+
+template < class RNG >
+const CatalogEntry* CardPool::sample(
+   const Bitmap& cards,
+   Span< const double > weights,
+   RNG&& rng) const
+{
+   double total = 0.;
+   cards.for_each([&](size_t idx) { total += std::max(0., weights[idx]); });
+   if(not (total > 0.)) {
+      return nullptr;
+   }
+   double target = std::uniform_real_distribution< double >(0., total)(rng);
+   const CatalogEntry* chosen = nullptr;
+   cards.for_each([&](size_t idx) {
+      if(weights[idx] > 0. && target >= 0.) {
+         chosen = &(*m_catalog)[idx];
+         target -= weights[idx];
+      }
+   });
+   return chosen;
+}
+
+#endif  // LORAINE_CARD_POOL_H
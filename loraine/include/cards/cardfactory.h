@@ -2,7 +2,84 @@
 #ifndef LORAINE_CARDFACTORY_H
 #define LORAINE_CARDFACTORY_H
 
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "cards/catalog.h"
+#include "core/gamedefs.h"
+#include "utils/arena.h"
+#include "utils/types.h"
+
+class Card;
+
+/**
+ * Builds cards by their code from prototypes.
+ *
+ * The factory keeps one fully built prototype per card code: one for every card of its catalog
+ * (built with the catalog's stats and keywords), replaced or joined by those added in code, e.g.
+ * with their effects, targeters and toll configured. A card is created by cloning its prototype,
+ * into the arena of the game creating it if one is given, so that creating the cards a game
+ * creates, summons and copies all the time does not re-run any construction logic.
+ *
+ * The prototype of a catalog card is built on its first creation, so that only the cards in use
+ * cost memory beyond the mapped catalog. Building is synchronized per card, so a factory is shared
+ * by the games of all threads. Adding prototypes is not synchronized with creating cards.
+ */
 class CardFactory {
+  public:
+   /**
+    * A factory without a catalog, creating only the cards of the prototypes added to it.
+    */
+   CardFactory() = default;
+   explicit CardFactory(CardCatalog catalog);
+   explicit CardFactory(const std::filesystem::path& catalog_path);
+   CardFactory(const CardFactory&) = delete;
+   CardFactory& operator=(const CardFactory&) = delete;
+
+   /**
+    * Adds the prototype of the card's code, replacing any previous one. The prototype is owned by
+    * the factory from then on.
+    */
+   void add_prototype(sptr< Card > prototype);
+   /**
+    * The prototype of the given code, or nullptr if there is none. Builds the prototype of a
+    * catalog card on first use, throwing std::invalid_argument for the catalog's trap cards (which
+    * cannot be built from data alone) and cards of unknown types.
+    */
+   [[nodiscard]] const Card* prototype(std::string_view code) const;
+
+   /**
+    * A new card of the given code, owned by the team. Throws std::out_of_range if there is no card
+    * of the code and std::invalid_argument if its catalog entry cannot be built (see `prototype`).
+    */
+   [[nodiscard]] sptr< Card > create(
+      std::string_view code,
+      Team owner,
+      const sptr< Arena >& arena = nullptr) const;
+   /**
+    * A copy of the card of its class (along with its current state and grants) with an identity of
+    * its own, allocated from the arena if one is given.
+    */
+   [[nodiscard]] static sptr< Card > clone(const Card& card, const sptr< Arena >& arena = nullptr);
+
+   [[nodiscard]] bool has_catalog() const { return m_catalog.has_value(); }
+   [[nodiscard]] auto& catalog() const { return m_catalog.value(); }
+
+  private:
+   std::optional< CardCatalog > m_catalog = std::nullopt;
+   // the prototypes added in code, keyed by views of their own codes
+   std::unordered_map< std::string_view, sptr< Card > > m_prototypes{};
+   // the prototypes of the catalog cards by catalog index, each built once on first use
+   mutable std::vector< sptr< Card > > m_catalog_prototypes{};
+   mutable std::vector< std::once_flag > m_built{};
+
+   const Card* _catalog_prototype(const CatalogEntry& entry) const;
+   static sptr< Card > _build(const CardCatalog& catalog, const CatalogEntry& entry);
 };
 
 #endif  // LORAINE_CARDFACTORY_H
@@ -0,0 +1,188 @@
+
+#ifndef LORAINE_CATALOG_H
+#define LORAINE_CATALOG_H
+
+#include <array>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cards/card_defs.h"
+#include "io/mapped_file.h"
+#include "utils/span.h"
+#include "utils/types.h"
+
+/**
+ * A string in the catalog's string table.
+ */
+struct CatalogString {
+   u32 offset = 0;
+   u32 size = 0;
+};
+
+/**
+ * The fixed-size record of a card in the catalog: its ConstState fields, its unit stats and
+ * keywords and the cards associated with it (e.g. the spell a champion creates or its level up).
+ * The enumerations are stored by their values in cards/card_defs.h, so reordering them requires a
+ * new catalog format version.
+ */
+struct CatalogEntry {
+   CatalogString code;
+   CatalogString name;
+   CatalogString description;
+   CatalogString lore;
+   // bit i is set if the card has the keyword of value i
+   u64 keywords;
+   u8 region;
+   u8 group;
+   u8 super_type;
+   u8 rarity;
+   u8 card_type;
+   u8 collectible;
+   u16 padding0;
+   u32 mana_cost;
+   u32 power;
+   u32 health;
+   // the associated cards, as a range of the catalog's associated card indices
+   u32 first_associated;
+   u32 n_associated;
+   u32 padding1;
+
+   [[nodiscard]] bool has_keyword(Keyword keyword) const
+   {
+      return (keywords >> static_cast< size_t >(keyword)) & 1;
+   }
+};
+static_assert(sizeof(CatalogEntry) == 72, "The catalog entry layout is expected to be 72 bytes.");
+
+/**
+ * The header at the start of a catalog file. It is followed by the card entries, the associated
+ * card indices, the code index and the string table, each 8 byte aligned.
+ */
+struct CatalogHeader {
+   constexpr static std::array< char, 8 > file_magic = {'L', 'O', 'R', 'C', 'A', 'T', '\0', '\0'};
+   constexpr static u32 current_format = 1;
+
+   std::array< char, 8 > magic = file_magic;
+   u32 format_version = current_format;
+   u32 n_cards = 0;
+   // the version of the card data compiled into the catalog (e.g. the patch of the data dump)
+   CatalogString data_version{};
+   // the number of slots of the code index, a power of 2
+   u32 index_size = 0;
+   u32 n_associated = 0;
+   u64 cards_offset = 0;
+   u64 associated_offset = 0;
+   u64 index_offset = 0;
+   u64 strings_offset = 0;
+   u64 strings_size = 0;
+};
+static_assert(sizeof(CatalogHeader) == 72, "The catalog header layout is expected to be 72 bytes.");
+
+/**
+ * A card catalog compiled by meta/compile_catalog.py (or a CatalogBuilder), mapped into memory.
+ *
+ * Nothing is parsed or copied on opening: entries and strings are read in place, and a card is
+ * found by its code through an open addressing hash index in the file. Every process opening the
+ * same catalog thus shares one page cache copy of it. Opening validates the header and checks
+ * once that every string, associated card range and index slot lies within the file, so that no
+ * later access has to.
+ */
+class CardCatalog {
+  public:
+   /**
+    * Maps the catalog file. Throws std::runtime_error if it is not a catalog of the current format
+    * or is corrupt.
+    */
+   explicit CardCatalog(const std::filesystem::path& path);
+
+   /**
+    * The hash of a card code the index is built with (64 bit FNV-1a).
+    */
+   static u64 hash_code(std::string_view code);
+
+   [[nodiscard]] size_t size() const { return m_header->n_cards; }
+   [[nodiscard]] std::string_view data_version() const { return string(m_header->data_version); }
+
+   [[nodiscard]] const CatalogEntry& operator[](size_t idx) const { return m_cards[idx]; }
+   [[nodiscard]] auto begin() const { return m_cards; }
+   [[nodiscard]] auto end() const { return m_cards + size(); }
+   /**
+    * The entry of the card with the given code, or nullptr if there is none.
+    */
+   [[nodiscard]] const CatalogEntry* find(std::string_view code) const;
+   /**
+    * The entry of the card with the given code. Throws std::out_of_range if there is none.
+    */
+   [[nodiscard]] const CatalogEntry& at(std::string_view code) const;
+   [[nodiscard]] size_t index_of(const CatalogEntry& entry) const
+   {
+      return size_t(&entry - m_cards);
+   }
+
+   [[nodiscard]] std::string_view string(const CatalogString& str) const
+   {
+      return {m_strings + str.offset, str.size};
+   }
+   /**
+    * The indices of the cards associated with the entry's.
+    */
+   [[nodiscard]] Span< const u32 > associated(const CatalogEntry& entry) const
+   {
+      return {m_associated + entry.first_associated, entry.n_associated};
+   }
+
+  private:
+   MappedFile m_file;
+   const CatalogHeader* m_header;
+   const CatalogEntry* m_cards;
+   const u32* m_associated;
+   // the card index + 1 of each slot, 0 for empty slots
+   const u32* m_index;
+   const char* m_strings;
+
+   [[nodiscard]] bool _is_consistent() const;
+};
+
+/**
+ * Writes a catalog file from card data given in memory, e.g. for tests or custom card pools. The
+ * card data dumps are compiled by meta/compile_catalog.py instead, which writes the same format.
+ */
+class CatalogBuilder {
+  public:
+   struct CardData {
+      std::string code;
+      std::string name;
+      std::string description = "";
+      std::string lore = "";
+      Region region = Region::DEMACIA;
+      Group group = Group::NONE;
+      CardSuperType super_type = CardSuperType::NONE;
+      Rarity rarity = Rarity::NONE;
+      CardType card_type = CardType::UNIT;
+      bool collectible = true;
+      size_t mana_cost = 0;
+      size_t power = 0;
+      size_t health = 0;
+      std::vector< Keyword > keywords = {};
+      std::vector< std::string > associated_codes = {};
+   };
+
+   explicit CatalogBuilder(std::string data_version) : m_data_version(std::move(data_version)) {}
+
+   void add(CardData card) { m_cards.emplace_back(std::move(card)); }
+   /**
+    * Writes the catalog. Throws std::invalid_argument if two cards share a code or an associated
+    * card code is not among the cards added.
+    */
+   void write(const std::filesystem::path& path) const;
+
+   [[nodiscard]] auto size() const { return m_cards.size(); }
+
+  private:
+   std::string m_data_version;
+   std::vector< CardData > m_cards{};
+};
+
+#endif  // LORAINE_CATALOG_H
@@ -16,6 +16,8 @@
 #include "events/event_subscriber.h"
 #include "events/lor_events/event_labels.h"
 #include "utils/algorithms.h"
+#include "utils/arena.h"
+#include "utils/small_function.h"
 #include "utils/types.h"
 #include "utils/utils.h"
 
@@ -30,6 +32,7 @@ class Grant;
 class Card: public Cloneable< abstract_method< Card > >, public Targetable {
   public:
    using EffectMap = std::map< events::EventLabel, std::vector< sptr< EffectBase > > >;
+   using CardMap = SmallFunction< sptr< Card >(const sptr< Card >&) >;
 
    struct ConstState {
       // the spell code
@@ -69,7 +72,8 @@ class Card: public Cloneable< abstract_method< Card > >, public Targetable {
       size_t position;
       // whether the spell is observable by all or only by the owner
       bool hidden;
-      // when m_effects move the base cost to a new permanent value
+      // when m_effects move the base cost to a new permanent value. Changes to the cost must go
+      // through the card's methods, which keep the cached cost up to date
       long int mana_cost_base = 0;
       // the current change to the mana cost of the spell
       long int mana_cost_delta = 0;
@@ -89,10 +93,7 @@ class Card: public Cloneable< abstract_method< Card > >, public Targetable {
    [[nodiscard]] inline auto& immutables() { return m_immutables; }
    [[nodiscard]] inline auto& mutables() const { return m_mutables; }
    [[nodiscard]] inline auto& mutables() { return m_mutables; }
-   [[nodiscard]] inline auto mana_cost() const
-   {
-      return std::max(0L, m_mutables.mana_cost_base + m_mutables.mana_cost_delta);
-   }
+   [[nodiscard]] inline long mana_cost() const { return m_mana_cost; }
    void effects(events::EventLabel e_type, std::vector< sptr< EffectBase > > effects);
    [[nodiscard]] inline auto& effects(events::EventLabel etype)
    {
@@ -145,7 +146,11 @@ class Card: public Cloneable< abstract_method< Card > >, public Targetable {
    }
 
    [[nodiscard]] bool has_effect(events::EventLabel e_type, const EffectBase& effect) const;
-   inline void reduce_mana_cost(long int amount) { m_mutables.mana_cost_delta -= amount; }
+   inline void reduce_mana_cost(long int amount)
+   {
+      m_mutables.mana_cost_delta -= amount;
+      _update_mana_cost();
+   }
 
    inline void move(Location loc, size_t index)
    {
@@ -167,6 +172,17 @@ class Card: public Cloneable< abstract_method< Card > >, public Targetable {
          store_grant(grant);
       }
    }
+   /**
+    * Points the grants and effects a copy cloned from its original at the copy `self` instead:
+    * the grants are bestowed on `self`, while their bestowing cards and the cards the effects are
+    * associated with are mapped by `card_of` (which maps the original to `self`).
+    */
+   void rebind(const sptr< Card >& self, const CardMap& card_of);
+   /**
+    * A copy of the card of its dynamic class with the identity `uuid`, allocated from the arena if
+    * one is given. Implemented by CloneableCard.
+    */
+   [[nodiscard]] virtual sptr< Card > clone_into(UUID uuid, const sptr< Arena >& arena) const = 0;
    inline void add_keyword(Keyword kword)
    {
       m_mutables.keywords[static_cast< unsigned long >(kword)] = true;
@@ -182,6 +198,7 @@ class Card: public Cloneable< abstract_method< Card > >, public Targetable {
       } else {
          m_mutables.mana_cost_delta += amount;
       }
+      _update_mana_cost();
    }
 
    inline bool operator==(const Card& rhs) const
@@ -205,6 +222,11 @@ class Card: public Cloneable< abstract_method< Card > >, public Targetable {
     */
    Card(const Card& card);
 
+   /*
+    * Copy constructor giving the copy an identity of its own (e.g. a card built from a prototype)
+    */
+   Card(const Card& card, UUID uuid);
+
    /*
     * Deleted copy assignment operator
     */
@@ -225,8 +247,39 @@ class Card: public Cloneable< abstract_method< Card > >, public Targetable {
    const ConstState m_immutables;
    // variable attributes of the spell
    MutableState m_mutables;
+   // the current mana cost, i.e. base and delta combined and clamped at 0
+   long m_mana_cost = 0;
+
+   inline void _update_mana_cost()
+   {
+      m_mana_cost = std::max(0L, m_mutables.mana_cost_base + m_mutables.mana_cost_delta);
+   }
 
    EffectMap _clone_effect_map(const EffectMap& emap);
+   [[nodiscard]] sptr< Grant > _clone_grant(const Card& original, const Grant& grant) const;
+};
+
+/**
+ * The Cloneable base of a concrete card class `Derived` deriving from `Base`, which implements
+ * Card::clone_into on top. Every concrete card class derives from it (down to those of tests and
+ * tools), so that copies of a card keep its class wherever they are made:
+ *
+ * class Unit : public CloneableCard< Unit, FieldCard > {...};
+ * class TestUnit : public CloneableCard< TestUnit, Unit > {...};
+ */
+template < typename Derived, typename Base >
+class CloneableCard: public Cloneable< Derived, inherit_constructors< Base > > {
+  public:
+   using Cloneable< Derived, inherit_constructors< Base > >::Cloneable;
+
+   [[nodiscard]] sptr< Card > clone_into(UUID uuid, const sptr< Arena >& arena) const override
+   {
+      const auto& card = static_cast< const Derived& >(*this);
+      if(arena == nullptr) {
+         return std::make_shared< Derived >(card, uuid);
+      }
+      return std::allocate_shared< Derived >(ArenaAllocator< Derived >(arena), card, uuid);
+   }
 };
 
 template < typename T >
@@ -4,10 +4,10 @@
 
 #include "fieldcard.h"
 
-class Landmark: public Cloneable<Landmark, inherit_constructors<FieldCard>> {
+class Landmark: public CloneableCard< Landmark, FieldCard > {
   public:
    // use base class constructors
-   using Cloneable::Cloneable;
+   using CloneableCard::CloneableCard;
 
 };
 
@@ -4,17 +4,17 @@
 
 #include "cardbase.h"
 
-class Spell: public Cloneable<Spell, inherit_constructors<Card>> {
+class Spell: public CloneableCard< Spell, Card > {
 
   public:
    // use base class constructors
-   using Cloneable::Cloneable;
+   using CloneableCard::CloneableCard;
 };
 
-class Skill : public Spell {
+class Skill: public CloneableCard< Skill, Spell > {
   public:
    // use base class constructors
-   using Spell::Spell;
+   using CloneableCard::CloneableCard;
 
 };
 
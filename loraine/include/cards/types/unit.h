@@ -5,9 +5,11 @@
 #include <utility>
 
 #include "cardbase.h"
+#include "effects/damage_modifiers.h"
 #include "fieldcard.h"
+#include "utils/small_function.h"
 
-class Unit: public Cloneable< Unit, inherit_constructors< FieldCard > > {
+class Unit: public CloneableCard< Unit, FieldCard > {
   public:
    struct ConstUnitState {
       // the fixed reference damage the unit deals.
@@ -16,54 +18,82 @@ class Unit: public Cloneable< Unit, inherit_constructors< FieldCard > > {
       const size_t health_ref;
    };
 
+   /// the integer type of the combat stats, small enough to keep them within a few bytes
+   using StatType = i16;
+
+   /**
+    * The stats read throughout combat and target filtering, packed into one small block. The
+    * derived power and health are cached and brought up to date by every change of their inputs,
+    * which is why the state can only be changed through the unit's methods.
+    */
    struct MutableUnitState {
+      MutableUnitState(size_t power, size_t health)
+          : power_base(static_cast< StatType >(power)),
+            health_base(static_cast< StatType >(health))
+      {
+      }
       // the permanent base power of the unit (can be moved by e.g. m_effects)
-      size_t power_base;
+      StatType power_base;
       // the permanent base health of the unit (can be moved by e.g. m_effects)
-      size_t health_base;
+      StatType health_base;
       // the current change to the unit power (temporary buffs/nerfs).
-      long int power_delta = 0;
+      StatType power_delta = 0;
       // the current change to the unit health (temporary buffs/nerfs).
-      long int health_delta = 0;
+      StatType health_delta = 0;
       // the damage the unit has taken
-      size_t damage = 0;
+      StatType damage = 0;
+      // the cached power and health, i.e. the above combined and clamped at 0
+      StatType power = 0;
+      StatType health = 0;
       // whether the unit is dead
       bool alive = true;
-      // the function to damage the unit with (e.g. needs to be flexible for Armored Elephant)
-      std::vector< std::function< long(Card&, long) > > dmg_modifiers{};
+   };
+
+   /**
+    * The rarely used customization points of a unit, kept out of line and only allocated once one
+    * of them is set.
+    */
+   using KillFunc = SmallFunction< void(const sptr< Card >& /*cause*/) >;
+   struct UnitHooks {
+      // the ids of the damage modifiers to apply (e.g. needs to be flexible for Armored Elephant)
+      std::vector< modifiers::ModifierId > dmg_modifiers{};
       // the function to kill the unit with (e.g. needs to be flexible for Unyielding Spirit)
-      std::function< void(const sptr< Card >& /*cause*/) > kill_func;
+      KillFunc kill_func;
    };
 
    [[nodiscard]] inline auto& unit_mutables() const { return m_unit_mutables; }
-   [[nodiscard]] inline auto& unit_mutables() { return m_unit_mutables; }
    [[nodiscard]] inline auto& unit_immutables() const { return m_unit_immutables; }
    [[nodiscard]] inline auto& unit_immutables() { return m_unit_immutables; }
 
    void power(size_t power, bool as_delta = true);
    [[nodiscard]] long power_raw() const;
-   [[nodiscard]] inline size_t power() const { return std::max(0L, power_raw()); }
+   [[nodiscard]] inline size_t power() const { return size_t(m_unit_mutables.power); }
    void add_power(long int amount, bool permanent);
    void health(size_t health);
    [[nodiscard]] long health_raw() const;
-   [[nodiscard]] inline size_t health() const { return std::max(long(0), health_raw()); }
+   [[nodiscard]] inline size_t health() const { return size_t(m_unit_mutables.health); }
    void add_health(long int amount, bool permanent);
    long take_damage(const sptr< Card >& damaging_card, long amount);
    void kill(const sptr< Card >& cause);
    size_t heal(size_t amount);
 
+   void add_damage_modifier(modifiers::ModifierId modifier);
+   void kill_func(KillFunc func);
+
    Unit(
       ConstState const_state,
       MutableState mutable_state,
       ConstUnitState const_unit_state,
       MutableUnitState mutable_unit_state)
-       : Cloneable(const_state, std::move(mutable_state)),
-         m_unit_mutables(std::move(mutable_unit_state)),
-         m_unit_immutables(std::move(const_unit_state))
+       : CloneableCard(const_state, std::move(mutable_state)),
+         m_unit_immutables(std::move(const_unit_state)),
+         m_unit_mutables(std::move(mutable_unit_state))
    {
+      _update_stats();
    }
    ~Unit() override = default;
-   Unit(const Unit& unit) = default;
+   Unit(const Unit& unit);
+   Unit(const Unit& unit, UUID uuid);
    Unit& operator=(const Unit& unit) = delete;
    Unit(Unit&&) = delete;
    Unit& operator=(Unit&&) = delete;
@@ -71,6 +101,10 @@ class Unit: public Cloneable< Unit, inherit_constructors< FieldCard > > {
   private:
    const ConstUnitState m_unit_immutables;
    MutableUnitState m_unit_mutables;
+   uptr< UnitHooks > m_hooks = nullptr;
+
+   UnitHooks& _hooks();
+   void _update_stats();
 };
 
 inline sptr< Unit > to_unit(const sptr< Card >& card)
@@ -34,6 +34,7 @@ enum class ActionLabel {
    REPLACE_FIELDCARD,
    TARGETING
 };
+constexpr const size_t n_action_labels = static_cast< size_t >(ActionLabel::TARGETING) + 1;
 
 enum class ActionRank { ELEMENTARY = 0, MACRO };
 
@@ -188,6 +189,8 @@ class PlayAction:
    {
    }
    [[nodiscard]] inline auto index() const { return m_hand_index; }
+   [[nodiscard]] inline auto target_index() const { return m_target_index; }
+   [[nodiscard]] inline auto& targets() const { return m_targets; }
 
    bool execute_impl(GameState& state);
 
@@ -264,7 +267,7 @@ class PlaceUnitAction:
    {
    }
    [[nodiscard]] inline auto to_bf() const { return m_to_bf; }
-   [[nodiscard]] inline auto indices_vec() const { return m_indices_vec; }
+   [[nodiscard]] inline auto& indices_vec() const { return m_indices_vec; }
 
    bool execute_impl(GameState& state);
 
@@ -2,6 +2,7 @@
 #ifndef LORAINE_ACTION_INVOKER_H
 #define LORAINE_ACTION_INVOKER_H
 
+#include <bitset>
 #include <utility>
 
 #include "action.h"
@@ -37,15 +38,16 @@ class GameState;
 class ActionInvokerBase {
   public:
    enum Label { DEFAULT = 0, COMBAT, MULLIGAN, REPLACING, TARGET };
-   explicit ActionInvokerBase(
-      Label label,
-      Logic* logic,
-      std::set< actions::ActionLabel > accepted_actions)
-       : m_label(label), m_logic(logic), m_accepted_actions(std::move(accepted_actions))
+   constexpr static size_t n_labels = Label::TARGET + 1;
+   /// a bit per action label, set if the label is accepted
+   using AcceptedActionsType = std::bitset< actions::n_action_labels >;
+
+   explicit ActionInvokerBase(Label label, Logic* logic, AcceptedActionsType accepted_actions)
+       : m_label(label), m_logic(logic), m_accepted_actions(accepted_actions)
    {
    }
-   explicit ActionInvokerBase(Label label, std::set< actions::ActionLabel > accepted_actions)
-       : m_label(label), m_logic(nullptr), m_accepted_actions(std::move(accepted_actions))
+   explicit ActionInvokerBase(Label label, AcceptedActionsType accepted_actions)
+       : m_label(label), m_logic(nullptr), m_accepted_actions(accepted_actions)
    {
    }
    virtual ~ActionInvokerBase() = default;
@@ -62,16 +64,20 @@ class ActionInvokerBase {
 
    void logic(Logic* logic) { m_logic = logic; }
    auto logic() { return m_logic; }
+   [[nodiscard]] auto logic() const { return m_logic; }
 
-   auto& accepted_actions() { return m_accepted_actions; }
    [[nodiscard]] auto& accepted_actions() const { return m_accepted_actions; }
+   [[nodiscard]] bool accepts(actions::ActionLabel label) const
+   {
+      return m_accepted_actions.test(static_cast< size_t >(label));
+   }
    virtual ActionInvokerBase* clone() = 0;
    [[nodiscard]] auto label() const { return m_label; }
 
   private:
    const Label m_label;
    Logic* m_logic;
-   const std::set< actions::ActionLabel > m_accepted_actions;
+   const AcceptedActionsType m_accepted_actions;
 };
 
 template < typename Derived, actions::ActionLabel... AcceptedActions >
@@ -81,21 +87,26 @@ class ActionInvoker: public ActionInvokerBase {
    using base::base;
 
    ActionInvoker(Logic* logic = nullptr)
-       : base(Derived::invoker_label, logic, std::set< actions::ActionLabel >{AcceptedActions...})
+       : base(Derived::invoker_label, logic, _accepted_actions())
    {
    }
    template < typename... Args >
    ActionInvoker(Args... args)
-       : base(
-          Derived::invoker_label,
-          std::forward< Args >(args)...,
-          std::set< actions::ActionLabel >{AcceptedActions...})
+       : base(Derived::invoker_label, std::forward< Args >(args)..., _accepted_actions())
    {
    }
    inline ActionInvokerBase* clone() override
    {
       return new Derived(static_cast< Derived& >(*this));
    }
+
+  private:
+   static AcceptedActionsType _accepted_actions()
+   {
+      AcceptedActionsType accepted;
+      (accepted.set(static_cast< size_t >(AcceptedActions)), ...);
+      return accepted;
+   }
 };
 
 class DefaultModeInvoker:
@@ -105,7 +116,8 @@ class DefaultModeInvoker:
        actions::ActionLabel::PLAY_FIELDCARD,
        actions::ActionLabel::DRAG_ENEMY,
        actions::ActionLabel::PLACE_UNIT,
-       actions::ActionLabel::PLACE_SPELL > {
+       actions::ActionLabel::PLACE_SPELL,
+       actions::ActionLabel::PLAY_REQUEST > {
   public:
    using base = ActionInvoker<
       DefaultModeInvoker,
@@ -113,7 +125,8 @@ class DefaultModeInvoker:
       actions::ActionLabel::PLAY_FIELDCARD,
       actions::ActionLabel::DRAG_ENEMY,
       actions::ActionLabel::PLACE_UNIT,
-      actions::ActionLabel::PLACE_SPELL >;
+      actions::ActionLabel::PLACE_SPELL,
+      actions::ActionLabel::PLAY_REQUEST >;
    using base::base;
 
    constexpr static Label invoker_label = Label::DEFAULT;
@@ -126,12 +139,14 @@ class CombatModeInvoker:
     public ActionInvoker<
        CombatModeInvoker,
        actions::ActionLabel::ACCEPT,
-       actions::ActionLabel::PLACE_SPELL > {
+       actions::ActionLabel::PLACE_SPELL,
+       actions::ActionLabel::PLACE_UNIT > {
   public:
    using base = ActionInvoker<
       CombatModeInvoker,
       actions::ActionLabel::ACCEPT,
-      actions::ActionLabel::PLACE_SPELL >;
+      actions::ActionLabel::PLACE_SPELL,
+      actions::ActionLabel::PLACE_UNIT >;
    using base::base;
 
    constexpr static Label invoker_label = Label::COMBAT;
@@ -3,11 +3,14 @@
 #define LORAINE_BOARD_H
 
 #include <iostream>
-#include <queue>
 #include <utility>
 #include <variant>
 
 #include "gamedefs.h"
+#include "rules.h"
+#include "utils/small_function.h"
+#include "utils/static_queue.h"
+#include "utils/static_vector.h"
 #include "utils/types.h"
 class FieldCard;
 class Unit;
@@ -15,15 +18,17 @@ class Landmark;
 
 class Board {
   public:
-   using BfType = std::vector< sptr< Unit > >;
-   using CampType = std::vector< sptr< FieldCard > >;
-   using BfQueueType = std::queue< sptr< Unit > >;
-   using CampQueueType = std::queue< sptr< FieldCard > >;
+   using BfType = StaticVector< sptr< Unit >, battlefield_capacity >;
+   using CampType = StaticVector< sptr< FieldCard >, camp_capacity >;
+   using BfQueueType = StaticQueue< sptr< Unit >, battlefield_capacity >;
+   using CampQueueType = StaticQueue< sptr< FieldCard >, camp_capacity >;
+   using UnitFilter = SmallFunction< bool(const sptr< FieldCard >&) >;
+   using UnitsType = StaticVector< sptr< Unit >, camp_capacity + battlefield_capacity >;
 
    Board(size_t camp_size, size_t bf_size)
        : m_camp_size_max(camp_size), m_bf_size_max(bf_size), m_bf(), m_camp(), m_camp_queue()
    {
-      _reserve_space();
+      _check_sizes();
    }
    Board(size_t camp_size, size_t bf_size, SymArr< BfType > bfs, SymArr< CampType > camps)
        : m_camp_size_max(camp_size),
@@ -32,7 +37,7 @@ class Board {
          m_camp(std::move(camps)),
          m_camp_queue()
    {
-      _reserve_space();
+      _check_sizes();
    }
    Board(
       size_t camp_size,
@@ -48,7 +53,7 @@ class Board {
          m_camp_queue(std::move(camp_queues)),
          m_bf_queue(std::move(bf_queues))
    {
-      _reserve_space();
+      _check_sizes();
    }
    /**
     * Counts the units in the camp or the battlefield, subject to a filter on
@@ -65,11 +70,16 @@ class Board {
    [[nodiscard]] size_t count_units(
       Team team,
       bool in_camp,
-      const std::function< bool(const sptr< FieldCard >&) >& filter) const;
+      const UnitFilter& filter) const;
    [[nodiscard]] size_t count_occupied_spots(Team team, bool in_camp) const;
 
+#ifdef LORAINE_STATIC_RULES
+   [[nodiscard]] constexpr static size_t max_size_bf() { return rules::Standard::BATTLEFIELD_SIZE; }
+   [[nodiscard]] constexpr static size_t max_size_camp() { return rules::Standard::CAMP_SIZE; }
+#else
    [[nodiscard]] auto max_size_bf() const { return m_bf_size_max; }
    [[nodiscard]] auto max_size_camp() const { return m_camp_size_max; }
+#endif
    auto& battlefield(Team team) { return m_bf[team]; }
    [[nodiscard]] auto& battlefield(Team team) const { return m_bf[team]; }
    auto& camp(Team team) { return m_camp[team]; }
@@ -78,6 +88,11 @@ class Board {
    [[nodiscard]] auto& camp_queue(Team team) const { return m_camp_queue[team]; }
 
    [[nodiscard]] std::vector< sptr< Unit > > camp_units(Team team) const;
+   /**
+    * All units of the team on the board, the camp's first and then the battlefield's, e.g. as the
+    * targets of an AOE effect. Collected inline, without allocating.
+    */
+   [[nodiscard]] UnitsType units(Team team) const;
 
    void add_to_bf(const sptr< Unit >& card, size_t idx);
    void add_to_bf(const sptr< Unit >& card);
@@ -87,6 +102,10 @@ class Board {
    void add_to_camp_queue(std::vector< sptr< FieldCard > >&& units);
    void add_to_bf_queue(const sptr< Unit >& unit);
    void add_to_bf_queue(std::vector< sptr< Unit > >&& units);
+   /**
+    * Removes all cards from the board, keeping the capacity of the containers.
+    */
+   void clear();
 
   private:
    size_t m_camp_size_max;
@@ -104,12 +123,18 @@ class Board {
    {
       return in_camp ? m_camp[team].size() < m_camp_size_max : m_bf[team].size() < m_bf_size_max;
    }
-   inline void _reserve_space()
+   inline void _check_sizes() const
    {
-      m_camp[RED].reserve(m_camp_size_max);
-      m_camp[BLUE].reserve(m_camp_size_max);
-      m_bf[RED].reserve(m_bf_size_max);
-      m_bf[BLUE].reserve(m_bf_size_max);
+#ifdef LORAINE_STATIC_RULES
+      if(m_camp_size_max != max_size_camp() || m_bf_size_max != max_size_bf()) {
+         throw std::invalid_argument("Board sizes differ from the static rules' sizes.");
+      }
+#endif
+      if(m_camp_size_max > camp_capacity || m_bf_size_max > battlefield_capacity) {
+         throw std::invalid_argument(
+            "Board sizes exceed the zone capacities (camp: " + std::to_string(camp_capacity)
+            + ", battlefield: " + std::to_string(battlefield_capacity) + ").");
+      }
    }
 
    /**
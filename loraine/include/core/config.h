@@ -6,29 +6,40 @@
 #include <filesystem>
 #include <string>
 
+#include "gamedefs.h"
 #include "nexus.h"
+#include "rules.h"
+
+/**
+ * Declares the limit `name` with the standard ruleset's value, as a constant for static rules.
+ */
+#ifdef LORAINE_STATIC_RULES
+   #define LORAINE_RULE(name) constexpr static size_t name = rules::Standard::name
+#else
+   #define LORAINE_RULE(name) const size_t name = rules::Standard::name
+#endif
 
 struct Config {
    static Config load(std::filesystem::path filepath);
    void save(std::filesystem::path filepath);
 
-   const size_t MAX_CARD_COPIES_IN_DECK = 3;
-   const size_t DECK_CARDS_LIMIT = 40;
-   const size_t CHAMPIONS_LIMIT = 6;
-   const size_t REGIONS_LIMIT = 2;
-   const size_t BATTLEFIELD_SIZE = 6;
-   const size_t CAMP_SIZE = 6;
-   const size_t HAND_CARDS_LIMIT = 10;
-   const size_t START_NEXUS_HEALTH = 20;
-   const size_t SPELL_STACK_LIMIT = 10;
-   const size_t MAX_MANA = 10;
-   const size_t MAX_FLOATING_MANA = 3;
-   const size_t MANA_START = 0;
-   const size_t FLOATING_MANA_START = 0;
-   const size_t INITIAL_HAND_SIZE = 4;
-   const size_t MAX_ROUNDS = 40;
-   const size_t INVALID_ACTIONS_LIMIT = 40;
-   const size_t ENLIGHTENMENT_THRESHOLD = 10;
+   LORAINE_RULE(MAX_CARD_COPIES_IN_DECK);
+   LORAINE_RULE(DECK_CARDS_LIMIT);
+   LORAINE_RULE(CHAMPIONS_LIMIT);
+   LORAINE_RULE(REGIONS_LIMIT);
+   LORAINE_RULE(BATTLEFIELD_SIZE);
+   LORAINE_RULE(CAMP_SIZE);
+   LORAINE_RULE(HAND_CARDS_LIMIT);
+   LORAINE_RULE(START_NEXUS_HEALTH);
+   LORAINE_RULE(SPELL_STACK_LIMIT);
+   LORAINE_RULE(MAX_MANA);
+   LORAINE_RULE(MAX_FLOATING_MANA);
+   LORAINE_RULE(MANA_START);
+   LORAINE_RULE(FLOATING_MANA_START);
+   LORAINE_RULE(INITIAL_HAND_SIZE);
+   LORAINE_RULE(MAX_ROUNDS);
+   LORAINE_RULE(INVALID_ACTIONS_LIMIT);
+   LORAINE_RULE(ENLIGHTENMENT_THRESHOLD);
 
    const Nexus::EffectMap PASSIVE_POWERS_BLUE = {};
    const Nexus::EffectMap PASSIVE_POWERS_RED = {};
@@ -6,11 +6,12 @@
 
 #include <functional>
 #include <map>
-#include <set>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
 #include "cards/card_defs.h"
+#include "utils/small_function.h"
 #include "utils/types.h"
 
 class Card;
@@ -20,7 +21,7 @@ class Deck {
    // vectors of sptrs should be fastest when cache locality is considered
    // (also for insertion operations)
    using ContainerType = std::vector< sptr< Card > >;
-   using FilterFunc = std::function< bool(const sptr< Card >&) >;
+   using FilterFunc = SmallFunction< bool(const sptr< Card >&) >;
 
    using value_type = typename ContainerType::value_type;
    using pointer = typename ContainerType::pointer;
@@ -38,7 +39,6 @@ class Deck {
    Deck() : m_cards(), m_regions() {}
    Deck(std::initializer_list< value_type > cards) : m_cards(cards) {}
    explicit Deck(ContainerType cards) : m_cards(std::move(cards)) {}
-   explicit Deck(ContainerType&& cards) : m_cards(std::move(cards)) {}
    Deck(const Deck& other);
    Deck& operator=(const Deck& other) = delete;
    Deck(Deck&& other) = default;
@@ -116,13 +116,13 @@ class Deck {
    template < class RNG >
    sptr< Card > pop_by_code(const char* card_code, RNG&& rng);
 
-   static std::set< Region > identify_regions(const ContainerType& container);
-   static std::set< Region > identify_regions(std::initializer_list< value_type > cards);
+   static RegionSet identify_regions(const ContainerType& container);
+   static RegionSet identify_regions(std::initializer_list< value_type > cards);
 
   private:
    ContainerType m_cards;
    // all the regions present in the given cards
-   std::set< Region > m_regions;
+   RegionSet m_regions;
 
    /**
     * Method to filter the indices of specific cards
@@ -144,8 +144,13 @@ sptr< Card > Deck::pop_by_code(const char* card_code, RNG&& rng)
 {
    auto indices = _find_indices(
       [&card_code](const sptr< Card >& card) { return card->immutables().code == card_code; });
-   random::shuffle_inplace(m_cards, rng);
-   return pop_by_index(indices[0]);
+   if(indices.empty()) {
+      throw std::invalid_argument(
+         "No card with code " + std::string(card_code) + " in deck to pop.");
+   }
+   std::uniform_int_distribution< size_t > dist(0, indices.size() - 1);
+   // the found indices count from the bottom, whereas popping counts from the top
+   return pop_by_index(m_cards.size() - 1 - indices[dist(rng)]);
 }
 
 template < typename Container, typename >
@@ -0,0 +1,157 @@
+
+#ifndef LORAINE_DECKCODE_H
+#define LORAINE_DECKCODE_H
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cards/card_defs.h"
+#include "core/config.h"
+#include "core/gamedefs.h"
+#include "utils/arena.h"
+#include "utils/types.h"
+
+class CardCatalog;
+class CardFactory;
+class Deck;
+
+/**
+ * A card of a deck code, by the parts of its card code: e.g. 01DE012 is card 12 of set 1 of
+ * faction 0 (Demacia).
+ */
+struct DeckCodeCard {
+   u32 set = 0;
+   u32 faction = 0;
+   u32 number = 0;
+   u32 count = 0;
+
+   /**
+    * The card with the given card code. Throws std::invalid_argument if it is not a card code of
+    * the form SSFFNNN (e.g. the code of a champion's level up, which no deck code can hold).
+    */
+   static DeckCodeCard parse(std::string_view card_code, u32 count);
+   /**
+    * Writes the card code to `out`, which needs room for 7 characters, and returns its length.
+    */
+   size_t write_code(char* out) const;
+   [[nodiscard]] std::string code() const;
+};
+
+/**
+ * The cards of one deck, as catalog indices, together with what the deck rules check.
+ */
+struct DeckList {
+   /**
+    * The rules a deck can break, as bits of `violations`.
+    */
+   enum Violation : u8 {
+      TOO_MANY_COPIES = 1 << 0,
+      WRONG_SIZE = 1 << 1,
+      TOO_MANY_CHAMPIONS = 1 << 2,
+      TOO_MANY_REGIONS = 1 << 3,
+      // set instead of the rules by bulk decoding for codes that cannot be decoded at all
+      MALFORMED = 1 << 4,
+      UNKNOWN_CARD = 1 << 5,
+   };
+
+   struct Entry {
+      // the index of the card in the catalog
+      u32 card;
+      u32 count;
+   };
+
+   std::vector< Entry > cards{};
+   RegionSet regions{};
+   size_t n_cards = 0;
+   size_t n_champions = 0;
+   u8 violations = 0;
+
+   [[nodiscard]] bool valid() const { return violations == 0; }
+   [[nodiscard]] bool violates(Violation violation) const { return (violations & violation) != 0; }
+};
+
+/**
+ * Decodes and encodes the deck codes of LoR: the base32 text (RFC 4648, without padding) of a
+ * version byte followed by varints, which list the cards grouped by their number of copies
+ * (3, 2, 1, then each larger count on its own) and, within those, by their set and faction.
+ *
+ * Decoding maps the cards straight to the catalog's entries and checks the deck against the
+ * configured limits while doing so. Short of the returned deck list, it does not allocate: the
+ * base32 text is decoded into a stack buffer and each card code is looked up from a stack copy.
+ *
+ * A codec only reads its catalog, so one codec may decode from many threads at once.
+ */
+class DeckCodec {
+  public:
+   /**
+    * The newest deck code version this codec knows the factions of.
+    */
+   constexpr static u32 max_version = 5;
+
+   explicit DeckCodec(const CardCatalog& catalog, const Config& config = Config{});
+
+   /**
+    * Decodes the deck code and checks the deck rules. Throws std::invalid_argument for malformed
+    * codes and std::out_of_range for cards that are not in the catalog. Broken deck rules are
+    * not errors, but marked in the deck list's violations.
+    */
+   [[nodiscard]] DeckList decode(std::string_view code) const;
+   /**
+    * Decodes many deck codes, split evenly over `n_threads` threads (0 for one per hardware
+    * thread). The deck lists are in the order of the codes; codes that cannot be decoded give
+    * deck lists without cards, marked MALFORMED or UNKNOWN_CARD.
+    */
+   [[nodiscard]] std::vector< DeckList > decode(
+      const std::vector< std::string_view >& codes,
+      size_t n_threads = 0) const;
+   /**
+    * Decodes a file of one deck code per line (surrounding whitespace ignored), as above.
+    */
+   [[nodiscard]] std::vector< DeckList > decode_file(
+      const std::filesystem::path& path,
+      size_t n_threads = 0) const;
+
+   /**
+    * The deck code of the deck list's cards.
+    */
+   [[nodiscard]] std::string encode(const DeckList& deck_list) const;
+   /**
+    * The deck list of the deck's cards, with the deck rules checked.
+    */
+   [[nodiscard]] DeckList list(const Deck& deck) const;
+
+   /**
+    * A deck of new cards of the deck list, created by the factory (whose catalog has to be this
+    * codec's) for the given owner.
+    */
+   [[nodiscard]] static Deck build(
+      const DeckList& deck_list,
+      const CardFactory& factory,
+      Team owner,
+      const sptr< Arena >& arena = nullptr);
+
+   /**
+    * The cards of a deck code, without looking them up. Throws std::invalid_argument for
+    * malformed codes.
+    */
+   [[nodiscard]] static std::vector< DeckCodeCard > decode_cards(std::string_view code);
+   /**
+    * The deck code of the cards, ordered as the official encoder orders them, so that equal
+    * decks have equal codes.
+    */
+   [[nodiscard]] static std::string encode_cards(const std::vector< DeckCodeCard >& cards);
+
+  private:
+   const CardCatalog* m_catalog;
+   size_t m_max_copies;
+   size_t m_deck_size;
+   size_t m_max_champions;
+   size_t m_max_regions;
+
+   void _add(DeckList& deck_list, u32 card, u32 count) const;
+   void _check(DeckList& deck_list) const;
+};
+
+#endif  // LORAINE_DECKCODE_H
@@ -13,6 +13,15 @@ inline Team opponent(Team team)
 
 constexpr const size_t n_teams = static_cast< size_t >(Team::RED) + 1;
 
+/**
+ * The capacities of the zones bounded by the rules. The zone containers are sized by these at
+ * compile time, so the configured zone sizes must not exceed them.
+ */
+constexpr const size_t battlefield_capacity = 6;
+constexpr const size_t camp_capacity = 6;
+constexpr const size_t hand_capacity = 10;
+constexpr const size_t spell_stack_capacity = 10;
+
 
 /**
  * Effectively an Enum class with a wrapper around it to provide some class utils
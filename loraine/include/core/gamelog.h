@@ -0,0 +1,280 @@
+
+#ifndef LORAINE_GAMELOG_H
+#define LORAINE_GAMELOG_H
+
+#include <iosfwd>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "core/action.h"
+#include "core/gamedefs.h"
+#include "events/lor_events/event_labels.h"
+#include "utils/types.h"
+#include "utils/varint.h"
+
+class GameState;
+class OutputSink;
+
+/**
+ * What a GameLog records.
+ */
+enum class LogLevel { OFF = 0, ACTIONS, ACTIONS_AND_EVENTS };
+
+/**
+ * The append-only history of a game.
+ *
+ * Every record is a fixed 4-byte header (kind, label, team, payload size) followed by its
+ * varint-encoded payload, appended to one contiguous byte arena. Recording an action or event is
+ * thus a few byte writes and, once the arena has grown to a game's size, free of allocations.
+ * Records are read in place through RecordViews; the byte offset at which each round begins is
+ * kept, so that the records of a round can be iterated directly.
+ *
+ * Actions are encoded losslessly (see decode_action). Their targets are recorded by where they are
+ * in the game (zone, team and index), so that logging and decoding a targeted action needs the
+ * state it was chosen in. Of an event's arguments, the integral and enumeration values and the
+ * ids of the cards are recorded.
+ */
+class GameLog {
+  public:
+   enum class Kind : u8 { ACTION = 0, EVENT };
+
+   struct Header {
+      Kind kind;
+      // the index of the action in actions::Action::ActionVariant, or the event label
+      u8 label;
+      u8 team;
+      u8 size;
+   };
+   static_assert(sizeof(Header) == 4, "The record header is expected to be 4 bytes.");
+
+   constexpr static size_t max_payload_size = 255;
+
+   /**
+    * Reads the varints of a payload one after the other.
+    */
+   class PayloadReader {
+     public:
+      PayloadReader(const u8* begin, const u8* end) : m_pos(begin), m_end(end) {}
+
+      u64 next() { return varint::decode(m_pos, m_end); }
+      i64 next_signed() { return varint::unzigzag(next()); }
+      /**
+       * Reads the number of elements of a sequence following in the payload, each taking
+       * `values_per_element` varints (of at least a byte each). Throws std::runtime_error if the
+       * rest of the payload cannot hold as many.
+       */
+      size_t next_count(size_t values_per_element = 1)
+      {
+         auto count = next();
+         if(count > remaining() / values_per_element) {
+            throw std::runtime_error("A record payload claims more elements than it holds.");
+         }
+         return count;
+      }
+      [[nodiscard]] size_t remaining() const { return size_t(m_end - m_pos); }
+      [[nodiscard]] bool empty() const { return m_pos == m_end; }
+
+     private:
+      const u8* m_pos;
+      const u8* m_end;
+   };
+
+   /**
+    * A record as stored in the log, without copying it out.
+    */
+   struct RecordView {
+      const Header* header;
+      size_t round;
+
+      [[nodiscard]] Kind kind() const { return header->kind; }
+      [[nodiscard]] bool is_action() const { return header->kind == Kind::ACTION; }
+      [[nodiscard]] Team team() const { return Team(header->team); }
+      [[nodiscard]] size_t action_index() const { return header->label; }
+      [[nodiscard]] events::EventLabel event_label() const
+      {
+         return events::EventLabel(header->label);
+      }
+      [[nodiscard]] const u8* payload() const { return reinterpret_cast< const u8* >(header + 1); }
+      [[nodiscard]] size_t payload_size() const { return header->size; }
+      [[nodiscard]] PayloadReader reader() const
+      {
+         return PayloadReader(payload(), payload() + payload_size());
+      }
+   };
+
+   class const_iterator {
+     public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = RecordView;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const RecordView*;
+      using reference = RecordView;
+
+      const_iterator(const GameLog* log, size_t offset, size_t round)
+          : m_log(log), m_offset(offset), m_round(round)
+      {
+         _sync_round();
+      }
+
+      RecordView operator*() const
+      {
+         return {reinterpret_cast< const Header* >(m_log->m_bytes.data() + m_offset), m_round};
+      }
+      const_iterator& operator++()
+      {
+         m_offset += sizeof(Header) + (**this).payload_size();
+         _sync_round();
+         return *this;
+      }
+      const_iterator operator++(int)
+      {
+         auto copy = *this;
+         ++(*this);
+         return copy;
+      }
+      bool operator==(const const_iterator& other) const { return m_offset == other.m_offset; }
+      bool operator!=(const const_iterator& other) const { return m_offset != other.m_offset; }
+
+     private:
+      const GameLog* m_log;
+      size_t m_offset;
+      size_t m_round;
+
+      void _sync_round()
+      {
+         const auto& offsets = m_log->m_round_offsets;
+         while(m_round + 1 < offsets.size() && offsets[m_round + 1] <= m_offset) {
+            m_round += 1;
+         }
+      }
+   };
+
+   struct Range {
+      const_iterator first;
+      const_iterator last;
+
+      [[nodiscard]] const_iterator begin() const { return first; }
+      [[nodiscard]] const_iterator end() const { return last; }
+   };
+
+   explicit GameLog(LogLevel level = LogLevel::ACTIONS) : m_level(level) {}
+
+   [[nodiscard]] auto level() const { return m_level; }
+   void level(LogLevel level) { m_level = level; }
+   [[nodiscard]] bool logs_actions() const { return m_level != LogLevel::OFF; }
+   [[nodiscard]] bool logs_events() const { return m_level == LogLevel::ACTIONS_AND_EVENTS; }
+
+   /**
+    * Appends an action. Actions with targets need the state they were chosen in, see the overload
+    * below; without it, they throw std::invalid_argument.
+    */
+   void append_action(size_t round, const actions::Action& action);
+   void append_action(size_t round, const actions::Action& action, const GameState& state);
+   template < typename... Args >
+   void append_event(size_t round, events::EventLabel label, Team team, const Args&... args)
+   {
+      PayloadWriter payload;
+      (_put_arg(payload, args), ...);
+      _append(round, Kind::EVENT, static_cast< u8 >(label), team, payload);
+   }
+   /**
+    * Appends a copy of a record, e.g. of another log.
+    */
+   void append(const RecordView& record);
+
+   /**
+    * Reconstructs the action of an action record. Targets are looked up in the given state, which
+    * has to be the game as it was when the action was logged (e.g. in a re-simulation); without a
+    * state, actions with targets throw std::invalid_argument. A payload that is not a valid
+    * encoding of the action throws std::runtime_error.
+    */
+   static actions::Action decode_action(const RecordView& record);
+   static actions::Action decode_action(const RecordView& record, const GameState& state);
+
+   [[nodiscard]] const_iterator begin() const { return {this, 0, 0}; }
+   [[nodiscard]] const_iterator end() const { return {this, m_bytes.size(), 0}; }
+   /**
+    * The records of the given round (empty if nothing was recorded in it).
+    */
+   [[nodiscard]] Range records(size_t round) const;
+
+   [[nodiscard]] auto size() const { return m_n_records; }
+   [[nodiscard]] auto empty() const { return m_n_records == 0; }
+   [[nodiscard]] auto& bytes() const { return m_bytes; }
+   void reserve(size_t n_bytes) { m_bytes.reserve(n_bytes); }
+   /**
+    * Discards all records, keeping the arena's capacity.
+    */
+   void clear();
+
+   /**
+    * Appends the log (its level, round offsets and arena) to a file of the sink. The log is copied
+    * into the sink's buffers, so it may be cleared and reused right away.
+    */
+   void write(OutputSink& sink, size_t file) const;
+   /**
+    * Reads a log written by `write` from the stream's current position. Several logs written to
+    * one file are read back one after the other.
+    *
+    * Nothing read is trusted: the arena only grows by the bytes the stream actually holds, and the
+    * records and round offsets are checked to lie within it before the log is returned. Throws
+    * std::runtime_error on a truncated or corrupt log.
+    */
+   static GameLog read(std::istream& in);
+
+  private:
+   struct PayloadWriter {
+      u8 bytes[max_payload_size + varint::max_bytes];
+      size_t size = 0;
+
+      void put(u64 value);
+      void put_signed(i64 value) { put(varint::zigzag(value)); }
+   };
+
+   template < typename T, typename = void >
+   struct has_card_id: std::false_type {
+   };
+   template < typename T >
+   struct has_card_id< T, std::void_t< decltype(std::declval< const T& >()->immutables().uuid) > >:
+       std::true_type {
+   };
+
+   template < typename T >
+   static void _put_arg(PayloadWriter& payload, const T& arg)
+   {
+      if constexpr(std::is_same_v< T, bool >) {
+         payload.put(arg);
+      } else if constexpr(std::is_integral_v< T > && std::is_signed_v< T >) {
+         payload.put_signed(arg);
+      } else if constexpr(std::is_integral_v< T > || std::is_enum_v< T >) {
+         payload.put(static_cast< u64 >(arg));
+      } else if constexpr(has_card_id< T >::value) {
+         payload.put(arg != nullptr ? arg->immutables().uuid.value() : 0);
+      }
+      // any other argument (e.g. an effect) is not recorded
+   }
+
+   void _append_action(size_t round, const actions::Action& action, const GameState* state);
+   static actions::Action _decode_action(const RecordView& record, const GameState* state);
+
+   void _append(size_t round, Kind kind, u8 label, Team team, const PayloadWriter& payload)
+   {
+      _append(round, Header{kind, label, static_cast< u8 >(team), 0}, payload.bytes, payload.size);
+   }
+   void _append(size_t round, Header header, const u8* payload, size_t payload_size);
+   /**
+    * Whether the arena is a sequence of valid records, and the round offsets ascend along their
+    * boundaries.
+    */
+   [[nodiscard]] bool _is_consistent() const;
+
+   std::vector< u8 > m_bytes{};
+   // the byte offset at which the records of each round begin
+   std::vector< size_t > m_round_offsets{};
+   size_t m_n_records = 0;
+   LogLevel m_level;
+};
+
+#endif  // LORAINE_GAMELOG_H
@@ -13,33 +13,36 @@
 #include "action_invoker.h"
 #include "board.h"
 #include "config.h"
+#include "effects/aura.h"
 #include "events/event_subscriber.h"
 #include "events/lor_events/event_labels.h"
 #include "gamedefs.h"
+#include "gamelog.h"
 #include "nexus.h"
 #include "player.h"
-#include "record.h"
+#include "timer_wheel.h"
+#include "utils/arena.h"
 #include "utils/random.h"
+#include "utils/static_vector.h"
 #include "utils/types.h"
 
 class Card;
-
+class CardFactory;
 
 class GameState {
    friend Logic;
 
    struct Buffer {
       std::optional< sptr< FieldCard > > play;  // play buffer
-      std::vector< sptr< Unit > > bf;  // battlefield buffer
-      std::vector< sptr< Spell > > spell;  // spell stack buffer
+      StaticVector< sptr< Unit >, battlefield_capacity > bf;  // battlefield buffer
+      StaticVector< sptr< Spell >, spell_stack_capacity > spell;  // spell stack buffer
       std::vector< sptr< EffectBase > > targeting;  // targeting buffer
       std::vector< sptr< Card > > choice;  // choice buffer
-      std::vector< sptr< actions::Action > > action;  // command buffer
+      std::vector< actions::Action > action;  // command buffer
    };
 
   public:
-   using SpellStackType = std::vector< sptr< Spell > >;
-   using HistoryType = std::map< size_t, std::vector< uptr< Record > > >;
+   using SpellStackType = StaticVector< sptr< Spell >, spell_stack_capacity >;
 
    GameState(
       const Config& cfg,
@@ -56,6 +59,15 @@ class GameState {
 
    GameState(const GameState& other);
 
+   /**
+    * Rewinds the state to the beginning of a new game with the given decks, so that a state can be
+    * reused across games instead of being reconstructed. Config and controllers are kept, as are
+    * the event array and the capacity of every container; only their contents are discarded.
+    *
+    * Like after construction, the game still has to be started by Logic::start_game.
+    */
+   void reset(SymArr< Deck > decks, Team starting_team, random::seed_type seed);
+
    inline auto& event(events::EventLabel label)
    {
       return m_events.at(static_cast< size_t >(label));
@@ -91,10 +103,44 @@ class GameState {
    [[nodiscard]] inline auto& buffer() const { return m_buffer; }
    [[nodiscard]] inline auto& grantfactory(Team team) { return m_grant_factory[team]; }
    [[nodiscard]] inline auto& grantfactory(Team team) const { return m_grant_factory[team]; }
-   [[nodiscard]] inline auto& history() { return m_history; }
-   [[nodiscard]] inline auto& history() const { return m_history; }
+   [[nodiscard]] inline auto& auras() { return m_auras; }
+   [[nodiscard]] inline auto& auras() const { return m_auras; }
+   [[nodiscard]] inline auto& timers() { return m_timers; }
+   [[nodiscard]] inline auto& timers() const { return m_timers; }
+   [[nodiscard]] inline auto& history() { return m_log; }
+   [[nodiscard]] inline auto& history() const { return m_log; }
+   /**
+    * Sets what is recorded to the history. Turned off, the history does not grow, which makes a
+    * step free of heap allocations once the state's containers have warmed up.
+    */
+   inline void log_level(LogLevel level) { m_log.level(level); }
+   [[nodiscard]] inline auto log_level() const { return m_log.level(); }
+   inline void record_history(bool record)
+   {
+      m_log.level(record ? LogLevel::ACTIONS : LogLevel::OFF);
+   }
+   [[nodiscard]] inline auto records_history() const { return m_log.logs_actions(); }
    [[nodiscard]] inline auto& rng() { return m_rng; }
    [[nodiscard]] inline auto& rng() const { return m_rng; }
+   /**
+    * Sets the factory Logic::create and Logic::copy build cards with. A factory is read-only while
+    * games run, so that all states (and their copies) can share one.
+    */
+   inline void card_factory(sptr< const CardFactory > factory)
+   {
+      m_card_factory = std::move(factory);
+   }
+   [[nodiscard]] inline auto& card_factory() const { return m_card_factory; }
+   /**
+    * The pool of the ids of everything created while the game is played. Logic draws from it for
+    * as long as it runs, a reset restarts it and a copy continues from where the original was.
+    */
+   [[nodiscard]] inline auto& ids() { return m_ids; }
+   /**
+    * The arena the cards created during the game are allocated from, made on first use. Reset and
+    * copied states start a new one, the cards of the previous one keep it alive as long as needed.
+    */
+   const sptr< Arena >& card_arena();
 
    Status status();
    inline bool is_resolved() const
@@ -102,13 +148,14 @@ class GameState {
       return m_spell_stack.empty() && m_board.battlefield(Team::BLUE).empty()
              && m_board.battlefield(Team::RED).empty();
    }
-   void commit_to_history(uptr< Record >&& record);
    void send_to_graveyard(const sptr< FieldCard >& unit);
    void send_to_spellyard(const sptr< Spell >& unit);
    void send_to_tossed(const sptr< Card >& card);
 
   private:
    Config m_config;
+   // ahead of the players, so that copying them can already draw ids from the copy's pool
+   uuids::Pool m_ids{uuids::Pool::game_index};
    SymArr< Player > m_players;
    Team m_starting_team;
    Board m_board;
@@ -122,8 +169,13 @@ class GameState {
 
    SpellStackType m_spell_stack{};
    SymArr< GrantFactory > m_grant_factory = {};
-   uptr< HistoryType > m_history = {};
+   AuraTracker m_auras{};
+   TimerWheel m_timers{};
+   // copies start with an empty history
+   GameLog m_log{};
    random::rng_type m_rng;
+   sptr< const CardFactory > m_card_factory = nullptr;
+   sptr< Arena > m_card_arena = nullptr;
 };
 
 #endif  // LORAINE_GAMESTATE_H
@@ -9,10 +9,17 @@
 #include <array>
 
 #include "action_invoker.h"
+#include "effects/aura.h"
 #include "events/event_subscriber.h"
 #include "events/lor_events/event_labels.h"
+#include "timer_wheel.h"
+#include "utils/alloc_tracker.h"
+#include "utils/profiler.h"
+#include "utils/span.h"
 
 // forward declare
+class CardFactory;
+class CardQuery;
 class GameState;
 
 class Logic: public Cloneable< Logic > {
@@ -86,7 +93,8 @@ class Logic: public Cloneable< Logic > {
     */
    void give_managems(Team team, long amount = 1);
    /**
-    * Creates a spell as determined by the code.
+    * Creates a card as determined by the code, cloned from the prototype of the state's card
+    * factory into the game's card arena.
     * @param team: shared_ptr<Card>,
     *    the team who will own the new spell
     * @param card_code: const char*,
@@ -96,7 +104,13 @@ class Logic: public Cloneable< Logic > {
     */
    sptr< Card > create(Team team, const char* card_code);
    /**
-    * Copy the given spell (basic or exact).
+    * Creates a card chosen uniformly at random (with the game's rng) among those of the query,
+    * as `create` does. Returns nullptr if no card matches the query.
+    */
+   sptr< Card > create_random(Team team, const CardQuery& query);
+   /**
+    * Copy the given spell (basic or exact). A basic copy is created from the prototype of the
+    * card's code, an exact copy is cloned from the card itself.
     * @param card: shared_ptr<Card>,
     *    the spell to copy
     * @param exact_copy: boolean,
@@ -122,7 +136,37 @@ class Logic: public Cloneable< Logic > {
     */
    long strike(const sptr< Unit >& unit_att, sptr< Unit >& unit_def);
    SymArr< long > strike_mutually(const sptr< Unit >& unit1, sptr< Unit >& unit2);
+   /**
+    * Deal damage to a single unit, which dies if it has no health left afterwards.
+    * @returns: long,
+    *   the damage taken.
+    */
    long damage_unit(const sptr< Unit >& unit, const sptr< Card >& cause, long dmg);
+   /**
+    * Deal damage to all the given units at once, as an AOE effect does (e.g. "Deal 1 to all
+    * enemies"). Every unit takes its damage first, then the UNIT_DAMAGE events fire in the order of
+    * the units and only then the units without health left die. Empty slots are skipped. Throws
+    * std::length_error, before damaging any unit, if there are more units than both boards hold.
+    * @param units: Span of shared_ptr<Unit>,
+    *   the damaged units, e.g. Board::units(team).
+    * @param cause: shared_ptr<Card>,
+    *   the card dealing the damage.
+    * @param dmg: long,
+    *   the damage dealt to each unit.
+    * @returns: long,
+    *   the total damage taken.
+    */
+   long damage_units(Span< const sptr< Unit > > units, const sptr< Card >& cause, long dmg);
+   /**
+    * Grant the same stats to all the given units (e.g. "Give all allies +1|+0"), through the grant
+    * factory of the bestowing card's owner. Empty slots are skipped.
+    */
+   void apply_stats_grant(
+      Span< const sptr< Unit > > units,
+      const sptr< Card >& bestowing_card,
+      long power,
+      long health,
+      bool permanent);
    void heal(const sptr< Unit >& unit, const sptr< Card >& cause, size_t amount);
    /**
     * Let a unit strike another.
@@ -136,6 +180,12 @@ class Logic: public Cloneable< Logic > {
    void damage_nexus_simultan(const sptr< Card >& damaging_card, SymArr< long > dmgs);
 
    void start_game();
+   /**
+    * Rewinds the logic to the beginning of a game: the effects of the cards still in the game are
+    * disconnected from the events and the mulligan invoker becomes the current one again. Called by
+    * GameState::reset before the state's cards are discarded.
+    */
+   void reset();
 
    template < typename NewInvokerType, typename... Args >
    inline void transition(Args&&... args);
@@ -153,18 +203,25 @@ class Logic: public Cloneable< Logic > {
 
    void refill_mana(Team team, bool normal_mana);
 
+   /**
+    * Bestow a grant through the grant factory of the given team. A temporary grant is scheduled to
+    * expire at the end of the current round.
+    */
    template < GrantType grant_type, typename... Params >
-   inline void grant(
+   inline sptr< Grant > grant(
       Team team,
       const sptr< Card >& bestowing_card,
       const sptr< Card >& card_to_bestow,
-      Params&&... params)
-   {
-      //      auto grant = m_grant_factory[team]->grant< grant_type >(
-      //         team, bestowing_card, card_to_bestow, std::forward< Params... >(params...));
-      //      card_to_bestow->store_grant(grant);
-      //      grant->apply(card_to_bestow);
-   }
+      Params&&... params);
+   /**
+    * Call `callback` with `card` at the given phase `rounds_ahead` rounds from now, e.g. for a
+    * countdown or a "next round" effect. The timer is dropped if the card leaves the board.
+    */
+   void schedule(
+      size_t rounds_ahead,
+      RoundPhase phase,
+      const sptr< Card >& card,
+      TimerWheel::Callback callback);
 
    /*
     * An api for triggering an event externally. Which m_subscribed_events is supposed to be
@@ -178,6 +235,17 @@ class Logic: public Cloneable< Logic > {
       const Filter& filter,
       std::optional< Team > opt_team);
 
+   /**
+    * Starts the continuous aura of `source`, which is on the board, covering the units there and
+    * any unit entering the board later on.
+    */
+   void add_aura(const sptr< Card >& source, AuraSpec spec);
+   /**
+    * Ends all auras of `source` and takes back what they granted. Units left without health by it
+    * die, killed by `source`.
+    */
+   void remove_aura(const sptr< Card >& source);
+
    void retreat_to_camp(Team team);
    void process_camp_queue(Team team);
 
@@ -199,6 +267,10 @@ class Logic: public Cloneable< Logic > {
    std::unique_ptr< ActionInvokerBase > m_action_invoker;
    /// the previous action invoker for incoming actions
    std::unique_ptr< ActionInvokerBase > m_prev_action_invoker = nullptr;
+   /// retired invokers (one per label), which are reused by the next transition to their label
+   /// instead of allocating a new one
+   std::array< std::unique_ptr< ActionInvokerBase >, ActionInvokerBase::n_labels >
+      m_spare_invokers{};
    /// private logic helpers
 
    /// The member declarations
@@ -209,12 +281,23 @@ class Logic: public Cloneable< Logic > {
    void _trigger_nightfall_if(const sptr< Card >& card);
 
    void _remove(const sptr< Card >& card);
+   /**
+    * Kills the unit(s) still alive but without health left.
+    */
+   void _kill_if_dead(const sptr< Unit >& unit, const sptr< Card >& cause);
+   void _kill_if_dead(Span< const sptr< Unit > > units, const sptr< Card >& cause);
 
    void _check_enlightenment(Team team);
+   void _schedule_expiry(const sptr< Grant >& grant);
+   void _schedule_keyword_timers(const sptr< Unit >& unit);
+   void _fire_timers(RoundPhase phase);
+   void _fire(const TimerWheel::Timer& timer);
    void _copy_grants(
       const std::vector< sptr< Grant > >& grants,
       const std::shared_ptr< Unit >& unit);
    void _set_status(Status status);
+   [[nodiscard]] const CardFactory& _card_factory() const;
+   void _retire(std::unique_ptr< ActionInvokerBase >&& invoker);
 };
 
 #include "gamestate.h"
@@ -235,9 +318,27 @@ void Logic::clamp_mana()
    }
 }
 
+template < GrantType grant_type, typename... Params >
+sptr< Grant > Logic::grant(
+   Team team,
+   const sptr< Card >& bestowing_card,
+   const sptr< Card >& card_to_bestow,
+   Params&&... params)
+{
+   auto grant = m_state->grantfactory(team).template grant< grant_type >(
+      bestowing_card, card_to_bestow, std::forward< Params >(params)...);
+   _schedule_expiry(grant);
+   return grant;
+}
+
 template < events::EventLabel event_label, typename... Params >
 void Logic::trigger_event(Params&&... params)
 {
+   LORAINE_PROFILE_SCOPE_DETAIL("Logic::trigger_event", events::label_name(event_label));
+   LORAINE_ALLOC_PHASE("Logic::trigger_event");
+   if(auto& log = m_state->history(); log.logs_events()) {
+      log.append_event(m_state->round(), event_label, params...);
+   }
    auto& event = m_state->event(event_label);
    event.detail< helpers::label_to_event_t< event_label > >().fire(
       *state(), std::forward< Params >(params)...);
@@ -296,7 +397,15 @@ void Logic::transition(Args&&... args)
       "Given NewInvokerType is not one of the designated invokers.");
 
    // move current invoker into previous
+   _retire(std::move(m_prev_action_invoker));
    m_prev_action_invoker = std::move(m_action_invoker);
+   if constexpr(sizeof...(Args) == 0) {
+      // the invokers hold no state of their own, so a retired one is as good as a new one
+      if(auto& spare = m_spare_invokers[NewInvokerType::invoker_label]; spare != nullptr) {
+         m_action_invoker = std::move(spare);
+         return;
+      }
+   }
    m_action_invoker = std::make_unique< NewInvokerType >(this, std::forward< Args >(args)...);
 }
 
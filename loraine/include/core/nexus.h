@@ -7,6 +7,7 @@
 
 #include "cards/card_defs.h"
 #include "core/targeting.h"
+#include "effects/damage_modifiers.h"
 #include "effects/effect.h"
 #include "events/event_listener.h"
 #include "events/event_subscriber.h"
@@ -46,11 +47,29 @@ class Nexus: public EventListener< Nexus >, public Targetable {
 
    inline void add_health(const sptr<Card>& card, long health)
    {
-      for(auto& modifier : m_damage_modifiers) {
-         modifier(*card, health);
+      if(health < 0) {
+         // negative health is damage, which the modifiers may alter
+         long damage = -health;
+         for(auto modifier : m_damage_modifiers) {
+            damage = modifiers::DamageModifiers::apply(modifier, *card, damage);
+         }
+         health = -damage;
       }
       m_health += health;
    }
+   inline void add_damage_modifier(modifiers::ModifierId modifier)
+   {
+      m_damage_modifiers.emplace_back(modifier);
+   }
+
+   /**
+    * Restores the nexus to the given health and drops the damage modifiers of the past game.
+    */
+   inline void reset(long health)
+   {
+      m_health = health;
+      m_damage_modifiers.clear();
+   }
 
   private:
    Team m_team;
@@ -58,8 +77,7 @@ class Nexus: public EventListener< Nexus >, public Targetable {
    long m_health;
    KeywordMap m_keywords;
    EffectMap m_effects;
-   std::vector< std::function< void(Card&, long) > > m_damage_modifiers{};
-
+   std::vector< modifiers::ModifierId > m_damage_modifiers{};
 };
 
 #endif  // LORAINE_NEXUS_H
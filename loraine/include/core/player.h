@@ -5,6 +5,7 @@
 #include "controller.h"
 #include "deck.h"
 #include "nexus.h"
+#include "utils/static_vector.h"
 
 class Player {
   public:
@@ -23,7 +24,10 @@ class Player {
       size_t common = 0;  // common mana to play fieldcards with
       size_t floating = 0;  // mana exclusively for spells
    };
-   using HandType = std::vector< sptr< Card > >;
+   using HandType = StaticVector< sptr< Card >, hand_capacity >;
+   /// the cards in the order they were sent there, each paired with the round it was sent in
+   template < typename CardType >
+   using YardType = std::vector< std::pair< size_t, sptr< CardType > > >;
 
    Player(
       Team team,
@@ -38,6 +42,12 @@ class Player {
    Player& operator=(const Player& other) = delete;
    Player& operator=(Player&& other) = delete;
 
+   /**
+    * Prepares the player for a new game with the given deck. The hand and the yards are emptied
+    * but keep their capacity, mana and flags are set back to their defaults.
+    */
+   void reset(Deck deck, long nexus_health);
+
    inline auto& nexus() { return m_nexus; }
    [[nodiscard]] inline auto& nexus() const { return m_nexus; }
    [[nodiscard]] inline auto team() const { return m_team; }
@@ -75,8 +85,8 @@ class Player {
    Deck m_deck;
    Mana m_mana;
    Flags m_flags;
-   std::map< size_t, std::vector< sptr< FieldCard > > > m_graveyard = {};
-   std::map< size_t, std::vector< sptr< Spell > > > m_spellyard = {};
+   YardType< FieldCard > m_graveyard = {};
+   YardType< Spell > m_spellyard = {};
    std::vector< sptr< Card > > m_tossed_cards = {};
 };
 
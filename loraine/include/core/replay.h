@@ -0,0 +1,165 @@
+
+#ifndef LORAINE_REPLAY_H
+#define LORAINE_REPLAY_H
+
+#include <array>
+#include <iosfwd>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "config.h"
+#include "gamedefs.h"
+#include "gamelog.h"
+#include "utils/random.h"
+#include "utils/small_function.h"
+#include "utils/types.h"
+
+class Card;
+class GameState;
+class OutputSink;
+
+/**
+ * Everything needed to re-simulate a game: the configuration, both decklists, the starting team,
+ * the rng seed and the actions taken. Since the engine is deterministic given these, a replay is
+ * a small fraction of the size of the states it reproduces. The hash of the state after every
+ * step is kept along, so that a re-simulation diverging from the recorded game is noticed at the
+ * step it happens.
+ */
+struct Replay {
+   constexpr static std::array< char, 8 > file_magic = {'L', 'O', 'R', 'R', 'E', 'P', 'L', '\0'};
+   constexpr static u64 current_format = 1;
+
+   Config config;
+   // the card codes of both decks, in their order before the game's initial shuffle
+   SymArr< std::vector< std::string > > decklists;
+   Team starting_team;
+   random::seed_type seed;
+   // the action records of the game
+   GameLog actions{};
+   // the state hash after each step
+   std::vector< u64 > step_hashes{};
+
+   [[nodiscard]] auto n_steps() const { return step_hashes.size(); }
+
+   /**
+    * A hash of the observable game state: the round and turn, both players' nexus, mana,
+    * zones and flags, and the units on the board. Card ids are left out, since they differ
+    * between the recorded and the re-simulated game.
+    */
+   static u64 hash(const GameState& state);
+
+   /**
+    * Appends the replay to a file of the sink: a header of the format version, the configured
+    * limits and nexus keywords, the decklists, the starting team and the seed, followed by the
+    * action log (see GameLog::write) and the step hashes. The nexus passive powers of a config are
+    * effects, which cannot be stored, so a config with any throws std::invalid_argument.
+    */
+   void write(OutputSink& sink, size_t file) const;
+   /**
+    * Reads a replay written by `write` from the stream's current position. Throws
+    * std::runtime_error for a stream of another format version or a truncated or corrupt one.
+    */
+   static Replay read(std::istream& in);
+};
+
+/**
+ * Records a game into a Replay while it is being played.
+ */
+class ReplayRecorder {
+  public:
+   /**
+    * Starts recording the game of `state`. The game must not have been started yet and the state's
+    * rng must have been freshly seeded with `seed` (e.g. by `random::create_rng(seed)` or
+    * `GameState::reset`). Turns on the state's action history, if it was off.
+    */
+   ReplayRecorder(GameState& state, random::seed_type seed);
+
+   /**
+    * Records the hash of the state after a step. To be called after every `Logic::step`.
+    */
+   void record_step();
+   /**
+    * The replay of the game up to the last recorded step.
+    */
+   [[nodiscard]] Replay replay() const;
+
+  private:
+   GameState* m_state;
+   Replay m_replay;
+};
+
+/**
+ * Re-simulates a recorded game headlessly: the recorded actions stand in for the controllers and
+ * no history is kept, so that the game runs as fast as the engine allows.
+ *
+ * While replaying, a keyframe is taken whenever a new round (every `keyframe_interval` rounds)
+ * begins: a snapshot of the state along with the step and the position in the action log it was
+ * taken at. Seeking restores the closest keyframe before the target and replays only the steps
+ * from there on, in either direction.
+ */
+class ReplayPlayer {
+  public:
+   /**
+    * Builds a card of the given code for a team. Needed to rebuild the decks from their lists.
+    */
+   using CardBuilder = SmallFunction< sptr< Card >(const std::string&, Team) >;
+   constexpr static size_t all_steps = std::numeric_limits< size_t >::max();
+
+   struct Keyframe {
+      // the number of steps replayed when it was taken
+      size_t step;
+      size_t round;
+      // the position of the next action record in the replay's log
+      GameLog::const_iterator next_action;
+      uptr< GameState > state;
+   };
+
+   ReplayPlayer(Replay replay, CardBuilder build_card, size_t keyframe_interval = 1);
+   ReplayPlayer(const ReplayPlayer&) = delete;
+   ReplayPlayer& operator=(const ReplayPlayer&) = delete;
+   ~ReplayPlayer();
+
+   /**
+    * Replays the next step. Throws if the state afterwards does not hash to the recorded one.
+    */
+   Status step();
+   /**
+    * Replays the steps until `n_steps` have been replayed overall (or the replay is done).
+    */
+   Status fast_forward(size_t n_steps = all_steps);
+   /**
+    * Brings the game to the state after `n_steps` steps, from the closest keyframe (or the current
+    * state, if that is closer).
+    */
+   Status seek(size_t n_steps);
+   /**
+    * Brings the game to the beginning of the given round (or to its end, if the game ended before).
+    */
+   Status seek_round(size_t round);
+
+   [[nodiscard]] auto& replay() const { return m_replay; }
+   [[nodiscard]] auto& state() { return *m_state; }
+   [[nodiscard]] auto& state() const { return *m_state; }
+   [[nodiscard]] auto steps_done() const { return m_step; }
+   [[nodiscard]] bool done() const { return m_step == m_replay.n_steps(); }
+   [[nodiscard]] auto& keyframes() const { return m_keyframes; }
+
+  private:
+   class ScriptedController;
+
+   Replay m_replay;
+   CardBuilder m_build_card;
+   uptr< GameState > m_state;
+   GameLog::const_iterator m_next_action;
+   size_t m_step = 0;
+   size_t m_keyframe_interval;
+   // ordered by step (and thus by round)
+   std::vector< Keyframe > m_keyframes{};
+
+   actions::Action _next_action(Team team);
+   void _take_keyframe();
+   void _restore(const Keyframe& keyframe);
+};
+
+#endif  // LORAINE_REPLAY_H
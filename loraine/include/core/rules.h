@@ -0,0 +1,40 @@
+#ifndef LORAINE_RULES_H
+#define LORAINE_RULES_H
+
+#include <cstddef>
+
+#include "gamedefs.h"
+
+namespace rules {
+
+/**
+ * The limits of the standard ruleset of LoR.
+ *
+ * They are the defaults of Config. Builds with LORAINE_STATIC_RULES (CMake option
+ * ENABLE_STATIC_RULES) compile them into Config as constants, so that every limit check is against
+ * an immediate and loops bounded by them can be unrolled. Without it they stay runtime values,
+ * which can be changed for experiments.
+ */
+struct Standard {
+   constexpr static size_t MAX_CARD_COPIES_IN_DECK = 3;
+   constexpr static size_t DECK_CARDS_LIMIT = 40;
+   constexpr static size_t CHAMPIONS_LIMIT = 6;
+   constexpr static size_t REGIONS_LIMIT = 2;
+   constexpr static size_t BATTLEFIELD_SIZE = battlefield_capacity;
+   constexpr static size_t CAMP_SIZE = camp_capacity;
+   constexpr static size_t HAND_CARDS_LIMIT = hand_capacity;
+   constexpr static size_t START_NEXUS_HEALTH = 20;
+   constexpr static size_t SPELL_STACK_LIMIT = spell_stack_capacity;
+   constexpr static size_t MAX_MANA = 10;
+   constexpr static size_t MAX_FLOATING_MANA = 3;
+   constexpr static size_t MANA_START = 0;
+   constexpr static size_t FLOATING_MANA_START = 0;
+   constexpr static size_t INITIAL_HAND_SIZE = 4;
+   constexpr static size_t MAX_ROUNDS = 40;
+   constexpr static size_t INVALID_ACTIONS_LIMIT = 40;
+   constexpr static size_t ENLIGHTENMENT_THRESHOLD = 10;
+};
+
+}  // namespace rules
+
+#endif  // LORAINE_RULES_H
@@ -5,13 +5,14 @@
 #include <utility>
 
 #include "core/gamedefs.h"
+#include "utils/small_function.h"
 #include "utils/types.h"
 
 // marker class for something that can be targeted
 class Targetable {
 };
 
-using Filter = std::function< bool(const Targetable& /*target*/) >;
+using Filter = SmallFunction< bool(const Targetable& /*target*/) >;
 
 class GameState;
 
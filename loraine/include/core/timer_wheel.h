@@ -0,0 +1,106 @@
+
+#ifndef LORAINE_TIMER_WHEEL_H
+#define LORAINE_TIMER_WHEEL_H
+
+#include <array>
+#include <vector>
+
+#include "utils/small_function.h"
+#include "utils/types.h"
+
+class Card;
+class Grant;
+class Logic;
+
+/**
+ * The points of a round at which timers fire.
+ */
+enum class RoundPhase { START = 0, END };
+constexpr const size_t n_round_phases = 2;
+
+/**
+ * Schedules what happens at a later round start or round end: temporary grants expiring,
+ * ephemeral units dying, regenerating units healing, countdowns and delayed triggers.
+ *
+ * The timers are kept in one slot per (round, phase) within the next `horizon` rounds; a timer
+ * further ahead waits in the slot of its round modulo the horizon until it is due. Firing a phase
+ * thus only touches the timers of that phase's slot instead of every card on the board.
+ */
+class TimerWheel {
+  public:
+   enum class Kind {
+      // undo a temporary grant (and drop it from its card)
+      EXPIRE_GRANT = 0,
+      // kill the unit if it is still ephemeral
+      EPHEMERAL,
+      // heal the unit if it still regenerates, then reschedule for the next round end
+      REGENERATION,
+      // call the callback with the card (e.g. a countdown or a "next round" effect)
+      DELAYED,
+   };
+   using Callback = SmallFunction< void(Logic&, const sptr< Card >&) >;
+
+   struct Timer {
+      size_t round;
+      RoundPhase phase;
+      Kind kind;
+      sptr< Card > card;
+      sptr< Grant > grant = nullptr;
+      Callback callback = nullptr;
+      // set on a timer already popped as due, when it is cancelled before it fired
+      bool cancelled = false;
+   };
+
+   constexpr static size_t horizon = 8;
+
+   void schedule(Timer timer);
+   /**
+    * Removes the timers due at the given round and phase from the wheel and returns them in the
+    * order they were scheduled. The returned timers stay valid until the next call.
+    */
+   std::vector< Timer >& pop_due(size_t round, RoundPhase phase);
+   /**
+    * Drops all timers of the card, e.g. because it left the board. Those of the last popped batch
+    * are marked as cancelled instead, so that they are skipped if they have not fired yet.
+    */
+   void cancel(const sptr< Card >& card);
+   [[nodiscard]] bool is_scheduled(Kind kind, const sptr< Card >& card) const;
+   void clear();
+   /**
+    * Replaces the card of every timer by the card `card_of` maps it to, e.g. its clone in a copied
+    * state, and the grant of a timer by the clone of it that this card holds.
+    */
+   template < typename CardMap >
+   void rebind(CardMap&& card_of)
+   {
+      for(auto& slot : m_slots) {
+         for(auto& timer : slot) {
+            timer.card = card_of(timer.card);
+            if(timer.grant != nullptr) {
+               timer.grant = _grant_of(*timer.card, *timer.grant);
+            }
+         }
+      }
+      // states are copied between batches, so the last popped batch has been fired already
+      m_due.clear();
+   }
+
+   [[nodiscard]] auto size() const { return m_size; }
+   [[nodiscard]] auto empty() const { return m_size == 0; }
+
+  private:
+   std::array< std::vector< Timer >, horizon * n_round_phases > m_slots{};
+   std::vector< Timer > m_due{};
+   size_t m_size = 0;
+
+   /**
+    * The grant of `card` that is a copy of `grant`.
+    */
+   static sptr< Grant > _grant_of(const Card& card, const Grant& grant);
+   static size_t _slot(size_t round, RoundPhase phase)
+   {
+      return (round % horizon) * n_round_phases + static_cast< size_t >(phase);
+   }
+};
+
+#endif  // LORAINE_TIMER_WHEEL_H
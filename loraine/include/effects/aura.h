@@ -0,0 +1,142 @@
+
+#ifndef LORAINE_AURA_H
+#define LORAINE_AURA_H
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+#include "cards/card.h"
+#include "cards/card_defs.h"
+#include "utils/small_function.h"
+#include "utils/types.h"
+
+class Board;
+
+/**
+ * The continuous part of an effect with label EffectBase::Label::AURA, e.g. "Other allies have
+ * +1|+0" or "Allies with 1 power have Elusive": the deltas it grants to every unit on the board
+ * (camp and battlefield) that it covers for as long as its source is there.
+ */
+struct AuraSpec {
+   enum class Scope { ALLIES = 0, ENEMIES, ALL };
+   using TargetFilter = SmallFunction< bool(const Card& /*source*/, const Unit& /*target*/) >;
+
+   long power = 0;
+   long health = 0;
+   std::optional< Keyword > keyword = std::nullopt;
+   Scope scope = Scope::ALLIES;
+   // whether the source grants the deltas to itself too (if it is a unit)
+   bool includes_source = false;
+   // further restricts the covered units, covers all units in scope if empty
+   TargetFilter filter = nullptr;
+};
+
+/**
+ * Tracks which aura source contributes which deltas to which unit.
+ *
+ * The contributions are updated incrementally: a source entering the board covers the units
+ * already there, a unit entering the board is covered by the sources already there, and leaving the
+ * board undoes exactly the contributions of (or to) the card that left. Nothing is re-scanned after
+ * an event, so an event costs time linear in the number of sources or contributions, not their
+ * product.
+ *
+ * Stat deltas are applied as temporary (round-independent) deltas of the unit; keywords are only
+ * granted, and later taken away, if the unit did not already have them. A unit leaving the board
+ * loses the deltas it received. Undoing health deltas may leave a damaged unit without health, so
+ * the removals return the units that lost health for the caller to check for deaths.
+ */
+class AuraTracker {
+  public:
+   struct Source {
+      sptr< Card > card;
+      AuraSpec spec;
+   };
+   struct Contribution {
+      sptr< Card > source;
+      sptr< Unit > target;
+      long power;
+      long health;
+      std::optional< Keyword > keyword;
+      // whether the keyword was added by this contribution, i.e. the target did not have it yet
+      bool owns_keyword;
+   };
+
+   /**
+    * Registers the aura of `source` and grants its deltas to the covered units on `board`.
+    */
+   void add_source(const sptr< Card >& source, AuraSpec spec, const Board& board);
+   /**
+    * Removes all auras of `source` and undoes their contributions. Returns the units that lost
+    * health by it, which may have none left.
+    */
+   std::vector< sptr< Unit > > remove_source(const sptr< Card >& source);
+   /**
+    * Grants the deltas of all registered auras covering `unit`, which has just entered the board.
+    */
+   void enter(const sptr< Unit >& unit);
+   /**
+    * Handles `card` leaving the board: its own auras end and the contributions it received are
+    * undone. Returns the other units that lost health by it, which may have none left.
+    */
+   std::vector< sptr< Unit > > leave(const sptr< Card >& card);
+   /**
+    * Forgets all sources and contributions without undoing them, for when the cards are discarded
+    * anyway (e.g. on GameState::reset).
+    */
+   void clear();
+   /**
+    * Replaces every card referred to by the card `card_of` maps it to, e.g. its clone in a copied
+    * state.
+    */
+   template < typename CardMap >
+   void rebind(CardMap&& card_of)
+   {
+      for(auto& source : m_sources) {
+         source.card = card_of(source.card);
+      }
+      for(auto& contribution : m_contributions) {
+         contribution.source = card_of(contribution.source);
+         contribution.target = card_of(contribution.target);
+      }
+   }
+
+   [[nodiscard]] auto& sources() const { return m_sources; }
+   [[nodiscard]] auto& contributions() const { return m_contributions; }
+   [[nodiscard]] bool empty() const { return m_sources.empty(); }
+
+  private:
+   std::vector< Source > m_sources;
+   std::vector< Contribution > m_contributions;
+
+   static bool _covers(const Source& source, const Unit& unit);
+   void _contribute(const Source& source, const sptr< Unit >& unit);
+   /**
+    * Removes and undoes the contributions matching `pred`. The units losing health are appended to
+    * `weakened`.
+    */
+   template < typename Predicate >
+   void _remove_contributions(Predicate&& pred, std::vector< sptr< Unit > >& weakened)
+   {
+      auto kept_end = std::partition(
+         m_contributions.begin(), m_contributions.end(), [&](const Contribution& contribution) {
+            return not pred(contribution);
+         });
+      for(auto it = kept_end; it != m_contributions.end(); ++it) {
+         _undo(*it, kept_end);
+         if(it->health > 0
+            && std::find(weakened.begin(), weakened.end(), it->target) == weakened.end()) {
+            weakened.emplace_back(it->target);
+         }
+      }
+      m_contributions.erase(kept_end, m_contributions.end());
+   }
+   /**
+    * Takes back the deltas of a removed contribution. The contributions that stay are the ones
+    * before `kept_end`. The health taken back is not checked for the unit's death here, that is
+    * the Logic's business (see Logic::remove_aura).
+    */
+   void _undo(const Contribution& contribution, std::vector< Contribution >::iterator kept_end);
+};
+
+#endif  // LORAINE_AURA_H
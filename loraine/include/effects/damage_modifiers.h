@@ -0,0 +1,60 @@
+#ifndef LORAINE_DAMAGE_MODIFIERS_H
+#define LORAINE_DAMAGE_MODIFIERS_H
+
+#include <algorithm>
+
+#include "utils/small_function.h"
+#include "utils/types.h"
+
+class Card;
+
+namespace modifiers {
+
+/// modifies the damage `amount` dealt by `source` and returns the damage to take instead
+using DamageModifier = SmallFunction< long(const Card& /*source*/, long /*amount*/) >;
+using ModifierId = u16;
+
+/**
+ * The damage modifiers known to the engine. Units and nexuses refer to them by id, so that copying
+ * them copies no callables and these modifiers are applied without an indirect call.
+ */
+enum BuiltinDamageModifier : ModifierId {
+   // no damage is taken at all
+   NEGATE_DAMAGE = 0,
+   // the damage is reduced by 1 (like TOUGH)
+   REDUCE_DAMAGE_BY_ONE,
+   // at most 1 damage is taken
+   CAP_DAMAGE_AT_ONE,
+};
+constexpr const ModifierId n_builtin_damage_modifiers = CAP_DAMAGE_AT_ONE + 1;
+
+/**
+ * The registry of damage modifiers. Modifiers beyond the built-in ones are registered once (e.g.
+ * by a card's definition) and are then referred to by the id returned. Registration is not
+ * synchronized and thus has to happen before games are played concurrently.
+ */
+class DamageModifiers {
+  public:
+   static ModifierId add(DamageModifier modifier);
+
+   static long apply(ModifierId id, const Card& source, long amount)
+   {
+      switch(id) {
+         case NEGATE_DAMAGE:
+            return 0;
+         case REDUCE_DAMAGE_BY_ONE:
+            return std::max(0L, amount - 1);
+         case CAP_DAMAGE_AT_ONE:
+            return std::min(1L, amount);
+         default:
+            return _apply_registered(id, source, amount);
+      }
+   }
+
+  private:
+   static long _apply_registered(ModifierId id, const Card& source, long amount);
+};
+
+}  // namespace modifiers
+
+#endif  // LORAINE_DAMAGE_MODIFIERS_H
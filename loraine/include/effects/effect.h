@@ -62,6 +62,8 @@ class EffectBase:
 
    [[nodiscard]] auto& uuid() const { return m_uuid; }
 
+   [[nodiscard]] std::string_view trace_name() const override;
+
    bool operator==(const EffectBase& effect) const;
    bool operator!=(const EffectBase& effect) const;
 
@@ -14,6 +14,7 @@
 #include "core/targeting.h"
 #include "event_subscriber.h"
 #include "events/lor_events/event_labels.h"
+#include "utils/effect_tracer.h"
 #include "utils/types.h"
 #include "utils/utils.h"
 
@@ -47,6 +48,7 @@ class EventBus: utils::CRTP< EventBus, Derived, Args...> {
 
   protected:
    void _notify(SubscriberType* subscriber, GameState& state, Args... args) {
+      LORAINE_TRACE_EFFECT(subscriber->trace_name(), EventT::value);
       // passing in the EventT is needed to distinguish among ambiguous on_event overloads
       subscriber->on_event(state, EventData(EventT{}, args...));
    }
@@ -57,6 +59,7 @@ class EventBus: utils::CRTP< EventBus, Derived, Args...> {
 
    void fire(GameState& state, Args... args)
    {
+      LORAINE_TRACE_EVENT_FIRED();
       // resort the subscribers according to whether the specific EventSpecialization has an
       // order method or not
       if constexpr(has_order_method< Derived >::value) {
@@ -25,6 +25,15 @@ class EventListener: public utils::CRTP< EventListener, Derived > {
 //   };
 
   public:
+   EventListener() = default;
+   // a copy is not subscribed to the events of its original (e.g. those of another game state),
+   // it has to be connected anew
+   EventListener(const EventListener& /*other*/) noexcept
+       : utils::CRTP< EventListener, Derived >()
+   {
+   }
+   EventListener& operator=(const EventListener& /*other*/) noexcept { return *this; }
+
    void connect(events::LOREvent& event)
    {
       event.subscribe(this->derived());
@@ -2,6 +2,8 @@
 #ifndef LORAINE_EVENT_SUBSCRIBER_H
 #define LORAINE_EVENT_SUBSCRIBER_H
 
+#include <string_view>
+
 // forward-declare
 class GameState;
 
@@ -31,6 +33,11 @@ struct IEventSubscriber< Event > {
    {
       throw std::logic_error("Empty on_event function called.");
    }
+   /**
+    * The name under which the subscriber's notifications are attributed by the effect tracer.
+    * Overriding it once in a subscriber of many events overrides it for all of them.
+    */
+   [[nodiscard]] virtual std::string_view trace_name() const { return "<anonymous>"; }
 };
 
 #endif  // LORAINE_EVENT_SUBSCRIBER_H
@@ -42,6 +42,43 @@ struct EventLabelType {
 
 constexpr const size_t n_events = static_cast< size_t >(EventLabel::UNIT_DAMAGE) + 1;
 
+/**
+ * The name of each event label, e.g. for reports and logs.
+ */
+constexpr const char* label_name(EventLabel label)
+{
+   constexpr const char* names[n_events] = {
+      "ATTACK",
+      "BEHOLD",
+      "BLOCK",
+      "CAPTURE",
+      "CAST",
+      "DAYBREAK",
+      "DISCARD",
+      "DRAW_CARD",
+      "ENLIGHTENMENT",
+      "GAIN_MANAGEM",
+      "HEAL_UNIT",
+      "LEVEL_UP",
+      "NEXUS_DAMAGE",
+      "NEXUS_STRIKE",
+      "NIGHTFALL",
+      "PLAY",
+      "RECALL",
+      "ROUND_END",
+      "ROUND_START",
+      "SCOUT",
+      "SLAY",
+      "STRIKE",
+      "STUN",
+      "SUMMON",
+      "SUPPORT",
+      "TARGET",
+      "UNIT_DAMAGE",
+   };
+   return names[static_cast< size_t >(label)];
+}
+
 }  // namespace lor_events
 
 #endif  // LORAINE_EVENT_LABELS_H
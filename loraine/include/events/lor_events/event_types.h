@@ -160,7 +160,7 @@ class NightfallEvent:
  * 1st Arg: const sptr<Card>& = The played spell
  */
 class PlayEvent:
-    public EventBus< PlayEvent, EventLabelType< EventLabel::ATTACK >, Team, const sptr< Card >& > {
+    public EventBus< PlayEvent, EventLabelType< EventLabel::PLAY >, Team, const sptr< Card >& > {
 };
 /*
  * 1st Arg: const sptr<Card>& = The recalling spell
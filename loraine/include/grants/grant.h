@@ -24,6 +24,18 @@ class Grant {
 
    void undo() { _undo(); }
    virtual void apply() = 0;
+   /**
+    * Copies the grant, e.g. for a copy of the card it was bestowed on, which then rebinds it.
+    */
+   [[nodiscard]] virtual sptr< Grant > clone() const = 0;
+   /**
+    * Points the grant at the given cards, e.g. at the clones of its cards in a copied state.
+    */
+   void rebind(sptr< Card > bestowing_card, sptr< Card > bestowed_card)
+   {
+      m_bestowing_card = std::move(bestowing_card);
+      m_bestowed_card = std::move(bestowed_card);
+   }
 
    [[nodiscard]] std::string explain() const;
    virtual ~Grant() = default;
@@ -34,10 +46,8 @@ class Grant {
       sptr< Card > bestowed_card,
       bool permanent);
 
-   Grant(const Grant& grant)
-       : m_grant_type(grant.get_grant_type()), m_permanent(grant.is_permanent()), m_uuid(utils::new_uuid())
-   {
-   }
+   // a copy keeps the identity of the grant, as a copied card keeps that of the card
+   Grant(const Grant& grant) = default;
    Grant(Grant&& grant) = default;
    Grant& operator=(Grant&& rhs) = delete;
    Grant& operator=(const Grant& rhs) = delete;
@@ -65,6 +75,10 @@ class StatsGrant: public Grant {
       long int power,
       long health);
 
+   [[nodiscard]] sptr< Grant > clone() const override
+   {
+      return std::make_shared< StatsGrant >(*this);
+   }
    void apply() override;
 
    [[nodiscard]] inline auto get_power_change() const { return m_power_change; }
@@ -88,6 +102,10 @@ class ManaGrant: public Grant {
       bool permanent,
       long int mana_change);
 
+   [[nodiscard]] sptr< Grant > clone() const override
+   {
+      return std::make_shared< ManaGrant >(*this);
+   }
    void apply() override
    {
       get_bestowed_card()->add_mana_cost(m_mana_change, is_permanent());
@@ -109,6 +127,10 @@ class KeywordGrant: public Grant {
       bool permanent,
       enum Keyword kword);
 
+   [[nodiscard]] sptr< Grant > clone() const override
+   {
+      return std::make_shared< KeywordGrant >(*this);
+   }
    void apply() override
    {
       if(auto bestowed_card = get_bestowed_card(); not bestowed_card->has_keyword(m_keyword)) {
@@ -140,6 +162,10 @@ class EffectGrant: public Grant {
          get_bestowed_card()->remove_effect(m_event_type, *m_effect);
       }
    }
+   [[nodiscard]] sptr< Grant > clone() const override
+   {
+      return std::make_shared< EffectGrant >(*this);
+   }
    void apply() override
    {
       get_bestowed_card()->add_effect(m_event_type, m_effect);
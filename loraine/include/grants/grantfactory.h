@@ -15,16 +15,16 @@ class GrantFactory {
       sptr< Grant > grant = nullptr;
       if constexpr(grant_type == GrantType::STATS) {
          grant = std::make_shared< StatsGrant >(
-            grant_type, bestowing_card, card_to_bestow, std::forward< Params... >(params...));
+            bestowing_card, card_to_bestow, std::forward< Params >(params)...);
       } else if constexpr(grant_type == GrantType::MANA) {
          grant = std::make_shared< ManaGrant >(
-            grant_type, bestowing_card, card_to_bestow, std::forward< Params... >(params...));
+            bestowing_card, card_to_bestow, std::forward< Params >(params)...);
       } else if constexpr(grant_type == GrantType::KEYWORD) {
          grant = std::make_shared< KeywordGrant >(
-            grant_type, bestowing_card, card_to_bestow, std::forward< Params... >(params...));
+            bestowing_card, card_to_bestow, std::forward< Params >(params)...);
       } else if constexpr(grant_type == GrantType::EFFECT) {
          grant = std::make_shared< EffectGrant >(
-            grant_type, bestowing_card, card_to_bestow, std::forward< Params... >(params...));
+            bestowing_card, card_to_bestow, std::forward< Params >(params)...);
       }
       for(auto& modifier : m_modifiers) {
          (*modifier)(*grant);
@@ -49,6 +49,8 @@ class GrantFactory {
       }
    }
 
+   inline void clear_modifiers() { m_modifiers.clear(); }
+
   private:
    std::vector< sptr< GrantModifier > > m_modifiers;
 };
@@ -6,6 +6,7 @@
 #include <utility>
 
 #include "grant.h"
+#include "utils/small_function.h"
 
 /*
  * Abstract Base Class for modifying grants after their play_event_triggers, but before execution time.
@@ -13,8 +14,10 @@
  * */
 class GrantModifier {
   public:
-   explicit GrantModifier(std::function< bool(Grant&) > filter = [](Grant& /*g*/) { return true; })
-       : m_filter(std::move(filter)), m_uuid(utils::new_uuid()){};
+   using FilterFunc = SmallFunction< bool(Grant&) >;
+
+   explicit GrantModifier(FilterFunc filter = [](Grant& /*g*/) { return true; })
+       : m_filter(filter), m_uuid(utils::new_uuid()){};
 
    void operator()(Grant& g)
    {
@@ -44,7 +47,7 @@ class GrantModifier {
    static void _set_keyword(KeywordGrant& kg, Keyword kword) { kg.m_keyword = kword; }
 
   private:
-   std::function< bool(Grant&) > m_filter;
+   FilterFunc m_filter;
    UUID m_uuid;
 
    virtual void _modify(Grant& g) = 0;
@@ -0,0 +1,32 @@
+
+#ifndef LORAINE_MAPPED_FILE_H
+#define LORAINE_MAPPED_FILE_H
+
+#include <filesystem>
+#include <vector>
+
+#include "utils/types.h"
+
+/**
+ * A read-only mapping of a whole file. Processes mapping the same file share its page cache copy.
+ * Where memory mapping is unavailable, the file is read into (8 byte aligned) memory instead.
+ */
+class MappedFile {
+  public:
+   explicit MappedFile(const std::filesystem::path& path);
+   MappedFile(const MappedFile&) = delete;
+   MappedFile(MappedFile&& other) noexcept;
+   MappedFile& operator=(const MappedFile&) = delete;
+   MappedFile& operator=(MappedFile&& other) noexcept;
+   ~MappedFile();
+
+   [[nodiscard]] const u8* data() const { return m_data; }
+   [[nodiscard]] size_t size() const { return m_size; }
+
+  private:
+   const u8* m_data = nullptr;
+   size_t m_size = 0;
+   std::vector< u64 > m_fallback;
+};
+
+#endif  // LORAINE_MAPPED_FILE_H
@@ -0,0 +1,164 @@
+
+#ifndef LORAINE_OUTPUT_SINK_H
+#define LORAINE_OUTPUT_SINK_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/types.h"
+
+/**
+ * Asynchronous file output for record producers (game logs, trajectory writers), keeping the
+ * simulation threads off the write syscalls.
+ *
+ * A producer takes a buffer from the sink, fills it and submits it to one of the sink's files.
+ * The sink takes ownership, writes it out in the background and recycles it through its free list.
+ * The sink owns a fixed number of buffers, so `acquire` blocks while all of them are filled or
+ * queued. A producer thus slows down to the disk's pace instead of queueing unbounded memory.
+ *
+ * Each submission is given its file offset right away. The writes of a file thus land in
+ * submission order, however many workers carry them out. They are carried out by io_uring if the
+ * library was built with LORAINE_ENABLE_IO_URING and the kernel supports it, and by a pool of
+ * worker threads otherwise.
+ */
+class OutputSink {
+  public:
+   using Buffer = std::vector< u8 >;
+   using FileId = size_t;
+
+   struct Options {
+      // the number of buffers in circulation
+      size_t n_buffers = 8;
+      // the capacity each buffer is created with
+      size_t buffer_capacity = size_t(1) << 20;
+      // the number of worker threads (without io_uring)
+      size_t n_threads = 1;
+      // whether to use io_uring where available
+      bool io_uring = true;
+   };
+
+   OutputSink();
+   explicit OutputSink(Options options);
+   OutputSink(const OutputSink&) = delete;
+   OutputSink& operator=(const OutputSink&) = delete;
+   /**
+    * Writes out everything submitted and closes all files.
+    */
+   ~OutputSink();
+
+   /**
+    * Opens (and truncates) a file to write to.
+    */
+   FileId open(const std::filesystem::path& path);
+   /**
+    * Closes the file once all writes to it are done. Its id is invalid from then on.
+    */
+   void close(FileId file);
+
+   /**
+    * An empty buffer of at least the configured capacity. Blocks while all buffers are in use.
+    * Its data is aligned for any fundamental type.
+    */
+   Buffer acquire();
+   /**
+    * Returns a buffer that is not going to be submitted.
+    */
+   void release(Buffer buffer);
+   /**
+    * Appends the contents of an acquired buffer to the file. Rethrows an earlier write error. The
+    * sink takes the buffer back even if it throws.
+    */
+   void submit(FileId file, Buffer buffer);
+   /**
+    * Writes the buffer's contents at the given offset of the file. Writes to overlapping ranges
+    * of a file are not ordered.
+    */
+   void submit_at(FileId file, u64 offset, Buffer buffer);
+   /**
+    * Moves the offset the next submissions are appended at, leaving room (e.g. for a header that
+    * is written last).
+    */
+   void skip(FileId file, u64 n_bytes);
+   /**
+    * Waits until all submitted buffers are written. Rethrows the first write error, if any.
+    */
+   void drain();
+
+   [[nodiscard]] auto& options() const { return m_options; }
+   [[nodiscard]] bool uses_io_uring() const { return m_uring != nullptr; }
+   /**
+    * The number of bytes submitted to the file so far.
+    */
+   [[nodiscard]] u64 size(FileId file) const;
+
+  private:
+   struct File;
+   struct Write {
+      File* file;
+      u64 offset;
+      Buffer buffer;
+      // the number of bytes written so far, in case the write is carried out in parts
+      size_t written = 0;
+   };
+   class Uring;
+
+   Options m_options;
+   mutable std::mutex m_mutex;
+   std::condition_variable m_cv;
+   // recycled buffers, and the number of buffers created in total
+   std::vector< Buffer > m_free;
+   // the number of buffers acquired and not yet written or released
+   size_t m_n_in_use = 0;
+   // the open files, which are erased once closed
+   std::unordered_map< FileId, uptr< File > > m_files;
+   FileId m_next_file = 0;
+   std::deque< Write > m_queue;
+   size_t m_n_pending = 0;
+   bool m_stopping = false;
+   std::exception_ptr m_error = nullptr;
+   std::vector< std::thread > m_workers;
+   uptr< Uring > m_uring;
+
+   void _enqueue(std::unique_lock< std::mutex >& lock, Write write);
+   void _work();
+   void _write(Write& write);
+   void _finish(Write& write, std::exception_ptr error);
+   void _recycle(Buffer buffer);
+   void _close_file(File& file);
+   void _erase_file(File& file);
+   File& _target(std::unique_lock< std::mutex >& lock, FileId file, Buffer& buffer);
+   File& _file(FileId file);
+};
+
+/**
+ * Copies bytes into the buffers of an OutputSink, submitting each to the file once it is full. The
+ * last, partly filled one is submitted by `finish`. A writer that is destroyed without finishing
+ * (e.g. since writing threw) gives its buffer back to the sink unwritten.
+ */
+class SinkWriter {
+  public:
+   SinkWriter(OutputSink& sink, OutputSink::FileId file);
+   SinkWriter(const SinkWriter&) = delete;
+   SinkWriter& operator=(const SinkWriter&) = delete;
+   ~SinkWriter();
+
+   void put(const void* data, size_t size);
+   void put(u64 value) { put(&value, sizeof(u64)); }
+   void finish();
+
+  private:
+   OutputSink& m_sink;
+   OutputSink::FileId m_file;
+   size_t m_capacity;
+   OutputSink::Buffer m_buffer;
+   // whether m_buffer is acquired from the sink and not yet handed back
+   bool m_holds_buffer = false;
+};
+
+#endif  // LORAINE_OUTPUT_SINK_H
@@ -0,0 +1,265 @@
+
+#ifndef LORAINE_TRAJECTORY_H
+#define LORAINE_TRAJECTORY_H
+
+#include <array>
+#include <filesystem>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "io/mapped_file.h"
+#include "io/output_sink.h"
+#include "utils/random.h"
+#include "utils/span.h"
+#include "utils/types.h"
+
+/**
+ * The shape of the (observation, legal mask, action, policy, value) records of a trajectory file.
+ *
+ * A record is laid out as the legal mask (one bit per action, in 64 bit words), the observation
+ * and the policy (floats), the action (u32) and the value (float), padded to a multiple of 8
+ * bytes. Every field is thus naturally aligned and found at a fixed offset.
+ */
+struct TrajectoryLayout {
+   u32 observation_size = 0;
+   u32 n_actions = 0;
+
+   [[nodiscard]] size_t mask_words() const { return (size_t(n_actions) + 63) / 64; }
+   [[nodiscard]] size_t observation_offset() const { return mask_words() * sizeof(u64); }
+   [[nodiscard]] size_t policy_offset() const
+   {
+      return observation_offset() + observation_size * sizeof(float);
+   }
+   [[nodiscard]] size_t action_offset() const { return policy_offset() + n_actions * sizeof(float); }
+   [[nodiscard]] size_t value_offset() const { return action_offset() + sizeof(u32); }
+   /**
+    * The size of a record in bytes.
+    */
+   [[nodiscard]] size_t stride() const { return (value_offset() + sizeof(float) + 7) / 8 * 8; }
+
+   bool operator==(const TrajectoryLayout& other) const
+   {
+      return observation_size == other.observation_size && n_actions == other.n_actions;
+   }
+   bool operator!=(const TrajectoryLayout& other) const { return not (*this == other); }
+};
+
+/**
+ * The header at the start of every trajectory file. The records begin `data_offset` bytes into the
+ * file, so that they are page aligned when the file is mapped.
+ */
+struct TrajectoryHeader {
+   constexpr static std::array< char, 8 > file_magic = {'L', 'O', 'R', 'T', 'R', 'A', 'J', '\0'};
+   constexpr static u32 current_format = 1;
+   constexpr static size_t data_offset = 4096;
+
+   std::array< char, 8 > magic = file_magic;
+   u32 format_version = current_format;
+   // the version of the encoder producing the observations, for the consumers to check against
+   u32 encoder_version = 0;
+   u32 observation_size = 0;
+   u32 n_actions = 0;
+   u64 stride = 0;
+   u64 n_records = 0;
+
+   [[nodiscard]] TrajectoryLayout layout() const { return {observation_size, n_actions}; }
+};
+
+/**
+ * A view of a record in place, either in a writer's buffer or in a mapped file.
+ */
+template < bool Const >
+class TrajectoryRecordView {
+   template < typename T >
+   using ptr_type = std::conditional_t< Const, const T*, T* >;
+   template < typename T >
+   using ref_type = std::conditional_t< Const, const T&, T& >;
+
+  public:
+   TrajectoryRecordView(ptr_type< u8 > data, const TrajectoryLayout& layout)
+       : m_data(data), m_layout(layout)
+   {
+   }
+
+   [[nodiscard]] auto legal_mask() const
+   {
+      return Span< std::remove_pointer_t< ptr_type< u64 > > >(
+         _field< u64 >(0), m_layout.mask_words());
+   }
+   [[nodiscard]] bool is_legal(size_t action) const
+   {
+      return (legal_mask()[action / 64] >> (action % 64)) & 1;
+   }
+   template < bool C = Const, typename = std::enable_if_t< not C > >
+   void set_legal(size_t action) const
+   {
+      legal_mask()[action / 64] |= u64(1) << (action % 64);
+   }
+   [[nodiscard]] auto observation() const
+   {
+      return Span< std::remove_pointer_t< ptr_type< float > > >(
+         _field< float >(m_layout.observation_offset()), m_layout.observation_size);
+   }
+   [[nodiscard]] auto policy() const
+   {
+      return Span< std::remove_pointer_t< ptr_type< float > > >(
+         _field< float >(m_layout.policy_offset()), m_layout.n_actions);
+   }
+   [[nodiscard]] ref_type< u32 > action() const { return *_field< u32 >(m_layout.action_offset()); }
+   [[nodiscard]] ref_type< float > value() const
+   {
+      return *_field< float >(m_layout.value_offset());
+   }
+   [[nodiscard]] auto data() const { return m_data; }
+
+  private:
+   ptr_type< u8 > m_data;
+   TrajectoryLayout m_layout;
+
+   template < typename T >
+   [[nodiscard]] ptr_type< T > _field(size_t offset) const
+   {
+      return reinterpret_cast< ptr_type< T > >(m_data + offset);
+   }
+};
+using TrajectoryRecord = TrajectoryRecordView< false >;
+using ConstTrajectoryRecord = TrajectoryRecordView< true >;
+
+/**
+ * Appends trajectory records to a series of shard files `<base>.<shard index>.traj`, each holding
+ * up to `records_per_shard` records.
+ *
+ * Records are filled in place in a buffer of an OutputSink. Once the buffer is full it is handed
+ * to the sink, which writes it out in a single batch while the next one is filled. If the disk
+ * falls behind, so that all of the sink's buffers are still waiting to be written, appending
+ * blocks until one is done.
+ */
+class TrajectoryWriter {
+  public:
+   /**
+    * Writes through a sink of its own with two buffers of `records_per_buffer` records each.
+    */
+   TrajectoryWriter(
+      std::filesystem::path base_path,
+      TrajectoryLayout layout,
+      u32 encoder_version,
+      size_t records_per_buffer = 1024,
+      size_t records_per_shard = size_t(1) << 20);
+   /**
+    * Writes through a sink shared with other producers, filling buffers of its capacity.
+    */
+   TrajectoryWriter(
+      OutputSink& sink,
+      std::filesystem::path base_path,
+      TrajectoryLayout layout,
+      u32 encoder_version,
+      size_t records_per_shard = size_t(1) << 20);
+   TrajectoryWriter(const TrajectoryWriter&) = delete;
+   TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+   ~TrajectoryWriter();
+
+   static std::filesystem::path shard_path(const std::filesystem::path& base_path, size_t shard);
+
+   /**
+    * A zeroed record to fill in. It stays valid until the next call to append or flush. Throws
+    * std::logic_error once the writer is closed.
+    */
+   TrajectoryRecord append();
+   /**
+    * Writes out all records appended so far.
+    */
+   void flush();
+   /**
+    * Writes out all records and completes the last shard's header. Called by the destructor, but
+    * only calling it explicitly reports write errors.
+    */
+   void close();
+
+   [[nodiscard]] auto& layout() const { return m_layout; }
+   [[nodiscard]] auto size() const { return m_n_records; }
+
+  private:
+   uptr< OutputSink > m_owned_sink;
+   OutputSink* m_sink;
+   std::filesystem::path m_base_path;
+   TrajectoryLayout m_layout;
+   u32 m_encoder_version;
+   size_t m_stride;
+   size_t m_records_per_buffer;
+   size_t m_records_per_shard;
+   size_t m_n_records = 0;
+   bool m_closed = false;
+
+   // the buffer being filled (empty until the first record is appended to it)
+   OutputSink::Buffer m_buffer{};
+   size_t m_buffer_records = 0;
+
+   OutputSink::FileId m_file = 0;
+   size_t m_shard = 0;
+   size_t m_shard_records = 0;
+
+   void _hand_over();
+   void _open_shard();
+   void _close_shard();
+};
+
+/**
+ * Reads the shards of a trajectory file by mapping them into memory: a record is accessed in place
+ * by its index, without parsing or copying.
+ */
+class TrajectoryReader {
+  public:
+   explicit TrajectoryReader(const std::vector< std::filesystem::path >& shard_paths);
+   /**
+    * Opens all shards written by a TrajectoryWriter with the given base path.
+    */
+   static TrajectoryReader open(const std::filesystem::path& base_path);
+
+   TrajectoryReader(const TrajectoryReader&) = delete;
+   TrajectoryReader(TrajectoryReader&&) = default;
+   TrajectoryReader& operator=(const TrajectoryReader&) = delete;
+   TrajectoryReader& operator=(TrajectoryReader&&) = default;
+   ~TrajectoryReader() = default;
+
+   [[nodiscard]] auto size() const { return m_n_records; }
+   [[nodiscard]] auto empty() const { return m_n_records == 0; }
+   [[nodiscard]] auto& layout() const { return m_layout; }
+   [[nodiscard]] auto encoder_version() const { return m_encoder_version; }
+   [[nodiscard]] auto n_shards() const { return m_shards.size(); }
+
+   [[nodiscard]] ConstTrajectoryRecord operator[](size_t idx) const;
+   [[nodiscard]] ConstTrajectoryRecord at(size_t idx) const;
+   /**
+    * A record drawn uniformly at random. Throws std::out_of_range if there are no records.
+    */
+   template < typename RNG >
+   [[nodiscard]] ConstTrajectoryRecord sample(RNG&& rng) const
+   {
+      if(empty()) {
+         throw std::out_of_range("A record cannot be sampled from an empty trajectory file.");
+      }
+      return (*this)[std::uniform_int_distribution< size_t >(0, m_n_records - 1)(rng)];
+   }
+
+  private:
+   struct Shard {
+      MappedFile mapping;
+      size_t n_records;
+
+      [[nodiscard]] const u8* records() const
+      {
+         return mapping.data() + TrajectoryHeader::data_offset;
+      }
+   };
+
+   std::vector< Shard > m_shards;
+   // the index of the first record of each shard
+   std::vector< size_t > m_first_record;
+   TrajectoryLayout m_layout{};
+   u32 m_encoder_version = 0;
+   size_t m_stride = 0;
+   size_t m_n_records = 0;
+};
+
+#endif  // LORAINE_TRAJECTORY_H
@@ -0,0 +1,126 @@
+
+#ifndef LORAINE_LETHAL_SOLVER_H
+#define LORAINE_LETHAL_SOLVER_H
+
+#include <array>
+#include <chrono>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "core/gamedefs.h"
+#include "utils/types.h"
+
+class GameState;
+class Unit;
+
+/**
+ * Exact solver for the question "is there guaranteed lethal this round, and what is the line?".
+ *
+ * Within a round the engine's only source of nexus damage is combat, so the solver searches the
+ * attack declarations of the team holding the attack token against every legal block of the
+ * defender. Sending an additional attacker can never lower the damage the defender is able to
+ * hold the nexus to, hence every eligible camp unit attacks and the attacker's remaining choices
+ * are the CHALLENGER drags. The defender answers lane by lane with a blocker (or none), subject to
+ * ELUSIVE, FEARSOME, CANT_BLOCK and STUN.
+ *
+ * The tree is searched with alpha-beta in a null window around the opponent's nexus health,
+ * ordering the moves that hurt the opponent most first, and a transposition table keyed by
+ * (lane, used blockers, forced blocks). Before searching, a combat predictor discards states in
+ * which the sum of all attacking power cannot reach the nexus. Root results are memoized by a
+ * hash of the combat relevant board, since the check is repeated before every expensive search.
+ *
+ * Damage is modelled as a lower bound (e.g. a DOUBLE_ATTACK's second strike is not counted), so a
+ * reported lethal line is guaranteed, while a missed lethal is possible for unmodelled effects.
+ */
+class LethalSolver {
+  public:
+   struct Line {
+      // camp indices of the attacking units, in battlefield lane order
+      std::vector< size_t > attackers;
+      // per lane: the enemy camp index dragged onto the battlefield by a CHALLENGER (if any)
+      std::vector< std::optional< size_t > > challenged;
+      // the nexus damage of this line against the defender's best blocks
+      long guaranteed_damage = 0;
+   };
+   struct Result {
+      // whether the line deals at least the opponent's remaining nexus health
+      bool lethal = false;
+      // whether the search was exhaustive (false if the time budget ran out first)
+      bool complete = true;
+      // the attack to declare if lethal, otherwise the attack holding up best
+      Line line;
+      // the number of search nodes visited (0 if answered by the predictor or the cache)
+      size_t nodes = 0;
+   };
+
+   explicit LethalSolver(
+      std::chrono::microseconds budget = std::chrono::milliseconds(1),
+      size_t tt_size_log2 = 14,
+      size_t cache_capacity = 4096);
+
+   /**
+    * Check the active team for lethal.
+    */
+   Result solve(const GameState& state);
+   /**
+    * Check whether the given team has lethal on its opponent this round.
+    * @param state GameState,
+    *   the state to analyze. It is only read.
+    * @param attacker Team,
+    *   the team whose attacks are searched
+    * @return Result,
+    *   the verdict and the corresponding line
+    */
+   Result solve(const GameState& state, Team attacker);
+
+   void budget(std::chrono::microseconds budget) { m_budget = budget; }
+   [[nodiscard]] auto budget() const { return m_budget; }
+   void clear_cache() { m_cache.clear(); }
+
+  private:
+   static constexpr size_t max_lanes = 6;
+   static constexpr i8 no_blocker = -1;
+
+   struct Fighter {
+      long power;
+      long health;
+      u16 flags;
+      size_t camp_index;
+   };
+   enum class Bound : u8 { EXACT = 0, LOWER, UPPER };
+   struct TTEntry {
+      u64 key = 0;
+      u32 generation = 0;
+      long value = 0;
+      Bound bound = Bound::EXACT;
+   };
+
+   std::chrono::microseconds m_budget;
+   std::vector< TTEntry > m_tt;
+   u32 m_generation = 0;
+   size_t m_cache_capacity;
+   std::unordered_map< u64, Result > m_cache;
+
+   // the per-solve search context
+   std::vector< Fighter > m_attackers;
+   std::vector< Fighter > m_blockers;
+   std::array< i8, max_lanes > m_forced{};
+   std::chrono::steady_clock::time_point m_deadline;
+   size_t m_nodes = 0;
+   bool m_aborted = false;
+
+   long _max_node(size_t lane, u32 used, long alpha, long beta);
+   long _min_node(size_t lane, u32 used, long alpha, long beta);
+   long _search_min_exact();
+
+   [[nodiscard]] bool _can_block(const Fighter& attacker, const Fighter& blocker) const;
+   [[nodiscard]] long _lane_damage(const Fighter& attacker, const Fighter* blocker) const;
+   [[nodiscard]] u64 _tt_key(bool max_phase, size_t lane, u32 used) const;
+   bool _tt_probe(u64 key, long& alpha, long& beta, long& value) const;
+   void _tt_store(u64 key, long value, long alpha, long beta);
+   bool _out_of_time();
+   [[nodiscard]] u64 _board_hash(long nexus_health) const;
+};
+
+#endif  // LORAINE_LETHAL_SOLVER_H
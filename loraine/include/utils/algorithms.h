@@ -181,9 +181,18 @@ void remove_by_sorted_indices(VectorT& v, const IndexVectorT& indices)
 template < typename VectorT, typename IndexVectorT >
 void remove_by_indices(VectorT& v, const IndexVectorT& indices)
 {
-   auto indices_copy = indices;
-   std::sort(indices_copy.begin(), indices_copy.end());
-   remove_by_sorted_indices(v, indices_copy);
+   // compacts the kept elements in place, which avoids sorting a copy of the indices. The
+   // quadratic lookup is cheaper than that for the few indices this is used with.
+   size_t kept = 0;
+   for(size_t i = 0; i < v.size(); ++i) {
+      if(std::find(indices.begin(), indices.end(), i) == indices.end()) {
+         if(kept != i) {
+            v[kept] = std::move(v[i]);
+         }
+         kept += 1;
+      }
+   }
+   v.erase(std::next(v.begin(), kept), v.end());
 }
 
 }  // namespace algo
@@ -0,0 +1,161 @@
+#ifndef LORAINE_ALLOC_TRACKER_H
+#define LORAINE_ALLOC_TRACKER_H
+
+#include <array>
+#include <atomic>
+#include <iosfwd>
+#include <utility>
+#include <vector>
+
+#include "utils/types.h"
+
+/**
+ * Per-thread accounting of heap allocations, attributed to the game phase they happen in.
+ *
+ * The counting is done by the replaced global allocation functions of the `loraine_alloc_hook`
+ * target (cppsrc/alloc_hook.cpp), which an executable opts into by linking it. Without the hook,
+ * the tracker never records anything (see AllocationTracker::hooked).
+ *
+ * Tracking is toggled at runtime per thread and is off by default:
+ *
+ *    profiling::AllocationTracker::enable();
+ *    logic.step();
+ *    auto allocs = profiling::AllocationTracker::total().count;
+ *
+ * Allocations are attributed to the innermost phase that is open when they happen. Phases are
+ * opened for the enclosing scope by
+ *
+ *    LORAINE_ALLOC_PHASE("Logic::step");
+ *
+ * Unlike the profiler's macros, phases are always compiled in, since they cost no more than two
+ * thread-local stores. Phase names must be string literals (or otherwise outlive the tracker), as
+ * they are keyed by pointer.
+ */
+
+#define LORAINE_ALLOC_PHASE_CONCAT_IMPL(a, b) a##b
+#define LORAINE_ALLOC_PHASE_CONCAT(a, b) LORAINE_ALLOC_PHASE_CONCAT_IMPL(a, b)
+#define LORAINE_ALLOC_PHASE(name) \
+   ::profiling::AllocationPhase LORAINE_ALLOC_PHASE_CONCAT(loraine_alloc_phase_, __LINE__)(name)
+
+namespace profiling {
+
+struct AllocationStats {
+   u64 count = 0;
+   u64 bytes = 0;
+
+   void add(size_t size)
+   {
+      count += 1;
+      bytes += size;
+   }
+};
+
+struct PhaseAllocations {
+   // nullptr for allocations outside any phase
+   const char* phase = nullptr;
+   AllocationStats stats;
+};
+
+class AllocationTracker {
+  public:
+   /// the number of distinct phases that are kept apart per thread, any further phases are
+   /// accounted for in the last one
+   constexpr static size_t max_phases = 32;
+
+   /**
+    * Enables or disables the tracking of the calling thread's allocations.
+    */
+   static void enable(bool enable = true) { local().enabled = enable; }
+   [[nodiscard]] static bool enabled() { return local().enabled; }
+   /**
+    * Whether the allocation hook is linked into the executable, i.e. whether anything will ever be
+    * recorded.
+    */
+   [[nodiscard]] static bool hooked() { return s_hooked.load(std::memory_order_relaxed); }
+
+   /**
+    * The allocations of the calling thread while tracking was enabled, since the last reset.
+    */
+   [[nodiscard]] static AllocationStats total() { return local().total; }
+   /**
+    * The calling thread's allocations per phase, sorted by count (descending).
+    */
+   static std::vector< PhaseAllocations > phases();
+   /**
+    * Writes the calling thread's allocations per phase as a human readable table.
+    */
+   static void write_report(std::ostream& os);
+   /**
+    * Discards the calling thread's recorded allocations.
+    */
+   static void reset();
+
+   /**
+    * Records an allocation of the calling thread. Called by the allocation hook, so it must not
+    * allocate itself.
+    */
+   static void record(size_t size) noexcept
+   {
+      auto& data = local();
+      if(not data.enabled) {
+         return;
+      }
+      data.total.add(size);
+      data.stats_of(data.phase).add(size);
+   }
+   /**
+    * Called once by the allocation hook to announce itself.
+    */
+   static void mark_hooked() { s_hooked.store(true, std::memory_order_relaxed); }
+
+  private:
+   friend class AllocationPhase;
+
+   struct ThreadAllocations {
+      bool enabled = false;
+      const char* phase = nullptr;
+      AllocationStats total;
+      std::array< PhaseAllocations, max_phases > phases{};
+      size_t n_phases = 0;
+
+      AllocationStats& stats_of(const char* phase_name)
+      {
+         for(size_t i = 0; i < n_phases; ++i) {
+            if(phases[i].phase == phase_name) {
+               return phases[i].stats;
+            }
+         }
+         if(n_phases < max_phases) {
+            phases[n_phases].phase = phase_name;
+            return phases[n_phases++].stats;
+         }
+         return phases.back().stats;
+      }
+   };
+
+   static ThreadAllocations& local()
+   {
+      thread_local ThreadAllocations data;
+      return data;
+   }
+
+   static inline std::atomic< bool > s_hooked = false;
+};
+
+class AllocationPhase {
+  public:
+   explicit AllocationPhase(const char* name)
+       : m_previous(std::exchange(AllocationTracker::local().phase, name))
+   {
+   }
+   ~AllocationPhase() { AllocationTracker::local().phase = m_previous; }
+   AllocationPhase(const AllocationPhase&) = delete;
+   AllocationPhase& operator=(const AllocationPhase&) = delete;
+
+  private:
+   const char* m_previous;
+};
+
+}  // namespace profiling
+
+#endif  // LORAINE_ALLOC_TRACKER_H
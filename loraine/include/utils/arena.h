@@ -0,0 +1,66 @@
+
+#ifndef LORAINE_ARENA_H
+#define LORAINE_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+#include "utils/types.h"
+
+/**
+ * An arena the objects of one game are allocated from, e.g. a std::pmr::monotonic_buffer_resource.
+ * Arenas are shared, so that an object allocated from one can keep it alive.
+ */
+using Arena = std::pmr::memory_resource;
+
+inline sptr< Arena > make_arena(size_t initial_size = 16 * 1024)
+{
+   return std::make_shared< std::pmr::monotonic_buffer_resource >(initial_size);
+}
+
+/**
+ * An allocator drawing from a shared arena and owning a share of it. Objects made by
+ * std::allocate_shared with it keep their arena alive through their control block, so that they
+ * may safely outlive the game (or state) that created the arena.
+ *
+ * Arenas are not synchronized: objects may only be allocated from one thread at a time.
+ */
+template < typename T >
+class ArenaAllocator {
+  public:
+   using value_type = T;
+
+   explicit ArenaAllocator(sptr< Arena > arena) noexcept : m_arena(std::move(arena)) {}
+   template < typename U >
+   ArenaAllocator(const ArenaAllocator< U >& other) noexcept : m_arena(other.arena())
+   {
+   }
+
+   T* allocate(size_t n)
+   {
+      return static_cast< T* >(m_arena->allocate(n * sizeof(T), alignof(T)));
+   }
+   void deallocate(T* ptr, size_t n) noexcept
+   {
+      m_arena->deallocate(ptr, n * sizeof(T), alignof(T));
+   }
+
+   [[nodiscard]] auto& arena() const { return m_arena; }
+
+   template < typename U >
+   bool operator==(const ArenaAllocator< U >& other) const noexcept
+   {
+      return m_arena == other.arena();
+   }
+   template < typename U >
+   bool operator!=(const ArenaAllocator< U >& other) const noexcept
+   {
+      return not (*this == other);
+   }
+
+  private:
+   sptr< Arena > m_arena;
+};
+
+#endif  // LORAINE_ARENA_H
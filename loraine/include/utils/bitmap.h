@@ -0,0 +1,164 @@
+#ifndef LORAINE_BITMAP_H
+#define LORAINE_BITMAP_H
+
+#include <bitset>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "utils/types.h"
+
+/**
+ * A fixed-size set of indices as a bitmap of 64 bit words, e.g. of the cards of a catalog.
+ *
+ * Combining bitmaps of the same size is a plain loop over their words, which compilers vectorize
+ * into SIMD instructions, so that intersecting a few of them over the whole card catalog costs
+ * about as much as checking a handful of cards one by one.
+ */
+class Bitmap {
+  public:
+   constexpr static size_t word_bits = 64;
+
+   Bitmap() = default;
+   explicit Bitmap(size_t size, bool value = false)
+       : m_words((size + word_bits - 1) / word_bits, value ? ~u64(0) : u64(0)), m_size(size)
+   {
+      _clear_tail();
+   }
+
+   [[nodiscard]] size_t size() const noexcept { return m_size; }
+   [[nodiscard]] bool test(size_t idx) const noexcept
+   {
+      return (m_words[idx / word_bits] >> (idx % word_bits)) & 1;
+   }
+   void set(size_t idx) noexcept { m_words[idx / word_bits] |= u64(1) << (idx % word_bits); }
+   void reset(size_t idx) noexcept { m_words[idx / word_bits] &= ~(u64(1) << (idx % word_bits)); }
+
+   /**
+    * The number of indices in the set.
+    */
+   [[nodiscard]] size_t count() const noexcept
+   {
+      size_t n = 0;
+      for(u64 word : m_words) {
+         n += std::bitset< word_bits >(word).count();
+      }
+      return n;
+   }
+   [[nodiscard]] bool none() const noexcept
+   {
+      for(u64 word : m_words) {
+         if(word != 0) {
+            return false;
+         }
+      }
+      return true;
+   }
+   [[nodiscard]] bool any() const noexcept { return not none(); }
+
+   /**
+    * The `n`-th smallest index in the set. Throws std::out_of_range if it holds no more than n.
+    */
+   [[nodiscard]] size_t select(size_t n) const
+   {
+      for(size_t w = 0; w < m_words.size(); ++w) {
+         u64 word = m_words[w];
+         auto n_set = std::bitset< word_bits >(word).count();
+         if(n >= n_set) {
+            n -= n_set;
+            continue;
+         }
+         // drop the n lowest set bits, the lowest remaining one is the index sought
+         for(; n > 0; --n) {
+            word &= word - 1;
+         }
+         return w * word_bits + _lowest_bit(word);
+      }
+      throw std::out_of_range("The bitmap holds fewer indices than requested.");
+   }
+
+   /**
+    * Calls `func` with each index in the set, in increasing order.
+    */
+   template < typename Func >
+   void for_each(Func&& func) const
+   {
+      for(size_t w = 0; w < m_words.size(); ++w) {
+         for(u64 word = m_words[w]; word != 0; word &= word - 1) {
+            func(w * word_bits + _lowest_bit(word));
+         }
+      }
+   }
+   [[nodiscard]] std::vector< size_t > indices() const
+   {
+      std::vector< size_t > out;
+      out.reserve(count());
+      for_each([&](size_t idx) { out.emplace_back(idx); });
+      return out;
+   }
+
+   Bitmap& operator&=(const Bitmap& other)
+   {
+      _check_size(other);
+      for(size_t w = 0; w < m_words.size(); ++w) {
+         m_words[w] &= other.m_words[w];
+      }
+      return *this;
+   }
+   Bitmap& operator|=(const Bitmap& other)
+   {
+      _check_size(other);
+      for(size_t w = 0; w < m_words.size(); ++w) {
+         m_words[w] |= other.m_words[w];
+      }
+      return *this;
+   }
+   /**
+    * Removes the indices of the other bitmap from this one.
+    */
+   Bitmap& subtract(const Bitmap& other)
+   {
+      _check_size(other);
+      for(size_t w = 0; w < m_words.size(); ++w) {
+         m_words[w] &= ~other.m_words[w];
+      }
+      return *this;
+   }
+
+   friend Bitmap operator&(Bitmap lhs, const Bitmap& rhs) { return lhs &= rhs; }
+   friend Bitmap operator|(Bitmap lhs, const Bitmap& rhs) { return lhs |= rhs; }
+   bool operator==(const Bitmap& other) const
+   {
+      return m_size == other.m_size && m_words == other.m_words;
+   }
+   bool operator!=(const Bitmap& other) const { return not (*this == other); }
+
+   [[nodiscard]] const auto& words() const noexcept { return m_words; }
+
+  private:
+   std::vector< u64 > m_words{};
+   size_t m_size = 0;
+
+   static size_t _lowest_bit(u64 word) noexcept
+   {
+      // the set bits below the lowest one of `word`
+      return std::bitset< word_bits >((word & (~word + 1)) - 1).count();
+   }
+   void _clear_tail() noexcept
+   {
+      if(auto tail = m_size % word_bits; tail != 0) {
+         m_words.back() &= (u64(1) << tail) - 1;
+      }
+   }
+   void _check_size(const Bitmap& other) const
+   {
+      if(other.m_size != m_size) {
+         throw std::invalid_argument(
+            "Bitmaps of sizes " + std::to_string(m_size) + " and " + std::to_string(other.m_size)
+            + " cannot be combined.");
+      }
+   }
+};
+
+#endif  // LORAINE_BITMAP_H
@@ -0,0 +1,151 @@
+
+#ifndef LORAINE_EFFECT_TRACER_H
+#define LORAINE_EFFECT_TRACER_H
+
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "events/lor_events/event_labels.h"
+#include "utils/profiler.h"
+#include "utils/types.h"
+
+/**
+ * Attribution of CPU time to the card implementations handling events.
+ *
+ * Every notification of an event subscriber is timed and keyed by the subscriber's trace name (the
+ * owning card's code for effects) and the label of the handled event. Nested notifications (an
+ * effect triggering events that other effects handle) are accounted for as inclusive time of the
+ * outer effect and subtracted from its self time. Events fired while an effect is running are
+ * counted towards it.
+ *
+ * Unless LORAINE_ENABLE_EFFECT_TRACING is defined (CMake option ENABLE_EFFECT_TRACING), the macros
+ * expand to nothing.
+ */
+
+#if defined(LORAINE_ENABLE_EFFECT_TRACING)
+   #define LORAINE_TRACE_EFFECT(trace_name, label) \
+      ::profiling::EffectScope loraine_effect_scope(trace_name, label)
+   #define LORAINE_TRACE_EVENT_FIRED() ::profiling::EffectTracer::event_fired()
+#else
+   #define LORAINE_TRACE_EFFECT(trace_name, label)
+   #define LORAINE_TRACE_EVENT_FIRED()
+#endif
+
+namespace profiling {
+
+struct EffectCost {
+   std::string card_code;
+   events::EventLabel label;
+   u64 calls = 0;
+   u64 inclusive_ns = 0;
+   u64 self_ns = 0;
+   u64 events_fired = 0;
+};
+
+struct EffectKey {
+   std::string card_code;
+   events::EventLabel label;
+};
+
+struct EffectKeyLess {
+   bool operator()(const EffectKey& k1, const EffectKey& k2) const
+   {
+      int cmp = k1.card_code.compare(k2.card_code);
+      return cmp < 0 || (cmp == 0 && k1.label < k2.label);
+   }
+};
+
+struct EffectFrame {
+   u64 start_ns;
+   u64 child_ns = 0;
+   u64 events_fired = 0;
+};
+
+struct ThreadEffectTrace {
+   std::map< EffectKey, EffectCost, EffectKeyLess > costs;
+};
+
+using EffectTraceRegistry = ThreadRegistry< ThreadEffectTrace >;
+
+class EffectTracer {
+  public:
+   enum class SortKey { CALLS, INCLUSIVE_TIME, SELF_TIME, EVENTS_FIRED };
+
+   /**
+    * Merges the costs of all threads (and thus all games run since the last reset).
+    * @param sort_by SortKey,
+    *   the column to sort by (descending)
+    * @return std::vector< EffectCost >,
+    *   one row per (card code, event label)
+    */
+   static std::vector< EffectCost > report(SortKey sort_by = SortKey::SELF_TIME);
+   /**
+    * Writes the report as a human readable table, limited to the first `top_n` rows (0 = all).
+    */
+   static void write_report(
+      std::ostream& os,
+      SortKey sort_by = SortKey::SELF_TIME,
+      size_t top_n = 0);
+   static void reset();
+
+   /**
+    * Counts an event fired towards the innermost running effect (if any).
+    */
+   static void event_fired()
+   {
+      if(auto& stack = frame_stack(); not stack.empty()) {
+         stack.back().events_fired += 1;
+      }
+   }
+
+   static std::vector< EffectFrame >& frame_stack()
+   {
+      thread_local std::vector< EffectFrame > stack;
+      return stack;
+   }
+};
+
+class EffectScope {
+  public:
+   EffectScope(std::string_view trace_name, events::EventLabel label)
+       : m_key{std::string(trace_name), label}
+   {
+      EffectTracer::frame_stack().emplace_back(EffectFrame{Profiler::now_ns()});
+   }
+   ~EffectScope()
+   {
+      auto& stack = EffectTracer::frame_stack();
+      auto frame = stack.back();
+      stack.pop_back();
+      u64 elapsed = Profiler::now_ns() - frame.start_ns;
+      if(not stack.empty()) {
+         stack.back().child_ns += elapsed;
+      }
+      auto& slot = EffectTraceRegistry::instance().local();
+      std::lock_guard lock(slot.mutex);
+      auto& costs = slot.data.costs;
+      auto entry = costs.find(m_key);
+      if(entry == costs.end()) {
+         entry = costs.emplace(m_key, EffectCost{m_key.card_code, m_key.label}).first;
+      }
+      auto& cost = entry->second;
+      cost.calls += 1;
+      cost.inclusive_ns += elapsed;
+      cost.self_ns += elapsed - std::min(elapsed, frame.child_ns);
+      cost.events_fired += frame.events_fired;
+   }
+   EffectScope(const EffectScope&) = delete;
+   EffectScope& operator=(const EffectScope&) = delete;
+
+  private:
+   // a copy, since the subscriber might not outlive its own notification. Card codes fit into the
+   // small string buffer, so this does not allocate.
+   EffectKey m_key;
+};
+
+}  // namespace profiling
+
+#endif  // LORAINE_EFFECT_TRACER_H
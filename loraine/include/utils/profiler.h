@@ -0,0 +1,265 @@
+
+#ifndef LORAINE_PROFILER_H
+#define LORAINE_PROFILER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iosfwd>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/types.h"
+
+/**
+ * Scoped instrumentation of the engine's hot paths.
+ *
+ * The macros below are the only intended entry point. Unless LORAINE_ENABLE_PROFILING is defined
+ * (CMake option ENABLE_PROFILING) they expand to nothing, so instrumented code carries no cost.
+ *
+ *    LORAINE_PROFILE_SCOPE("Logic::step");                   // time the enclosing scope
+ *    LORAINE_PROFILE_SCOPE_DETAIL("trigger_event", "PLAY");  // time a zone with a sub-label
+ *    LORAINE_PROFILE_COUNT("cards_drawn", 1);                // bump a named counter
+ *
+ * Zone and detail names must be string literals (or otherwise outlive the profiler), since they
+ * are stored and keyed by pointer. Every thread accumulates into its own data, which is only
+ * merged when a report is requested.
+ */
+
+#if defined(LORAINE_ENABLE_PROFILING)
+   #define LORAINE_PROFILE_CONCAT_IMPL(a, b) a##b
+   #define LORAINE_PROFILE_CONCAT(a, b) LORAINE_PROFILE_CONCAT_IMPL(a, b)
+   #define LORAINE_PROFILE_SCOPE(name) \
+      ::profiling::ScopedZone LORAINE_PROFILE_CONCAT(loraine_profile_zone_, __LINE__)(name)
+   #define LORAINE_PROFILE_SCOPE_DETAIL(name, detail) \
+      ::profiling::ScopedZone LORAINE_PROFILE_CONCAT(loraine_profile_zone_, __LINE__)(name, detail)
+   #define LORAINE_PROFILE_COUNT(name, amount) ::profiling::count(name, amount)
+#else
+   #define LORAINE_PROFILE_SCOPE(name)
+   #define LORAINE_PROFILE_SCOPE_DETAIL(name, detail)
+   #define LORAINE_PROFILE_COUNT(name, amount)
+#endif
+
+namespace profiling {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * A registry of per-thread data of type T.
+ *
+ * Each thread lazily creates its own instance on first access. The instances are owned by the
+ * registry and thus outlive their threads, so that data of finished worker threads is still
+ * available when merging. The per-thread mutex is only contended while a merge is in progress.
+ */
+template < typename T >
+class ThreadRegistry {
+  public:
+   struct Slot {
+      std::mutex mutex;
+      T data;
+      u32 thread_index;
+   };
+
+   static ThreadRegistry& instance()
+   {
+      static ThreadRegistry registry;
+      return registry;
+   }
+
+   /**
+    * The calling thread's slot.
+    */
+   Slot& local()
+   {
+      thread_local Slot* slot = nullptr;
+      if(slot == nullptr) {
+         std::lock_guard lock(m_mutex);
+         slot = m_slots.emplace_back(std::make_unique< Slot >()).get();
+         slot->thread_index = static_cast< u32 >(m_slots.size() - 1);
+      }
+      return *slot;
+   }
+
+   /**
+    * Calls func(const T&, u32 thread_index) for every thread's data.
+    */
+   template < typename Func >
+   void for_each(Func&& func)
+   {
+      std::lock_guard lock(m_mutex);
+      for(auto& slot : m_slots) {
+         std::lock_guard slot_lock(slot->mutex);
+         func(slot->data, slot->thread_index);
+      }
+   }
+
+   /**
+    * Calls func(T&) for every thread's data, e.g. to reset it.
+    */
+   template < typename Func >
+   void for_each_mut(Func&& func)
+   {
+      std::lock_guard lock(m_mutex);
+      for(auto& slot : m_slots) {
+         std::lock_guard slot_lock(slot->mutex);
+         func(slot->data);
+      }
+   }
+
+  private:
+   ThreadRegistry() = default;
+
+   std::mutex m_mutex;
+   std::vector< uptr< Slot > > m_slots;
+};
+
+struct ZoneKey {
+   const char* name;
+   const char* detail;
+
+   bool operator==(const ZoneKey& other) const
+   {
+      return name == other.name && detail == other.detail;
+   }
+};
+
+struct ZoneKeyHash {
+   size_t operator()(const ZoneKey& key) const
+   {
+      auto h = std::hash< const void* >{}(key.name);
+      return h ^ (std::hash< const void* >{}(key.detail) + 0x9e3779b9 + (h << 6) + (h >> 2));
+   }
+};
+
+struct ZoneStats {
+   u64 calls = 0;
+   u64 total_ns = 0;
+   u64 min_ns = std::numeric_limits< u64 >::max();
+   u64 max_ns = 0;
+
+   void add(u64 ns)
+   {
+      calls += 1;
+      total_ns += ns;
+      min_ns = std::min(min_ns, ns);
+      max_ns = std::max(max_ns, ns);
+   }
+   void merge(const ZoneStats& other)
+   {
+      calls += other.calls;
+      total_ns += other.total_ns;
+      min_ns = std::min(min_ns, other.min_ns);
+      max_ns = std::max(max_ns, other.max_ns);
+   }
+};
+
+struct TraceEvent {
+   ZoneKey zone;
+   u64 start_ns;
+   u64 duration_ns;
+};
+
+struct ThreadProfile {
+   std::unordered_map< ZoneKey, ZoneStats, ZoneKeyHash > zones;
+   std::unordered_map< const char*, u64 > counters;
+   // the completed zones in order of completion, only recorded while tracing is enabled
+   std::vector< TraceEvent > trace;
+};
+
+using ProfileRegistry = ThreadRegistry< ThreadProfile >;
+
+/**
+ * A merged row of the flat report.
+ */
+struct ZoneReport {
+   std::string name;
+   ZoneStats stats;
+};
+
+class Profiler {
+  public:
+   /**
+    * Enables or disables recording trace events for the chrome trace export. Every thread records
+    * at most `capacity_per_thread` events, later ones are dropped.
+    */
+   static void enable_tracing(bool enable, size_t capacity_per_thread = 1 << 20);
+   [[nodiscard]] static bool tracing() { return s_tracing.load(std::memory_order_relaxed); }
+   [[nodiscard]] static size_t trace_capacity()
+   {
+      return s_trace_capacity.load(std::memory_order_relaxed);
+   }
+
+   /**
+    * Merges the zones of all threads, sorted by total time (descending).
+    */
+   static std::vector< ZoneReport > report();
+   /**
+    * Merges the counters of all threads, sorted by name.
+    */
+   static std::vector< std::pair< std::string, u64 > > counters();
+   /**
+    * Writes the flat report (zones and counters) as a human readable table.
+    */
+   static void write_report(std::ostream& os);
+   /**
+    * Writes the recorded trace events in the chrome trace-event JSON format (chrome://tracing,
+    * perfetto).
+    */
+   static void write_chrome_trace(std::ostream& os);
+   /**
+    * Discards all the accumulated data of every thread.
+    */
+   static void reset();
+
+   /**
+    * Nanoseconds since the profiler's epoch, the common time base of all threads.
+    */
+   static u64 now_ns()
+   {
+      return static_cast< u64 >(
+         std::chrono::duration_cast< std::chrono::nanoseconds >(Clock::now() - s_epoch).count());
+   }
+
+  private:
+   static inline std::atomic< bool > s_tracing = false;
+   static inline std::atomic< size_t > s_trace_capacity = 0;
+   static inline const Clock::time_point s_epoch = Clock::now();
+};
+
+class ScopedZone {
+  public:
+   explicit ScopedZone(const char* name, const char* detail = nullptr)
+       : m_zone{name, detail}, m_start(Profiler::now_ns())
+   {
+   }
+   ~ScopedZone()
+   {
+      u64 end = Profiler::now_ns();
+      auto& slot = ProfileRegistry::instance().local();
+      std::lock_guard lock(slot.mutex);
+      slot.data.zones[m_zone].add(end - m_start);
+      if(Profiler::tracing() && slot.data.trace.size() < Profiler::trace_capacity()) {
+         slot.data.trace.emplace_back(TraceEvent{m_zone, m_start, end - m_start});
+      }
+   }
+   ScopedZone(const ScopedZone&) = delete;
+   ScopedZone& operator=(const ScopedZone&) = delete;
+
+  private:
+   ZoneKey m_zone;
+   u64 m_start;
+};
+
+inline void count(const char* name, u64 amount)
+{
+   auto& slot = ProfileRegistry::instance().local();
+   std::lock_guard lock(slot.mutex);
+   slot.data.counters[name] += amount;
+}
+
+}  // namespace profiling
+
+#endif  // LORAINE_PROFILER_H
@@ -0,0 +1,139 @@
+#ifndef LORAINE_SMALL_FUNCTION_H
+#define LORAINE_SMALL_FUNCTION_H
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template < typename Signature, size_t Capacity = 2 * sizeof(void*) >
+class SmallFunction;
+
+/**
+ * A non-allocating replacement of std::function for the engine's callbacks (filters, modifiers,
+ * hooks).
+ *
+ * The callable is stored inline in a buffer of `Capacity` bytes, which is checked at compile time.
+ * Trivially copyable callables (function pointers, lambdas capturing references, pointers or
+ * plain values) are copied bytewise, so copying a card or a filter does not clone closures on the
+ * heap. Any other callable (e.g. a lambda capturing a shared_ptr) is copied, moved and destroyed
+ * through functions generated for its type.
+ *
+ * Calling an empty SmallFunction throws std::bad_function_call.
+ */
+template < typename R, typename... Args, size_t Capacity >
+class SmallFunction< R(Args...), Capacity > {
+  public:
+   SmallFunction() noexcept = default;
+   SmallFunction(std::nullptr_t) noexcept {}
+   template <
+      typename F,
+      typename = std::enable_if_t<
+         not std::is_same_v< std::decay_t< F >, SmallFunction >
+         and std::is_invocable_r_v< R, std::decay_t< F >&, Args... > > >
+   SmallFunction(F&& func) noexcept(std::is_nothrow_constructible_v< std::decay_t< F >, F&& >)
+   {
+      using Callable = std::decay_t< F >;
+      static_assert(
+         sizeof(Callable) <= Capacity and alignof(Callable) <= alignof(StorageType),
+         "The callable does not fit into the SmallFunction's buffer.");
+      static_assert(
+         std::is_nothrow_move_constructible_v< Callable >,
+         "SmallFunction only stores callables that can be moved without throwing.");
+      ::new(&m_storage) Callable(std::forward< F >(func));
+      m_invoke = [](const void* storage, Args... args) -> R {
+         return (*static_cast< Callable* >(const_cast< void* >(storage)))(
+            std::forward< Args >(args)...);
+      };
+      if constexpr(not std::is_trivially_copyable_v< Callable >) {
+         m_manage = &_manage< Callable >;
+      }
+   }
+   SmallFunction(const SmallFunction& other) : m_invoke(other.m_invoke), m_manage(other.m_manage)
+   {
+      if(m_manage != nullptr) {
+         m_manage(Operation::COPY, &m_storage, const_cast< StorageType* >(&other.m_storage));
+      } else {
+         m_storage = other.m_storage;
+      }
+   }
+   SmallFunction(SmallFunction&& other) noexcept { _take(other); }
+   SmallFunction& operator=(const SmallFunction& other)
+   {
+      if(this != &other) {
+         SmallFunction copy(other);
+         _reset();
+         _take(copy);
+      }
+      return *this;
+   }
+   SmallFunction& operator=(SmallFunction&& other) noexcept
+   {
+      if(this != &other) {
+         _reset();
+         _take(other);
+      }
+      return *this;
+   }
+   ~SmallFunction() { _reset(); }
+
+   R operator()(Args... args) const
+   {
+      if(m_invoke == nullptr) {
+         throw std::bad_function_call();
+      }
+      return m_invoke(&m_storage, std::forward< Args >(args)...);
+   }
+   explicit operator bool() const noexcept { return m_invoke != nullptr; }
+
+  private:
+   using StorageType = std::aligned_storage_t< Capacity, alignof(std::max_align_t) >;
+   enum class Operation { COPY, MOVE, DESTROY };
+
+   StorageType m_storage{};
+   R (*m_invoke)(const void*, Args...) = nullptr;
+   // copies, moves or destroys a callable that is not trivially copyable, nullptr otherwise
+   void (*m_manage)(Operation, void*, void*) = nullptr;
+
+   template < typename Callable >
+   static void _manage(Operation op, void* dest, void* src)
+   {
+      switch(op) {
+         case Operation::COPY:
+            ::new(dest) Callable(*static_cast< const Callable* >(src));
+            break;
+         case Operation::MOVE:
+            ::new(dest) Callable(std::move(*static_cast< Callable* >(src)));
+            static_cast< Callable* >(src)->~Callable();
+            break;
+         case Operation::DESTROY:
+            static_cast< Callable* >(dest)->~Callable();
+            break;
+      }
+   }
+
+   /**
+    * Moves the other's callable into this empty function, leaving the other empty.
+    */
+   void _take(SmallFunction& other) noexcept
+   {
+      m_invoke = std::exchange(other.m_invoke, nullptr);
+      m_manage = std::exchange(other.m_manage, nullptr);
+      if(m_manage != nullptr) {
+         m_manage(Operation::MOVE, &m_storage, &other.m_storage);
+      } else {
+         m_storage = other.m_storage;
+      }
+   }
+   void _reset() noexcept
+   {
+      if(m_manage != nullptr) {
+         m_manage(Operation::DESTROY, &m_storage, nullptr);
+      }
+      m_invoke = nullptr;
+      m_manage = nullptr;
+   }
+};
+
+#endif  // LORAINE_SMALL_FUNCTION_H
@@ -0,0 +1,49 @@
+#ifndef LORAINE_SPAN_H
+#define LORAINE_SPAN_H
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+/**
+ * A non-owning view of contiguous elements, standing in for C++20's std::span. Any container
+ * with `data()` and `size()` (std::vector, StaticVector, std::array) converts to it implicitly,
+ * a temporary one too, as long as the span does not outlive it (e.g. as a function argument).
+ */
+template < typename T >
+class Span {
+  public:
+   using element_type = T;
+   using value_type = std::remove_cv_t< T >;
+   using size_type = size_t;
+   using pointer = T*;
+   using reference = T&;
+   using iterator = T*;
+
+   constexpr Span() noexcept = default;
+   constexpr Span(pointer data, size_type size) noexcept : m_data(data), m_size(size) {}
+   template <
+      typename Container,
+      typename = std::enable_if_t<
+         not std::is_same_v< std::decay_t< Container >, Span >
+         and std::is_convertible_v<
+            decltype(std::data(std::declval< Container& >())),
+            pointer > > >
+   constexpr Span(Container&& container) noexcept
+       : m_data(std::data(container)), m_size(std::size(container))
+   {
+   }
+
+   [[nodiscard]] constexpr iterator begin() const noexcept { return m_data; }
+   [[nodiscard]] constexpr iterator end() const noexcept { return m_data + m_size; }
+   [[nodiscard]] constexpr pointer data() const noexcept { return m_data; }
+   [[nodiscard]] constexpr size_type size() const noexcept { return m_size; }
+   [[nodiscard]] constexpr bool empty() const noexcept { return m_size == 0; }
+   [[nodiscard]] constexpr reference operator[](size_type idx) const { return m_data[idx]; }
+
+  private:
+   pointer m_data = nullptr;
+   size_type m_size = 0;
+};
+
+#endif  // LORAINE_SPAN_H
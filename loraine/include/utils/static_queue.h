@@ -0,0 +1,112 @@
+#ifndef LORAINE_STATIC_QUEUE_H
+#define LORAINE_STATIC_QUEUE_H
+
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+/**
+ * A FIFO queue with a fixed capacity `N`, stored inline as a ring buffer. The counterpart of
+ * StaticVector for the bounded queues of the board.
+ *
+ * The interface follows std::queue. Pushing onto a full queue throws std::length_error.
+ */
+template < typename T, size_t N >
+class StaticQueue {
+  public:
+   using value_type = T;
+   using size_type = size_t;
+   using reference = T&;
+   using const_reference = const T&;
+
+   StaticQueue() noexcept = default;
+   StaticQueue(const StaticQueue& other)
+   {
+      for(size_type i = 0; i < other.m_size; ++i) {
+         push(other._at(i));
+      }
+   }
+   StaticQueue(StaticQueue&& other) noexcept(std::is_nothrow_move_constructible_v< T >)
+   {
+      for(size_type i = 0; i < other.m_size; ++i) {
+         ::new(_slot(m_size++)) T(std::move(other._at(i)));
+      }
+      other.clear();
+   }
+   StaticQueue& operator=(const StaticQueue& other)
+   {
+      if(this != &other) {
+         clear();
+         for(size_type i = 0; i < other.m_size; ++i) {
+            push(other._at(i));
+         }
+      }
+      return *this;
+   }
+   StaticQueue& operator=(StaticQueue&& other) noexcept(std::is_nothrow_move_constructible_v< T >)
+   {
+      if(this != &other) {
+         clear();
+         for(size_type i = 0; i < other.m_size; ++i) {
+            ::new(_slot(m_size++)) T(std::move(other._at(i)));
+         }
+         other.clear();
+      }
+      return *this;
+   }
+   ~StaticQueue() { clear(); }
+
+   [[nodiscard]] size_type size() const noexcept { return m_size; }
+   [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+   [[nodiscard]] constexpr static size_type capacity() noexcept { return N; }
+
+   [[nodiscard]] reference front() { return _at(0); }
+   [[nodiscard]] const_reference front() const { return _at(0); }
+   [[nodiscard]] reference back() { return _at(m_size - 1); }
+   [[nodiscard]] const_reference back() const { return _at(m_size - 1); }
+
+   template < typename... Args >
+   reference emplace(Args&&... args)
+   {
+      if(m_size == N) {
+         throw std::length_error(
+            "StaticQueue of capacity " + std::to_string(N) + " is full.");
+      }
+      T* elem = ::new(_slot(m_size)) T(std::forward< Args >(args)...);
+      m_size += 1;
+      return *elem;
+   }
+   void push(const T& value) { emplace(value); }
+   void push(T&& value) { emplace(std::move(value)); }
+   void pop()
+   {
+      _at(0).~T();
+      m_head = (m_head + 1) % N;
+      m_size -= 1;
+   }
+   void clear() noexcept
+   {
+      while(m_size > 0) {
+         pop();
+      }
+      m_head = 0;
+   }
+
+  private:
+   std::aligned_storage_t< sizeof(T), alignof(T) > m_storage[N];
+   size_type m_head = 0;
+   size_type m_size = 0;
+
+   /// the storage of the `idx`-th element from the front
+   void* _slot(size_type idx) noexcept { return &m_storage[(m_head + idx) % N]; }
+   T& _at(size_type idx) { return *std::launder(reinterpret_cast< T* >(_slot(idx))); }
+   const T& _at(size_type idx) const
+   {
+      return *std::launder(reinterpret_cast< const T* >(&m_storage[(m_head + idx) % N]));
+   }
+};
+
+#endif  // LORAINE_STATIC_QUEUE_H
@@ -0,0 +1,223 @@
+#ifndef LORAINE_STATIC_VECTOR_H
+#define LORAINE_STATIC_VECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+/**
+ * A vector with a fixed capacity `N`, whose elements are stored inline, i.e. without any heap
+ * allocation. Meant for the zones of the game that are bounded by the rules (camp, battlefield,
+ * hand, spell stack), which thus sit within their owning object and copy along with it.
+ *
+ * The interface follows std::vector as far as the engine uses it. Growing beyond the capacity
+ * throws std::length_error, since the rules' bounds were violated.
+ */
+template < typename T, size_t N >
+class StaticVector {
+  public:
+   using value_type = T;
+   using size_type = size_t;
+   using difference_type = std::ptrdiff_t;
+   using reference = T&;
+   using const_reference = const T&;
+   using pointer = T*;
+   using const_pointer = const T*;
+   using iterator = T*;
+   using const_iterator = const T*;
+   using reverse_iterator = std::reverse_iterator< iterator >;
+   using const_reverse_iterator = std::reverse_iterator< const_iterator >;
+
+   StaticVector() noexcept = default;
+   StaticVector(size_type count, const T& value) { resize(count, value); }
+   StaticVector(std::initializer_list< T > init) : StaticVector(init.begin(), init.end()) {}
+   template <
+      typename InputIt,
+      typename = std::enable_if_t< not std::is_integral_v< InputIt > >,
+      typename = typename std::iterator_traits< InputIt >::iterator_category >
+   StaticVector(InputIt first, InputIt last)
+   {
+      for(; first != last; ++first) {
+         emplace_back(*first);
+      }
+   }
+   StaticVector(const StaticVector& other) : StaticVector(other.begin(), other.end()) {}
+   StaticVector(StaticVector&& other) noexcept(std::is_nothrow_move_constructible_v< T >)
+   {
+      for(auto& elem : other) {
+         ::new(_slot(m_size++)) T(std::move(elem));
+      }
+      other.clear();
+   }
+   StaticVector& operator=(const StaticVector& other)
+   {
+      if(this != &other) {
+         clear();
+         for(const auto& elem : other) {
+            ::new(_slot(m_size++)) T(elem);
+         }
+      }
+      return *this;
+   }
+   StaticVector& operator=(StaticVector&& other) noexcept(std::is_nothrow_move_constructible_v< T >)
+   {
+      if(this != &other) {
+         clear();
+         for(auto& elem : other) {
+            ::new(_slot(m_size++)) T(std::move(elem));
+         }
+         other.clear();
+      }
+      return *this;
+   }
+   ~StaticVector() { clear(); }
+
+   [[nodiscard]] iterator begin() noexcept { return data(); }
+   [[nodiscard]] const_iterator begin() const noexcept { return data(); }
+   [[nodiscard]] const_iterator cbegin() const noexcept { return data(); }
+   [[nodiscard]] iterator end() noexcept { return data() + m_size; }
+   [[nodiscard]] const_iterator end() const noexcept { return data() + m_size; }
+   [[nodiscard]] const_iterator cend() const noexcept { return data() + m_size; }
+   [[nodiscard]] reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+   [[nodiscard]] const_reverse_iterator rbegin() const noexcept
+   {
+      return const_reverse_iterator(end());
+   }
+   [[nodiscard]] const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+   [[nodiscard]] reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+   [[nodiscard]] const_reverse_iterator rend() const noexcept
+   {
+      return const_reverse_iterator(begin());
+   }
+   [[nodiscard]] const_reverse_iterator crend() const noexcept { return rend(); }
+
+   [[nodiscard]] size_type size() const noexcept { return m_size; }
+   [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+   [[nodiscard]] constexpr static size_type capacity() noexcept { return N; }
+   [[nodiscard]] constexpr static size_type max_size() noexcept { return N; }
+   /**
+    * Only checks that `count` elements fit, the storage is always there.
+    */
+   void reserve(size_type count) const { _check_capacity(count); }
+
+   [[nodiscard]] pointer data() noexcept { return std::launder(reinterpret_cast< T* >(m_storage)); }
+   [[nodiscard]] const_pointer data() const noexcept
+   {
+      return std::launder(reinterpret_cast< const T* >(m_storage));
+   }
+   [[nodiscard]] reference operator[](size_type idx) { return data()[idx]; }
+   [[nodiscard]] const_reference operator[](size_type idx) const { return data()[idx]; }
+   [[nodiscard]] reference at(size_type idx)
+   {
+      _check_index(idx);
+      return data()[idx];
+   }
+   [[nodiscard]] const_reference at(size_type idx) const
+   {
+      _check_index(idx);
+      return data()[idx];
+   }
+   [[nodiscard]] reference front() { return data()[0]; }
+   [[nodiscard]] const_reference front() const { return data()[0]; }
+   [[nodiscard]] reference back() { return data()[m_size - 1]; }
+   [[nodiscard]] const_reference back() const { return data()[m_size - 1]; }
+
+   template < typename... Args >
+   reference emplace_back(Args&&... args)
+   {
+      _check_capacity(m_size + 1);
+      T* elem = ::new(_slot(m_size)) T(std::forward< Args >(args)...);
+      m_size += 1;
+      return *elem;
+   }
+   void push_back(const T& value) { emplace_back(value); }
+   void push_back(T&& value) { emplace_back(std::move(value)); }
+   void pop_back()
+   {
+      m_size -= 1;
+      data()[m_size].~T();
+   }
+
+   template < typename... Args >
+   iterator emplace(const_iterator pos, Args&&... args)
+   {
+      auto offset = std::distance(cbegin(), pos);
+      emplace_back(std::forward< Args >(args)...);
+      std::rotate(begin() + offset, end() - 1, end());
+      return begin() + offset;
+   }
+   iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+   iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+
+   iterator erase(const_iterator pos) { return erase(pos, std::next(pos)); }
+   iterator erase(const_iterator first, const_iterator last)
+   {
+      auto first_it = begin() + std::distance(cbegin(), first);
+      auto last_it = begin() + std::distance(cbegin(), last);
+      if(first_it != last_it) {
+         auto new_end = std::move(last_it, end(), first_it);
+         _destroy_from(static_cast< size_type >(std::distance(begin(), new_end)));
+      }
+      return first_it;
+   }
+   void clear() noexcept { _destroy_from(0); }
+
+   void resize(size_type count) { _resize(count); }
+   void resize(size_type count, const T& value) { _resize(count, value); }
+
+   friend bool operator==(const StaticVector& lhs, const StaticVector& rhs)
+   {
+      return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+   }
+   friend bool operator!=(const StaticVector& lhs, const StaticVector& rhs)
+   {
+      return not (lhs == rhs);
+   }
+
+  private:
+   std::aligned_storage_t< sizeof(T), alignof(T) > m_storage[N];
+   size_type m_size = 0;
+
+   void* _slot(size_type idx) noexcept { return &m_storage[idx]; }
+
+   static void _check_capacity(size_type count)
+   {
+      if(count > N) {
+         throw std::length_error(
+            "StaticVector of capacity " + std::to_string(N) + " cannot hold "
+            + std::to_string(count) + " elements.");
+      }
+   }
+   void _check_index(size_type idx) const
+   {
+      if(idx >= m_size) {
+         throw std::out_of_range(
+            "Index " + std::to_string(idx) + " out of range for size " + std::to_string(m_size)
+            + ".");
+      }
+   }
+   void _destroy_from(size_type new_size) noexcept
+   {
+      while(m_size > new_size) {
+         pop_back();
+      }
+   }
+   template < typename... Value >
+   void _resize(size_type count, const Value&... value)
+   {
+      _check_capacity(count);
+      _destroy_from(count);
+      while(m_size < count) {
+         ::new(_slot(m_size)) T(value...);
+         m_size += 1;
+      }
+   }
+};
+
+#endif  // LORAINE_STATIC_VECTOR_H
@@ -2,11 +2,11 @@
 #ifndef LORAINE_TYPES_H
 #define LORAINE_TYPES_H
 
-#include <uuid.h>
-
 #include <cinttypes>
 #include <memory>
 
+#include "uuid.h"
+
 using i8 = int8_t;
 using i16 = int16_t;
 using i32 = int32_t;
@@ -17,7 +17,7 @@ using u32 = uint32_t;
 using u64 = uint64_t;
 
 // unique universal identifier type
-using UUID = uuids::uuid;
+using UUID = uuids::UUID;
 // short handles for most common pointer types
 template < typename T >
 using uptr = std::unique_ptr< T >;
@@ -2,8 +2,6 @@
 #ifndef LORAINE_UTIlS_H
 #define LORAINE_UTIlS_H
 
-#include <uuid.h>
-
 #include <optional>
 #include <tuple>
 #include <variant>
@@ -62,9 +60,13 @@ namespace utils {
 
 inline UUID new_uuid()
 {
-   // safer to wrap static variable in function call, in case of exception throw.
-   static auto generator = uuids::uuid_random_generator();
-   return generator();
+   return uuids::Pool::local().get();
+}
+
+inline u64 hash_combine(u64 seed, u64 value)
+{
+   // the 64 bit variant of boost's hash_combine
+   return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 12) + (seed >> 4));
 }
 
 template < template < typename... > class, typename >
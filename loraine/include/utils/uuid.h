@@ -2,31 +2,149 @@
 #ifndef LORAINE_UUID_H
 #define LORAINE_UUID_H
 
-#include <array>
-#include <mutex>
-#include <set>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
 
 namespace uuids {
 
-class Pool {
+/**
+ * The identity of an object of the engine (card, effect, grant, controller, ...).
+ *
+ * A plain 64-bit value, so that comparing and hashing identities is a single integer operation.
+ * The value 0 is the nil id and never handed out by a Pool.
+ */
+class UUID {
   public:
    using int_type = uint64_t;
 
-   explicit Pool(int_type max_value = std::numeric_limits< int_type >::max()) : m_max(max_value) {}
+   constexpr UUID() noexcept = default;
+   constexpr explicit UUID(int_type value) noexcept : m_value(value) {}
+
+   [[nodiscard]] constexpr int_type value() const noexcept { return m_value; }
+   [[nodiscard]] constexpr bool is_nil() const noexcept { return m_value == 0; }
 
-   int_type get() { return m_counter++; }
+   friend constexpr bool operator==(UUID lhs, UUID rhs) noexcept
+   {
+      return lhs.m_value == rhs.m_value;
+   }
+   friend constexpr bool operator!=(UUID lhs, UUID rhs) noexcept
+   {
+      return lhs.m_value != rhs.m_value;
+   }
+   friend constexpr bool operator<(UUID lhs, UUID rhs) noexcept
+   {
+      return lhs.m_value < rhs.m_value;
+   }
 
   private:
-   int_type m_counter = 0;
-   int_type m_max;
+   int_type m_value = 0;
 };
 
-class UUID {
-   UUID(uint64_t value) : m_value(value) {}
+/**
+ * Hands out ids by counting upwards.
+ *
+ * The upper `index_bits` of an id hold the index of the pool, the lower bits hold the pool's
+ * counter. Every thread has a pool of its own, whose index it draws once from a global atomic
+ * counter, so that ids are unique across threads without any synchronization per id (as long as
+ * fewer than 2^20 - 1 threads are started).
+ *
+ * A game owns a pool of the reserved `game_index` instead and draws the ids of everything it
+ * creates from it while being played (see Scope). Its ids thus only depend on the game itself,
+ * not on what the thread playing it ran before. The ids of two games may coincide, which is
+ * harmless, since no object is ever shared between them.
+ */
+class Pool {
+  public:
+   using int_type = UUID::int_type;
+
+   constexpr static unsigned int index_bits = 20;
+   constexpr static unsigned int counter_bits = 64 - index_bits;
+   constexpr static int_type max_count = (int_type(1) << counter_bits) - 1;
+   constexpr static int_type game_index = (int_type(1) << index_bits) - 1;
+
+   explicit Pool(int_type index)
+       : m_prefix((index & ((int_type(1) << index_bits) - 1)) << counter_bits)
+   {
+   }
+
+   /**
+    * Makes the pool the one the calling thread draws its ids from for the lifetime of the scope.
+    * Scopes nest, the previous pool is restored on leaving one.
+    */
+   class Scope {
+     public:
+      explicit Scope(Pool& pool) noexcept : m_previous(std::exchange(_current(), &pool)) {}
+      ~Scope() { _current() = m_previous; }
+      Scope(const Scope&) = delete;
+      Scope& operator=(const Scope&) = delete;
+
+     private:
+      Pool* m_previous;
+   };
+
+   /**
+    * The result of `func`, called with the ids drawn from the pool.
+    */
+   template < typename Func >
+   static decltype(auto) with(Pool& pool, Func&& func)
+   {
+      Scope scope(pool);
+      return std::forward< Func >(func)();
+   }
+
+   UUID get()
+   {
+      if(m_counter == max_count) {
+         throw std::overflow_error("The id pool is exhausted.");
+      }
+      return UUID(m_prefix | ++m_counter);
+   }
+   /**
+    * Restarts the counter, e.g. to get the same ids for the same game played again. Only safe once
+    * no object carrying an id of this pool is in use anymore.
+    */
+   void reset() noexcept { m_counter = 0; }
+
+   /**
+    * The pool the calling thread currently draws its ids from: that of the innermost scope, or
+    * else the thread's own one.
+    */
+   static Pool& local()
+   {
+      if(auto* current = _current(); current != nullptr) {
+         return *current;
+      }
+      static std::atomic< int_type > next_index{0};
+      thread_local Pool pool(next_index.fetch_add(1, std::memory_order_relaxed));
+      return pool;
+   }
+
   private:
-   uint64_t m_value;
+   int_type m_prefix;
+   int_type m_counter = 0;
+
+   static Pool*& _current() noexcept
+   {
+      thread_local Pool* current = nullptr;
+      return current;
+   }
 };
 
 }  // namespace uuids
 
+namespace std {
+
+template <>
+struct hash< uuids::UUID > {
+   size_t operator()(uuids::UUID id) const noexcept
+   {
+      return std::hash< uuids::UUID::int_type >()(id.value());
+   }
+};
+
+}  // namespace std
+
 #endif  // LORAINE_UUID_H
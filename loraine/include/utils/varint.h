@@ -0,0 +1,59 @@
+#ifndef LORAINE_VARINT_H
+#define LORAINE_VARINT_H
+
+#include <cstddef>
+#include <stdexcept>
+
+#include "types.h"
+
+/**
+ * LEB128 variable-length integers: 7 bits per byte, the high bit marking that another byte
+ * follows. Small values (indices, counts, damage) thus take a single byte. Signed values are
+ * zigzag-mapped first, so that small negative values stay short too.
+ */
+namespace varint {
+
+constexpr const size_t max_bytes = 10;
+
+/**
+ * Writes `value` to `out`, which needs room for max_bytes, and returns the number of bytes written.
+ */
+inline size_t encode(u64 value, u8* out) noexcept
+{
+   size_t n = 0;
+   while(value >= 0x80) {
+      out[n++] = static_cast< u8 >(value | 0x80);
+      value >>= 7;
+   }
+   out[n++] = static_cast< u8 >(value);
+   return n;
+}
+
+/**
+ * Reads a value from [`pos`, `end`) and advances `pos` past it.
+ */
+inline u64 decode(const u8*& pos, const u8* end)
+{
+   u64 value = 0;
+   for(unsigned int shift = 0; pos != end && shift < 64; shift += 7) {
+      u8 byte = *pos++;
+      value |= u64(byte & 0x7F) << shift;
+      if((byte & 0x80) == 0) {
+         return value;
+      }
+   }
+   throw std::out_of_range("Truncated or overlong varint.");
+}
+
+constexpr u64 zigzag(i64 value) noexcept
+{
+   return (u64(value) << 1) ^ u64(value >> 63);
+}
+constexpr i64 unzigzag(u64 value) noexcept
+{
+   return i64(value >> 1) ^ -i64(value & 1);
+}
+
+}  // namespace varint
+
+#endif  // LORAINE_VARINT_H
@@ -0,0 +1,192 @@
+import argparse
+import glob
+import json
+import os
+import struct
+import sys
+
+# The binary catalog format read by CardCatalog (loraine/include/cards/catalog.h).
+# The enumerations below mirror the order of their counterparts in cards/card_defs.h.
+FORMAT_VERSION = 1
+MAGIC = b"LORCAT\0\0"
+HEADER = struct.Struct("<8sIIIIIIQQQQQ")
+ENTRY = struct.Struct("<8IQ6BH3I3I")
+
+REGIONS = [
+    "BILGEWATER", "DEMACIA", "FRELJORD", "IONIA", "NOXUS", "PILTOVER_ZAUN", "SHADOW_ISLES",
+    "TARGON",
+]
+GROUPS = [
+    "NONE", "ASCENDED", "CELESTIAL", "DRAGON", "ELITE", "ELNUK", "PORO", "SEA_MONSTER", "SPIDER",
+    "TECH", "TREASURE", "YETI",
+]
+CARD_TYPES = ["SPELL", "UNIT", "LANDMARK", "TRAP"]
+SUPER_TYPES = ["NONE", "CHAMPION", "SKILL"]
+RARITIES = ["NONE", "CHAMPION", "COMMON", "EPIC", "RARE"]
+KEYWORDS = [
+    "ALLEGIANCE", "ATTACK", "ATTUNE", "BARRIER", "BEHOLD", "BURST", "CANT_BLOCK", "CAPTURE",
+    "CHALLENGER", "DYBREAK", "DEEP", "DOUBLE_ATTACK", "DRAIN", "ELUSIVE", "ENLIGHTENED",
+    "EPHEMERAL", "FAST", "FEARSOME", "FOCUS", "FLEETING", "FROSTBITE", "FURY", "NEXUS_STRIKE",
+    "NIGHTFALL", "OBLITERATE", "IMMOBILE", "INVOKE", "LAST_BREATH", "LIFESTEAL", "OVERWHELM",
+    "PLUNDER", "QUICK_ATTACK", "RECALL", "REGENERATION", "SCOUT", "SKILL", "SLOW", "SPELLSHIELD",
+    "STRIKE", "STRONGEST", "STUN", "SUPPORT", "TOSS", "TOUGH", "TRAP", "VULNERABLE", "WEAKEST",
+]
+# the keyword names of the data dumps that are spelled differently in the engine
+KEYWORD_ALIASES = {"DAYBREAK": "DYBREAK", "DOUBLE_STRIKE": "DOUBLE_ATTACK"}
+
+
+class CatalogError(ValueError):
+    """A card that cannot be compiled into the catalog, as CatalogBuilder::write would refuse it."""
+
+
+def enum_name(text):
+    return text.replace("'", "").replace("&", "").replace(" ", "_").upper()
+
+
+def hash_code(code):
+    """64 bit FNV-1a, as CardCatalog::hash_code."""
+    h = 14695981039346656037
+    for byte in code.encode("utf-8"):
+        h = ((h ^ byte) * 1099511628211) & 0xFFFFFFFFFFFFFFFF
+    return h
+
+
+def aligned(offset):
+    return (offset + 7) // 8 * 8
+
+
+def enum_index(values, name, card, field):
+    """The index of `name` in the enumeration `values`, raising a CatalogError if it has none."""
+    if name not in values:
+        raise CatalogError(f"The card {card['cardCode']} has the unknown {field} {name!r}.")
+    return values.index(name)
+
+
+def convert(card, warnings):
+    """The catalog fields of a card of the data dumps. Raises a CatalogError for a card of a region,
+    card type, super type or rarity the engine does not know."""
+    region = enum_name(card.get("regionRef", "") or (card.get("regionRefs") or [""])[0])
+    region = region.replace("PILTOVERZAUN", "PILTOVER_ZAUN").replace("SHADOWISLES", "SHADOW_ISLES")
+    subtypes = card.get("subtypes") or [card.get("subtype", "")]
+    group = enum_name(subtypes[0]) if subtypes and subtypes[0] else "NONE"
+    card_type = enum_name(card["type"])
+    super_type = enum_name(card.get("supertype", "")) or "NONE"
+    if card_type == "ABILITY":
+        card_type, super_type = "SPELL", "SKILL"
+    keywords = 0
+    for keyword in card.get("keywords", []):
+        name = KEYWORD_ALIASES.get(enum_name(keyword), enum_name(keyword))
+        if name in KEYWORDS:
+            keywords |= 1 << KEYWORDS.index(name)
+        else:
+            warnings.add(f"unknown keyword {keyword}")
+    fields = {
+        "code": card["cardCode"],
+        "name": card["name"],
+        "description": card.get("descriptionRaw", ""),
+        "lore": card.get("flavorText", "").replace("\\", ""),
+        "keywords": keywords,
+        "region": enum_index(REGIONS, region, card, "region"),
+        # a group the engine does not know is no group it could refer to
+        "group": GROUPS.index(group) if group in GROUPS else 0,
+        "super_type": enum_index(SUPER_TYPES, super_type, card, "super type"),
+        "rarity": enum_index(
+            RARITIES, enum_name(card.get("rarityRef", "None")) or "NONE", card, "rarity"),
+        "card_type": enum_index(CARD_TYPES, card_type, card, "card type"),
+        "collectible": int(card.get("collectible", True)),
+        "mana_cost": card.get("cost", 0),
+        "power": card.get("attack", 0),
+        "health": card.get("health", 0),
+        "associated": card.get("associatedCardRefs", []),
+    }
+    if group not in GROUPS:
+        warnings.add(f"unknown group {group}")
+    return fields
+
+
+def compile_catalog(cards, data_version):
+    """The bytes of the catalog of the given (converted) cards. Raises a CatalogError for a card
+    associated with a card that is not among them, as CatalogBuilder::write does."""
+    strings = bytearray()
+
+    def add_string(text):
+        encoded = text.encode("utf-8")
+        ref = (len(strings), len(encoded))
+        strings.extend(encoded)
+        return ref
+
+    version_ref = add_string(data_version)
+    card_index = {}
+    for i, card in enumerate(cards):
+        if card["code"] in card_index:
+            raise CatalogError(f"The card code {card['code']} was added twice.")
+        card_index[card["code"]] = i
+    entries = bytearray()
+    associated = []
+    for card in cards:
+        refs = []
+        for code in card["associated"]:
+            if code not in card_index:
+                raise CatalogError(
+                    f"The card {card['code']} is associated with the unknown card {code}.")
+            refs.append(card_index[code])
+        entries += ENTRY.pack(
+            *add_string(card["code"]), *add_string(card["name"]),
+            *add_string(card["description"]), *add_string(card["lore"]),
+            card["keywords"], card["region"], card["group"], card["super_type"], card["rarity"],
+            card["card_type"], card["collectible"], 0,
+            card["mana_cost"], card["power"], card["health"],
+            len(associated), len(refs), 0,
+        )
+        associated += refs
+
+    index_size = 2
+    while index_size < 2 * len(cards):
+        index_size *= 2
+    index = [0] * index_size
+    for i, card in enumerate(cards):
+        slot = hash_code(card["code"]) & (index_size - 1)
+        while index[slot] != 0:
+            slot = (slot + 1) & (index_size - 1)
+        index[slot] = i + 1
+
+    cards_offset = aligned(HEADER.size)
+    associated_offset = aligned(cards_offset + len(entries))
+    index_offset = aligned(associated_offset + 4 * len(associated))
+    strings_offset = aligned(index_offset + 4 * index_size)
+    out = bytearray(strings_offset + len(strings))
+    out[0:HEADER.size] = HEADER.pack(
+        MAGIC, FORMAT_VERSION, len(cards), *version_ref, index_size, len(associated),
+        cards_offset, associated_offset, index_offset, strings_offset, len(strings),
+    )
+    out[cards_offset:cards_offset + len(entries)] = entries
+    out[associated_offset:associated_offset + 4 * len(associated)] = struct.pack(
+        f"<{len(associated)}I", *associated)
+    out[index_offset:index_offset + 4 * index_size] = struct.pack(f"<{index_size}I", *index)
+    out[strings_offset:] = strings
+    return bytes(out)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description="Compiles the set data downloaded by download.py into a binary card catalog.")
+    parser.add_argument("--sets", default=os.path.join(os.getcwd(), "sets"))
+    parser.add_argument("--output", default="cards.lorcat")
+    parser.add_argument("--data-version", default="latest")
+    args = parser.parse_args()
+
+    cards = []
+    warnings = set()
+    try:
+        for fpath in sorted(glob.glob(os.path.join(args.sets, "*", "*", "data", "*.json"))):
+            with open(fpath, "rb") as json_file:
+                for card in json.load(json_file):
+                    cards.append(convert(card, warnings))
+        for warning in sorted(warnings):
+            print(warning)
+        catalog = compile_catalog(cards, args.data_version)
+    except CatalogError as error:
+        sys.exit(f"error: {error}")
+    with open(args.output, "wb") as out_file:
+        out_file.write(catalog)
+    print(f"compiled {len(cards)} cards into {args.output}")
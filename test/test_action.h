@@ -15,13 +15,15 @@ struct TestController: public Controller {
 
    std::stack< actions::Action > action_stack;
 
-   actions::Action choose_action(const GameState& state) override
+   actions::Action choose_action(const GameState& /*state*/) override
    {
       auto a = action_stack.top();
       action_stack.pop();
       return a;
    }
-   actions::Action choose_targets(const GameState& state, const sptr< EffectBase >& effect) override
+   actions::Action choose_targets(
+      const GameState& /*state*/,
+      const sptr< EffectBase >& /*effect*/) override
    {
       auto a = action_stack.top();
       action_stack.pop();
@@ -32,6 +34,78 @@ struct TestController: public Controller {
    void pop() { action_stack.pop(); }
 };
 
+/**
+ * Always chooses the last valid action, which is the most aggressive one on offer (the widest
+ * attack or block, or the last playable card).
+ */
+struct GreedyController: public Controller {
+   using Controller::Controller;
+
+   actions::Action choose_action(const GameState& state) override
+   {
+      return state.logic()->action_invoker().valid_actions(state).back();
+   }
+   actions::Action choose_targets(
+      const GameState& /*state*/,
+      const sptr< EffectBase >& /*effect*/) override
+   {
+      throw std::logic_error("No targets expected.");
+   }
+};
+
+/**
+ * Plays the first playable hand card, otherwise attacks (or blocks) with its first camp unit and
+ * accepts if neither is possible. Single unit combat keeps the game going long enough to reach a
+ * steady state.
+ */
+struct SteadyController: public Controller {
+   using Controller::Controller;
+
+   actions::Action choose_action(const GameState& state) override
+   {
+      Team team = state.active_team();
+      const auto& invoker = state.logic()->action_invoker();
+      if(not state.logic()->in_combat()) {
+         for(size_t i = 0; i < state.player(team).hand().size(); ++i) {
+            if(actions::Action play(actions::PlayRequestAction(team, i)); invoker.is_valid(play)) {
+               return play;
+            }
+         }
+      }
+      const auto& camp = state.board().camp(team);
+      for(size_t i = 0; i < camp.size(); ++i) {
+         if(camp[i]->is_unit()) {
+            if(actions::Action place(actions::PlaceUnitAction(team, true, {i}));
+               invoker.is_valid(place)) {
+               return place;
+            }
+            break;
+         }
+      }
+      return actions::Action(actions::AcceptAction(team));
+   }
+   actions::Action choose_targets(
+      const GameState& /*state*/,
+      const sptr< EffectBase >& /*effect*/) override
+   {
+      throw std::logic_error("No targets expected.");
+   }
+};
+
+/**
+ * A deck of `copies` many of each of the first three test units.
+ */
+inline Deck make_test_deck(Team team, int copies = 4)
+{
+   Deck::ContainerType cards;
+   for(int i = 0; i < copies; ++i) {
+      cards.emplace_back(std::make_shared< TestUnit1 >(team));
+      cards.emplace_back(std::make_shared< TestUnit2 >(team));
+      cards.emplace_back(std::make_shared< TestUnit3 >(team));
+   }
+   return Deck(cards);
+}
+
 class ActionTest: public ::testing::Test {
   protected:
    GameState state = init_state();
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <new>
+#include <sstream>
+
+#include "all.h"
+#include "test_action.h"
+#include "utils/alloc_tracker.h"
+
+namespace {
+
+/**
+ * The allocations of the engine itself, i.e. excluding the controllers' decisions.
+ */
+u64 engine_allocations()
+{
+   u64 count = profiling::AllocationTracker::total().count;
+   for(const auto& [phase, stats] : profiling::AllocationTracker::phases()) {
+      if(phase != nullptr && std::string_view(phase) == "Controller::choose_action") {
+         count -= stats.count;
+      }
+   }
+   return count;
+}
+
+}  // namespace
+
+TEST(AllocationTest, allocations_are_counted_per_phase)
+{
+   using namespace profiling;
+   if(not AllocationTracker::hooked()) {
+      GTEST_SKIP() << "The allocation hook is not linked.";
+   }
+   AllocationTracker::reset();
+   auto allocate = [] { return std::make_unique< long >(0); };
+   allocate();
+   EXPECT_EQ(AllocationTracker::total().count, 0);
+
+   AllocationTracker::enable();
+   allocate();
+   {
+      LORAINE_ALLOC_PHASE("test_phase");
+      allocate();
+      allocate();
+   }
+   AllocationTracker::enable(false);
+   allocate();
+
+   EXPECT_EQ(AllocationTracker::total().count, 3);
+   EXPECT_EQ(AllocationTracker::total().bytes, 3 * sizeof(long));
+   auto phases = AllocationTracker::phases();
+   ASSERT_EQ(phases.size(), 2);
+   EXPECT_EQ(std::string_view(phases[0].phase), "test_phase");
+   EXPECT_EQ(phases[0].stats.count, 2);
+   EXPECT_EQ(phases[1].phase, nullptr);
+   EXPECT_EQ(phases[1].stats.count, 1);
+
+   std::stringstream report;
+   AllocationTracker::write_report(report);
+   EXPECT_NE(report.str().find("test_phase"), std::string::npos);
+
+   AllocationTracker::reset();
+   EXPECT_EQ(AllocationTracker::total().count, 0);
+   EXPECT_TRUE(AllocationTracker::phases().empty());
+}
+
+TEST(AllocationTest, every_allocation_variant_is_counted)
+{
+   using namespace profiling;
+   if(not AllocationTracker::hooked()) {
+      GTEST_SKIP() << "The allocation hook is not linked.";
+   }
+   struct alignas(64) Wide {
+      char bytes[64];
+   };
+   // storing the pointers in a volatile keeps the compiler from eliding the allocations
+   void* volatile sink = nullptr;
+   AllocationTracker::reset();
+   AllocationTracker::enable();
+   auto* single = new long(0);
+   sink = single;
+   delete single;
+   auto* array = new long[2];
+   sink = array;
+   delete[] array;
+   auto* nothrow_single = new(std::nothrow) long(0);
+   sink = nothrow_single;
+   delete nothrow_single;
+   auto* nothrow_array = new(std::nothrow) long[2];
+   sink = nothrow_array;
+   delete[] nothrow_array;
+   auto* wide = new Wide();
+   sink = wide;
+   delete wide;
+   auto* wide_array = new Wide[2];
+   sink = wide_array;
+   delete[] wide_array;
+   auto* nothrow_wide = new(std::nothrow) Wide();
+   sink = nothrow_wide;
+   delete nothrow_wide;
+   AllocationTracker::enable(false);
+   EXPECT_EQ(reinterpret_cast< std::uintptr_t >(sink) % alignof(Wide), 0);
+   EXPECT_EQ(AllocationTracker::total().count, 7);
+   AllocationTracker::reset();
+}
+
+TEST(AllocationTest, steady_state_step_is_allocation_free)
+{
+   using namespace profiling;
+   if(not AllocationTracker::hooked()) {
+      GTEST_SKIP() << "The allocation hook is not linked.";
+   }
+   GameState state(
+      Config(),
+      {make_test_deck(BLUE, 10), make_test_deck(RED, 10)},
+      {std::make_shared< SteadyController >(BLUE), std::make_shared< SteadyController >(RED)},
+      BLUE,
+      random::create_rng(0));
+   state.record_history(false);
+   auto& logic = *state.logic();
+   logic.start_game();
+
+   // the first rounds warm up the containers of the state, from then on a step must not allocate
+   constexpr size_t warmup_rounds = 10;
+   auto status = logic.check_status();
+   size_t steady_steps = 0;
+   while(status == Status::ONGOING) {
+      bool steady = state.round() > warmup_rounds;
+      AllocationTracker::reset();
+      AllocationTracker::enable(steady);
+      status = logic.step();
+      AllocationTracker::enable(false);
+      if(steady) {
+         steady_steps += 1;
+         EXPECT_EQ(engine_allocations(), 0) << "in round " << state.round();
+      }
+   }
+   EXPECT_GT(steady_steps, 10);
+   AllocationTracker::reset();
+}
+
+TEST(AllocationTest, reset_state_plays_allocation_free)
+{
+   using namespace profiling;
+   if(not AllocationTracker::hooked()) {
+      GTEST_SKIP() << "The allocation hook is not linked.";
+   }
+   GameState state(
+      Config(),
+      {make_test_deck(BLUE, 10), make_test_deck(RED, 10)},
+      {std::make_shared< SteadyController >(BLUE), std::make_shared< SteadyController >(RED)},
+      BLUE,
+      random::create_rng(0));
+   state.record_history(false);
+   auto& logic = *state.logic();
+   auto play = [&](bool track) {
+      logic.start_game();
+      auto status = logic.check_status();
+      size_t steps = 0;
+      while(status == Status::ONGOING) {
+         AllocationTracker::reset();
+         AllocationTracker::enable(track);
+         status = logic.step();
+         AllocationTracker::enable(false);
+         steps += 1;
+         EXPECT_EQ(engine_allocations(), 0) << "in round " << state.round();
+      }
+      return steps;
+   };
+   // a whole game warms up the containers, the next game in the same state must not allocate
+   play(false);
+   state.reset({make_test_deck(BLUE, 10), make_test_deck(RED, 10)}, BLUE, 1);
+   EXPECT_GT(play(true), 0);
+   AllocationTracker::reset();
+}
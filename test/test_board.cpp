@@ -31,4 +31,47 @@ TEST(BoardTest, Functionalities)
    board.add_to_camp(unit6);
    auto& camp_blue =  board.camp(Team::BLUE);
    EXPECT_EQ(camp_blue.back(), unit6);
-}
\ No newline at end of file
+}
+TEST(BoardTest, aura_contributions)
+{
+   using camp_type = Board::CampType;
+   auto source = std::make_shared< TestUnit1 >(BLUE);
+   auto ally = std::make_shared< TestUnit3 >(BLUE);
+   auto enemy = std::make_shared< TestUnit2 >(RED);
+   Board board(
+      6, 6, {Board::BfType{}, Board::BfType{}}, {camp_type{source, ally}, camp_type{enemy}});
+   auto ally_power = ally->power();
+   auto source_power = source->power();
+   auto enemy_power = enemy->power();
+
+   AuraTracker auras;
+   AuraSpec spec;
+   spec.power = 1;
+   spec.keyword = Keyword::ELUSIVE;
+   auras.add_source(source, spec, board);
+   EXPECT_EQ(ally->power(), ally_power + 1);
+   EXPECT_TRUE(ally->has_keyword(Keyword::ELUSIVE));
+   EXPECT_EQ(source->power(), source_power);
+   EXPECT_EQ(enemy->power(), enemy_power);
+   EXPECT_EQ(auras.contributions().size(), 1);
+
+   // a second source granting the same keyword keeps it once the first one is gone
+   auto second = std::make_shared< TestUnit4 >(BLUE);
+   board.add_to_camp(second);
+   AuraSpec keyword_only;
+   keyword_only.keyword = Keyword::ELUSIVE;
+   auras.add_source(second, keyword_only, board);
+
+   auto newcomer = std::make_shared< TestUnit5 >(BLUE);
+   auto newcomer_power = newcomer->power();
+   auras.enter(newcomer);
+   EXPECT_EQ(newcomer->power(), newcomer_power + 1);
+
+   auras.leave(source);
+   EXPECT_EQ(ally->power(), ally_power);
+   EXPECT_EQ(newcomer->power(), newcomer_power);
+   EXPECT_TRUE(ally->has_keyword(Keyword::ELUSIVE));
+   auras.remove_source(second);
+   EXPECT_FALSE(ally->has_keyword(Keyword::ELUSIVE));
+   EXPECT_TRUE(auras.contributions().empty());
+}
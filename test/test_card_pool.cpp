@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <map>
+
+#include "cards/card_pool.h"
+#include "cards/catalog.h"
+#include "test_utils.h"
+#include "utils/random.h"
+
+TEST(BitmapTest, operations)
+{
+   Bitmap bits(130);
+   EXPECT_TRUE(bits.none());
+   for(size_t idx : {0, 63, 64, 129}) {
+      bits.set(idx);
+   }
+   EXPECT_EQ(bits.count(), 4);
+   EXPECT_TRUE(bits.test(64));
+   EXPECT_FALSE(bits.test(65));
+   EXPECT_EQ(bits.select(0), 0);
+   EXPECT_EQ(bits.select(2), 64);
+   EXPECT_EQ(bits.select(3), 129);
+   EXPECT_THROW(static_cast< void >(bits.select(4)), std::out_of_range);
+   EXPECT_EQ(bits.indices(), (std::vector< size_t >{0, 63, 64, 129}));
+
+   Bitmap all(130, true);
+   EXPECT_EQ(all.count(), 130);
+   EXPECT_EQ(all & bits, bits);
+   EXPECT_EQ((all | bits).count(), 130);
+   all.subtract(bits);
+   EXPECT_EQ(all.count(), 126);
+   EXPECT_FALSE(all.test(63));
+   EXPECT_THROW(all &= Bitmap(129), std::invalid_argument);
+}
+
+class CardPoolTest: public CatalogFileTest {
+  protected:
+   void add_cards(CatalogBuilder& builder) override
+   {
+      builder.add({"01DE001", "Vanguard", "", "", Region::DEMACIA, Group::NONE,
+                   CardSuperType::NONE, Rarity::COMMON, CardType::UNIT, true, 2, 2, 2});
+      builder.add({"01DE002", "Elite", "", "", Region::DEMACIA, Group::ELITE,
+                   CardSuperType::NONE, Rarity::RARE, CardType::UNIT, true, 4, 4, 3,
+                   {Keyword::CHALLENGER}});
+      builder.add({"01DE012", "Garen", "", "", Region::DEMACIA, Group::NONE,
+                   CardSuperType::CHAMPION, Rarity::CHAMPION, CardType::UNIT, true, 5, 5, 5,
+                   {Keyword::REGENERATION}});
+      builder.add({"01DE041", "Judgment", "", "", Region::DEMACIA, Group::NONE,
+                   CardSuperType::NONE, Rarity::EPIC, CardType::SPELL, true, 8});
+      builder.add({"01FR001", "Poro", "", "", Region::FRELJORD, Group::PORO,
+                   CardSuperType::NONE, Rarity::COMMON, CardType::UNIT, true, 1, 2, 1});
+      builder.add({"01FR002", "Poro Snax", "", "", Region::FRELJORD, Group::NONE,
+                   CardSuperType::NONE, Rarity::NONE, CardType::SPELL, false, 1});
+      builder.add({"01IO001", "Ninja", "", "", Region::IONIA, Group::NONE,
+                   CardSuperType::NONE, Rarity::COMMON, CardType::UNIT, true, 2, 3, 1,
+                   {Keyword::ELUSIVE, Keyword::CHALLENGER}});
+   }
+
+   static std::vector< std::string_view > codes(const CardQuery& query)
+   {
+      std::vector< std::string_view > out;
+      const auto& catalog = query.pool().catalog();
+      query.cards().for_each(
+         [&](size_t idx) { out.emplace_back(catalog.string(catalog[idx].code)); });
+      return out;
+   }
+};
+
+TEST_F(CardPoolTest, queries)
+{
+   CardCatalog catalog(path);
+   CardPool pool(catalog);
+   EXPECT_EQ(pool.size(), 7);
+   EXPECT_EQ(pool.query().count(), 7);
+
+   using Codes = std::vector< std::string_view >;
+   EXPECT_EQ(
+      codes(pool.query().region(Region::DEMACIA).card_type(CardType::UNIT)),
+      (Codes{"01DE001", "01DE002", "01DE012"}));
+   EXPECT_EQ(codes(pool.query().keyword(Keyword::CHALLENGER)), (Codes{"01DE002", "01IO001"}));
+   EXPECT_EQ(
+      codes(pool.query().keyword(Keyword::CHALLENGER).without_keyword(Keyword::ELUSIVE)),
+      (Codes{"01DE002"}));
+   EXPECT_EQ(codes(pool.query().cost_between(2, 4)), (Codes{"01DE001", "01DE002", "01IO001"}));
+   EXPECT_EQ(codes(pool.query().cost(1).collectible()), (Codes{"01FR001"}));
+   EXPECT_EQ(codes(pool.query().collectible(false)), (Codes{"01FR002"}));
+   EXPECT_EQ(codes(pool.query().super_type(CardSuperType::CHAMPION)), (Codes{"01DE012"}));
+   EXPECT_EQ(codes(pool.query().group(Group::PORO)), (Codes{"01FR001"}));
+   EXPECT_EQ(codes(pool.query().rarity(Rarity::EPIC)), (Codes{"01DE041"}));
+   EXPECT_EQ(
+      codes(pool.query().regions(RegionSet(u8(0b1100))).card_type(CardType::UNIT)),
+      (Codes{"01FR001", "01IO001"}));
+   EXPECT_TRUE(pool.query().cost(9).empty());
+   EXPECT_TRUE(pool.query().cost_between(3, 2).empty());
+   EXPECT_EQ(pool.query().cost_between(0, 99).count(), 7);
+   EXPECT_EQ(pool.query().cost_between(9, 99).count(), 0);
+}
+
+TEST_F(CardPoolTest, sampling)
+{
+   CardCatalog catalog(path);
+   CardPool pool(catalog);
+   auto rng = random::create_rng(0);
+
+   auto units = pool.query().card_type(CardType::UNIT);
+   std::map< std::string_view, size_t > counts;
+   for(int i = 0; i < 1000; ++i) {
+      const auto* entry = units.sample(rng);
+      ASSERT_NE(entry, nullptr);
+      EXPECT_EQ(CardType(entry->card_type), CardType::UNIT);
+      counts[catalog.string(entry->code)]++;
+   }
+   EXPECT_EQ(counts.size(), 5);
+   EXPECT_EQ(pool.query().cost(9).sample(rng), nullptr);
+
+   // only the cards of the query with a positive weight are chosen
+   std::vector< double > weights(pool.size(), 0.);
+   weights[catalog.index_of(catalog.at("01DE012"))] = 3.;
+   weights[catalog.index_of(catalog.at("01IO001"))] = 1.;
+   weights[catalog.index_of(catalog.at("01DE041"))] = 100.;
+   counts.clear();
+   for(int i = 0; i < 1000; ++i) {
+      counts[catalog.string(units.sample(weights, rng)->code)]++;
+   }
+   ASSERT_EQ(counts.size(), 2);
+   EXPECT_GT(counts["01DE012"], counts["01IO001"]);
+   EXPECT_EQ(pool.query().cost(1).sample(weights, rng), nullptr);
+}
@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <thread>
+
 TEST(CardTest, Basics)
 {
    auto unit1 = std::make_shared< TestUnit1 >(BLUE);
@@ -62,4 +64,70 @@ TEST(CardTest, Basics)
 
 //   EXPECT_EQ(unit2->check_play_condition(), true);
 
-}
\ No newline at end of file
+}
+TEST(CardTest, cached_stats_and_hooks)
+{
+   auto unit = std::make_shared< TestUnit1 >(BLUE);
+   auto cause = std::make_shared< TestUnit3 >(RED);
+   unit->add_power(-7, false);
+   EXPECT_EQ(unit->power_raw(), -2);
+   EXPECT_EQ(unit->power(), 0);
+   unit->power(3, false);
+   EXPECT_EQ(unit->power(), 3);
+
+   unit->add_mana_cost(-5, false);
+   EXPECT_EQ(unit->mana_cost(), 0);
+   unit->add_mana_cost(6, false);
+   EXPECT_EQ(unit->mana_cost(), 1);
+
+   size_t kills = 0;
+   unit->kill_func([&](const sptr< Card >& /*cause*/) { kills += 1; });
+   auto copy = unit->clone();
+   EXPECT_EQ(copy->power(), 3);
+   EXPECT_EQ(copy->mana_cost(), 1);
+   copy->kill(cause);
+   EXPECT_EQ(kills, 1);
+   EXPECT_TRUE(copy->unit_mutables().alive);
+}
+TEST(CardTest, damage_modifiers)
+{
+   auto unit = std::make_shared< TestUnit1 >(BLUE);
+   auto cause = std::make_shared< TestUnit3 >(RED);
+   unit->health(10);
+   unit->add_damage_modifier(modifiers::REDUCE_DAMAGE_BY_ONE);
+   EXPECT_EQ(unit->take_damage(cause, 3), 2);
+
+   // the registered modifiers outlive this test, hence the count is not captured by reference
+   static long halving_count = 0;
+   halving_count = 0;
+   auto halve = modifiers::DamageModifiers::add([](const Card& /*source*/, long amount) {
+      halving_count += 1;
+      return amount / 2;
+   });
+   EXPECT_GE(halve, modifiers::n_builtin_damage_modifiers);
+   unit->add_damage_modifier(halve);
+   // reduced to 4 first, then halved
+   EXPECT_EQ(unit->take_damage(cause, 5), 2);
+   EXPECT_EQ(halving_count, 1);
+
+   auto copy = to_unit(unit->clone());
+   copy->add_damage_modifier(modifiers::NEGATE_DAMAGE);
+   EXPECT_EQ(copy->take_damage(cause, 5), 0);
+   EXPECT_EQ(unit->take_damage(cause, 5), 2);
+   EXPECT_EQ(halving_count, 3);
+}
+TEST(CardTest, identity)
+{
+   auto unit = std::make_shared< TestUnit1 >(BLUE);
+   auto other = std::make_shared< TestUnit1 >(BLUE);
+   auto copy = unit->clone();
+   EXPECT_EQ(*copy, *unit);
+   EXPECT_NE(*other, *unit);
+   EXPECT_EQ(std::hash< Card >()(*copy), std::hash< Card >()(*unit));
+   EXPECT_FALSE(unit->immutables().uuid.is_nil());
+
+   // the pools of different threads never hand out the same id
+   UUID from_thread;
+   std::thread([&] { from_thread = utils::new_uuid(); }).join();
+   EXPECT_NE(from_thread, utils::new_uuid());
+}
@@ -5,10 +5,12 @@
 
 #include "all.h"
 
-class TestUnit1: public Unit {
+class TestUnit1: public CloneableCard< TestUnit1, Unit > {
   public:
+   using CloneableCard::CloneableCard;
+
    TestUnit1(Team owner)
-       : Unit(
+       : CloneableCard(
           Card::ConstState{
              "CODE1",
              "TestUnit1",
@@ -28,10 +30,12 @@ class TestUnit1: public Unit {
    }
 };
 
-class TestUnit2: public Unit {
+class TestUnit2: public CloneableCard< TestUnit2, Unit > {
   public:
+   using CloneableCard::CloneableCard;
+
    TestUnit2(Team owner)
-       : Unit(
+       : CloneableCard(
           Card::ConstState{
              "CODE2",
              "TestUnit2",
@@ -50,10 +54,12 @@ class TestUnit2: public Unit {
    {
    }
 };
-class TestUnit3: public Unit {
+class TestUnit3: public CloneableCard< TestUnit3, Unit > {
   public:
+   using CloneableCard::CloneableCard;
+
    TestUnit3(Team owner)
-       : Unit(
+       : CloneableCard(
           Card::ConstState{
              "CODE3",
              "TestUnit3",
@@ -72,10 +78,12 @@ class TestUnit3: public Unit {
    {
    }
 };
-class TestUnit4: public Unit {
+class TestUnit4: public CloneableCard< TestUnit4, Unit > {
   public:
+   using CloneableCard::CloneableCard;
+
    TestUnit4(Team owner)
-       : Unit(
+       : CloneableCard(
           Card::ConstState{
              "CODE4",
              "TestUnit4",
@@ -94,10 +102,12 @@ class TestUnit4: public Unit {
    {
    }
 };
-class TestUnit5: public Unit {
+class TestUnit5: public CloneableCard< TestUnit5, Unit > {
   public:
+   using CloneableCard::CloneableCard;
+
    TestUnit5(Team owner)
-       : Unit(
+       : CloneableCard(
           Card::ConstState{
              "CODE5",
              "TestUnit5",
@@ -116,10 +126,12 @@ class TestUnit5: public Unit {
    {
    }
 };
-class TestUnit6: public Unit {
+class TestUnit6: public CloneableCard< TestUnit6, Unit > {
   public:
+   using CloneableCard::CloneableCard;
+
    TestUnit6(Team owner)
-       : Unit(
+       : CloneableCard(
           Card::ConstState{
              "CODE6",
              "TestUnit6",
@@ -139,10 +151,12 @@ class TestUnit6: public Unit {
    }
 };
 
-class TestSpell: public Spell {
+class TestSpell: public CloneableCard< TestSpell, Spell > {
   public:
+   using CloneableCard::CloneableCard;
+
    TestSpell(Team owner)
-       : Spell(
+       : CloneableCard(
           Card::ConstState{
              "CODE6",
              "TestUnit6",
@@ -160,4 +174,18 @@ class TestSpell: public Spell {
    }
 };
 
+/**
+ * Gives its card +1|+0 for the round whenever a round starts.
+ */
+class TestRallyEffect: public Cloneable< TestRallyEffect, inherit_constructors< EffectBase > > {
+  public:
+   using Cloneable::Cloneable;
+
+   void on_event(GameState& state, events::RoundStartEvent::EventData&& /*data*/) override
+   {
+      const auto& card = associated_card();
+      state.logic()->grant< GrantType::STATS >(card->mutables().owner, card, card, false, 1L, 0L);
+   }
+};
+
 #endif  // LORAINE_TEST_CARDS_H
@@ -0,0 +1,228 @@
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <thread>
+
+#include "cards/card.h"
+#include "cards/cardfactory.h"
+#include "cards/catalog.h"
+#include "test_utils.h"
+
+class CatalogTest: public CatalogFileTest {
+  protected:
+   void add_cards(CatalogBuilder& builder) override
+   {
+      builder.add(
+         {"01DE012",
+          "Garen",
+          "Regeneration",
+          "lore",
+          Region::DEMACIA,
+          Group::NONE,
+          CardSuperType::CHAMPION,
+          Rarity::CHAMPION,
+          CardType::UNIT,
+          true,
+          5,
+          5,
+          5,
+          {Keyword::REGENERATION},
+          {"01DE012T1", "01DE041"}});
+      builder.add({"01DE012T1", "Garen (level 2)", "", "", Region::DEMACIA, Group::NONE,
+                   CardSuperType::CHAMPION, Rarity::NONE, CardType::UNIT, false, 5, 6, 6,
+                   {Keyword::REGENERATION, Keyword::OVERWHELM}});
+      builder.add({"01DE041", "Judgment", "", "", Region::DEMACIA, Group::NONE,
+                   CardSuperType::NONE, Rarity::NONE, CardType::SPELL, false, 8});
+      builder.add({"01PZ008T2", "Get Excited!", "", "", Region::PILTOVER_ZAUN, Group::NONE,
+                   CardSuperType::SKILL, Rarity::NONE, CardType::SPELL, false, 0});
+      builder.add({"02IO006", "The Grand Plaza", "", "", Region::IONIA, Group::NONE,
+                   CardSuperType::NONE, Rarity::RARE, CardType::LANDMARK, true, 3});
+      builder.add({"02PZ008", "Boom", "", "", Region::PILTOVER_ZAUN, Group::NONE,
+                   CardSuperType::NONE, Rarity::NONE, CardType::TRAP, false, 0});
+   }
+};
+
+TEST_F(CatalogTest, maps_entries)
+{
+   CardCatalog catalog(path);
+   EXPECT_EQ(catalog.size(), 6);
+   EXPECT_EQ(catalog.data_version(), "test-1.0");
+   const auto& garen = catalog.at("01DE012");
+   EXPECT_EQ(catalog.string(garen.name), "Garen");
+   EXPECT_EQ(Region(garen.region), Region::DEMACIA);
+   EXPECT_EQ(garen.power, 5);
+   EXPECT_TRUE(garen.has_keyword(Keyword::REGENERATION));
+   EXPECT_FALSE(garen.has_keyword(Keyword::OVERWHELM));
+   auto associated = catalog.associated(garen);
+   ASSERT_EQ(associated.size(), 2);
+   EXPECT_EQ(catalog.string(catalog[associated[0]].code), "01DE012T1");
+   EXPECT_EQ(catalog.string(catalog[associated[1]].code), "01DE041");
+   for(const auto& entry : catalog) {
+      EXPECT_EQ(catalog.find(catalog.string(entry.code)), &entry);
+   }
+   EXPECT_EQ(catalog.find("01DE999"), nullptr);
+   EXPECT_THROW(static_cast< void >(catalog.at("01DE999")), std::out_of_range);
+
+   CatalogBuilder duplicates("test");
+   duplicates.add({"01DE012", "Garen"});
+   duplicates.add({"01DE012", "Garen"});
+   EXPECT_THROW(duplicates.write(path), std::invalid_argument);
+}
+
+TEST_F(CatalogTest, factory_builds_cards)
+{
+   CardFactory factory(path);
+   auto garen = to_unit(factory.create("01DE012T1", Team::RED));
+   ASSERT_NE(garen, nullptr);
+   EXPECT_EQ(garen->immutables().name, "Garen (level 2)");
+   EXPECT_FALSE(garen->immutables().is_collectible);
+   EXPECT_EQ(garen->mutables().owner, Team::RED);
+   EXPECT_EQ(garen->mana_cost(), 5);
+   EXPECT_EQ(garen->power(), 6);
+   EXPECT_EQ(garen->health(), 6);
+   EXPECT_TRUE(garen->has_keyword(Keyword::OVERWHELM));
+   EXPECT_FALSE(garen->has_keyword(Keyword::ELUSIVE));
+
+   EXPECT_NE(to_spell(factory.create("01DE041", Team::BLUE)), nullptr);
+   EXPECT_NE(to_skill(factory.create("01PZ008T2", Team::BLUE)), nullptr);
+   EXPECT_NE(to_landmark(factory.create("02IO006", Team::BLUE)), nullptr);
+   EXPECT_THROW(static_cast< void >(factory.create("02PZ008", Team::BLUE)), std::invalid_argument);
+   EXPECT_THROW(static_cast< void >(factory.create("01DE999", Team::BLUE)), std::out_of_range);
+   // every card built is a new instance
+   EXPECT_NE(
+      factory.create("01DE041", Team::BLUE)->immutables().uuid,
+      factory.create("01DE041", Team::BLUE)->immutables().uuid);
+   // a catalog card's prototype is built once, on first use, whichever thread asks for it
+   std::vector< const Card* > prototypes(4, nullptr);
+   {
+      std::vector< std::thread > threads;
+      for(size_t t = 0; t < prototypes.size(); ++t) {
+         threads.emplace_back([&, t] { prototypes[t] = factory.prototype("02IO006"); });
+      }
+      for(auto& thread : threads) {
+         thread.join();
+      }
+   }
+   for(const auto* proto : prototypes) {
+      EXPECT_NE(proto, nullptr);
+      EXPECT_EQ(proto, factory.prototype("02IO006"));
+   }
+   EXPECT_EQ(factory.prototype("01DE999"), nullptr);
+}
+
+namespace {
+
+/**
+ * Rewrites the catalog file with the bytes changed by `corrupt`, which is given the file's header.
+ */
+void patch_catalog(
+   const std::filesystem::path& path,
+   const std::function< void(std::vector< char >&, const CatalogHeader&) >& corrupt)
+{
+   std::vector< char > bytes;
+   {
+      std::ifstream in(path, std::ios::binary);
+      bytes.assign(std::istreambuf_iterator< char >(in), std::istreambuf_iterator< char >());
+   }
+   CatalogHeader header;
+   std::memcpy(&header, bytes.data(), sizeof(CatalogHeader));
+   corrupt(bytes, header);
+   std::ofstream out(path, std::ios::binary | std::ios::trunc);
+   out.write(bytes.data(), std::streamsize(bytes.size()));
+}
+
+template < typename T >
+void poke(std::vector< char >& bytes, u64 offset, T value)
+{
+   std::memcpy(bytes.data() + offset, &value, sizeof(T));
+}
+
+}  // namespace
+
+TEST_F(CatalogTest, rejects_corrupt_catalogs)
+{
+   using Corruption = std::function< void(std::vector< char >&, const CatalogHeader&) >;
+   auto entry_field = [](const CatalogHeader& header, size_t card, size_t field_offset) {
+      return header.cards_offset + card * sizeof(CatalogEntry) + field_offset;
+   };
+   std::vector< Corruption > corruptions{
+      // a name reaching past the string table
+      [&](auto& bytes, const auto& header) {
+         poke(
+            bytes,
+            entry_field(header, 1, offsetof(CatalogEntry, name) + offsetof(CatalogString, size)),
+            u32(header.strings_size));
+      },
+      // a string offset overflowing with its size
+      [&](auto& bytes, const auto& header) {
+         poke(bytes, entry_field(header, 2, offsetof(CatalogEntry, lore)), u32(0xFFFFFFFF));
+         poke(
+            bytes,
+            entry_field(header, 2, offsetof(CatalogEntry, lore) + offsetof(CatalogString, size)),
+            u32(2));
+      },
+      // the data version outside the string table
+      [&](auto& bytes, const auto& header) {
+         poke(
+            bytes,
+            offsetof(CatalogHeader, data_version),
+            CatalogString{u32(header.strings_size), 1});
+      },
+      // an associated card range past the associated indices
+      [&](auto& bytes, const auto& header) {
+         poke(bytes, entry_field(header, 0, offsetof(CatalogEntry, n_associated)), u32(3));
+      },
+      // an associated card index past the cards
+      [&](auto& bytes, const auto& header) {
+         poke(bytes, header.associated_offset, u32(header.n_cards));
+      },
+      // an index slot referring past the cards
+      [&](auto& bytes, const auto& header) {
+         for(u32 slot = 0; slot < header.index_size; ++slot) {
+            u64 offset = header.index_offset + slot * sizeof(u32);
+            u32 card = 0;
+            std::memcpy(&card, bytes.data() + offset, sizeof(u32));
+            if(card == 0) {
+               poke(bytes, offset, u32(header.n_cards + 1));
+               return;
+            }
+         }
+      },
+      // an index without empty slots, on which a lookup of a missing code would never end
+      [&](auto& bytes, const auto& header) {
+         for(u32 slot = 0; slot < header.index_size; ++slot) {
+            poke(bytes, header.index_offset + slot * sizeof(u32), u32(1));
+         }
+      }};
+   for(size_t i = 0; i < corruptions.size(); ++i) {
+      SetUp();
+      // the pristine file opens
+      static_cast< void >(CardCatalog(path));
+      patch_catalog(path, corruptions[i]);
+      EXPECT_THROW(CardCatalog{path}, std::runtime_error) << "corruption " << i;
+   }
+}
+
+TEST_F(CatalogTest, factory_rejects_unknown_card_types)
+{
+   CatalogBuilder builder("test");
+   builder.add({"01DE001", "Vanguard"});
+   builder.add({"01DE002", "Unknown", "", "", Region::DEMACIA, Group::NONE, CardSuperType::NONE,
+                Rarity::NONE, CardType(7)});
+   builder.write(path);
+   // the catalog itself is sound, only the factory cannot tell what to build
+   CardCatalog catalog(path);
+   EXPECT_EQ(catalog.size(), 2);
+   CardFactory factory(path);
+   EXPECT_NE(factory.create("01DE001", Team::BLUE), nullptr);
+   for(int attempt = 0; attempt < 2; ++attempt) {
+      EXPECT_THROW(
+         static_cast< void >(factory.create("01DE002", Team::BLUE)), std::invalid_argument);
+   }
+}
@@ -70,4 +70,42 @@ TEST(DeckTest, Functionalities)
       true);
    EXPECT_EQ(filtered_popped.size(), filtered.size());
    EXPECT_EQ(deck.size(), size_before - filtered.size());
-}
\ No newline at end of file
+}
+TEST(DeckTest, Popping)
+{
+   Deck deck({
+      std::make_shared< TestUnit1 >(BLUE),
+      std::make_shared< TestUnit2 >(BLUE),
+      std::make_shared< TestUnit3 >(BLUE),
+      std::make_shared< TestUnit2 >(BLUE),
+      std::make_shared< TestUnit4 >(BLUE),
+   });
+   // indices count from the top of the deck, i.e. the back of the container
+   auto top = deck.at(4);
+   auto below_top = deck.at(3);
+   auto bottom = deck.at(0);
+   EXPECT_EQ(deck.pop_by_index(0), top);
+   ASSERT_EQ(deck.size(), 4);
+   EXPECT_EQ(deck.at(3), below_top);
+   EXPECT_EQ(deck.pop_by_index(deck.size() - 1), bottom);
+   ASSERT_EQ(deck.size(), 3);
+   EXPECT_EQ(deck.at(0)->immutables().code, "CODE2");
+   EXPECT_EQ(deck.at(2), below_top);
+
+   // popping by code takes one of the matching cards and keeps the order of the others
+   auto rng = random::create_rng(0);
+   auto lower = deck.at(0);
+   auto middle = deck.at(1);
+   auto popped = deck.pop_by_code("CODE2", rng);
+   EXPECT_TRUE(popped == lower || popped == below_top);
+   ASSERT_EQ(deck.size(), 2);
+   if(popped == lower) {
+      EXPECT_EQ(deck.at(0), middle);
+      EXPECT_EQ(deck.at(1), below_top);
+   } else {
+      EXPECT_EQ(deck.at(0), lower);
+      EXPECT_EQ(deck.at(1), middle);
+   }
+   EXPECT_THROW(deck.pop_by_code("CODE5", rng), std::invalid_argument);
+   EXPECT_EQ(deck.size(), 2);
+}
@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include "cards/card.h"
+#include "cards/cardfactory.h"
+#include "cards/catalog.h"
+#include "core/deck.h"
+#include "core/deckcode.h"
+#include "test_utils.h"
+
+class DeckCodeTest: public CatalogFileTest {
+  protected:
+   void add_cards(CatalogBuilder& builder) override
+   {
+      for(size_t number = 1; number <= 14; ++number) {
+         std::array< char, 8 > code{};
+         std::snprintf(code.data(), code.size(), "01DE%03zu", number);
+         CatalogBuilder::CardData card{code.data(), "Unit"};
+         card.power = 1;
+         card.health = 1;
+         if(number == 12) {
+            card.super_type = CardSuperType::CHAMPION;
+            card.rarity = Rarity::CHAMPION;
+         }
+         builder.add(std::move(card));
+      }
+      builder.add({"01FR001", "Frost", "", "", Region::FRELJORD});
+      builder.add({"01IO001", "Blade", "", "", Region::IONIA});
+   }
+
+   /**
+    * A deck of 13 Demacian cards thrice and 01DE014 once (40 cards, 3 of them champions).
+    */
+   static std::vector< DeckCodeCard > demacia_deck()
+   {
+      std::vector< DeckCodeCard > cards;
+      for(u32 number = 1; number <= 13; ++number) {
+         cards.push_back({1, 0, number, 3});
+      }
+      cards.push_back({1, 0, 14, 1});
+      return cards;
+   }
+};
+
+TEST(DeckCodeCardTest, codes)
+{
+   auto card = DeckCodeCard::parse("01DE012", 3);
+   EXPECT_EQ(card.set, 1);
+   EXPECT_EQ(card.faction, 0);
+   EXPECT_EQ(card.number, 12);
+   EXPECT_EQ(card.code(), "01DE012");
+   EXPECT_EQ(DeckCodeCard::parse("04MT003", 1).faction, 9);
+   EXPECT_THROW(static_cast< void >(DeckCodeCard::parse("01DE012T1", 1)), std::invalid_argument);
+   EXPECT_THROW(static_cast< void >(DeckCodeCard::parse("01XX012", 1)), std::invalid_argument);
+
+   // format 1 version 1, one group of 3 copies holding 01DE012, no groups of 2 or 1 copies
+   auto cards = DeckCodec::decode_cards("CEAQCAIABQAAA");
+   ASSERT_EQ(cards.size(), 1);
+   EXPECT_EQ(cards[0].code(), "01DE012");
+   EXPECT_EQ(cards[0].count, 3);
+   EXPECT_EQ(DeckCodec::encode_cards(cards), "CEAQCAIABQAAA");
+   EXPECT_EQ(DeckCodec::decode_cards("ceaqcaiabqaaa===").size(), 1);
+
+   EXPECT_THROW(static_cast< void >(DeckCodec::decode_cards("")), std::invalid_argument);
+   EXPECT_THROW(
+      static_cast< void >(DeckCodec::decode_cards("CEAQ!AIABQAAA")), std::invalid_argument);
+   EXPECT_THROW(static_cast< void >(DeckCodec::decode_cards("CEAQCAIA")), std::invalid_argument);
+
+   // counts beyond 3 follow the groups, and the encoding does not depend on the input order
+   std::vector< DeckCodeCard > unordered{{1, 1, 5, 1}, {1, 0, 7, 4}, {1, 0, 3, 1}, {2, 9, 1, 2}};
+   auto code = DeckCodec::encode_cards(unordered);
+   auto decoded = DeckCodec::decode_cards(code);
+   ASSERT_EQ(decoded.size(), 4);
+   EXPECT_EQ(decoded[0].code(), "02MT001");
+   EXPECT_EQ(decoded[1].code(), "01DE003");
+   EXPECT_EQ(decoded[2].code(), "01FR005");
+   EXPECT_EQ(decoded[3].code(), "01DE007");
+   EXPECT_EQ(decoded[3].count, 4);
+   std::reverse(unordered.begin(), unordered.end());
+   EXPECT_EQ(DeckCodec::encode_cards(unordered), code);
+}
+
+TEST(DeckCodeCardTest, faction_versions)
+{
+   // decks of three copies of a single card, as the official library encodes them: the version is
+   // the lowest one knowing all of the deck's factions
+   std::vector< std::pair< std::string, std::string > > official{
+      {"01DE001", "CEAQCAIAAEAAA"},
+      {"02BW001", "CIAQCAQGAEAAA"},
+      {"03MT001", "CIAQCAYJAEAAA"},
+      {"04SH001", "CMAQCBAHAEAAA"},
+      {"04BC001", "CQAQCBAKAEAAA"},
+      {"05RU001", "CUAQCBIMAEAAA"}};
+   for(const auto& [card, code] : official) {
+      auto cards = DeckCodec::decode_cards(code);
+      ASSERT_EQ(cards.size(), 1);
+      EXPECT_EQ(cards[0].code(), card);
+      EXPECT_EQ(cards[0].count, 3);
+      EXPECT_EQ(DeckCodec::encode_cards({DeckCodeCard::parse(card, 3)}), code);
+   }
+   // a deck takes the version of its newest faction
+   EXPECT_EQ(
+      DeckCodec::encode_cards({DeckCodeCard::parse("01DE001", 3), DeckCodeCard::parse("04SH001", 3)})
+         .substr(0, 2),
+      "CM");
+}
+
+TEST_F(DeckCodeTest, decode_validates)
+{
+   CardCatalog catalog(path);
+   DeckCodec codec(catalog);
+
+   auto code = DeckCodec::encode_cards(demacia_deck());
+   auto deck_list = codec.decode(code);
+   EXPECT_TRUE(deck_list.valid());
+   EXPECT_EQ(deck_list.cards.size(), 14);
+   EXPECT_EQ(deck_list.n_cards, 40);
+   EXPECT_EQ(deck_list.n_champions, 3);
+   EXPECT_EQ(deck_list.regions, RegionSet(u8(1 << size_t(Region::DEMACIA))));
+   EXPECT_EQ(catalog.string(catalog[deck_list.cards[0].card].code), "01DE001");
+   EXPECT_EQ(codec.encode(deck_list), code);
+
+   auto cards = demacia_deck();
+   cards.back().count = 4;
+   cards.push_back({1, 1, 1, 1});
+   cards.push_back({1, 2, 1, 1});
+   deck_list = codec.decode(DeckCodec::encode_cards(cards));
+   EXPECT_TRUE(deck_list.violates(DeckList::TOO_MANY_COPIES));
+   EXPECT_TRUE(deck_list.violates(DeckList::WRONG_SIZE));
+   EXPECT_TRUE(deck_list.violates(DeckList::TOO_MANY_REGIONS));
+   EXPECT_FALSE(deck_list.violates(DeckList::TOO_MANY_CHAMPIONS));
+   EXPECT_EQ(deck_list.regions.size(), 3);
+
+   EXPECT_THROW(
+      static_cast< void >(codec.decode(DeckCodec::encode_cards({{1, 0, 99, 1}}))),
+      std::out_of_range);
+}
+
+TEST_F(DeckCodeTest, decode_file)
+{
+   CardCatalog catalog(path);
+   DeckCodec codec(catalog);
+   auto code = DeckCodec::encode_cards(demacia_deck());
+   auto codes_path = unique_temp_path(".txt");
+   {
+      std::ofstream file(codes_path);
+      file << code << "\n  " << code << " \r\n\n"
+           << "NOT A CODE\n"
+           << DeckCodec::encode_cards({{1, 0, 99, 1}}) << "\n"
+           << "CEAQCAIABQAAA";
+   }
+   for(size_t n_threads : {1, 2, 8}) {
+      auto deck_lists = codec.decode_file(codes_path, n_threads);
+      ASSERT_EQ(deck_lists.size(), 5);
+      EXPECT_TRUE(deck_lists[0].valid());
+      EXPECT_TRUE(deck_lists[1].valid());
+      EXPECT_TRUE(deck_lists[2].violates(DeckList::MALFORMED));
+      EXPECT_TRUE(deck_lists[3].violates(DeckList::UNKNOWN_CARD));
+      EXPECT_TRUE(deck_lists[3].cards.empty());
+      EXPECT_EQ(deck_lists[4].violations, DeckList::WRONG_SIZE);
+      EXPECT_EQ(deck_lists[4].n_champions, 3);
+   }
+   std::filesystem::remove(codes_path);
+}
+
+TEST_F(DeckCodeTest, build_deck)
+{
+   auto factory = std::make_shared< CardFactory >(path);
+   DeckCodec codec(factory->catalog());
+   auto code = DeckCodec::encode_cards(demacia_deck());
+   auto deck = DeckCodec::build(codec.decode(code), *factory, Team::RED, make_arena());
+   ASSERT_EQ(deck.size(), 40);
+   EXPECT_EQ(deck[0]->immutables().code, "01DE001");
+   EXPECT_EQ(deck[0]->mutables().owner, Team::RED);
+   EXPECT_EQ(Deck::identify_regions(Deck::ContainerType(deck.begin(), deck.end())).size(), 1);
+
+   auto deck_list = codec.list(deck);
+   EXPECT_TRUE(deck_list.valid());
+   EXPECT_EQ(codec.encode(deck_list), code);
+}
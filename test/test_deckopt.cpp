@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+
+#include "cards/card_pool.h"
+#include "cards/cardfactory.h"
+#include "cards/catalog.h"
+#include "core/deckcode.h"
+#include "deck_builder.h"
+#include "evaluator.h"
+#include "test_utils.h"
+#include "utils/random.h"
+
+class DeckoptTest: public CatalogFileTest {
+  protected:
+   void add_cards(CatalogBuilder& builder) override
+   {
+      // 12 units and a champion of each region, enough for decks of two regions
+      for(auto [region, code] : {std::pair{Region::DEMACIA, "DE"},
+                                 std::pair{Region::FRELJORD, "FR"},
+                                 std::pair{Region::IONIA, "IO"}}) {
+         for(size_t i = 1; i <= 12; ++i) {
+            auto number = std::to_string(i);
+            builder.add({"01" + std::string(code) + std::string(3 - number.size(), '0') + number,
+                         "Unit", "", "", region, Group::NONE, CardSuperType::NONE,
+                         Rarity::COMMON, CardType::UNIT, true, i % 6 + 1, i % 4 + 1, i % 5 + 1});
+         }
+         builder.add({"01" + std::string(code) + "020", "Champion", "", "", region, Group::NONE,
+                      CardSuperType::CHAMPION, Rarity::CHAMPION, CardType::UNIT, true, 4, 4, 4});
+      }
+      // neither traps nor uncollectible cards are drawn into decks
+      builder.add({"01DE030", "Trap", "", "", Region::DEMACIA, Group::NONE, CardSuperType::NONE,
+                   Rarity::COMMON, CardType::TRAP, true});
+      builder.add({"01FR030", "Token", "", "", Region::FRELJORD, Group::NONE, CardSuperType::NONE,
+                   Rarity::NONE, CardType::UNIT, false, 1, 1, 1});
+   }
+
+   /**
+    * Checks the deck list against the deck building limits, both directly and by the codec.
+    */
+   static void expect_legal(const DeckList& deck, const CardCatalog& catalog)
+   {
+      Config config;
+      size_t n_cards = 0;
+      size_t n_champions = 0;
+      RegionSet regions;
+      for(const auto& [card, count] : deck.cards) {
+         const auto& entry = catalog[card];
+         EXPECT_GE(count, 1);
+         EXPECT_LE(count, config.MAX_CARD_COPIES_IN_DECK);
+         EXPECT_TRUE(entry.collectible);
+         EXPECT_NE(CardType(entry.card_type), CardType::TRAP);
+         n_cards += count;
+         if(CardSuperType(entry.super_type) == CardSuperType::CHAMPION) {
+            n_champions += count;
+         }
+         regions.add(Region(entry.region));
+      }
+      EXPECT_TRUE(std::is_sorted(
+         deck.cards.begin(), deck.cards.end(), [](const auto& a, const auto& b) {
+            return a.card <= b.card;
+         }));
+      EXPECT_EQ(n_cards, config.DECK_CARDS_LIMIT);
+      EXPECT_EQ(deck.n_cards, n_cards);
+      EXPECT_LE(n_champions, config.CHAMPIONS_LIMIT);
+      EXPECT_EQ(deck.n_champions, n_champions);
+      EXPECT_LE(regions.size(), config.REGIONS_LIMIT);
+      EXPECT_EQ(deck.regions, regions);
+      EXPECT_EQ(deck.violations, 0);
+
+      DeckCodec codec(catalog);
+      auto decoded = codec.decode(codec.encode(deck));
+      EXPECT_EQ(decoded.violations, 0);
+      EXPECT_EQ(deckopt::deck_hash(decoded), deckopt::deck_hash(deck));
+   }
+};
+
+TEST_F(DeckoptTest, random_decks_respect_the_limits)
+{
+   CardCatalog catalog(path);
+   CardPool pool(catalog);
+   deckopt::DeckBuilder builder(pool);
+   EXPECT_EQ(builder.candidates().count(), 39);
+   auto rng = random::create_rng(0);
+   for(int i = 0; i < 50; ++i) {
+      expect_legal(builder.random_deck(rng), catalog);
+   }
+}
+
+TEST_F(DeckoptTest, mutations_respect_the_limits)
+{
+   CardCatalog catalog(path);
+   CardPool pool(catalog);
+   deckopt::DeckBuilder builder(pool);
+   auto rng = random::create_rng(1);
+   auto deck = builder.random_deck(rng);
+   bool changed = false;
+   for(size_t n_swaps : {0, 1, 3, 10, 40}) {
+      auto mutated = builder.mutate(deck, n_swaps, rng);
+      expect_legal(mutated, catalog);
+      changed |= deckopt::deck_hash(mutated) != deckopt::deck_hash(deck);
+      deck = std::move(mutated);
+   }
+   EXPECT_TRUE(changed);
+}
+
+TEST_F(DeckoptTest, crossovers_respect_the_limits)
+{
+   CardCatalog catalog(path);
+   CardPool pool(catalog);
+   deckopt::DeckBuilder builder(pool);
+   auto rng = random::create_rng(2);
+   for(int i = 0; i < 30; ++i) {
+      auto first = builder.random_deck(rng);
+      auto second = builder.random_deck(rng);
+      auto child = builder.crossover(first, second, rng);
+      expect_legal(child, catalog);
+      // the child stays within the first parent's regions unless both parents' fit the limit
+      if(RegionSet(first.regions.bits() | second.regions.bits()).size() > Config().REGIONS_LIMIT) {
+         EXPECT_EQ(RegionSet(child.regions.bits() | first.regions.bits()), first.regions);
+      }
+   }
+   // crossing a deck with itself keeps it
+   auto deck = builder.random_deck(rng);
+   EXPECT_EQ(deckopt::deck_hash(builder.crossover(deck, deck, rng)), deckopt::deck_hash(deck));
+}
+
+TEST_F(DeckoptTest, evaluator)
+{
+   auto factory = std::make_shared< CardFactory >(path);
+   CardPool pool(factory->catalog());
+   deckopt::DeckBuilder builder(pool);
+   auto rng = random::create_rng(3);
+   std::vector< DeckList > gauntlet{builder.random_deck(rng), builder.random_deck(rng)};
+   auto deck = builder.random_deck(rng);
+   auto other = builder.random_deck(rng);
+
+   EXPECT_THROW(deckopt::Evaluator(factory, {}, 1), std::invalid_argument);
+   deckopt::Evaluator single(factory, gauntlet, 1, 7);
+   deckopt::Evaluator threaded(factory, gauntlet, 3, 7);
+   EXPECT_EQ(threaded.n_threads(), 3);
+   EXPECT_EQ(single.record(deck).games, 0);
+   EXPECT_EQ(single.record(deck).score(), 0.5);
+
+   // a deck given twice plays its games once
+   single.evaluate({&deck, &other, &deck}, 6);
+   EXPECT_EQ(single.games_played(), 12);
+   EXPECT_EQ(single.n_cached(), 2);
+   auto record = single.record(deck);
+   EXPECT_EQ(record.games, 6);
+   EXPECT_LE(record.wins + record.ties, 6);
+   EXPECT_LT(record.radius(0.05), 1.);
+
+   // the results depend neither on the number of threads nor on the order of the decks
+   threaded.evaluate({&other, &deck}, 6);
+   EXPECT_EQ(threaded.record(deck).wins, record.wins);
+   EXPECT_EQ(threaded.record(deck).ties, record.ties);
+   EXPECT_EQ(threaded.record(other).wins, single.record(other).wins);
+
+   // recorded games are not played again, only those beyond them
+   single.evaluate({&deck}, 6);
+   EXPECT_EQ(single.games_played(), 12);
+   single.evaluate({&deck}, 8);
+   EXPECT_EQ(single.games_played(), 14);
+   threaded.evaluate({&deck}, 8);
+   EXPECT_EQ(threaded.record(deck).wins, single.record(deck).wins);
+   EXPECT_EQ(threaded.record(deck).ties, single.record(deck).ties);
+}
@@ -0,0 +1,129 @@
+
+#include <gtest/gtest.h>
+
+#include "search/lethal_solver.h"
+#include "test_action.h"
+
+class LethalSolverTest: public ActionTest {
+  protected:
+   LethalSolver solver{std::chrono::seconds(1)};
+
+   template < typename UnitType >
+   sptr< Unit > add_unit(Team team, std::initializer_list< Keyword > keywords = {})
+   {
+      auto unit = std::make_shared< UnitType >(team);
+      for(auto kw : keywords) {
+         unit->add_keyword(kw);
+      }
+      state.board().add_to_camp(unit);
+      return unit;
+   }
+
+   void set_nexus_health(Team team, long health)
+   {
+      auto& nexus = state.player(team).nexus();
+      nexus.add_health(std::make_shared< TestUnit1 >(opponent(team)), health - nexus.health());
+   }
+};
+
+TEST_F(LethalSolverTest, no_attack_token)
+{
+   add_unit< TestUnit1 >(BLUE);
+   set_nexus_health(RED, 1);
+   auto result = solver.solve(state, BLUE);
+   EXPECT_FALSE(result.lethal);
+   EXPECT_TRUE(result.complete);
+   EXPECT_EQ(result.nodes, 0);
+}
+
+TEST_F(LethalSolverTest, unblocked_attack)
+{
+   state.player(BLUE).flags().attack_token = true;
+   add_unit< TestUnit1 >(BLUE);
+   add_unit< TestUnit1 >(BLUE);
+   add_unit< TestUnit1 >(BLUE);
+
+   // 15 power can never reach a full nexus, the predictor answers without searching
+   auto result = solver.solve(state, BLUE);
+   EXPECT_FALSE(result.lethal);
+   EXPECT_EQ(result.nodes, 0);
+
+   set_nexus_health(RED, 15);
+   result = solver.solve(state, BLUE);
+   EXPECT_TRUE(result.lethal);
+   EXPECT_TRUE(result.complete);
+   EXPECT_EQ(result.line.attackers.size(), 3);
+   EXPECT_EQ(result.line.guaranteed_damage, 15);
+}
+
+TEST_F(LethalSolverTest, overwhelm)
+{
+   state.player(BLUE).flags().attack_token = true;
+   auto big = add_unit< TestUnit1 >(BLUE);
+   big->add_power(3, true);
+   add_unit< TestUnit1 >(BLUE);
+   add_unit< TestUnit1 >(BLUE);
+   add_unit< TestUnit2 >(RED);
+   set_nexus_health(RED, 13);
+
+   // the defender blocks the 8 power unit and takes 10
+   auto result = solver.solve(state, BLUE);
+   EXPECT_FALSE(result.lethal);
+   EXPECT_EQ(result.line.guaranteed_damage, 10);
+
+   // with overwhelm 3 damage spill over the 5 health blocker, any block lets 13 through
+   big->add_keyword(Keyword::OVERWHELM);
+   result = solver.solve(state, BLUE);
+   EXPECT_TRUE(result.lethal);
+   EXPECT_EQ(result.line.guaranteed_damage, 13);
+}
+
+TEST_F(LethalSolverTest, elusive_and_fearsome)
+{
+   state.player(BLUE).flags().attack_token = true;
+   add_unit< TestUnit1 >(BLUE, {Keyword::ELUSIVE});
+   add_unit< TestUnit1 >(BLUE, {Keyword::FEARSOME});
+   auto blocker = add_unit< TestUnit3 >(RED);
+   set_nexus_health(RED, 6);
+
+   // the blocker can only stop the fearsome unit
+   auto result = solver.solve(state, BLUE);
+   EXPECT_FALSE(result.lethal);
+   EXPECT_EQ(result.line.guaranteed_damage, 5);
+
+   // too weak to block a fearsome unit
+   blocker->add_power(-1, true);
+   result = solver.solve(state, BLUE);
+   EXPECT_TRUE(result.lethal);
+   EXPECT_EQ(result.line.guaranteed_damage, 10);
+}
+
+TEST_F(LethalSolverTest, challenger_line)
+{
+   state.player(BLUE).flags().attack_token = true;
+   add_unit< TestUnit3 >(BLUE, {Keyword::CHALLENGER});
+   add_unit< TestUnit1 >(BLUE, {Keyword::ELUSIVE});
+   add_unit< TestUnit2 >(RED, {Keyword::ELUSIVE});
+   add_unit< TestUnit2 >(RED);
+   set_nexus_health(RED, 5);
+
+   // only dragging the elusive blocker onto the challenger lets the elusive unit through
+   auto result = solver.solve(state, BLUE);
+   EXPECT_TRUE(result.lethal);
+   EXPECT_TRUE(result.complete);
+   ASSERT_EQ(result.line.attackers.size(), 2);
+   // the stronger elusive unit is sent into the first lane
+   EXPECT_EQ(result.line.attackers[0], 1);
+   EXPECT_EQ(result.line.attackers[1], 0);
+   EXPECT_FALSE(result.line.challenged[0].has_value());
+   ASSERT_TRUE(result.line.challenged[1].has_value());
+   EXPECT_EQ(result.line.challenged[1].value(), 0);
+   EXPECT_EQ(result.line.guaranteed_damage, 5);
+   EXPECT_GT(result.nodes, 0);
+
+   // the same board is answered from the cache
+   auto cached = solver.solve(state, BLUE);
+   EXPECT_TRUE(cached.lethal);
+   EXPECT_EQ(cached.nodes, 0);
+   EXPECT_EQ(cached.line.challenged[1], result.line.challenged[1]);
+}
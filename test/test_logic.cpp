@@ -3,9 +3,1108 @@
 
 #include <gtest/gtest.h>
 
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "cards/card_pool.h"
+#include "cards/cardfactory.h"
 #include "core/gamestate.h"
+#include "core/replay.h"
+#include "grants/grantfactory.h"
+#include "io/output_sink.h"
+#include "test_action.h"
 #include "test_cards.h"
+#include "test_utils.h"
 
 TEST(LogicTest, Logic_Basics) {
 //   GameState state();
-}
\ No newline at end of file
+}
+
+namespace {
+
+sptr< Card > build_test_card(const std::string& code, Team team)
+{
+   if(code == "CODE1") {
+      return std::make_shared< TestUnit1 >(team);
+   }
+   if(code == "CODE2") {
+      return std::make_shared< TestUnit2 >(team);
+   }
+   return std::make_shared< TestUnit3 >(team);
+}
+
+/**
+ * Plays a game between greedy controllers to its end and returns its replay.
+ */
+Replay record_greedy_game(random::seed_type seed)
+{
+   GameState game(
+      Config(),
+      {make_test_deck(BLUE), make_test_deck(RED)},
+      {std::make_shared< GreedyController >(BLUE), std::make_shared< GreedyController >(RED)},
+      BLUE,
+      random::create_rng(seed));
+   ReplayRecorder recorder(game, seed);
+   game.logic()->start_game();
+   auto status = game.logic()->check_status();
+   while(status == Status::ONGOING) {
+      status = game.logic()->step();
+      recorder.record_step();
+   }
+   return recorder.replay();
+}
+
+}  // namespace
+
+class LogicGameTest: public ::testing::Test {
+  protected:
+   GameState state{
+      Config(),
+      {make_test_deck(BLUE), make_test_deck(RED)},
+      {std::make_shared< TestController >(BLUE), std::make_shared< TestController >(RED)},
+      BLUE,
+      random::create_rng(0)};
+
+   auto controller(Team team)
+   {
+      return std::dynamic_pointer_cast< TestController >(state.player(team).controller());
+   }
+};
+
+TEST_F(LogicGameTest, round_structure)
+{
+   auto& logic = *state.logic();
+   logic.start_game();
+   Team attacker = state.starting_team();
+   Team defender = opponent(attacker);
+   EXPECT_EQ(state.round(), 1);
+   EXPECT_EQ(state.active_team(), attacker);
+   EXPECT_TRUE(state.player(attacker).flags().attack_token);
+   EXPECT_FALSE(state.player(defender).flags().attack_token);
+   for(Team team : {BLUE, RED}) {
+      // the starting hand and the card drawn at round start
+      EXPECT_EQ(state.player(team).hand().size(), state.config().INITIAL_HAND_SIZE + 1);
+      EXPECT_EQ(state.player(team).mana().gems, 1);
+      EXPECT_EQ(state.player(team).mana().common, 1);
+   }
+
+   controller(attacker)->add_action(actions::Action(actions::AcceptAction(attacker)));
+   EXPECT_EQ(logic.step(), Status::ONGOING);
+   EXPECT_EQ(state.round(), 1);
+   EXPECT_EQ(state.active_team(), defender);
+
+   // both players passed, so the next round begins with the attack token switching sides
+   controller(defender)->add_action(actions::Action(actions::AcceptAction(defender)));
+   EXPECT_EQ(logic.step(), Status::ONGOING);
+   EXPECT_EQ(state.round(), 2);
+   EXPECT_EQ(state.active_team(), defender);
+   EXPECT_TRUE(state.player(defender).flags().attack_token);
+   EXPECT_FALSE(state.player(attacker).flags().attack_token);
+   EXPECT_EQ(state.player(attacker).mana().gems, 2);
+}
+
+TEST_F(LogicGameTest, game_runs_to_completion)
+{
+   GameState game(
+      Config(),
+      {make_test_deck(BLUE), make_test_deck(RED)},
+      {std::make_shared< GreedyController >(BLUE), std::make_shared< GreedyController >(RED)},
+      BLUE,
+      random::create_rng(0));
+   game.logic()->start_game();
+   auto status = game.logic()->check_status();
+   for(int steps = 0; steps < 1000 && status == Status::ONGOING; ++steps) {
+      status = game.logic()->step();
+   }
+   EXPECT_NE(status, Status::ONGOING);
+   for(Team team : {BLUE, RED}) {
+      EXPECT_LE(game.board().camp(team).size(), game.config().CAMP_SIZE);
+      EXPECT_TRUE(game.board().battlefield(team).empty());
+   }
+}
+
+TEST_F(LogicGameTest, passing_ends_the_round)
+{
+   auto& logic = *state.logic();
+   logic.start_game();
+   Team attacker = state.starting_team();
+   Team defender = opponent(attacker);
+
+   controller(attacker)->add_action(actions::Action(actions::AcceptAction(attacker)));
+   EXPECT_EQ(logic.step(), Status::ONGOING);
+   EXPECT_TRUE(state.player(attacker).flags().pass);
+
+   // playing a card instead of passing revokes the opponent's pass
+   controller(defender)->add_action(actions::Action(actions::PlayRequestAction(defender, 0)));
+   EXPECT_EQ(logic.step(), Status::ONGOING);
+   EXPECT_FALSE(state.player(attacker).flags().pass);
+   EXPECT_EQ(state.round(), 1);
+   EXPECT_EQ(state.board().camp(defender).size(), 1);
+   EXPECT_EQ(state.player(defender).hand().size(), state.config().INITIAL_HAND_SIZE);
+
+   // a player who passed before has to pass anew
+   controller(attacker)->add_action(actions::Action(actions::AcceptAction(attacker)));
+   EXPECT_EQ(logic.step(), Status::ONGOING);
+   EXPECT_EQ(state.round(), 1);
+   for(Team team : {BLUE, RED}) {
+      state.player(team).mana().common = 10;
+      state.player(team).mana().gems = state.config().MAX_MANA;
+   }
+   controller(defender)->add_action(actions::Action(actions::AcceptAction(defender)));
+   EXPECT_EQ(logic.step(), Status::ONGOING);
+   EXPECT_EQ(state.round(), 2);
+   for(Team team : {BLUE, RED}) {
+      const auto& mana = state.player(team).mana();
+      // unspent mana floats into the next round up to its limit, the gems stay capped
+      EXPECT_EQ(mana.floating, state.config().MAX_FLOATING_MANA);
+      EXPECT_EQ(mana.gems, state.config().MAX_MANA);
+      EXPECT_EQ(mana.common, state.config().MAX_MANA);
+      EXPECT_FALSE(state.player(team).flags().pass);
+   }
+}
+
+TEST_F(LogicGameTest, status_checks)
+{
+   auto start_health = long(state.config().START_NEXUS_HEALTH);
+   {
+      GameState game(state);
+      EXPECT_EQ(game.logic()->check_status(), Status::ONGOING);
+      game.player(RED).nexus().reset(0);
+      EXPECT_EQ(game.logic()->check_status(), Status::BLUE_WINS_NEXUS);
+      // the outcome is frozen once decided
+      game.player(BLUE).nexus().reset(0);
+      EXPECT_EQ(game.logic()->check_status(), Status::BLUE_WINS_NEXUS);
+      game.player(RED).nexus().reset(start_health);
+      EXPECT_EQ(game.logic()->check_status(), Status::BLUE_WINS_NEXUS);
+   }
+   {
+      GameState game(state);
+      game.player(BLUE).nexus().reset(-2);
+      EXPECT_EQ(game.logic()->check_status(), Status::RED_WINS_NEXUS);
+   }
+   {
+      GameState game(state);
+      game.player(BLUE).nexus().reset(0);
+      game.player(RED).nexus().reset(-1);
+      EXPECT_EQ(game.logic()->check_status(), Status::TIE);
+   }
+   {
+      GameState game(state);
+      game.round() = state.config().MAX_ROUNDS;
+      EXPECT_EQ(game.logic()->check_status(), Status::ONGOING);
+      game.round() += 1;
+      EXPECT_EQ(game.logic()->check_status(), Status::TIE);
+   }
+   {
+      // drawing from an empty deck loses the game
+      GameState game(state);
+      while(not game.player(RED).deck().empty()) {
+         game.logic()->draw_card(RED);
+      }
+      EXPECT_EQ(game.logic()->check_status(), Status::ONGOING);
+      game.logic()->draw_card(RED);
+      EXPECT_EQ(game.logic()->check_status(), Status::win(BLUE, false));
+   }
+}
+
+TEST_F(LogicGameTest, default_mode_actions)
+{
+   auto& logic = *state.logic();
+   logic.start_game();
+   const auto& invoker = logic.action_invoker();
+   Team attacker = state.starting_team();
+   Team defender = opponent(attacker);
+   auto count = [](const std::vector< actions::Action >& actions, actions::ActionLabel label) {
+      return std::count_if(actions.begin(), actions.end(), [&](const auto& action) {
+         return action.label() == label;
+      });
+   };
+
+   auto actions = invoker.valid_actions(state);
+   EXPECT_EQ(actions.front().label(), actions::ActionLabel::ACCEPT);
+   EXPECT_EQ(
+      count(actions, actions::ActionLabel::PLAY_REQUEST), state.player(attacker).hand().size());
+   EXPECT_TRUE(invoker.is_valid(actions::Action(actions::PlayRequestAction(attacker, 0))));
+   EXPECT_FALSE(invoker.is_valid(actions::Action(
+      actions::PlayRequestAction(attacker, state.player(attacker).hand().size()))));
+   EXPECT_EQ(count(actions, actions::ActionLabel::PLACE_UNIT), 0);
+
+   // a card costing more than the mana at hand cannot be played
+   const auto& hand = state.player(attacker).hand();
+   GrantFactory().grant< GrantType::MANA >(hand.front(), hand.front(), true, 2L);
+   EXPECT_FALSE(invoker.is_valid(actions::Action(actions::PlayRequestAction(attacker, 0))));
+   actions = invoker.valid_actions(state);
+   EXPECT_EQ(count(actions, actions::ActionLabel::PLAY_REQUEST), hand.size() - 1);
+
+   // the attack token offers every single unit and every prefix of the camp's units
+   for(int i = 0; i < 3; ++i) {
+      logic.place_in_camp(std::make_shared< TestUnit1 >(attacker), std::nullopt);
+      logic.place_in_camp(std::make_shared< TestUnit1 >(defender), std::nullopt);
+   }
+   actions = invoker.valid_actions(state);
+   EXPECT_EQ(count(actions, actions::ActionLabel::PLACE_UNIT), 3 + 2);
+   EXPECT_EQ(actions.back().detail< actions::PlaceUnitAction >().indices_vec().size(), 3);
+   EXPECT_TRUE(invoker.is_valid(actions::Action(actions::PlaceUnitAction(attacker, true, {2, 0}))));
+   EXPECT_FALSE(
+      invoker.is_valid(actions::Action(actions::PlaceUnitAction(attacker, true, {1, 1}))));
+   EXPECT_FALSE(invoker.is_valid(actions::Action(actions::PlaceUnitAction(attacker, true, {3}))));
+   EXPECT_FALSE(invoker.is_valid(actions::Action(actions::PlaceUnitAction(attacker, false, {0}))));
+   // without the attack token there is nothing to place
+   EXPECT_FALSE(invoker.is_valid(actions::Action(actions::PlaceUnitAction(defender, true, {0}))));
+
+   // nothing can be played into a full camp, as replacing is not supported yet
+   while(state.board().camp(attacker).size() < state.board().max_size_camp()) {
+      logic.place_in_camp(std::make_shared< TestUnit1 >(attacker), std::nullopt);
+   }
+   EXPECT_EQ(count(invoker.valid_actions(state), actions::ActionLabel::PLAY_REQUEST), 0);
+
+   // once units are moved, only the attack declaration remains
+   state.buffer().bf.emplace_back(to_unit(state.board().camp(attacker).front()));
+   actions = invoker.valid_actions(state);
+   ASSERT_EQ(actions.size(), 1);
+   EXPECT_EQ(actions.front().label(), actions::ActionLabel::ACCEPT);
+}
+
+TEST_F(LogicGameTest, combat_mode_actions)
+{
+   auto& logic = *state.logic();
+   auto& board = state.board();
+   for(int i = 0; i < 2; ++i) {
+      auto attacker = std::make_shared< TestUnit1 >(BLUE);
+      auto& bf = board.battlefield(BLUE);
+      bf.emplace_back(attacker);
+      attacker->move(Location::BATTLEFIELD, bf.size() - 1);
+   }
+   for(int i = 0; i < 3; ++i) {
+      logic.place_in_camp(std::make_shared< TestUnit2 >(RED), std::nullopt);
+   }
+   state.attacker(BLUE);
+   logic.transition< CombatModeInvoker >();
+   if(state.active_team() != RED) {
+      state.turn() += 1;
+   }
+   const auto& invoker = logic.action_invoker();
+
+   // the defender blocks with at most as many units as there are attackers
+   auto actions = invoker.valid_actions(state);
+   EXPECT_EQ(actions.size(), 1 + 3 + 1);
+   EXPECT_TRUE(invoker.is_valid(actions::Action(actions::PlaceUnitAction(RED, true, {0, 2}))));
+   EXPECT_FALSE(invoker.is_valid(actions::Action(actions::PlaceUnitAction(RED, true, {0, 1, 2}))));
+   EXPECT_FALSE(invoker.is_valid(actions::Action(actions::PlaceUnitAction(BLUE, true, {0}))));
+   EXPECT_FALSE(invoker.is_valid(actions::Action(actions::PlayRequestAction(RED, 0))));
+   EXPECT_TRUE(invoker.is_valid(actions::Action(actions::AcceptAction(BLUE))));
+
+   // and only once
+   auto blocker = board.camp(RED).front();
+   board.battlefield(RED).emplace_back(to_unit(blocker));
+   actions = invoker.valid_actions(state);
+   ASSERT_EQ(actions.size(), 1);
+   EXPECT_EQ(actions.front().label(), actions::ActionLabel::ACCEPT);
+   EXPECT_FALSE(invoker.is_valid(actions::Action(actions::PlaceUnitAction(RED, true, {1}))));
+}
+
+TEST_F(LogicGameTest, camp_placement)
+{
+   auto& logic = *state.logic();
+   auto& camp = state.board().camp(BLUE);
+   std::vector< sptr< Unit > > units{
+      std::make_shared< TestUnit1 >(BLUE),
+      std::make_shared< TestUnit2 >(BLUE),
+      std::make_shared< TestUnit3 >(BLUE)};
+   for(const auto& unit : units) {
+      logic.place_in_camp(unit, std::nullopt);
+   }
+   for(size_t i = 0; i < units.size(); ++i) {
+      EXPECT_EQ(units[i]->mutables().location, Location::CAMP);
+      EXPECT_EQ(units[i]->mutables().position, i);
+   }
+
+   // a replacement takes the place of the replaced card, which is gone
+   auto replacement = std::make_shared< TestUnit1 >(BLUE);
+   logic.place_in_camp(replacement, 1);
+   ASSERT_EQ(camp.size(), 3);
+   EXPECT_EQ(camp[0], units[0]);
+   EXPECT_EQ(camp[1], replacement);
+   EXPECT_EQ(camp[2], units[2]);
+   EXPECT_EQ(replacement->mutables().position, 1);
+   EXPECT_THROW(logic.place_in_camp(std::make_shared< TestUnit1 >(BLUE), 3), std::out_of_range);
+
+   // cards leave the camp by identity, even though the positions right of them are stale now
+   logic.obliterate(units[0]);
+   ASSERT_EQ(camp.size(), 2);
+   EXPECT_EQ(camp[0], replacement);
+   logic.obliterate(units[2]);
+   ASSERT_EQ(camp.size(), 1);
+   EXPECT_EQ(camp[0], replacement);
+}
+
+TEST_F(LogicGameTest, reset_replays_the_same_game)
+{
+   GameState game(
+      Config(),
+      {make_test_deck(BLUE), make_test_deck(RED)},
+      {std::make_shared< GreedyController >(BLUE), std::make_shared< GreedyController >(RED)},
+      BLUE,
+      random::create_rng(0));
+   auto play = [&] {
+      game.logic()->start_game();
+      auto status = game.logic()->check_status();
+      for(int steps = 0; steps < 1000 && status == Status::ONGOING; ++steps) {
+         status = game.logic()->step();
+      }
+      return std::pair(status, game.round());
+   };
+   auto first = play();
+   ASSERT_NE(first.first, Status::ONGOING);
+
+   game.reset({make_test_deck(BLUE), make_test_deck(RED)}, BLUE, 0);
+   EXPECT_EQ(game.round(), 0);
+   EXPECT_EQ(game.logic()->check_status(), Status::ONGOING);
+   EXPECT_EQ(game.logic()->action_invoker().label(), ActionInvokerBase::Label::MULLIGAN);
+   for(Team team : {BLUE, RED}) {
+      EXPECT_EQ(game.player(team).nexus().health(), game.config().START_NEXUS_HEALTH);
+      EXPECT_TRUE(game.player(team).hand().empty());
+      EXPECT_TRUE(game.player(team).graveyard().empty());
+      EXPECT_EQ(game.player(team).deck().size(), 12);
+      EXPECT_TRUE(game.board().camp(team).empty());
+   }
+   // same decks, starting team and seed make for the same game
+   EXPECT_EQ(play(), first);
+}
+
+TEST_F(LogicGameTest, aoe_damage_and_grants)
+{
+   auto& logic = *state.logic();
+   auto& board = state.board();
+   auto cause = std::make_shared< TestUnit3 >(BLUE);
+   auto weak = std::make_shared< TestUnit1 >(RED);
+   auto sturdy = std::make_shared< TestUnit2 >(RED);
+   logic.place_in_camp(weak, std::nullopt);
+   logic.place_in_camp(sturdy, std::nullopt);
+
+   // both take their damage before the one without health left dies
+   EXPECT_EQ(logic.damage_units(board.units(RED), cause, 4), 8);
+   EXPECT_FALSE(weak->unit_mutables().alive);
+   EXPECT_EQ(sturdy->health(), 1);
+   ASSERT_EQ(board.camp(RED).size(), 1);
+   EXPECT_EQ(board.camp(RED).front(), sturdy);
+   EXPECT_EQ(state.player(RED).graveyard().size(), 1);
+
+   logic.apply_stats_grant(board.units(RED), cause, 1, 2, false);
+   EXPECT_EQ(sturdy->power(), 5);
+   EXPECT_EQ(sturdy->health(), 3);
+
+   // more units than both boards hold are refused before any of them is damaged
+   std::vector< sptr< Unit > > too_many(2 * Board::UnitsType::capacity() + 1, sturdy);
+   EXPECT_THROW(logic.damage_units(too_many, cause, 1), std::length_error);
+   EXPECT_EQ(sturdy->health(), 3);
+
+   // a single unit dies of its damage just the same
+   EXPECT_EQ(logic.damage_unit(sturdy, cause, 3), 3);
+   EXPECT_FALSE(sturdy->unit_mutables().alive);
+   EXPECT_TRUE(board.camp(RED).empty());
+   EXPECT_EQ(state.player(RED).graveyard().size(), 2);
+}
+
+TEST_F(LogicGameTest, auras_taking_back_health_kill)
+{
+   auto& logic = *state.logic();
+   auto& board = state.board();
+   auto source = std::make_shared< TestUnit3 >(BLUE);
+   auto second_source = std::make_shared< TestUnit3 >(BLUE);
+   auto ally = std::make_shared< TestUnit2 >(BLUE);
+   auto other = std::make_shared< TestUnit2 >(BLUE);
+   for(const auto& unit : {source, second_source}) {
+      logic.place_in_camp(unit, std::nullopt);
+   }
+   logic.place_in_camp(ally, std::nullopt);
+   logic.place_in_camp(other, std::nullopt);
+   AuraSpec spec;
+   spec.health = 2;
+   logic.add_aura(source, spec);
+   logic.add_aura(second_source, spec);
+   auto health = ally->health();
+   EXPECT_EQ(logic.damage_unit(ally, source, long(health) - 1), long(health) - 1);
+   EXPECT_EQ(ally->health(), 1);
+
+   // ending the aura takes back the health the damage did not
+   logic.remove_aura(source);
+   EXPECT_FALSE(ally->unit_mutables().alive);
+   EXPECT_TRUE(other->unit_mutables().alive);
+   EXPECT_EQ(state.player(BLUE).graveyard().size(), 1);
+
+   // so does the aura's source leaving the board
+   logic.damage_unit(other, source, long(other->health()) - 1);
+   logic.obliterate(second_source);
+   EXPECT_FALSE(other->unit_mutables().alive);
+   EXPECT_EQ(board.camp(BLUE).size(), 1);
+   EXPECT_EQ(board.camp(BLUE).front(), source);
+}
+
+TEST_F(LogicGameTest, combat_resolution)
+{
+   auto& logic = *state.logic();
+   auto& board = state.board();
+   // three attackers against a single blocker, so the defending lane is shorter
+   auto blocked = std::make_shared< TestUnit3 >(BLUE);
+   auto first = std::make_shared< TestUnit1 >(BLUE);
+   auto second = std::make_shared< TestUnit2 >(BLUE);
+   auto blocker = std::make_shared< TestUnit2 >(RED);
+   for(const auto& unit : std::initializer_list< sptr< Unit > >{blocked, first, second}) {
+      auto& bf = board.battlefield(BLUE);
+      bf.emplace_back(unit);
+      unit->move(Location::BATTLEFIELD, bf.size() - 1);
+   }
+   board.battlefield(RED).emplace_back(blocker);
+   blocker->move(Location::BATTLEFIELD, 0);
+   state.attacker(BLUE);
+   logic.transition< CombatModeInvoker >();
+   ASSERT_TRUE(logic.in_combat());
+
+   logic.resolve();
+   // the unblocked attackers strike the defender's nexus, not their own
+   EXPECT_EQ(
+      state.player(RED).nexus().health(),
+      long(state.config().START_NEXUS_HEALTH) - first->power() - second->power());
+   EXPECT_EQ(state.player(BLUE).nexus().health(), long(state.config().START_NEXUS_HEALTH));
+   EXPECT_FALSE(blocked->unit_mutables().alive);
+   EXPECT_EQ(blocker->health(), 2);
+   // the survivors retreat to camp from left to right
+   ASSERT_EQ(board.camp(BLUE).size(), 2);
+   EXPECT_EQ(board.camp(BLUE)[0], first);
+   EXPECT_EQ(board.camp(BLUE)[1], second);
+   EXPECT_EQ(second->mutables().location, Location::CAMP);
+   EXPECT_EQ(second->mutables().position, 1);
+   ASSERT_EQ(board.camp(RED).size(), 1);
+   EXPECT_EQ(board.camp(RED).front(), blocker);
+   for(Team team : {BLUE, RED}) {
+      EXPECT_TRUE(board.battlefield(team).empty());
+   }
+   EXPECT_EQ(logic.action_invoker().label(), ActionInvokerBase::Label::DEFAULT);
+}
+
+TEST_F(LogicGameTest, copies_rebind_the_logic)
+{
+   state.logic()->start_game();
+   state.logic()->transition< DefaultModeInvoker >();
+   GameState copy(state);
+   auto logic = copy.logic();
+   EXPECT_NE(logic, state.logic());
+   EXPECT_EQ(logic->state(), &copy);
+   EXPECT_EQ(logic->action_invoker().logic(), logic.get());
+   EXPECT_EQ(state.logic()->action_invoker().logic(), state.logic().get());
+   EXPECT_EQ(logic->action_invoker().label(), ActionInvokerBase::Label::DEFAULT);
+   // the copy plays on by itself, leaving the original untouched
+   Team team = copy.active_team();
+   std::dynamic_pointer_cast< TestController >(copy.player(team).controller())
+      ->add_action(actions::Action(actions::AcceptAction(team)));
+   auto active_before = state.active_team();
+   EXPECT_EQ(logic->step(), Status::ONGOING);
+   EXPECT_NE(copy.active_team(), team);
+   EXPECT_EQ(state.active_team(), active_before);
+}
+
+TEST_F(LogicGameTest, grant_factory)
+{
+   GrantFactory factory;
+   auto cause = std::make_shared< TestUnit3 >(BLUE);
+   auto unit = std::make_shared< TestUnit1 >(BLUE);
+   auto stats = factory.grant< GrantType::STATS >(cause, unit, true, 2L, 1L);
+   EXPECT_EQ(stats->get_grant_type(), GrantType::STATS);
+   EXPECT_EQ(stats->get_bestowing_card(), cause);
+   EXPECT_EQ(stats->get_bestowed_card(), unit);
+   EXPECT_EQ(unit->power(), 7);
+   EXPECT_EQ(unit->health(), 5);
+   auto mana = factory.grant< GrantType::MANA >(cause, unit, false, 1L);
+   EXPECT_EQ(unit->mana_cost(), 1);
+   auto keyword = factory.grant< GrantType::KEYWORD >(cause, unit, true, Keyword::OVERWHELM);
+   EXPECT_TRUE(unit->has_keyword(Keyword::OVERWHELM));
+   EXPECT_EQ(unit->mutables().grants.size(), 2);
+   ASSERT_EQ(unit->mutables().grants_temp.size(), 1);
+   EXPECT_EQ(unit->mutables().grants_temp.front(), mana);
+}
+
+TEST_F(LogicGameTest, round_timers)
+{
+   // enough cards to play past the wheel's horizon
+   GameState game(
+      Config(),
+      {make_test_deck(BLUE, 8), make_test_deck(RED, 8)},
+      {std::make_shared< TestController >(BLUE), std::make_shared< TestController >(RED)},
+      BLUE,
+      random::create_rng(0));
+   auto& logic = *game.logic();
+   auto controller = [&](Team team) {
+      return std::dynamic_pointer_cast< TestController >(game.player(team).controller());
+   };
+   logic.start_game();
+   Team attacker = game.starting_team();
+   Team defender = opponent(attacker);
+   auto end_round = [&] {
+      controller(attacker)->add_action(actions::Action(actions::AcceptAction(attacker)));
+      logic.step();
+      controller(defender)->add_action(actions::Action(actions::AcceptAction(defender)));
+      logic.step();
+      std::swap(attacker, defender);
+   };
+   auto buffed = std::make_shared< TestUnit2 >(BLUE);
+   auto ephemeral = std::make_shared< TestUnit1 >(BLUE);
+   ephemeral->add_keyword(Keyword::EPHEMERAL);
+   logic.place_in_camp(buffed, std::nullopt);
+   logic.place_in_camp(ephemeral, std::nullopt);
+   logic.grant< GrantType::STATS >(BLUE, buffed, buffed, false, 2L, 0L);
+   EXPECT_EQ(buffed->power(), 6);
+
+   size_t fired_in_round = 0;
+   // beyond the wheel's horizon, so the timer has to wait a full turn of the wheel
+   logic.schedule(
+      TimerWheel::horizon + 1,
+      RoundPhase::START,
+      buffed,
+      [&fired_in_round](Logic& logic, const sptr< Card >& /*card*/) {
+         fired_in_round = logic.state()->round();
+      });
+
+   end_round();
+   EXPECT_EQ(game.round(), 2);
+   EXPECT_EQ(buffed->power(), 4);
+   EXPECT_TRUE(buffed->mutables().grants_temp.empty());
+   EXPECT_FALSE(ephemeral->unit_mutables().alive);
+   EXPECT_EQ(game.board().camp(BLUE).size(), 1);
+
+   while(game.round() < TimerWheel::horizon + 2) {
+      EXPECT_EQ(fired_in_round, 0);
+      end_round();
+   }
+   EXPECT_EQ(fired_in_round, TimerWheel::horizon + 2);
+   EXPECT_TRUE(game.timers().empty());
+}
+
+TEST_F(LogicGameTest, timers_of_removed_cards)
+{
+   auto& logic = *state.logic();
+   logic.start_game();
+   auto killer = std::make_shared< TestUnit1 >(BLUE);
+   auto victim = std::make_shared< TestUnit2 >(RED);
+   logic.place_in_camp(killer, std::nullopt);
+   logic.place_in_camp(victim, std::nullopt);
+   // all due at this round's end, the first one removing the card of the others
+   logic.schedule(
+      0, RoundPhase::END, killer, [&victim](Logic& logic, const sptr< Card >& card) {
+         logic.kill_unit(victim, card);
+      });
+   logic.grant< GrantType::STATS >(RED, victim, victim, false, 1L, 0L);
+   bool fired = false;
+   logic.schedule(0, RoundPhase::END, victim, [&fired](Logic&, const sptr< Card >&) {
+      fired = true;
+   });
+   EXPECT_EQ(state.timers().size(), 3);
+
+   for(int i = 0; i < 2; ++i) {
+      Team team = state.active_team();
+      controller(team)->add_action(actions::Action(actions::AcceptAction(team)));
+      logic.step();
+   }
+   EXPECT_EQ(state.round(), 2);
+   EXPECT_FALSE(victim->unit_mutables().alive);
+   EXPECT_FALSE(fired);
+   // the grant of the removed unit did not expire either
+   EXPECT_EQ(victim->power(), 5);
+   EXPECT_EQ(victim->mutables().grants_temp.size(), 1);
+   EXPECT_TRUE(state.timers().empty());
+}
+
+TEST_F(LogicGameTest, seek_restores_grants_and_effects)
+{
+   auto& logic = *state.logic();
+   logic.start_game();
+   auto rallying = std::make_shared< TestUnit1 >(BLUE);
+   rallying->add_effect(
+      events::EventLabel::ROUND_START,
+      std::make_shared< TestRallyEffect >(rallying, EffectBase::RegistrationTime::CREATION));
+   auto buffed = std::make_shared< TestUnit2 >(RED);
+   logic.place_in_camp(rallying, std::nullopt);
+   logic.place_in_camp(buffed, std::nullopt);
+   logic.subscribe_effects(rallying, EffectBase::RegistrationTime::CREATION);
+   // expires at the end of this round
+   logic.grant< GrantType::STATS >(RED, buffed, buffed, false, 2L, 0L);
+
+   // a keyframe, as the replay player takes them, whose grant and effect belong to it alone
+   GameState keyframe(state);
+   auto kept_buffed = to_unit(keyframe.board().camp(RED).front());
+   auto kept_rallying = to_unit(keyframe.board().camp(BLUE).front());
+   ASSERT_EQ(kept_buffed->mutables().grants_temp.size(), 1);
+   const auto& kept_grant = kept_buffed->mutables().grants_temp.front();
+   EXPECT_NE(kept_grant, buffed->mutables().grants_temp.front());
+   EXPECT_EQ(kept_grant->get_bestowed_card(), kept_buffed);
+   EXPECT_EQ(kept_grant->get_bestowing_card(), kept_buffed);
+   const auto& kept_effect = kept_rallying->effects().at(events::EventLabel::ROUND_START).front();
+   EXPECT_EQ(kept_effect->associated_card(), kept_rallying);
+   ASSERT_EQ(kept_effect->subscribed_events().size(), 1);
+   EXPECT_EQ(
+      kept_effect->subscribed_events().front(), &keyframe.event(events::EventLabel::ROUND_START));
+
+   // play on past the grant's expiry and the next two round starts
+   auto play_rounds = [](GameState& game) {
+      std::vector< u64 > hashes;
+      while(game.round() < 3) {
+         Team team = game.active_team();
+         auto controller = std::dynamic_pointer_cast< TestController >(
+            game.player(team).controller());
+         controller->add_action(actions::Action(actions::AcceptAction(team)));
+         game.logic()->step();
+         hashes.emplace_back(Replay::hash(game));
+      }
+      return hashes;
+   };
+   auto hashes = play_rounds(state);
+   EXPECT_EQ(buffed->power(), 4);
+   EXPECT_TRUE(buffed->mutables().grants_temp.empty());
+   EXPECT_EQ(rallying->power(), 6);
+
+   // seeking back restores (a copy of) the keyframe, which replays the same game
+   GameState restored(keyframe);
+   EXPECT_EQ(play_rounds(restored), hashes);
+   auto restored_rallying = to_unit(restored.board().camp(BLUE).front());
+   EXPECT_EQ(to_unit(restored.board().camp(RED).front())->power(), 4);
+   EXPECT_EQ(restored_rallying->power(), 6);
+   ASSERT_EQ(restored_rallying->mutables().grants_temp.size(), 1);
+   EXPECT_EQ(
+      restored_rallying->mutables().grants_temp.front()->get_bestowed_card(), restored_rallying);
+
+   // while the keyframe itself is left as it was
+   EXPECT_EQ(kept_buffed->power(), 6);
+   EXPECT_EQ(kept_buffed->mutables().grants_temp.size(), 1);
+   EXPECT_EQ(kept_rallying->power(), 5);
+   EXPECT_EQ(keyframe.timers().size(), 1);
+}
+
+TEST_F(LogicGameTest, game_log)
+{
+   GameLog log;
+   log.append_action(1, actions::Action(actions::PlaceUnitAction(RED, true, {0, 2, 5})));
+   log.append_action(1, actions::Action(actions::MulliganAction(BLUE, {true, false, true})));
+   log.append_action(3, actions::Action(actions::PlayFieldCardFinishAction(BLUE, 300)));
+   ASSERT_EQ(log.size(), 3);
+   auto record = log.begin();
+   auto place = GameLog::decode_action(*record);
+   EXPECT_EQ(place.team(), RED);
+   EXPECT_TRUE(place.detail< actions::PlaceUnitAction >().to_bf());
+   EXPECT_EQ(
+      place.detail< actions::PlaceUnitAction >().indices_vec(), std::vector< size_t >({0, 2, 5}));
+   auto mulligan = GameLog::decode_action(*++record);
+   EXPECT_EQ(
+      mulligan.detail< actions::MulliganAction >().replace_decisions(),
+      std::vector< bool >({true, false, true}));
+   auto finish = GameLog::decode_action(*++record);
+   EXPECT_EQ((*record).round, 3);
+   EXPECT_EQ(finish.detail< actions::PlayFieldCardFinishAction >().index(), 300);
+   EXPECT_EQ(std::distance(log.records(1).begin(), log.records(1).end()), 2);
+   EXPECT_EQ(log.records(2).begin(), log.records(2).end());
+
+   auto& history = state.history();
+   state.log_level(LogLevel::ACTIONS_AND_EVENTS);
+   auto& logic = *state.logic();
+   logic.start_game();
+   for(int i = 0; i < 4; ++i) {
+      Team team = state.active_team();
+      controller(team)->add_action(actions::Action(actions::AcceptAction(team)));
+      logic.step();
+   }
+   size_t n_actions = 0;
+   size_t n_round_starts = 0;
+   size_t last_round = 0;
+   for(auto rec : history) {
+      EXPECT_GE(rec.round, last_round);
+      last_round = rec.round;
+      if(rec.is_action()) {
+         n_actions += 1;
+         EXPECT_TRUE(GameLog::decode_action(rec).is_accept());
+      } else if(rec.event_label() == events::EventLabel::ROUND_START) {
+         n_round_starts += 1;
+         EXPECT_EQ(rec.reader().next(), rec.round);
+      }
+   }
+   EXPECT_EQ(n_actions, 4);
+   EXPECT_EQ(n_round_starts, state.round());
+   size_t n_by_round = 0;
+   for(size_t round = 0; round <= state.round(); ++round) {
+      n_by_round += std::distance(history.records(round).begin(), history.records(round).end());
+   }
+   EXPECT_EQ(n_by_round, history.size());
+
+   // copies keep the level but not the records
+   GameState copy(state);
+   EXPECT_TRUE(copy.history().empty());
+   EXPECT_EQ(copy.log_level(), LogLevel::ACTIONS_AND_EVENTS);
+   auto size_before = history.size();
+   state.record_history(false);
+   Team team = state.active_team();
+   controller(team)->add_action(actions::Action(actions::AcceptAction(team)));
+   logic.step();
+   EXPECT_EQ(history.size(), size_before);
+}
+
+TEST(GameLogTest, rejects_corrupt_logs)
+{
+   GameLog log;
+   log.append_action(0, actions::Action(actions::AcceptAction(BLUE)));
+   log.append_action(0, actions::Action(actions::PlaceUnitAction(RED, true, {0, 2})));
+   // a log as `write` lays it out: level, record count, round offsets and arena
+   auto serialized = [&](u64 n_records, std::vector< u64 > offsets, std::vector< u8 > bytes) {
+      std::vector< u64 > words{
+         u64(LogLevel::ACTIONS), n_records, u64(offsets.size()), u64(bytes.size())};
+      words.insert(words.end(), offsets.begin(), offsets.end());
+      std::string str(reinterpret_cast< const char* >(words.data()), words.size() * sizeof(u64));
+      str.append(bytes.begin(), bytes.end());
+      return str;
+   };
+   auto read = [](std::string str) {
+      std::istringstream in(str);
+      return GameLog::read(in);
+   };
+   EXPECT_EQ(read(serialized(2, {0}, log.bytes())).bytes(), log.bytes());
+
+   auto with_byte = [&](size_t pos, u8 value) {
+      auto bytes = log.bytes();
+      bytes[pos] = value;
+      return bytes;
+   };
+   // the sizes claim more than the stream holds, which is not allocated up front
+   auto huge = serialized(2, {0}, log.bytes());
+   reinterpret_cast< u64* >(huge.data())[3] = u64(1) << 60;
+   EXPECT_THROW(read(huge), std::runtime_error);
+   huge = serialized(2, {0}, log.bytes());
+   reinterpret_cast< u64* >(huge.data())[2] = u64(1) << 60;
+   EXPECT_THROW(read(huge), std::runtime_error);
+
+   std::vector< std::string > corrupt{
+      serialized(3, {0}, log.bytes()),
+      serialized(2, {}, log.bytes()),
+      serialized(2, {0, 1}, log.bytes()),
+      serialized(2, {4, 0}, log.bytes()),
+      // a team, an action index and a payload size out of range
+      serialized(2, {0}, with_byte(2, 2)),
+      serialized(2, {0}, with_byte(1, 200)),
+      serialized(2, {0}, with_byte(3, 100)),
+   };
+   for(size_t i = 0; i < corrupt.size(); ++i) {
+      EXPECT_THROW(read(corrupt[i]), std::runtime_error) << "corruption " << i;
+   }
+}
+
+TEST(GameLogTest, rejects_corrupt_action_payloads)
+{
+   auto index_of = [](actions::Action action) { return u8(action.detail().index()); };
+   auto decode = [](u8 index, std::vector< u8 > payload) {
+      std::vector< u8 > record{u8(GameLog::Kind::ACTION), index, 0, u8(payload.size())};
+      record.insert(record.end(), payload.begin(), payload.end());
+      return GameLog::decode_action(
+         GameLog::RecordView{reinterpret_cast< const GameLog::Header* >(record.data()), 0});
+   };
+   auto place = index_of(actions::Action(actions::PlaceUnitAction(BLUE, true, {0})));
+   auto mulligan = index_of(actions::Action(actions::MulliganAction(BLUE, {true})));
+   EXPECT_EQ(
+      decode(place, {1, 2, 0, 3}).detail< actions::PlaceUnitAction >().indices_vec(),
+      std::vector< size_t >({0, 3}));
+   // more indices than the payload holds (1000 of them), a truncated varint and trailing bytes
+   EXPECT_THROW(decode(place, {1, 0xE8, 0x07, 0}), std::runtime_error);
+   EXPECT_THROW(decode(place, {1, 1, 0x80}), std::runtime_error);
+   EXPECT_THROW(decode(place, {1, 1, 0, 0}), std::runtime_error);
+   // a mulligan of more decisions than its mask has bits, or bits beyond its decisions
+   EXPECT_THROW(decode(mulligan, {65, 1}), std::runtime_error);
+   EXPECT_THROW(decode(mulligan, {2, 4}), std::runtime_error);
+   EXPECT_EQ(
+      decode(mulligan, {2, 2}).detail< actions::MulliganAction >().replace_decisions(),
+      std::vector< bool >({false, true}));
+
+   GameLog log;
+   EXPECT_THROW(
+      log.append_action(
+         0, actions::Action(actions::MulliganAction(BLUE, std::vector< bool >(65, true)))),
+      std::invalid_argument);
+}
+
+TEST_F(LogicGameTest, game_log_targets)
+{
+   auto& logic = *state.logic();
+   auto& board = state.board();
+   auto in_camp = std::make_shared< TestUnit1 >(BLUE);
+   auto on_bf = std::make_shared< TestUnit2 >(RED);
+   logic.place_in_camp(std::make_shared< TestUnit3 >(BLUE), std::nullopt);
+   logic.place_in_camp(in_camp, std::nullopt);
+   board.battlefield(RED).emplace_back(on_bf);
+   on_bf->move(Location::BATTLEFIELD, 0);
+   auto in_hand = state.player(RED).deck().pop();
+   state.player(RED).hand().emplace_back(in_hand);
+   sptr< Targetable > nexus(sptr< Targetable >(), &state.player(RED).nexus());
+   std::vector< sptr< Targetable > > targets{on_bf, in_camp, nexus, in_hand};
+
+   GameLog log;
+   EXPECT_THROW(
+      log.append_action(1, actions::Action(actions::TargetingAction(BLUE, targets))),
+      std::invalid_argument);
+   log.append_action(1, actions::Action(actions::TargetingAction(BLUE, targets)), state);
+   log.append_action(1, actions::Action(actions::PlayAction(BLUE, 0, {in_camp})), state);
+   ASSERT_EQ(log.size(), 2);
+   auto record = log.begin();
+   EXPECT_THROW(GameLog::decode_action(*record), std::invalid_argument);
+   auto targeting = GameLog::decode_action(*record, state);
+   EXPECT_EQ(targeting.detail< actions::TargetingAction >().targets(), targets);
+   auto play = GameLog::decode_action(*++record, state);
+   ASSERT_TRUE(play.detail< actions::PlayAction >().targets().has_value());
+   EXPECT_EQ(
+      *play.detail< actions::PlayAction >().targets(),
+      std::vector< sptr< Targetable > >{in_camp});
+
+   // decoded against a copy of the state, the targets are those of the copy
+   GameState copy(state);
+   auto copied = GameLog::decode_action(*log.begin(), copy).detail< actions::TargetingAction >();
+   ASSERT_EQ(copied.targets().size(), targets.size());
+   EXPECT_EQ(copied.targets()[0], sptr< Targetable >(copy.board().battlefield(RED)[0]));
+   EXPECT_EQ(copied.targets()[1], sptr< Targetable >(copy.board().camp(BLUE)[1]));
+   EXPECT_EQ(copied.targets()[2].get(), &copy.player(RED).nexus());
+   EXPECT_EQ(copied.targets()[3], sptr< Targetable >(copy.player(RED).hand().back()));
+   EXPECT_NE(copied.targets()[1], targets[1]);
+
+   // a target in none of the zones cannot be logged
+   auto elsewhere = std::make_shared< TestUnit1 >(BLUE);
+   EXPECT_THROW(
+      log.append_action(1, actions::Action(actions::TargetingAction(BLUE, {elsewhere})), state),
+      std::invalid_argument);
+}
+
+TEST_F(LogicGameTest, replay)
+{
+   GameState game(
+      Config(),
+      {make_test_deck(BLUE), make_test_deck(RED)},
+      {std::make_shared< GreedyController >(BLUE), std::make_shared< GreedyController >(RED)},
+      BLUE,
+      random::create_rng(7));
+   ReplayRecorder recorder(game, 7);
+   game.logic()->start_game();
+   auto status = game.logic()->check_status();
+   while(status == Status::ONGOING) {
+      status = game.logic()->step();
+      recorder.record_step();
+   }
+   auto replay = recorder.replay();
+   ASSERT_GT(replay.n_steps(), 0);
+   EXPECT_EQ(replay.actions.size(), game.history().size());
+
+   ReplayPlayer player(replay, build_test_card);
+   EXPECT_EQ(player.fast_forward(replay.n_steps() / 2), Status::ONGOING);
+   EXPECT_EQ(player.steps_done(), replay.n_steps() / 2);
+   EXPECT_EQ(player.fast_forward(), status);
+   EXPECT_TRUE(player.done());
+   EXPECT_EQ(player.state().round(), game.round());
+   EXPECT_EQ(Replay::hash(player.state()), Replay::hash(game));
+
+   // a tampered step hash is noticed at its step. The cards may as well come from a factory the
+   // player shares ownership of
+   replay.step_hashes[3] += 1;
+   auto factory = std::make_shared< CardFactory >();
+   factory->add_prototype(std::make_shared< TestUnit1 >(BLUE));
+   factory->add_prototype(std::make_shared< TestUnit2 >(BLUE));
+   factory->add_prototype(std::make_shared< TestUnit3 >(BLUE));
+   ReplayPlayer tampered(replay, [factory](const std::string& code, Team team) {
+      return factory->create(code, team);
+   });
+   factory = nullptr;
+   EXPECT_THROW(tampered.fast_forward(), std::runtime_error);
+   EXPECT_EQ(tampered.steps_done(), 3);
+}
+
+TEST_F(LogicGameTest, replay_storage)
+{
+   auto replay = record_greedy_game(13);
+   auto path = unique_temp_path(".replay");
+   {
+      OutputSink sink(OutputSink::Options{2, 256, 1});
+      auto file = sink.open(path);
+      // small buffers, so that the hashes span several of them
+      replay.write(sink, file);
+      replay.write(sink, file);
+      sink.close(file);
+   }
+   {
+      std::ifstream in(path, std::ios::binary);
+      for(int i = 0; i < 2; ++i) {
+         auto read = Replay::read(in);
+         EXPECT_EQ(read.decklists, replay.decklists);
+         EXPECT_EQ(read.starting_team, replay.starting_team);
+         EXPECT_EQ(read.seed, replay.seed);
+         EXPECT_EQ(read.step_hashes, replay.step_hashes);
+         EXPECT_EQ(read.actions.bytes(), replay.actions.bytes());
+         EXPECT_EQ(read.config.START_NEXUS_HEALTH, replay.config.START_NEXUS_HEALTH);
+         EXPECT_EQ(read.config.NEXUS_KEYWORDS_RED, replay.config.NEXUS_KEYWORDS_RED);
+         // the read replay re-simulates the recorded game
+         ReplayPlayer player(std::move(read), build_test_card);
+         EXPECT_NE(player.fast_forward(), Status::ONGOING);
+         EXPECT_EQ(Replay::hash(player.state()), replay.step_hashes.back());
+      }
+      EXPECT_THROW(Replay::read(in), std::runtime_error);
+   }
+   {
+      // another format version is refused
+      std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+      file.seekp(std::streamoff(Replay::file_magic.size()));
+      u64 version = Replay::current_format + 1;
+      file.write(reinterpret_cast< const char* >(&version), sizeof(u64));
+   }
+   std::ifstream in(path, std::ios::binary);
+   EXPECT_THROW(Replay::read(in), std::runtime_error);
+   std::filesystem::remove(path);
+}
+
+TEST_F(LogicGameTest, replay_keyframes)
+{
+   auto replay = record_greedy_game(11);
+   size_t n_steps = replay.n_steps();
+   ReplayPlayer player(replay, build_test_card);
+   player.fast_forward();
+   size_t n_rounds = player.state().round();
+   ASSERT_GT(n_rounds, 3);
+   // one keyframe per round, the first one taken before the first step
+   ASSERT_EQ(player.keyframes().size(), n_rounds);
+   EXPECT_EQ(player.keyframes().front().step, 0);
+   for(size_t i = 0; i < n_rounds; ++i) {
+      EXPECT_EQ(player.keyframes()[i].round, i + 1);
+   }
+
+   // the restored keyframes replay the remaining steps without a desync
+   EXPECT_EQ(player.seek(n_steps / 2), Status::ONGOING);
+   EXPECT_EQ(player.steps_done(), n_steps / 2);
+   EXPECT_EQ(Replay::hash(player.state()), replay.step_hashes[n_steps / 2 - 1]);
+   player.seek_round(3);
+   EXPECT_EQ(player.state().round(), 3);
+   EXPECT_EQ(player.steps_done(), player.keyframes()[2].step);
+   player.seek_round(2);
+   player.seek_round(2);
+   EXPECT_EQ(player.steps_done(), player.keyframes()[1].step);
+   EXPECT_NE(player.seek(n_steps), Status::ONGOING);
+   EXPECT_TRUE(player.done());
+   EXPECT_EQ(Replay::hash(player.state()), replay.step_hashes.back());
+   EXPECT_EQ(player.keyframes().size(), n_rounds);
+   EXPECT_THROW(player.seek(n_steps + 1), std::out_of_range);
+}
+
+TEST_F(LogicGameTest, create_from_prototypes)
+{
+   auto& logic = *state.logic();
+   EXPECT_THROW(static_cast< void >(logic.create(RED, "CODE1")), std::logic_error);
+
+   auto factory = std::make_shared< CardFactory >();
+   factory->add_prototype(std::make_shared< TestUnit1 >(BLUE));
+   factory->add_prototype(std::make_shared< TestUnit2 >(BLUE));
+   factory->add_prototype(std::make_shared< TestSpell >(BLUE));
+   state.card_factory(factory);
+   auto card = logic.create(RED, "CODE1");
+   auto unit = to_unit(card);
+   ASSERT_NE(unit, nullptr);
+   // created cards are of the class of their prototype, not just of its card type
+   EXPECT_NE(std::dynamic_pointer_cast< TestUnit1 >(card), nullptr);
+   EXPECT_NE(std::dynamic_pointer_cast< TestSpell >(logic.create(RED, "CODE6")), nullptr);
+   EXPECT_EQ(unit->mutables().owner, RED);
+   EXPECT_EQ(unit->power(), 5);
+   EXPECT_NE(unit->immutables().uuid, factory->prototype("CODE1")->immutables().uuid);
+   EXPECT_NE(*logic.create(RED, "CODE1"), *card);
+   EXPECT_THROW(static_cast< void >(logic.create(RED, "CODE9")), std::out_of_range);
+
+   unit->add_power(2, true);
+   auto basic = to_unit(logic.copy(card));
+   auto exact = to_unit(logic.copy(card, true));
+   EXPECT_EQ(basic->power(), 5);
+   EXPECT_EQ(exact->power(), 7);
+   EXPECT_NE(std::dynamic_pointer_cast< TestUnit1 >(basic), nullptr);
+   EXPECT_NE(std::dynamic_pointer_cast< TestUnit1 >(exact), nullptr);
+   EXPECT_NE(dynamic_cast< const TestUnit1* >(card->clone().get()), nullptr);
+   EXPECT_EQ(exact->mutables().owner, RED);
+   EXPECT_NE(*exact, *card);
+   // the prototype is untouched
+   EXPECT_EQ(dynamic_cast< const Unit* >(factory->prototype("CODE1"))->power(), 5);
+
+   // created cards keep the arena of their game alive
+   const auto* arena = state.card_arena().get();
+   auto copy = GameState(state);
+   EXPECT_NE(copy.card_arena().get(), arena);
+   EXPECT_EQ(copy.card_factory(), factory);
+   state.reset({make_test_deck(BLUE), make_test_deck(RED)}, BLUE, 0);
+   EXPECT_NE(state.card_arena().get(), arena);
+   EXPECT_EQ(unit->power(), 7);
+}
+
+TEST_F(LogicGameTest, ids_per_game)
+{
+   auto factory = std::make_shared< CardFactory >();
+   factory->add_prototype(std::make_shared< TestUnit1 >(BLUE));
+   // the ids of the cards a game creates, played twice on the same state
+   auto play = [&factory] {
+      GameState game(
+         Config(),
+         {make_test_deck(BLUE), make_test_deck(RED)},
+         {std::make_shared< GreedyController >(BLUE), std::make_shared< GreedyController >(RED)},
+         BLUE,
+         random::create_rng(5));
+      game.card_factory(factory);
+      std::vector< UUID > ids;
+      for(int i = 0; i < 2; ++i) {
+         game.logic()->start_game();
+         for(int steps = 0; steps < 6; ++steps) {
+            game.logic()->step();
+         }
+         ids.emplace_back(game.logic()->create(RED, "CODE1")->immutables().uuid);
+         // a copy continues with the ids the original would have drawn
+         GameState copy(game);
+         auto from_copy = copy.logic()->create(RED, "CODE1")->immutables().uuid;
+         ids.emplace_back(game.logic()->create(RED, "CODE1")->immutables().uuid);
+         EXPECT_EQ(from_copy, ids.back());
+         game.reset({make_test_deck(BLUE), make_test_deck(RED)}, BLUE, 5);
+      }
+      return ids;
+   };
+   auto ids = play();
+   ASSERT_EQ(ids.size(), 4);
+   EXPECT_NE(ids[0], ids[1]);
+   EXPECT_EQ(ids[0], ids[2]);
+   EXPECT_EQ(ids[1], ids[3]);
+
+   // neither what a thread ran before nor the thread itself changes the ids of a game
+   std::vector< UUID > on_thread;
+   std::thread([&] {
+      for(int i = 0; i < 10; ++i) {
+         static_cast< void >(utils::new_uuid());
+      }
+      on_thread = play();
+   }).join();
+   EXPECT_EQ(on_thread, ids);
+   // outside of a game, ids are drawn from the thread's own pool again
+   auto outside = utils::new_uuid();
+   EXPECT_TRUE(std::find(ids.begin(), ids.end(), outside) == ids.end());
+}
+
+TEST_F(LogicGameTest, create_random)
+{
+   CatalogBuilder builder("test-1.0");
+   builder.add({"01DE001", "Vanguard", "", "", Region::DEMACIA, Group::NONE, CardSuperType::NONE,
+                Rarity::COMMON, CardType::UNIT, true, 2, 2, 2});
+   builder.add({"01FR001", "Poro", "", "", Region::FRELJORD, Group::PORO, CardSuperType::NONE,
+                Rarity::COMMON, CardType::UNIT, true, 1, 2, 1});
+   builder.add({"01FR002", "Poro Snax", "", "", Region::FRELJORD, Group::NONE,
+                CardSuperType::NONE, Rarity::NONE, CardType::SPELL, false, 1});
+   TempCatalog catalog(builder);
+   auto factory = std::make_shared< CardFactory >(catalog.path());
+   CardPool pool(factory->catalog());
+   state.card_factory(factory);
+   auto& logic = *state.logic();
+   auto card = logic.create_random(RED, pool.query().region(Region::FRELJORD).card_type(
+                                           CardType::UNIT));
+   ASSERT_NE(card, nullptr);
+   EXPECT_EQ(card->immutables().code, "01FR001");
+   EXPECT_EQ(card->mutables().owner, RED);
+   EXPECT_EQ(logic.create_random(RED, pool.query().cost(7)), nullptr);
+   state.card_factory(nullptr);
+}
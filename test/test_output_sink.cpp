@@ -0,0 +1,155 @@
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "core/gamelog.h"
+#include "io/output_sink.h"
+#include "io/trajectory.h"
+#include "test_utils.h"
+
+class OutputSinkTest: public ::testing::Test {
+  protected:
+   std::filesystem::path dir = unique_temp_path();
+
+   void SetUp() override
+   {
+      std::filesystem::remove_all(dir);
+      std::filesystem::create_directories(dir);
+   }
+   void TearDown() override { std::filesystem::remove_all(dir); }
+};
+
+TEST_F(OutputSinkTest, recycles_buffers_in_order)
+{
+   auto path = dir / "bytes.bin";
+   constexpr size_t n_chunks = 200;
+   constexpr size_t chunk_size = 1000;
+   {
+      // more workers than buffers, so that writes complete out of order
+      OutputSink sink(OutputSink::Options{2, chunk_size, 3});
+      auto file = sink.open(path);
+      for(size_t i = 0; i < n_chunks; ++i) {
+         auto buffer = sink.acquire();
+         EXPECT_TRUE(buffer.empty());
+         EXPECT_GE(buffer.capacity(), chunk_size);
+         for(size_t j = 0; j < chunk_size; ++j) {
+            buffer.emplace_back(u8((i + j) % 251));
+         }
+         sink.submit(file, std::move(buffer));
+      }
+      sink.drain();
+      EXPECT_EQ(sink.size(file), n_chunks * chunk_size);
+      sink.close(file);
+      EXPECT_THROW(sink.submit(file, sink.acquire()), std::invalid_argument);
+   }
+   std::ifstream in(path, std::ios::binary);
+   std::vector< char > bytes(n_chunks * chunk_size + 1);
+   in.read(bytes.data(), std::streamsize(bytes.size()));
+   ASSERT_EQ(in.gcount(), n_chunks * chunk_size);
+   for(size_t i = 0; i < n_chunks; ++i) {
+      for(size_t j = 0; j < chunk_size; j += 97) {
+         ASSERT_EQ(u8(bytes[i * chunk_size + j]), u8((i + j) % 251));
+      }
+   }
+}
+
+TEST_F(OutputSinkTest, failed_writes_give_their_buffers_back)
+{
+   // a single buffer, so that any buffer that went missing makes acquire block forever
+   OutputSink sink(OutputSink::Options{1, 16, 1});
+   auto file = sink.open(dir / "bytes.bin");
+   u64 value = 7;
+   {
+      SinkWriter unfinished(sink, file);
+      unfinished.put(value);
+   }
+   {
+      SinkWriter writer(sink, file);
+      writer.put(value);
+      writer.finish();
+   }
+   sink.close(file);
+   EXPECT_THROW(sink.submit(file, sink.acquire()), std::invalid_argument);
+   EXPECT_THROW(sink.submit_at(file, 0, sink.acquire()), std::invalid_argument);
+   {
+      SinkWriter writer(sink, file);
+      for(int i = 0; i < 2; ++i) {
+         writer.put(value);
+      }
+      // the full buffer cannot be submitted to the closed file
+      EXPECT_THROW(writer.put(value), std::invalid_argument);
+   }
+   {
+      SinkWriter writer(sink, file);
+      EXPECT_THROW(writer.finish(), std::invalid_argument);
+   }
+   sink.release(sink.acquire());
+   sink.drain();
+   EXPECT_EQ(std::filesystem::file_size(dir / "bytes.bin"), sizeof(u64));
+}
+
+TEST_F(OutputSinkTest, closed_files_are_forgotten)
+{
+   OutputSink sink(OutputSink::Options{2, 16, 1});
+   auto first = sink.open(dir / "first.bin");
+   auto second = sink.open(dir / "second.bin");
+   EXPECT_NE(first, second);
+   sink.close(first);
+   EXPECT_THROW(static_cast< void >(sink.size(first)), std::invalid_argument);
+   EXPECT_THROW(sink.close(first), std::invalid_argument);
+   // ids are not reused, so a stale id never refers to a later file
+   auto third = sink.open(dir / "third.bin");
+   EXPECT_NE(third, first);
+   EXPECT_NE(third, second);
+   EXPECT_EQ(sink.size(second), 0);
+   sink.close(second);
+   sink.close(third);
+}
+
+TEST_F(OutputSinkTest, shared_by_producers)
+{
+   OutputSink sink(OutputSink::Options{4, 4096, 2});
+   TrajectoryLayout layout{3, 10};
+   auto base = dir / "selfplay";
+   auto log_path = dir / "games.log";
+
+   GameLog log(LogLevel::ACTIONS_AND_EVENTS);
+   log.append_action(1, actions::Action(actions::MulliganAction(BLUE, {true, false, true})));
+   log.append_action(3, actions::Action(actions::PlayFieldCardFinishAction(RED, 300)));
+   log.append_event(3, events::EventLabel::ROUND_START, RED, size_t(3));
+   {
+      TrajectoryWriter writer(sink, base, layout, 1, 50);
+      auto log_file = sink.open(log_path);
+      for(size_t i = 0; i < 120; ++i) {
+         auto record = writer.append();
+         record.value() = float(i);
+         if(i % 40 == 0) {
+            // a game ended, its log goes to the sink while the trajectories keep coming
+            log.write(sink, log_file);
+         }
+      }
+      writer.close();
+      sink.close(log_file);
+   }
+   sink.drain();
+
+   auto reader = TrajectoryReader::open(base);
+   EXPECT_EQ(reader.n_shards(), 3);
+   ASSERT_EQ(reader.size(), 120);
+   for(size_t i : {0, 49, 50, 119}) {
+      EXPECT_EQ(reader[i].value(), float(i));
+   }
+
+   std::ifstream in(log_path, std::ios::binary);
+   for(int i = 0; i < 3; ++i) {
+      auto read = GameLog::read(in);
+      EXPECT_EQ(read.level(), LogLevel::ACTIONS_AND_EVENTS);
+      ASSERT_EQ(read.size(), 3);
+      EXPECT_EQ(read.bytes(), log.bytes());
+      EXPECT_EQ(std::distance(read.records(3).begin(), read.records(3).end()), 2);
+      EXPECT_EQ(GameLog::decode_action(*read.records(3).begin()).team(), RED);
+   }
+   EXPECT_THROW(GameLog::read(in), std::runtime_error);
+}
@@ -0,0 +1,79 @@
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <thread>
+
+#include "utils/effect_tracer.h"
+#include "utils/profiler.h"
+
+TEST(ProfilerTest, zones_are_merged_across_threads)
+{
+   using namespace profiling;
+   Profiler::reset();
+   Profiler::enable_tracing(true, 16);
+   auto work = [] {
+      for(int i = 0; i < 3; ++i) {
+         ScopedZone zone("test_zone", "detail");
+         count("test_counter", 2);
+      }
+   };
+   work();
+   std::thread worker(work);
+   worker.join();
+
+   auto rows = Profiler::report();
+   auto row = std::find_if(rows.begin(), rows.end(), [](const ZoneReport& r) {
+      return r.name == "test_zone<detail>";
+   });
+   ASSERT_NE(row, rows.end());
+   EXPECT_EQ(row->stats.calls, 6);
+   EXPECT_LE(row->stats.min_ns, row->stats.max_ns);
+
+   auto counters = Profiler::counters();
+   ASSERT_EQ(counters.size(), 1);
+   EXPECT_EQ(counters[0].first, "test_counter");
+   EXPECT_EQ(counters[0].second, 12);
+
+   std::stringstream trace;
+   Profiler::write_chrome_trace(trace);
+   EXPECT_EQ(trace.str().rfind("{\"traceEvents\":[", 0), 0);
+   size_t n_events = 0;
+   for(auto pos = trace.str().find("\"ph\":\"X\""); pos != std::string::npos;
+       pos = trace.str().find("\"ph\":\"X\"", pos + 1)) {
+      n_events += 1;
+   }
+   EXPECT_EQ(n_events, 6);
+
+   Profiler::enable_tracing(false);
+   Profiler::reset();
+   EXPECT_TRUE(Profiler::report().empty());
+}
+
+TEST(ProfilerTest, effect_costs_are_attributed_per_card_and_label)
+{
+   using namespace profiling;
+   EffectTracer::reset();
+   for(int game = 0; game < 2; ++game) {
+      EffectScope outer("01DE001", events::EventLabel::PLAY);
+      EffectTracer::event_fired();
+      {
+         EffectScope inner("01NX002", events::EventLabel::STRIKE);
+         EffectTracer::event_fired();
+         EffectTracer::event_fired();
+      }
+   }
+   auto rows = EffectTracer::report(EffectTracer::SortKey::EVENTS_FIRED);
+   ASSERT_EQ(rows.size(), 2);
+   EXPECT_EQ(rows[0].card_code, "01NX002");
+   EXPECT_EQ(rows[0].label, events::EventLabel::STRIKE);
+   EXPECT_EQ(rows[0].events_fired, 4);
+   EXPECT_EQ(rows[1].card_code, "01DE001");
+   EXPECT_EQ(rows[1].calls, 2);
+   EXPECT_EQ(rows[1].events_fired, 2);
+   // the inner effect's time is part of the outer's inclusive but not its self time
+   EXPECT_GE(rows[1].inclusive_ns, rows[1].self_ns + rows[0].inclusive_ns);
+
+   EffectTracer::reset();
+   EXPECT_TRUE(EffectTracer::report().empty());
+}
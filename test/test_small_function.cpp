@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <memory>
+
+#include "utils/small_function.h"
+
+TEST(SmallFunctionTest, empty_functions_throw)
+{
+   SmallFunction< int(int) > empty;
+   EXPECT_FALSE(empty);
+   EXPECT_THROW(empty(1), std::bad_function_call);
+   SmallFunction< int(int) > null = nullptr;
+   EXPECT_THROW(null(1), std::bad_function_call);
+}
+
+TEST(SmallFunctionTest, trivial_callables)
+{
+   int offset = 3;
+   SmallFunction< int(int) > add = [&offset](int x) { return x + offset; };
+   auto copy = add;
+   offset = 4;
+   EXPECT_EQ(add(1), 5);
+   EXPECT_EQ(copy(1), 5);
+   SmallFunction< int(int) > moved = std::move(copy);
+   EXPECT_EQ(moved(2), 6);
+   EXPECT_FALSE(copy);  // NOLINT(bugprone-use-after-move)
+}
+
+TEST(SmallFunctionTest, callables_owning_resources)
+{
+   auto owned = std::make_shared< int >(7);
+   {
+      SmallFunction< int() > func = [owned] { return *owned; };
+      EXPECT_EQ(owned.use_count(), 2);
+      auto copy = func;
+      EXPECT_EQ(owned.use_count(), 3);
+      EXPECT_EQ(copy(), 7);
+
+      SmallFunction< int() > moved = std::move(func);
+      EXPECT_EQ(owned.use_count(), 3);
+      EXPECT_FALSE(func);  // NOLINT(bugprone-use-after-move)
+      EXPECT_EQ(moved(), 7);
+
+      // assigning destroys the callable held before
+      copy = [] { return 1; };
+      EXPECT_EQ(owned.use_count(), 2);
+      EXPECT_EQ(copy(), 1);
+      copy = moved;
+      EXPECT_EQ(owned.use_count(), 3);
+      copy = copy;
+      EXPECT_EQ(owned.use_count(), 3);
+      moved = nullptr;
+      EXPECT_EQ(owned.use_count(), 2);
+   }
+   EXPECT_EQ(owned.use_count(), 1);
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include "utils/static_queue.h"
+#include "utils/static_vector.h"
+#include "utils/types.h"
+
+TEST(StaticVectorTest, vector_operations)
+{
+   StaticVector< sptr< int >, 4 > vec{std::make_shared< int >(0), std::make_shared< int >(1)};
+   vec.emplace_back(std::make_shared< int >(2));
+   EXPECT_EQ(vec.size(), 3);
+   EXPECT_EQ(*vec.back(), 2);
+
+   vec.insert(std::next(vec.begin()), std::make_shared< int >(5));
+   EXPECT_EQ(*vec[1], 5);
+   EXPECT_EQ(*vec[2], 1);
+   EXPECT_THROW(vec.emplace_back(std::make_shared< int >(3)), std::length_error);
+
+   auto erased = vec[1];
+   vec.erase(std::next(vec.begin()));
+   EXPECT_EQ(vec.size(), 3);
+   // the erased element is destroyed, so only the local copy still owns it
+   EXPECT_EQ(erased.use_count(), 1);
+
+   auto copy = vec;
+   EXPECT_EQ(copy, vec);
+   EXPECT_EQ(vec.front().use_count(), 2);
+   auto moved = std::move(copy);
+   EXPECT_TRUE(copy.empty());
+   EXPECT_EQ(moved, vec);
+
+   vec.erase(vec.begin(), vec.end());
+   EXPECT_TRUE(vec.empty());
+   EXPECT_THROW((void) vec.at(0), std::out_of_range);
+}
+
+TEST(StaticVectorTest, queue_wraps_around)
+{
+   StaticQueue< int, 3 > queue;
+   for(int round = 0; round < 4; ++round) {
+      queue.push(round);
+      queue.push(round + 10);
+      EXPECT_EQ(queue.front(), round);
+      queue.pop();
+      EXPECT_EQ(queue.front(), round + 10);
+      queue.pop();
+   }
+   queue.push(1);
+   queue.push(2);
+   queue.push(3);
+   EXPECT_THROW(queue.push(4), std::length_error);
+   auto copy = queue;
+   queue.clear();
+   EXPECT_TRUE(queue.empty());
+   EXPECT_EQ(copy.size(), 3);
+   EXPECT_EQ(copy.front(), 1);
+   EXPECT_EQ(copy.back(), 3);
+}
@@ -0,0 +1,84 @@
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include "io/trajectory.h"
+#include "test_utils.h"
+#include "utils/random.h"
+
+TEST(TrajectoryTest, write_and_map_shards)
+{
+   auto dir = unique_temp_path();
+   std::filesystem::remove_all(dir);
+   std::filesystem::create_directories(dir);
+   auto base = dir / "selfplay";
+
+   TrajectoryLayout layout{5, 70};
+   // 2 mask words, 5 + 70 floats, the action and the value, padded to a multiple of 8
+   EXPECT_EQ(layout.mask_words(), 2);
+   EXPECT_EQ(layout.stride() % 8, 0);
+   EXPECT_EQ(layout.stride(), 328);
+
+   // small buffers and shards, so that the writer hands over buffers and rolls over shards
+   constexpr size_t n_records = 250;
+   {
+      TrajectoryWriter writer(base, layout, 3, 16, 100);
+      for(size_t i = 0; i < n_records; ++i) {
+         auto record = writer.append();
+         for(size_t j = 0; j < layout.observation_size; ++j) {
+            record.observation()[j] = float(i) + 0.5f * float(j);
+         }
+         record.set_legal(i % layout.n_actions);
+         record.set_legal(69);
+         record.policy()[i % layout.n_actions] = 1.f;
+         record.action() = u32(i % layout.n_actions);
+         record.value() = i % 2 == 0 ? 1.f : -1.f;
+      }
+      writer.close();
+      EXPECT_EQ(writer.size(), n_records);
+      EXPECT_THROW(static_cast< void >(writer.append()), std::logic_error);
+      EXPECT_EQ(writer.size(), n_records);
+   }
+
+   auto reader = TrajectoryReader::open(base);
+   EXPECT_EQ(reader.n_shards(), 3);
+   ASSERT_EQ(reader.size(), n_records);
+   EXPECT_EQ(reader.layout(), layout);
+   EXPECT_EQ(reader.encoder_version(), 3);
+   for(size_t i : {size_t(0), size_t(99), size_t(100), size_t(249)}) {
+      auto record = reader[i];
+      EXPECT_EQ(record.observation()[4], float(i) + 2.f);
+      EXPECT_TRUE(record.is_legal(i % layout.n_actions));
+      EXPECT_TRUE(record.is_legal(69));
+      EXPECT_EQ(record.is_legal(68), i % layout.n_actions == 68);
+      EXPECT_EQ(record.policy()[i % layout.n_actions], 1.f);
+      EXPECT_EQ(record.action(), i % layout.n_actions);
+      EXPECT_EQ(record.value(), i % 2 == 0 ? 1.f : -1.f);
+   }
+   EXPECT_THROW(static_cast< void >(reader.at(n_records)), std::out_of_range);
+   auto rng = random::create_rng(0);
+   for(int i = 0; i < 20; ++i) {
+      auto record = reader.sample(rng);
+      EXPECT_EQ(record.value(), u32(record.observation()[0]) % 2 == 0 ? 1.f : -1.f);
+   }
+
+   std::filesystem::remove_all(dir);
+}
+
+TEST(TrajectoryTest, empty_files)
+{
+   auto dir = unique_temp_path();
+   std::filesystem::remove_all(dir);
+   std::filesystem::create_directories(dir);
+   auto base = dir / "empty";
+   TrajectoryLayout layout{2, 3};
+   TrajectoryWriter(base, layout, 1).close();
+
+   auto reader = TrajectoryReader::open(base);
+   EXPECT_TRUE(reader.empty());
+   auto rng = random::create_rng(0);
+   EXPECT_THROW(static_cast< void >(reader.sample(rng)), std::out_of_range);
+
+   std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,75 @@
+
+#ifndef LORAINE_TEST_UTILS_H
+#define LORAINE_TEST_UTILS_H
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+
+#include "cards/catalog.h"
+
+#ifdef _WIN32
+   #include <process.h>
+#else
+   #include <unistd.h>
+#endif
+
+/**
+ * A path in the temp directory of its own for the running test, named after the test and the
+ * process, so that concurrent test runs do not clobber each other's files.
+ */
+inline std::filesystem::path unique_temp_path(const std::string& suffix = "")
+{
+#ifdef _WIN32
+   auto pid = _getpid();
+#else
+   auto pid = getpid();
+#endif
+   const auto* test = ::testing::UnitTest::GetInstance()->current_test_info();
+   std::string name = "loraine_";
+   if(test != nullptr) {
+      name += std::string(test->test_suite_name()) + "_" + test->name() + "_";
+   }
+   return std::filesystem::temp_directory_path() / (name + std::to_string(pid) + suffix);
+}
+
+/**
+ * A catalog file written to a temp path of its own, removed again on destruction.
+ */
+class TempCatalog {
+  public:
+   explicit TempCatalog(const CatalogBuilder& builder) : m_path(unique_temp_path(".lorcat"))
+   {
+      builder.write(m_path);
+   }
+   TempCatalog(const TempCatalog&) = delete;
+   TempCatalog& operator=(const TempCatalog&) = delete;
+   ~TempCatalog() { std::filesystem::remove(m_path); }
+
+   [[nodiscard]] auto& path() const { return m_path; }
+
+  private:
+   std::filesystem::path m_path;
+};
+
+/**
+ * Base of the fixtures reading a catalog: the cards added by `add_cards` are written to the catalog
+ * file at `path` before each test, which is removed after it.
+ */
+class CatalogFileTest: public ::testing::Test {
+  protected:
+   std::filesystem::path path = unique_temp_path(".lorcat");
+
+   void SetUp() override
+   {
+      CatalogBuilder builder("test-1.0");
+      add_cards(builder);
+      builder.write(path);
+   }
+   void TearDown() override { std::filesystem::remove(path); }
+
+   virtual void add_cards(CatalogBuilder& builder) = 0;
+};
+
+#endif  // LORAINE_TEST_UTILS_H
@@ -0,0 +1,226 @@
+#include "deck_builder.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace deckopt {
+
+u64 deck_hash(const DeckList& deck_list)
+{
+   auto cards = deck_list.cards;
+   std::sort(cards.begin(), cards.end(), [](const auto& a, const auto& b) {
+      return a.card < b.card;
+   });
+   // 64 bit FNV-1a over the (card, count) pairs
+   u64 hash = 14695981039346656037ULL;
+   for(const auto& [card, count] : cards) {
+      for(u64 value : {u64(card), u64(count)}) {
+         for(size_t byte = 0; byte < sizeof(u32); ++byte) {
+            hash = (hash ^ ((value >> (8 * byte)) & 0xFF)) * 1099511628211ULL;
+         }
+      }
+   }
+   return hash;
+}
+
+DeckBuilder::DeckBuilder(const CardPool& pool, const Config& config)
+    : m_pool(&pool),
+      m_candidates(pool.query().collectible().exclude(pool.card_type(CardType::TRAP)).cards()),
+      m_regions(),
+      m_max_copies(config.MAX_CARD_COPIES_IN_DECK),
+      m_deck_size(config.DECK_CARDS_LIMIT),
+      m_max_champions(config.CHAMPIONS_LIMIT),
+      m_max_regions(config.REGIONS_LIMIT)
+{
+   for(size_t r = 0; r < n_regions; ++r) {
+      if((m_candidates & pool.region(Region(r))).any()) {
+         m_regions.add(Region(r));
+      }
+   }
+   if(m_regions.empty()) {
+      throw std::invalid_argument("The card pool holds no collectible cards to build decks of.");
+   }
+}
+
+DeckList DeckBuilder::random_deck(random::rng_type& rng) const
+{
+   std::vector< Region > regions;
+   for(size_t r = 0; r < n_regions; ++r) {
+      if(m_regions.contains(Region(r))) {
+         regions.emplace_back(Region(r));
+      }
+   }
+   std::shuffle(regions.begin(), regions.end(), rng);
+   RegionSet allowed;
+   for(size_t i = 0; i < std::min(m_max_regions, regions.size()); ++i) {
+      allowed.add(regions[i]);
+   }
+   DeckList deck;
+   deck.cards.reserve(m_deck_size);
+   _fill(deck, allowed, rng);
+   _finish(deck);
+   return deck;
+}
+
+DeckList DeckBuilder::mutate(DeckList deck, size_t n_swaps, random::rng_type& rng) const
+{
+   for(size_t swap = 0; swap < n_swaps && deck.n_cards > 0; ++swap) {
+      _remove_copy(deck, false, rng);
+      _fill(deck, m_regions, rng);
+   }
+   _finish(deck);
+   return deck;
+}
+
+DeckList DeckBuilder::crossover(
+   const DeckList& first,
+   const DeckList& second,
+   random::rng_type& rng) const
+{
+   RegionSet allowed = first.regions;
+   if(auto both = RegionSet(first.regions.bits() | second.regions.bits());
+      both.size() <= m_max_regions) {
+      allowed = both;
+   }
+   const auto& catalog = m_pool->catalog();
+   auto count_in = [](const DeckList& deck, u32 card) -> u32 {
+      auto entry = std::find_if(deck.cards.begin(), deck.cards.end(), [&](const auto& e) {
+         return e.card == card;
+      });
+      return entry != deck.cards.end() ? entry->count : 0;
+   };
+   DeckList child;
+   child.cards.reserve(m_deck_size);
+   std::bernoulli_distribution coin(0.5);
+   // the parents are told apart by their position, as they may be the same deck
+   for(bool is_first : {true, false}) {
+      const auto& parent = is_first ? first : second;
+      const auto& other = is_first ? second : first;
+      for(const auto& [card, count] : parent.cards) {
+         // the cards of both parents are decided when visiting the first
+         if(not allowed.contains(Region(catalog[card].region))
+            || (not is_first && count_in(first, card) > 0)) {
+            continue;
+         }
+         u32 copies = coin(rng) ? count : count_in(other, card);
+         if(copies > 0) {
+            _add(child, card, u32(std::min(size_t(copies), m_max_copies)));
+         }
+      }
+   }
+   while(child.n_champions > m_max_champions) {
+      _remove_copy(child, true, rng);
+   }
+   while(child.n_cards > m_deck_size) {
+      _remove_copy(child, false, rng);
+   }
+   _fill(child, allowed, rng);
+   _finish(child);
+   return child;
+}
+
+bool DeckBuilder::_is_champion(u32 card) const
+{
+   return CardSuperType(m_pool->catalog()[card].super_type) == CardSuperType::CHAMPION;
+}
+
+RegionSet DeckBuilder::_regions(const DeckList& deck) const
+{
+   RegionSet regions;
+   for(const auto& entry : deck.cards) {
+      regions.add(Region(m_pool->catalog()[entry.card].region));
+   }
+   return regions;
+}
+
+void DeckBuilder::_add(DeckList& deck, u32 card, u32 copies) const
+{
+   auto entry = std::find_if(deck.cards.begin(), deck.cards.end(), [&](const auto& e) {
+      return e.card == card;
+   });
+   if(entry == deck.cards.end()) {
+      deck.cards.push_back({card, copies});
+   } else {
+      entry->count += copies;
+   }
+   deck.n_cards += copies;
+   if(_is_champion(card)) {
+      deck.n_champions += copies;
+   }
+   deck.regions.add(Region(m_pool->catalog()[card].region));
+}
+
+void DeckBuilder::_remove_copy(DeckList& deck, bool champion, random::rng_type& rng) const
+{
+   size_t n_eligible = champion ? deck.n_champions : deck.n_cards;
+   if(n_eligible == 0) {
+      return;
+   }
+   auto copy = std::uniform_int_distribution< size_t >(0, n_eligible - 1)(rng);
+   for(auto entry = deck.cards.begin(); entry != deck.cards.end(); ++entry) {
+      bool is_champion = _is_champion(entry->card);
+      if(champion && not is_champion) {
+         continue;
+      }
+      if(copy >= entry->count) {
+         copy -= entry->count;
+         continue;
+      }
+      deck.n_cards -= 1;
+      if(is_champion) {
+         deck.n_champions -= 1;
+      }
+      if(--entry->count == 0) {
+         deck.cards.erase(entry);
+         deck.regions = _regions(deck);
+      }
+      return;
+   }
+}
+
+void DeckBuilder::_fill(DeckList& deck, RegionSet allowed, random::rng_type& rng) const
+{
+   Bitmap full(m_pool->size());
+   for(const auto& [card, count] : deck.cards) {
+      if(count >= m_max_copies) {
+         full.set(card);
+      }
+   }
+   while(deck.n_cards < m_deck_size) {
+      auto query = m_pool->query().only(m_candidates).exclude(full);
+      // a deck at the region limit only draws from its regions, any other from the allowed ones
+      query.regions(deck.regions.size() >= m_max_regions ? deck.regions : allowed);
+      if(deck.n_champions >= m_max_champions) {
+         query.exclude(m_pool->super_type(CardSuperType::CHAMPION));
+      }
+      const auto* entry = query.sample(rng);
+      if(entry == nullptr) {
+         throw std::runtime_error("The card pool cannot fill a deck within the deck limits.");
+      }
+      auto card = u32(m_pool->catalog().index_of(*entry));
+      auto current = std::find_if(deck.cards.begin(), deck.cards.end(), [&](const auto& e) {
+         return e.card == card;
+      });
+      size_t present = current != deck.cards.end() ? current->count : 0;
+      size_t room = std::min(m_max_copies - present, m_deck_size - deck.n_cards);
+      if(_is_champion(card)) {
+         room = std::min(room, m_max_champions - deck.n_champions);
+      }
+      auto copies = std::uniform_int_distribution< size_t >(1, room)(rng);
+      _add(deck, card, u32(copies));
+      if(present + copies >= m_max_copies) {
+         full.set(card);
+      }
+   }
+}
+
+void DeckBuilder::_finish(DeckList& deck) const
+{
+   std::sort(deck.cards.begin(), deck.cards.end(), [](const auto& a, const auto& b) {
+      return a.card < b.card;
+   });
+   deck.regions = _regions(deck);
+   deck.violations = 0;
+}
+
+}  // namespace deckopt
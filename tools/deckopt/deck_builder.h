@@ -0,0 +1,77 @@
+
+#ifndef LORAINE_DECKOPT_DECK_BUILDER_H
+#define LORAINE_DECKOPT_DECK_BUILDER_H
+
+#include "cards/card_pool.h"
+#include "core/config.h"
+#include "core/deckcode.h"
+#include "utils/random.h"
+
+namespace deckopt {
+
+/**
+ * The hash of a deck list's cards, independent of their order. Decks of equal hashes are taken
+ * to be equal by the evaluation cache.
+ */
+u64 deck_hash(const DeckList& deck_list);
+
+/**
+ * Builds, mutates and recombines deck lists within the deck building limits of a Config, drawing
+ * the cards from the collectible cards of a pool (traps excluded, since the card factory cannot
+ * build them). Every deck list it returns satisfies all limits, and its cards are sorted by their
+ * catalog index.
+ */
+class DeckBuilder {
+  public:
+   DeckBuilder(const CardPool& pool, const Config& config = Config{});
+
+   /**
+    * A random deck of at most REGIONS_LIMIT random regions.
+    */
+   [[nodiscard]] DeckList random_deck(random::rng_type& rng) const;
+   /**
+    * The deck with `n_swaps` random copies replaced by random cards of its regions (or of a new
+    * region, while it has fewer than the limit).
+    */
+   [[nodiscard]] DeckList mutate(DeckList deck, size_t n_swaps, random::rng_type& rng) const;
+   /**
+    * A deck mixing the cards of both parents: each card takes the copies of one parent at random,
+    * as far as it fits the regions of the first parent (or of both, if they are within the limit).
+    */
+   [[nodiscard]] DeckList crossover(
+      const DeckList& first,
+      const DeckList& second,
+      random::rng_type& rng) const;
+
+   [[nodiscard]] auto& candidates() const { return m_candidates; }
+
+  private:
+   const CardPool* m_pool;
+   Bitmap m_candidates;
+   RegionSet m_regions;
+   size_t m_max_copies;
+   size_t m_deck_size;
+   size_t m_max_champions;
+   size_t m_max_regions;
+
+   [[nodiscard]] bool _is_champion(u32 card) const;
+   [[nodiscard]] RegionSet _regions(const DeckList& deck) const;
+   /**
+    * Adds the copies of the card and updates the deck's totals.
+    */
+   void _add(DeckList& deck, u32 card, u32 copies) const;
+   /**
+    * Removes one random copy of the deck's cards (of its champions only, if asked to).
+    */
+   void _remove_copy(DeckList& deck, bool champion, random::rng_type& rng) const;
+   /**
+    * Fills the deck up to the deck size with random cards of the allowed regions (only of its
+    * own, once it has as many as the limit), staying within the limits.
+    */
+   void _fill(DeckList& deck, RegionSet allowed, random::rng_type& rng) const;
+   void _finish(DeckList& deck) const;
+};
+
+}  // namespace deckopt
+
+#endif  // LORAINE_DECKOPT_DECK_BUILDER_H
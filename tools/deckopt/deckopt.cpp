@@ -0,0 +1,248 @@
+
+/**
+ * Deck-building optimizer: evolves decks of a card catalog by a genetic algorithm, their fitness
+ * being their score in simulated games against a gauntlet of (meta) decks.
+ *
+ * Every generation is evaluated by successive halving: all decks play a few games against the
+ * gauntlet, then the better half plays twice as many, and so on up to the maximum number of games.
+ * Beyond the elites, decks whose confidence interval lies below the best deck's are dropped early.
+ * Elites carry over to the next generation together with their records; the rest of it are
+ * crossovers and mutations of decks chosen by tournament selection. Each generation reports its
+ * best deck as a JSON line.
+ *
+ * Usage: deckopt --catalog FILE --gauntlet FILE [--population N] [--generations N] [--elite N]
+ *                [--min-games N] [--max-games N] [--threads N] [--seed N] [--output FILE]
+ */
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <unordered_set>
+
+#include "cards/card_pool.h"
+#include "cards/cardfactory.h"
+#include "core/deckcode.h"
+#include "deck_builder.h"
+#include "evaluator.h"
+
+namespace {
+
+struct Options {
+   std::string catalog;
+   std::string gauntlet;
+   std::string output;
+   size_t population = 32;
+   size_t generations = 20;
+   size_t elite = 4;
+   u64 min_games = 8;
+   u64 max_games = 128;
+   size_t threads = 0;
+   u64 seed = 0;
+   // the error probability of the confidence intervals that stop weak decks early
+   double delta = 0.05;
+};
+
+/**
+ * Ranks the population by successive halving, returning its indices from best to worst: first
+ * those that reached the last round, by score, then those dropped in earlier rounds, latest first.
+ */
+std::vector< size_t > race(
+   deckopt::Evaluator& evaluator,
+   const std::vector< DeckList >& population,
+   const Options& opts)
+{
+   std::vector< size_t > alive(population.size());
+   std::iota(alive.begin(), alive.end(), 0);
+   std::vector< size_t > dropped;
+   std::vector< deckopt::MatchRecord > records(population.size());
+   auto better = [&](size_t a, size_t b) {
+      return records[a].score() > records[b].score()
+             || (records[a].score() == records[b].score() && a < b);
+   };
+   for(u64 n_games = opts.min_games;; n_games = std::min(2 * n_games, opts.max_games)) {
+      std::vector< const DeckList* > decks;
+      decks.reserve(alive.size());
+      for(auto idx : alive) {
+         decks.emplace_back(&population[idx]);
+      }
+      evaluator.evaluate(decks, n_games);
+      for(auto idx : alive) {
+         records[idx] = evaluator.record(population[idx]);
+      }
+      std::sort(alive.begin(), alive.end(), better);
+      if(n_games >= opts.max_games) {
+         break;
+      }
+      // keep the better half, but beyond the elites only those that may still beat the best
+      size_t keep = std::max(opts.elite, (alive.size() + 1) / 2);
+      const auto& best = records[alive.front()];
+      double best_lower = best.score() - best.radius(opts.delta);
+      while(keep > opts.elite) {
+         const auto& record = records[alive[keep - 1]];
+         if(record.score() + record.radius(opts.delta) >= best_lower) {
+            break;
+         }
+         --keep;
+      }
+      if(keep < alive.size()) {
+         dropped.insert(dropped.begin(), alive.begin() + long(keep), alive.end());
+         alive.resize(keep);
+      }
+   }
+   alive.insert(alive.end(), dropped.begin(), dropped.end());
+   return alive;
+}
+
+std::vector< DeckList > next_generation(
+   const std::vector< DeckList >& population,
+   const std::vector< size_t >& ranking,
+   const deckopt::DeckBuilder& builder,
+   const Options& opts,
+   random::rng_type& rng)
+{
+   std::vector< DeckList > next;
+   std::unordered_set< u64 > hashes;
+   next.reserve(opts.population);
+   for(size_t i = 0; i < std::min(opts.elite, ranking.size()); ++i) {
+      next.emplace_back(population[ranking[i]]);
+      hashes.emplace(deckopt::deck_hash(next.back()));
+   }
+   // a binary tournament over the ranks, i.e. the better ranked of two random decks
+   std::uniform_int_distribution< size_t > rank(0, ranking.size() - 1);
+   auto select = [&]() -> const DeckList& {
+      return population[ranking[std::min(rank(rng), rank(rng))]];
+   };
+   std::bernoulli_distribution recombine(0.7);
+   std::geometric_distribution< size_t > extra_swaps(0.5);
+   size_t attempts = 0;
+   while(next.size() < opts.population) {
+      const auto& first = select();
+      auto child = recombine(rng) ? builder.crossover(first, select(), rng) : first;
+      child = builder.mutate(std::move(child), 1 + extra_swaps(rng), rng);
+      // duplicates are only accepted once the pool of new decks seems exhausted
+      if(hashes.emplace(deckopt::deck_hash(child)).second || ++attempts > 100 * opts.population) {
+         next.emplace_back(std::move(child));
+      }
+   }
+   return next;
+}
+
+void write_decks(
+   std::ostream& os,
+   const DeckCodec& codec,
+   const deckopt::Evaluator& evaluator,
+   const std::vector< DeckList >& population,
+   const std::vector< size_t >& ranking,
+   size_t n_decks)
+{
+   os << std::fixed << std::setprecision(3);
+   for(size_t i = 0; i < std::min(n_decks, ranking.size()); ++i) {
+      const auto& deck = population[ranking[i]];
+      auto record = evaluator.record(deck);
+      os << codec.encode(deck) << "\t" << record.score() << "\t" << record.games << "\n";
+   }
+}
+
+int run(const Options& opts)
+{
+   auto start = std::chrono::steady_clock::now();
+   auto factory = std::make_shared< CardFactory >(opts.catalog);
+   const auto& catalog = factory->catalog();
+   CardPool pool(catalog);
+   DeckCodec codec(catalog);
+
+   auto gauntlet = codec.decode_file(opts.gauntlet);
+   for(size_t i = 0; i < gauntlet.size(); ++i) {
+      if(gauntlet[i].violates(DeckList::MALFORMED)
+         || gauntlet[i].violates(DeckList::UNKNOWN_CARD)) {
+         std::cerr << "Gauntlet deck " << i + 1 << " cannot be decoded with the catalog.\n";
+         return 1;
+      }
+      if(not gauntlet[i].valid()) {
+         std::cerr << "Warning: gauntlet deck " << i + 1 << " breaks the deck building rules.\n";
+      }
+   }
+
+   deckopt::DeckBuilder builder(pool);
+   deckopt::Evaluator evaluator(factory, std::move(gauntlet), opts.threads, opts.seed);
+   auto rng = random::create_rng(opts.seed);
+   std::vector< DeckList > population;
+   population.reserve(opts.population);
+   for(size_t i = 0; i < opts.population; ++i) {
+      population.emplace_back(builder.random_deck(rng));
+   }
+   std::cerr << "Evolving " << opts.population << " decks against " << evaluator.gauntlet().size()
+             << " gauntlet decks on " << evaluator.n_threads() << " thread(s).\n";
+
+   std::vector< size_t > ranking;
+   for(size_t generation = 0; generation < opts.generations; ++generation) {
+      ranking = race(evaluator, population, opts);
+      const auto& best = population[ranking.front()];
+      auto record = evaluator.record(best);
+      auto seconds =
+         std::chrono::duration< double >(std::chrono::steady_clock::now() - start).count();
+      std::cout << std::fixed << std::setprecision(3) << "{\"generation\": " << generation
+                << ", \"best_deck\": \"" << codec.encode(best) << "\", \"best_score\": "
+                << record.score() << ", \"best_games\": " << record.games
+                << ", \"games_played\": " << evaluator.games_played()
+                << ", \"decks_evaluated\": " << evaluator.n_cached() << ", \"seconds\": " << seconds
+                << "}" << std::endl;
+      if(generation + 1 < opts.generations) {
+         population = next_generation(population, ranking, builder, opts, rng);
+      }
+   }
+
+   if(opts.output.empty()) {
+      write_decks(std::cout, codec, evaluator, population, ranking, opts.elite);
+   } else {
+      std::ofstream file(opts.output);
+      write_decks(file, codec, evaluator, population, ranking, opts.elite);
+   }
+   return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+   Options opts;
+   for(int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      if(i + 1 < argc && arg == "--catalog") {
+         opts.catalog = argv[++i];
+      } else if(i + 1 < argc && arg == "--gauntlet") {
+         opts.gauntlet = argv[++i];
+      } else if(i + 1 < argc && arg == "--output") {
+         opts.output = argv[++i];
+      } else if(i + 1 < argc && arg == "--population") {
+         opts.population = std::stoul(argv[++i]);
+      } else if(i + 1 < argc && arg == "--generations") {
+         opts.generations = std::stoul(argv[++i]);
+      } else if(i + 1 < argc && arg == "--elite") {
+         opts.elite = std::stoul(argv[++i]);
+      } else if(i + 1 < argc && arg == "--min-games") {
+         opts.min_games = std::stoull(argv[++i]);
+      } else if(i + 1 < argc && arg == "--max-games") {
+         opts.max_games = std::stoull(argv[++i]);
+      } else if(i + 1 < argc && arg == "--threads") {
+         opts.threads = std::stoul(argv[++i]);
+      } else if(i + 1 < argc && arg == "--seed") {
+         opts.seed = std::stoull(argv[++i]);
+      } else {
+         opts.catalog.clear();
+         break;
+      }
+   }
+   if(opts.catalog.empty() || opts.gauntlet.empty() || opts.population == 0
+      || opts.elite > opts.population || opts.min_games == 0 || opts.min_games > opts.max_games) {
+      std::cerr << "Usage: " << argv[0]
+                << " --catalog FILE --gauntlet FILE [--population N] [--generations N]"
+                   " [--elite N] [--min-games N] [--max-games N] [--threads N] [--seed N]"
+                   " [--output FILE]\n";
+      return 1;
+   }
+   return run(opts);
+}
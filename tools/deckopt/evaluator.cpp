@@ -0,0 +1,165 @@
+#include "evaluator.h"
+
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <thread>
+#include <unordered_set>
+
+#include "deck_builder.h"
+#include "scripted_controllers.h"
+
+namespace deckopt {
+
+namespace {
+
+u64 splitmix64(u64 value)
+{
+   value += 0x9E3779B97F4A7C15ULL;
+   value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+   value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+   return value ^ (value >> 31);
+}
+
+}  // namespace
+
+double MatchRecord::radius(double delta) const
+{
+   if(games == 0) {
+      return 1.;
+   }
+   return std::sqrt(std::log(2. / delta) / (2. * double(games)));
+}
+
+struct Evaluator::Worker {
+   uptr< GameState > state = nullptr;
+};
+
+Evaluator::Evaluator(
+   sptr< const CardFactory > factory,
+   std::vector< DeckList > gauntlet,
+   size_t n_threads,
+   u64 seed,
+   const Config& config)
+    : m_factory(std::move(factory)),
+      m_gauntlet(std::move(gauntlet)),
+      m_seed(seed),
+      m_config(config)
+{
+   if(m_gauntlet.empty()) {
+      throw std::invalid_argument("The gauntlet holds no decks to evaluate against.");
+   }
+   if(n_threads == 0) {
+      n_threads = std::max(1U, std::thread::hardware_concurrency());
+   }
+   m_workers.reserve(n_threads);
+   for(size_t t = 0; t < n_threads; ++t) {
+      m_workers.emplace_back(std::make_unique< Worker >());
+   }
+}
+
+Evaluator::~Evaluator() = default;
+
+void Evaluator::evaluate(const std::vector< const DeckList* >& decks, u64 n_games)
+{
+   struct Job {
+      const DeckList* deck;
+      u64 hash;
+      u64 game;
+   };
+   std::vector< Job > jobs;
+   std::unordered_set< u64 > queued;
+   for(const auto* deck : decks) {
+      auto hash = deck_hash(*deck);
+      // a deck given twice only plays its missing games once
+      if(not queued.emplace(hash).second) {
+         continue;
+      }
+      for(u64 game = m_records[hash].games; game < n_games; ++game) {
+         jobs.push_back({deck, hash, game});
+      }
+   }
+
+   std::vector< int > outcomes(jobs.size(), 0);
+   std::vector< std::exception_ptr > errors(m_workers.size());
+   std::atomic< size_t > next_job = 0;
+   auto work = [&](size_t t) {
+      try {
+         for(size_t j = next_job++; j < jobs.size(); j = next_job++) {
+            outcomes[j] = _play(*m_workers[t], *jobs[j].deck, jobs[j].hash, jobs[j].game);
+         }
+      } catch(...) {
+         errors[t] = std::current_exception();
+      }
+   };
+   std::vector< std::thread > threads;
+   threads.reserve(m_workers.size() - 1);
+   for(size_t t = 1; t < m_workers.size(); ++t) {
+      threads.emplace_back(work, t);
+   }
+   work(0);
+   for(auto& thread : threads) {
+      thread.join();
+   }
+   for(auto& error : errors) {
+      if(error) {
+         std::rethrow_exception(error);
+      }
+   }
+
+   for(size_t j = 0; j < jobs.size(); ++j) {
+      auto& record = m_records[jobs[j].hash];
+      record.games += 1;
+      record.wins += outcomes[j] > 0;
+      record.ties += outcomes[j] == 0;
+   }
+   m_games_played += jobs.size();
+}
+
+MatchRecord Evaluator::record(const DeckList& deck) const
+{
+   auto found = m_records.find(deck_hash(deck));
+   return found != m_records.end() ? found->second : MatchRecord{};
+}
+
+int Evaluator::_play(Worker& worker, const DeckList& deck, u64 hash, u64 game) const
+{
+   const auto& rival = m_gauntlet[game % m_gauntlet.size()];
+   u64 round = game / m_gauntlet.size();
+   // the deck alternates sides and, every other pair of games, who starts
+   Team team = Team(round % 2);
+   Team starting_team = Team((round / 2) % 2);
+   u64 seed = splitmix64(hash ^ splitmix64(game ^ splitmix64(m_seed)));
+
+   auto arena = make_arena();
+   SymArr< Deck > decks{Deck(), Deck()};
+   decks[team] = DeckCodec::build(deck, *m_factory, team, arena);
+   decks[opponent(team)] = DeckCodec::build(rival, *m_factory, opponent(team), arena);
+   if(worker.state == nullptr) {
+      worker.state = std::make_unique< GameState >(
+         m_config,
+         std::move(decks),
+         SymArr< sptr< Controller > >{
+            std::make_shared< controllers::ScriptedController >(BLUE),
+            std::make_shared< controllers::ScriptedController >(RED)},
+         starting_team,
+         random::create_rng(seed));
+      worker.state->card_factory(m_factory);
+   } else {
+      worker.state->reset(std::move(decks), starting_team, seed);
+   }
+
+   auto& logic = *worker.state->logic();
+   logic.start_game();
+   auto status = logic.check_status();
+   while(status == Status::ONGOING) {
+      status = logic.step();
+   }
+   if(status == Status::TIE) {
+      return 0;
+   }
+   bool blue_won = status == Status::BLUE_WINS_NEXUS || status == Status::BLUE_WINS_DRAW;
+   return blue_won == (team == BLUE) ? 1 : -1;
+}
+
+}  // namespace deckopt
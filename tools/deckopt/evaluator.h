@@ -0,0 +1,88 @@
+
+#ifndef LORAINE_DECKOPT_EVALUATOR_H
+#define LORAINE_DECKOPT_EVALUATOR_H
+
+#include <unordered_map>
+#include <vector>
+
+#include "all.h"
+#include "cards/cardfactory.h"
+#include "core/deckcode.h"
+
+namespace deckopt {
+
+/**
+ * The results of a deck's games against the gauntlet.
+ */
+struct MatchRecord {
+   u64 games = 0;
+   u64 wins = 0;
+   u64 ties = 0;
+
+   /**
+    * The share of points won, a tie counting half.
+    */
+   [[nodiscard]] double score() const
+   {
+      return games > 0 ? (double(wins) + 0.5 * double(ties)) / double(games) : 0.5;
+   }
+   /**
+    * The half-width of the Hoeffding confidence interval of the score at confidence 1 - delta.
+    */
+   [[nodiscard]] double radius(double delta) const;
+};
+
+/**
+ * Estimates the strength of decks by simulated games against a gauntlet of opposing decks, played
+ * by scripted controllers on all threads.
+ *
+ * Game `g` of a deck is against gauntlet deck g % size on alternating sides, seeded from the deck's
+ * hash and g alone. Results are thus independent of the number of threads and of the order decks
+ * are evaluated in, and are cached per deck hash: asking for more games of a deck only plays the
+ * games beyond those already recorded. Each thread keeps one game state, which is reset for every
+ * game instead of being rebuilt.
+ */
+class Evaluator {
+  public:
+   Evaluator(
+      sptr< const CardFactory > factory,
+      std::vector< DeckList > gauntlet,
+      size_t n_threads = 0,
+      u64 seed = 0,
+      const Config& config = Config{});
+   ~Evaluator();
+
+   /**
+    * Plays the games needed for each deck to have a record of at least `n_games` games.
+    */
+   void evaluate(const std::vector< const DeckList* >& decks, u64 n_games);
+   /**
+    * The record of the deck (an empty one if it has not been evaluated yet).
+    */
+   [[nodiscard]] MatchRecord record(const DeckList& deck) const;
+
+   [[nodiscard]] auto n_threads() const { return m_workers.size(); }
+   [[nodiscard]] auto games_played() const { return m_games_played; }
+   [[nodiscard]] auto n_cached() const { return m_records.size(); }
+   [[nodiscard]] auto& gauntlet() const { return m_gauntlet; }
+
+  private:
+   struct Worker;
+
+   sptr< const CardFactory > m_factory;
+   std::vector< DeckList > m_gauntlet;
+   u64 m_seed;
+   Config m_config;
+   std::vector< uptr< Worker > > m_workers;
+   std::unordered_map< u64, MatchRecord > m_records;
+   u64 m_games_played = 0;
+
+   /**
+    * Plays game `game` of the deck and returns 1 for a win, 0 for a tie and -1 for a loss.
+    */
+   int _play(Worker& worker, const DeckList& deck, u64 hash, u64 game) const;
+};
+
+}  // namespace deckopt
+
+#endif  // LORAINE_DECKOPT_EVALUATOR_H